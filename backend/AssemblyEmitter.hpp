@@ -3,13 +3,23 @@
 
 #include "MachineIRModule.hpp"
 #include "TargetMachine.hpp"
+#include <ostream>
 
 class AssemblyEmitter {
 public:
   AssemblyEmitter(MachineIRModule *Module, TargetMachine *TM)
       : TM(TM), MIRM(Module) {}
 
-  void GenerateAssembly();
+  /// Print the assembly of the whole module to @OS.
+  void GenerateAssembly(std::ostream &OS);
+
+  /// Print the assembly of @Func to @OS. @FunctionCounter is the index of the
+  /// function in the module, it makes the local labels unique.
+  void EmitFunction(MachineFunction &Func, unsigned FunctionCounter,
+                    std::ostream &OS);
+
+  /// Print the data section to @OS.
+  void EmitGlobalData(std::ostream &OS);
 
 private:
   TargetMachine *TM;
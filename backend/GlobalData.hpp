@@ -83,7 +83,7 @@ public:
     }
   }
 
-  void Print() const {
+  void Print(std::ostream &OS) const {
     std::string Str = Name + ":\n";
     for (auto &[Directive, InitVal] : InitValues) {
       Str += "  ." + DirectiveToString(Directive) + "\t";
@@ -92,7 +92,7 @@ public:
       else
         Str += "\"" + InitVal + "\"\n";
     }
-    std::cout << Str << std::endl;
+    OS << Str << std::endl;
   }
 
 private:
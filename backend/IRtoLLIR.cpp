@@ -1,6 +1,8 @@
 #include "IRtoLLIR.hpp"
 #include "../middle_end/IR/BasicBlock.hpp"
 #include "../middle_end/IR/Function.hpp"
+#include "../support/Statistic.hpp"
+#include "../support/TimeProfiler.hpp"
 #include "LowLevelType.hpp"
 #include "MachineBasicBlock.hpp"
 #include "MachineFunction.hpp"
@@ -9,6 +11,9 @@
 #include <cassert>
 #include "Support.hpp"
 
+STATISTIC(NumMemcpyCalls, "IRtoLLIR",
+          "Number of memory copies lowered to a memcpy call");
+
 MachineOperand IRtoLLIR::GetMachineOperandFromValue(Value *Val,
                                                     MachineBasicBlock *MBB,
                                                     bool IsDef = false) {
@@ -20,7 +25,7 @@ MachineOperand IRtoLLIR::GetMachineOperandFromValue(Value *Val,
   if (Val->IsRegister()) {
     auto BitWidth = Val->GetBitWidth();
     if (Val->GetTypeRef().IsPTR() &&
-        dynamic_cast<StackAllocationInstruction *>(Val) == nullptr)
+        !isa<StackAllocationInstruction>(Val))
       BitWidth = TM->GetPointerSize();
     unsigned NextVReg;
 
@@ -81,7 +86,7 @@ MachineOperand IRtoLLIR::GetMachineOperandFromValue(Value *Val,
 
     return Result;
   } else if (Val->IsConstant()) {
-    auto C = dynamic_cast<Constant *>(Val);
+    auto C = dyn_cast<Constant>(Val);
 
     MachineOperand Result =
         C->IsFPConst() ? MachineOperand::CreateFPImmediate(C->GetFloatValue())
@@ -158,7 +163,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
   auto ResultMI = MachineInstruction((unsigned)Operation + (1 << 16), BB);
 
   // Three address ALU instructions: INSTR Result, Op1, Op2
-  if (auto I = dynamic_cast<BinaryInstruction *>(Instr); I != nullptr) {
+  if (auto I = dyn_cast<BinaryInstruction>(Instr); I != nullptr) {
     auto Result = GetMachineOperandFromValue((Value *)I, BB, true);
     auto FirstSrcOp = GetMachineOperandFromValue(I->GetLHS(), BB);
     auto SecondSrcOp = GetMachineOperandFromValue(I->GetRHS(), BB);
@@ -168,7 +173,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
     ResultMI.AddOperand(SecondSrcOp);
   }
   // Two address ALU instructions: INSTR Result, Op
-  else if (auto I = dynamic_cast<UnaryInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<UnaryInstruction>(Instr); I != nullptr) {
     auto Result = GetMachineOperandFromValue((Value *)I, BB, true);
     MachineOperand Op;
 
@@ -206,7 +211,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
     ResultMI.AddOperand(Op);
   }
   // Store instruction: STR [address], Src
-  else if (auto I = dynamic_cast<StoreInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<StoreInstruction>(Instr); I != nullptr) {
     // TODO: maybe it should be something else then a register since its
     // an address, revisit this
     assert((I->GetMemoryLocation()->IsRegister() ||
@@ -239,7 +244,8 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
         !I->GetSavedValue()->GetTypeRef().IsPTR()) {
       // Handle the case where the referred struct is a function parameter,
       // therefore held in registers
-      if (auto FP = dynamic_cast<FunctionParameter *>(I->GetSavedValue()); FP != nullptr) {
+      if (auto FP = dyn_cast<FunctionParameter>(I->GetSavedValue());
+          FP != nullptr) {
         unsigned RegSize = TM->GetPointerSize();
         auto StructName = FP->GetName();
         assert(!StructToRegMap[StructName].empty() && "Unknown struct name");
@@ -281,7 +287,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
         }
       }
     } else if (!ParamByIDToRegMap[I->GetSavedValue()->GetID()].empty()) {
-      assert(dynamic_cast<FunctionParameter *>(I->GetSavedValue()));
+      assert(isa<FunctionParameter>(I->GetSavedValue()));
       const unsigned RegSize = TM->GetPointerSize();
 
       MachineInstruction CurrentStore;
@@ -310,7 +316,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
     }
     // if the source is a SA instruction, then its address which needs to be
     // stored, therefore it has to be materialized by STACK_ADDRESS instruction
-    else if (dynamic_cast<StackAllocationInstruction *>(I->GetSavedValue())) {
+    else if (isa<StackAllocationInstruction>(I->GetSavedValue())) {
       assert(ParentFunction->IsStackSlot(I->GetSavedValue()->GetID()));
       auto SA = MachineInstruction(MachineInstruction::STACK_ADDRESS, BB);
       auto SourceReg = ParentFunction->GetNextAvailableVReg();
@@ -322,7 +328,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
       ResultMI.AddOperand(GetMachineOperandFromValue(I->GetSavedValue(), BB));
   }
   // Load instruction: LD Dest, [address]
-  else if (auto I = dynamic_cast<LoadInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<LoadInstruction>(Instr); I != nullptr) {
     // TODO: same as with STORE
     assert((I->GetMemoryLocation()->IsRegister() ||
             I->GetMemoryLocation()->IsGlobalVar()) && "Forbidden source");
@@ -379,7 +385,8 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
   // **arithmetic instructions to calculate the index** ex: 1 index which is 6
   //   MUL idx, sizeof(Source[0]), 6
   //   ADD Dest, Dest, idx
-  else if (auto I = dynamic_cast<GetElementPointerInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<GetElementPointerInstruction>(Instr);
+           I != nullptr) {
     MachineInstruction GoalInstr;
     // Used for to look up GoalInstr if it was inserted
     int GoalInstrIdx = -1;
@@ -528,7 +535,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
     return ADD;
   }
   // Jump instruction: J label
-  else if (auto I = dynamic_cast<JumpInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<JumpInstruction>(Instr); I != nullptr) {
     for (auto &BB : BBs)
       if (I->GetTargetLabelName() == BB.GetName()) {
         ResultMI.AddLabel(BB.GetName().c_str());
@@ -536,7 +543,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
       }
   }
   // Branch instruction: Br op label label
-  else if (auto I = dynamic_cast<BranchInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<BranchInstruction>(Instr); I != nullptr) {
     const char *LabelTrue = nullptr;
     const char *LabelFalse = nullptr;
 
@@ -555,7 +562,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
       ResultMI.AddLabel(LabelTrue);
   }
   // Compare instruction: cmp dest, src1, src2
-  else if (auto I = dynamic_cast<CompareInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<CompareInstruction>(Instr); I != nullptr) {
     auto Result = GetMachineOperandFromValue((Value *)I, BB, true);
     auto FirstSrcOp = GetMachineOperandFromValue(I->GetLHS(), BB);
     auto SecondSrcOp = GetMachineOperandFromValue(I->GetRHS(), BB);
@@ -567,7 +574,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
     ResultMI.SetAttributes(I->GetRelation());
   }
   // Call instruction: call Result, function_name(Param1, ...)
-  else if (auto I = dynamic_cast<CallInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<CallInstruction>(Instr); I != nullptr) {
     // The function has a call instruction
     ParentFunction->SetToCaller();
 
@@ -576,7 +583,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
     // some parameters on the stack
     auto &TargetArgRegs = TM->GetABI()->GetArgumentRegisters();
     unsigned ParamCounter = 0;
-    for (auto *Param : I->GetArgs()) {
+    for (Value *Param : I->GetArgs()) {
       MachineInstruction Instr;
 
       // In case if its a struct by value param, then it is already loaded
@@ -657,7 +664,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
       }
     }
 
-    ResultMI.AddFunctionName(I->GetName().c_str());
+    ResultMI.AddFunctionName(I->GetName().CStr());
 
     // if no return value then we are done
     if (I->GetTypeRef().IsVoid())
@@ -711,7 +718,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
     }
   }
   // Ret instruction: ret op
-  else if (auto I = dynamic_cast<ReturnInstruction *>(Instr); I != nullptr) {
+  else if (auto I = dyn_cast<ReturnInstruction>(Instr); I != nullptr) {
     // If return is void
     if (I->GetRetVal() == nullptr)
       return ResultMI;
@@ -786,8 +793,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
         assert(RegsCount == 2 && "Only supporting two return registers for now");
         assert(!IsFP && "FP values cannot be divided into multiple registers");
 
-        auto Const = dynamic_cast<Constant*>(I->GetRetVal());
-        auto ImmMO = GetMachineOperandFromValue(I->GetRetVal(), BB);
+        auto Const = dyn_cast<Constant>(I->GetRetVal());
 
         for (size_t i = 0; i < RegsCount; i++) {
           auto LI = MachineInstruction(MachineInstruction::LOAD_IMM, BB);
@@ -845,7 +851,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
     }
   }
   // Memcopy instruction: memcopy dest, source, num_of_bytes
-  else if (auto I = dynamic_cast<MemoryCopyInstruction *>(Instr);
+  else if (auto I = dyn_cast<MemoryCopyInstruction>(Instr);
            I != nullptr) {
     // lower this into load and store pairs if used with structs lower then
     // a certain size (for now be it the size which can be passed by value)
@@ -889,6 +895,7 @@ MachineInstruction IRtoLLIR::ConvertToMachineInstr(Instruction *Instr,
       BB->InsertInstr(Param3);
 
       ResultMI.AddFunctionName("memcpy");
+      ++NumMemcpyCalls;
       return ResultMI;
     }
 
@@ -1021,9 +1028,6 @@ void IRtoLLIR::GenerateLLIRFromIR() {
   TU->GetFunctions().reserve(IRM.GetFunctions().size());
 
   for (auto &Fun : IRM.GetFunctions()) {
-    // reset state
-    Reset();
-
     // function declarations does not need any LLIR code
     if (Fun.IsDeclarationOnly())
       continue;
@@ -1032,41 +1036,59 @@ void IRtoLLIR::GenerateLLIRFromIR() {
     MachineFunction *MFunction = TU->GetCurrentFunction();
     assert(MFunction);
 
-    MFunction->SetName(Fun.GetName());
-    HandleFunctionParams(Fun, MFunction);
+    GenerateLLIRFromFunction(Fun, MFunction);
+  }
 
-    // Create all basic block first with their name, so jumps can refer to them
-    // already
-    auto &MFuncMBBs = MFunction->GetBasicBlocks();
-    for (auto &BB : Fun.GetBasicBlocks())
-      MFuncMBBs.push_back(MachineBasicBlock{BB.get()->GetName(), MFunction});
+  GenerateGlobalData();
+}
 
-    unsigned BBCounter = 0;
-    for (auto &BB : Fun.GetBasicBlocks()) {
-      for (auto &Instr : BB->GetInstructions()) {
-        auto InstrPtr = Instr.get();
+void IRtoLLIR::GenerateLLIRFromFunction(Function &Fun,
+                                        MachineFunction *MFunction) {
+  TimeScope Scope("codegen", "IRtoLLIR", Fun.GetName().Str());
 
-        if (InstrPtr->IsStackAllocation()) {
-          HandleStackAllocation((StackAllocationInstruction *)InstrPtr,
-                                MFunction, TM);
-          continue;
-        }
-        MFuncMBBs[BBCounter].InsertInstr(
-            ConvertToMachineInstr(InstrPtr, &MFuncMBBs[BBCounter], MFuncMBBs));
-
-        // everything after a return is dead code so skip those
-        // TODO: add unconditional branch aswell, but it would be better to
-        // just not handle this here but in some optimization pass for
-        // example in dead code elimination
-        if (MFuncMBBs[BBCounter].GetInstructions().back().IsReturn())
-          break;
-      }
+  // reset state
+  Reset();
+
+  auto FunName = Fun.GetName().ToString();
+  MFunction->SetName(FunName);
+  HandleFunctionParams(Fun, MFunction);
 
-      BBCounter++;
+  // Create all basic block first with their name, so jumps can refer to them
+  // already
+  auto &MFuncMBBs = MFunction->GetBasicBlocks();
+  for (auto &BB : Fun.GetBasicBlocks())
+    MFuncMBBs.push_back(MachineBasicBlock{BB.get()->GetName(), MFunction});
+
+  unsigned BBCounter = 0;
+  for (auto &BB : Fun.GetBasicBlocks()) {
+    for (auto &Instr : BB->GetInstructions()) {
+      auto InstrPtr = &Instr;
+
+      if (InstrPtr->IsStackAllocation()) {
+        HandleStackAllocation((StackAllocationInstruction *)InstrPtr,
+                              MFunction, TM);
+        continue;
+      }
+      MFuncMBBs[BBCounter].InsertInstr(
+          ConvertToMachineInstr(InstrPtr, &MFuncMBBs[BBCounter], MFuncMBBs));
+
+      // everything after a return is dead code so skip those
+      // TODO: add unconditional branch aswell, but it would be better to
+      // just not handle this here but in some optimization pass for
+      // example in dead code elimination
+      if (MFuncMBBs[BBCounter].GetInstructions().back().IsReturn())
+        break;
     }
+
+    BBCounter++;
   }
+}
+
+void IRtoLLIR::GenerateGlobalData() {
+  TimeScope Scope("codegen", "IRtoLLIR");
+
   for (auto &GlobalVar : IRM.GetGlobalVars()) {
-    auto Name = ((GlobalVariable*)GlobalVar.get())->GetName();
+    auto Name = ((GlobalVariable*)GlobalVar.get())->GetName().ToString();
     auto Size = GlobalVar->GetTypeRef().GetByteSize();
 
     auto GD = GlobalData(Name, Size);
@@ -1081,8 +1103,9 @@ void IRtoLLIR::GenerateLLIRFromIR() {
         if (InitStr.empty() && InitVal == nullptr)
           GD.InsertAllocation(Size, 0);
         else // string literal case
-          GD.InsertAllocation(InitVal ? ((GlobalVariable *)InitVal)->GetName()
-                                      : InitStr);
+          GD.InsertAllocation(
+              InitVal ? ((GlobalVariable *)InitVal)->GetName().ToString()
+                      : InitStr);
       }
       // if the list is not empty then allocate the appropriate type of
       // memories with initialization
@@ -1129,7 +1152,8 @@ void IRtoLLIR::GenerateLLIRFromIR() {
           break;
         }
 
-        GD.InsertAllocation(((GlobalVariable *)InitVal)->GetName(), d);
+        GD.InsertAllocation(((GlobalVariable *)InitVal)->GetName().ToString(),
+                            d);
       }
     } else {
       GD.InsertAllocation(Size, InitList[0]);
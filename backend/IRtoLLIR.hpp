@@ -18,6 +18,14 @@ public:
 
   void GenerateLLIRFromIR();
 
+  /// Translate @Fun into @MFunction, which must be already part of the
+  /// module. Only the state of @MFunction is touched, so different
+  /// functions can be translated concurrently by different instances.
+  void GenerateLLIRFromFunction(Function &Fun, MachineFunction *MFunction);
+
+  /// Translate the global variables into the data of the module.
+  void GenerateGlobalData();
+
   MachineIRModule *GetMachIRMod() { return TU; }
 
   void Reset() {
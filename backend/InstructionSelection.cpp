@@ -1,13 +1,19 @@
 #include "InsturctionSelection.hpp"
+#include "../support/TimeProfiler.hpp"
 
 void InsturctionSelection::InstrSelect() {
-  for (auto &MFunc : MIRM->GetFunctions()) {
-    for (auto &MBB : MFunc.GetBasicBlocks())
-      for (size_t i = 0; i < MBB.GetInstructions().size(); i++)
-        // Skip selection if already selected
-        if (!MBB.GetInstructions()[i].IsAlreadySelected()) {
-          TM->SelectInstruction(&MBB.GetInstructions()[i]);
-          assert(MBB.GetInstructions()[i].IsAlreadySelected());
-        }
-  }
+  for (auto &MFunc : MIRM->GetFunctions())
+    RunOnFunction(MFunc);
+}
+
+void InsturctionSelection::RunOnFunction(MachineFunction &MFunc) {
+  TimeScope Scope("codegen", "InstructionSelection", MFunc.GetName());
+
+  for (auto &MBB : MFunc.GetBasicBlocks())
+    for (size_t i = 0; i < MBB.GetInstructions().size(); i++)
+      // Skip selection if already selected
+      if (!MBB.GetInstructions()[i].IsAlreadySelected()) {
+        TM->SelectInstruction(&MBB.GetInstructions()[i]);
+        assert(MBB.GetInstructions()[i].IsAlreadySelected());
+      }
 }
@@ -12,6 +12,7 @@ public:
       : MIRM(Input), TM(Target) {}
 
   void InstrSelect();
+  void RunOnFunction(MachineFunction &Func);
 
 private:
   MachineIRModule *MIRM;
@@ -3,6 +3,13 @@
 #include "MachineFunction.hpp"
 #include "MachineIRModule.hpp"
 #include "TargetMachine.hpp"
+#include "../support/Statistic.hpp"
+#include "../support/TimeProfiler.hpp"
+
+STATISTIC(NumRenamedOperands, "LLIROptimizer",
+          "Number of operands renamed to an already computed register");
+STATISTIC(NumDeadInstructions, "LLIROptimizer",
+          "Number of instructions removed");
 
 struct AliveDefinitions {
   std::vector<MachineInstruction *> Instructions;
@@ -48,8 +55,10 @@ static void RenameRegisters(std::map<uint64_t, uint64_t> &Renameables,
       auto Use = I.GetNthUse(i);
       const bool IsVirtualRegType =
           Use && (Use->IsVirtualReg() || (Use->IsMemory() && Use->IsVirtual()));
-      if (IsVirtualRegType && Renameables.count(Use->GetReg()))
+      if (IsVirtualRegType && Renameables.count(Use->GetReg())) {
         Use->SetReg(Renameables[Use->GetReg()]);
+        ++NumRenamedOperands;
+      }
     }
   }
 }
@@ -180,18 +189,25 @@ static void DeadCodeElimination(MachineBasicBlock &MBB) {
 
     // If the instruction result has no uses after it (note: iteration is bottom
     // up) then it's defined value is dead, mark it for termination.
-    if (UsedValues.count(Instructions[i].GetDef()->GetReg()) == 0)
+    if (UsedValues.count(Instructions[i].GetDef()->GetReg()) == 0) {
       Instructions.erase(Instructions.begin() + i);
+      ++NumDeadInstructions;
+    }
   }
 }
 
 void LLIROptimizer::Run() {
-  for (auto &MFunc : MIRM->GetFunctions()) {
-    for (auto &MBB : MFunc.GetBasicBlocks()) {
-      CopyPropagation(MBB);
-      DeadCodeElimination(MBB);
-      CSE(MBB);
-      DeadCodeElimination(MBB);
-    }
+  for (auto &MFunc : MIRM->GetFunctions())
+    RunOnFunction(MFunc);
+}
+
+void LLIROptimizer::RunOnFunction(MachineFunction &MFunc) {
+  TimeScope Scope("codegen", "LLIROptimizer", MFunc.GetName());
+
+  for (auto &MBB : MFunc.GetBasicBlocks()) {
+    CopyPropagation(MBB);
+    DeadCodeElimination(MBB);
+    CSE(MBB);
+    DeadCodeElimination(MBB);
   }
 }
@@ -1,6 +1,7 @@
 #ifndef LLIR_OPTIMIZER_HPP
 #define LLIR_OPTIMIZER_HPP
 
+class MachineFunction;
 class MachineIRModule;
 class TargetMachine;
 
@@ -10,6 +11,7 @@ public:
       : MIRM(Input), TM(Target) {}
 
   void Run();
+  void RunOnFunction(MachineFunction &Func);
 
 private:
   MachineIRModule *MIRM;
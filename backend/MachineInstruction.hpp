@@ -241,8 +241,8 @@ public:
     AddOperand(MachineOperand::CreateFunctionName(Name));
   }
 
-  void AddGlobalSymbol(std::string Symbol) {
-    AddOperand(MachineOperand::CreateGlobalSymbol(Symbol));
+  void AddGlobalSymbol(Symbol GS) {
+    AddOperand(MachineOperand::CreateGlobalSymbol(GS));
   }
 
   void AddAttribute(unsigned AttributeFlag) {
@@ -3,6 +3,7 @@
 
 #include "LowLevelType.hpp"
 #include "TargetRegister.hpp"
+#include "../support/Symbol.hpp"
 #include <cstdint>
 #include <iostream>
 
@@ -56,9 +57,9 @@ public:
 
   const char *GetLabel() { return Label; }
   const char *GetFunctionName() { return Label; }
-  std::string &GetGlobalSymbol() { return GlobalSymbol; }
+  Symbol GetGlobalSymbol() const { return GlobalSymbol; }
   void SetLabel(const char *L) { Label = L; }
-  void SetGlobalSymbol(const std::string &GS) { GlobalSymbol = GS; }
+  void SetGlobalSymbol(Symbol GS) { GlobalSymbol = GS; }
 
   bool IsVirtual() const { return Virtual; }
   void SetVirtual(bool v) { Virtual = v; }
@@ -149,10 +150,10 @@ public:
     return MO;
   }
 
-  static MachineOperand CreateGlobalSymbol(std::string &Symbol) {
+  static MachineOperand CreateGlobalSymbol(Symbol GS) {
     MachineOperand MO;
     MO.SetToGlobalSymbol();
-    MO.SetGlobalSymbol(Symbol);
+    MO.SetGlobalSymbol(GS);
     return MO;
   }
 
@@ -217,7 +218,7 @@ private:
   };
   int Offset = 0;
   LowLevelType LLT;
-  std::string GlobalSymbol;
+  Symbol GlobalSymbol;
   bool Virtual = false;
   unsigned RegisterClass = ~0;
 };
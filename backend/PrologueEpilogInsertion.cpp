@@ -4,11 +4,7 @@
 #include "MachineOperand.hpp"
 #include "Support.hpp"
 #include "TargetInstruction.hpp"
-
-/// TODO: Solve the stack issue: inserting physregs can collide with existing
-/// stack slot with the same ID
-static int NextStackSlot = 0;
-std::map<unsigned, unsigned> LocalPhysRegToStackSlotMap;
+#include "../support/TimeProfiler.hpp"
 
 MachineInstruction
 PrologueEpilogInsertion::CreateADDInstruction(int64_t StackAdjustmentSize) {
@@ -35,7 +31,7 @@ void PrologueEpilogInsertion::InsertLinkRegisterSave(MachineFunction &Func) {
 
   MachineInstruction STR(MachineInstruction::STORE, nullptr);
   auto LROffset = Func.GetStackObjectPosition(
-      LocalPhysRegToStackSlotMap[TM->GetRegInfo()->GetLinkRegister()]);
+      PhysRegToStackSlotMap[TM->GetRegInfo()->GetLinkRegister()]);
   LROffset = GetNextAlignedValue(LROffset, 16);
   auto SPReg = TM->GetRegInfo()->GetStackRegister();
   auto Dest = TM->GetRegInfo()->GetLinkRegister();
@@ -58,7 +54,7 @@ void PrologueEpilogInsertion::InsertLinkRegisterReload(MachineFunction &Func) {
 
   MachineInstruction LOAD(MachineInstruction::LOAD, nullptr);
   auto LROffset = Func.GetStackObjectPosition(
-      LocalPhysRegToStackSlotMap[TM->GetRegInfo()->GetLinkRegister()]);
+      PhysRegToStackSlotMap[TM->GetRegInfo()->GetLinkRegister()]);
   LROffset = GetNextAlignedValue(LROffset, 16);
   auto SPReg = TM->GetRegInfo()->GetStackRegister();
   auto Dest = TM->GetRegInfo()->GetLinkRegister();
@@ -105,8 +101,8 @@ MachineInstruction PrologueEpilogInsertion::CreateSTORE(MachineFunction &Func,
                                                         unsigned Register) {
   MachineInstruction STR(MachineInstruction::STORE, nullptr);
   auto StackID = Register;
-  if (LocalPhysRegToStackSlotMap.count(Register) > 0)
-    StackID = LocalPhysRegToStackSlotMap[Register];
+  if (PhysRegToStackSlotMap.count(Register) > 0)
+    StackID = PhysRegToStackSlotMap[Register];
   auto Offset = Func.GetStackObjectPosition(StackID);
   Offset = GetNextAlignedValue(Offset, TM->GetPointerSize() / 8);
   auto SPReg = TM->GetRegInfo()->GetStackRegister();
@@ -125,8 +121,8 @@ MachineInstruction PrologueEpilogInsertion::CreateLOAD(MachineFunction &Func,
                                                         unsigned Register) {
   MachineInstruction LOAD(MachineInstruction::LOAD, nullptr);
   auto StackID = Register;
-  if (LocalPhysRegToStackSlotMap.count(Register) > 0)
-    StackID = LocalPhysRegToStackSlotMap[Register];
+  if (PhysRegToStackSlotMap.count(Register) > 0)
+    StackID = PhysRegToStackSlotMap[Register];
   auto Offset = Func.GetStackObjectPosition(StackID);
   Offset = GetNextAlignedValue(Offset, TM->GetPointerSize() / 8);
   auto SPReg = TM->GetRegInfo()->GetStackRegister();
@@ -166,47 +162,54 @@ void PrologueEpilogInsertion::ReloadClobberedCalleeSavedRegisters(
 }
 
 void PrologueEpilogInsertion::Run() {
-  for (auto &Func : MIRM->GetFunctions()) {
-    // if there is no stack frame then do not emit adjustments
-    if (Func.GetStackFrameSize() == 0 && Func.GetUsedCalleSavedRegs().empty())
-      continue;
-
-    // reset state before processing a new function
-    LocalPhysRegToStackSlotMap.clear();
-    MBBWithRetIdx = ~0;
-    NextStackSlot = 10000;
-
-    for (auto CalleSavedReg : Func.GetUsedCalleSavedRegs()) {
-      Func.GetStackFrame().InsertStackSlot(NextStackSlot,
-                                           TM->GetPointerSize() / 8,
-                                           TM->GetPointerSize() / 8);
-      LocalPhysRegToStackSlotMap[CalleSavedReg] = NextStackSlot++;
-    }
-
-    if (Func.IsCaller()) {
-      Func.GetStackFrame().InsertStackSlot(NextStackSlot, TM->GetPointerSize() / 8, 16);
-      LocalPhysRegToStackSlotMap[TM->GetRegInfo()->GetLinkRegister()] = NextStackSlot++;
-    }
-
-    // find where the ret is
-    for (size_t i = 0; i < Func.GetBasicBlocks().size(); i++) {
-      for (auto &MI : Func.GetBasicBlocks()[i].GetInstructions())
-        if (TM->GetInstrDefs()->GetTargetInstr(MI.GetOpcode())->IsReturn()) {
-          MBBWithRetIdx = i;
-          break;
-        }
-      // break out from the outer loop aswell
-      if (MBBWithRetIdx != ~0u)
-        break;
-    }
+  for (auto &Func : MIRM->GetFunctions())
+    RunOnFunction(Func);
+}
+
+void PrologueEpilogInsertion::RunOnFunction(MachineFunction &Func) {
+  TimeScope Scope("codegen", "PrologueEpilogInsertion", Func.GetName());
+
+  // if there is no stack frame then do not emit adjustments
+  if (Func.GetStackFrameSize() == 0 && Func.GetUsedCalleSavedRegs().empty())
+    return;
+
+  // reset state before processing a new function
+  PhysRegToStackSlotMap.clear();
+  MBBWithRetIdx = ~0;
+  NextStackSlot = 10000;
 
-    assert(MBBWithRetIdx != ~0u && "Have not found a return instruction");
+  for (auto CalleSavedReg : Func.GetUsedCalleSavedRegs()) {
+    Func.GetStackFrame().InsertStackSlot(NextStackSlot,
+                                         TM->GetPointerSize() / 8,
+                                         TM->GetPointerSize() / 8);
+    PhysRegToStackSlotMap[CalleSavedReg] = NextStackSlot++;
+  }
+
+  if (Func.IsCaller()) {
+    Func.GetStackFrame().InsertStackSlot(NextStackSlot,
+                                         TM->GetPointerSize() / 8, 16);
+    PhysRegToStackSlotMap[TM->GetRegInfo()->GetLinkRegister()] =
+        NextStackSlot++;
+  }
 
-    InsertStackAdjustmentUpward(Func);
-    InsertLinkRegisterSave(Func);
-    SpillClobberedCalleeSavedRegisters(Func);
-    ReloadClobberedCalleeSavedRegisters(Func);
-    InsertLinkRegisterReload(Func);
-    InsertStackAdjustmentDownward(Func);
+  // find where the ret is
+  for (size_t i = 0; i < Func.GetBasicBlocks().size(); i++) {
+    for (auto &MI : Func.GetBasicBlocks()[i].GetInstructions())
+      if (TM->GetInstrDefs()->GetTargetInstr(MI.GetOpcode())->IsReturn()) {
+        MBBWithRetIdx = i;
+        break;
+      }
+    // break out from the outer loop aswell
+    if (MBBWithRetIdx != ~0u)
+      break;
   }
-}
\ No newline at end of file
+
+  assert(MBBWithRetIdx != ~0u && "Have not found a return instruction");
+
+  InsertStackAdjustmentUpward(Func);
+  InsertLinkRegisterSave(Func);
+  SpillClobberedCalleeSavedRegisters(Func);
+  ReloadClobberedCalleeSavedRegisters(Func);
+  InsertLinkRegisterReload(Func);
+  InsertStackAdjustmentDownward(Func);
+}
@@ -3,6 +3,7 @@
 
 #include "MachineIRModule.hpp"
 #include "TargetMachine.hpp"
+#include <map>
 
 class PrologueEpilogInsertion {
 public:
@@ -10,6 +11,7 @@ public:
       : MIRM(Module), TM(TM) {}
 
   void Run();
+  void RunOnFunction(MachineFunction &Func);
 
   MachineInstruction CreateADDInstruction(int64_t StackAdjustmentSize);
 
@@ -30,6 +32,14 @@ private:
 
   /// The index of the Machine Basic Block, which contains a return instruction.
   unsigned MBBWithRetIdx = ~0;
+
+  /// The stack slots where the callee saved registers and the link register
+  /// are saved in the currently processed function.
+  std::map<unsigned, unsigned> PhysRegToStackSlotMap;
+
+  /// TODO: Solve the stack issue: inserting physregs can collide with existing
+  /// stack slot with the same ID
+  unsigned NextStackSlot = 0;
 };
 
 #endif
\ No newline at end of file
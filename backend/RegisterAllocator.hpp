@@ -10,6 +10,7 @@ public:
       : MIRM(Module), TM(TM) {}
 
   void RunRA();
+  void RunOnFunction(MachineFunction &Func);
 
 private:
   MachineIRModule *MIRM;
@@ -10,6 +10,7 @@ public:
       : MIRM(Input), TM(Target) {}
 
   void Run();
+  void RunOnFunction(MachineFunction &Func);
 
 private:
   MachineIRModule *MIRM;
@@ -3,10 +3,14 @@
 #include "../../MachineBasicBlock.hpp"
 #include "../../MachineFunction.hpp"
 #include "../../TargetMachine.hpp"
+#include "../../../support/Statistic.hpp"
 #include <cassert>
 
 using namespace AArch64;
 
+STATISTIC(NumMaterializedImmediates, "Legalizer",
+          "Number of immediate operands loaded into a register");
+
 // Modulo operation is not legal on ARM, has to be expanded
 bool AArch64InstructionLegalizer::Check(MachineInstruction *MI) {
   switch (MI->GetOpcode()) {
@@ -140,6 +144,7 @@ bool AArch64InstructionLegalizer::ExpandSTORE(MachineInstruction *MI) {
   LOAD_IMM.AddOperand(LOAD_IMMResultVReg);
   LOAD_IMM.AddOperand(Immediate);
   ParentBB->InsertBefore(std::move(LOAD_IMM), MI);
+  ++NumMaterializedImmediates;
 
   return true;
 }
@@ -191,7 +196,8 @@ bool AArch64InstructionLegalizer::ExpandGLOBAL_ADDRESS(MachineInstruction *MI) {
 
   auto GlobalVar = *MI->GetOperand(1);
   assert(GlobalVar.IsGlobalSymbol() && "Operand #2 must be a symbol");
-  auto GlobalVarName = ":lo12:" + GlobalVar.GetGlobalSymbol();
+  auto GlobalVarName =
+      Symbol::Intern(":lo12:" + GlobalVar.GetGlobalSymbol().ToString());
 
   MI->SetOpcode(ADRP);
 
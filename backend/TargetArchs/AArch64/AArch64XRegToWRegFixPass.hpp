@@ -13,6 +13,7 @@ public:
       : MIRM(Module), TM(TM) {}
 
   void Run();
+  void RunOnFunction(MachineFunction &Func);
 
 private:
   MachineIRModule *MIRM;
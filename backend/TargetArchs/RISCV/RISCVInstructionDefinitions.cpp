@@ -124,8 +124,10 @@ RISCVInstructionDefinitions::IRToTargetInstrMap
 
 TargetInstruction *
 RISCVInstructionDefinitions::GetTargetInstr(unsigned Opcode) {
-  if (0 == Instructions.count(Opcode))
+  // The table is shared by every thread, so it must not be modified here
+  auto It = Instructions.find(Opcode);
+  if (It == Instructions.end())
     return nullptr;
 
-  return &Instructions[Opcode];
+  return &It->second;
 }
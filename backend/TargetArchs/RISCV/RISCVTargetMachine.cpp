@@ -427,7 +427,8 @@ bool RISCVTargetMachine::SelectGLOBAL_ADDRESS(MachineInstruction *MI) {
 
   auto GlobalVar = *MI->GetOperand(1);
   assert(GlobalVar.IsGlobalSymbol() && "Operand #2 must be a symbol");
-  auto GlobalVarHi = "%hi(" + GlobalVar.GetGlobalSymbol() + ")";
+  auto GlobalVarHi =
+      Symbol::Intern("%hi(" + GlobalVar.GetGlobalSymbol().ToString() + ")");
 
   MI->SetOpcode(LUI);
   MI->ReplaceOperand(MachineOperand::CreateGlobalSymbol(GlobalVarHi), 1);
@@ -437,7 +438,8 @@ bool RISCVTargetMachine::SelectGLOBAL_ADDRESS(MachineInstruction *MI) {
   auto DestReg = *MI->GetOperand(0);
   addi.AddOperand(DestReg);
   addi.AddOperand(DestReg);
-  auto GlobalVarLo = "%lo(" + GlobalVar.GetGlobalSymbol() + ")";
+  auto GlobalVarLo =
+      Symbol::Intern("%lo(" + GlobalVar.GetGlobalSymbol().ToString() + ")");
   addi.AddGlobalSymbol(GlobalVarLo);
   ParentBB->InsertAfter(std::move(addi), MI);
 
@@ -3,8 +3,12 @@
 #include "MachineFunction.hpp"
 #include "MachineInstruction.hpp"
 #include "TargetMachine.hpp"
+#include "../support/Statistic.hpp"
 #include <cassert>
 
+STATISTIC(NumMaterializedImmediates, "Legalizer",
+          "Number of immediate operands loaded into a register");
+
 /// Materialize @MI instruction @Index-th operand - which must be an immediate -
 /// into a virtual register by issuing a LOAD_IMM
 static bool MaterializeImmOperand(MachineInstruction *MI, const size_t Index) {
@@ -24,6 +28,7 @@ static bool MaterializeImmOperand(MachineInstruction *MI, const size_t Index) {
 
   // insert after modifying MI, otherwise MI would became invalid
   ParentBB->InsertBefore(std::move(LI), MI);
+  ++NumMaterializedImmediates;
 
   return true;
 }
@@ -700,6 +705,7 @@ bool TargetInstructionLegalizer::ExpandCMP(MachineInstruction *MI) {
         MI = &*ParentBB->InsertBefore(std::move(LI), MI);
         src2 = dst;
         MI++;
+        ++NumMaterializedImmediates;
       }
     }
 
@@ -772,6 +778,7 @@ bool TargetInstructionLegalizer::ExpandCMP(MachineInstruction *MI) {
         MI = &*ParentBB->InsertBefore(std::move(LI), MI);
         src2 = dst;
         MI++;
+        ++NumMaterializedImmediates;
       }
     }
 
@@ -952,6 +959,7 @@ bool TargetInstructionLegalizer::ExpandSTORE(MachineInstruction *MI) {
     LI.AddOperand(LOAD_IMMResultVReg);
     LI.AddOperand(Src);
     ParentBB->InsertBefore(std::move(LI), MI);
+    ++NumMaterializedImmediates;
 
     return true;
   }
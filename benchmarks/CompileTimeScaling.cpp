@@ -0,0 +1,376 @@
+// Measures how the compile time and the memory usage of miniCC grow with the
+// size of its input. Synthetic programs are generated while one parameter of
+// them grows geometrically and the others are fixed, each one is compiled by
+// miniCC with -ftime-trace, then the time of each phase, the wall clock time
+// and the peak memory usage are reported. The growth column is the exponent
+// of the time as the function of the parameter between two steps, so 1 is
+// linear and 2 is quadratic.
+//
+// Usage: scaling-benchmark [options] [-- compiler flags...]
+//   -compiler=<path>     the compiler, by default miniCC next to this program
+//   -sweep=<params>      comma separated list of the parameters to grow, or
+//                        "all" (default): functions, statements, nesting,
+//                        locals, switch-cases, global-array, macros
+//   -steps=N             number of sizes of each parameter (default 5)
+//   -factor=N            growth of the parameter between the steps (default 2)
+//   -<param>=N           the value of the parameter when it is not grown, and
+//                        its first value when it is
+//   -output=<file>       write the results into a JSON file as well
+//   -generate            print the program of the given parameters and exit
+
+#include "SourceGenerator.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/// The phases reported by -ftime-trace in pipeline order, with their column
+/// titles.
+static const std::vector<std::pair<std::string, std::string>> Phases = {
+    {"PreProcessor", "PP"},
+    {"Parser", "Parse"},
+    {"Semantics", "Sema"},
+    {"IRCodegen", "IRGen"},
+    {"IROptimizer", "IROpt"},
+    {"IRtoLLIR", "ToLLIR"},
+    {"LLIROptimizer", "LLOpt"},
+    {"Legalizer", "Legal"},
+    {"RegisterClassSelection", "RCS"},
+    {"InstructionSelection", "ISel"},
+    {"RegisterAllocator", "RA"},
+    {"PrologueEpilogInsertion", "PEI"},
+    {"XRegToWRegFix", "XToW"},
+    {"AssemblyEmitter", "Emit"},
+};
+
+/// A parameter of the generator, which can be grown.
+struct Parameter {
+  const char *Name;
+  unsigned GeneratorOptions::*Field;
+  /// The first value of the sweep if the parameter is 0 by default.
+  unsigned DefaultStart;
+};
+
+static const std::vector<Parameter> Parameters = {
+    {"functions", &GeneratorOptions::Functions, 8},
+    {"statements", &GeneratorOptions::Statements, 16},
+    {"nesting", &GeneratorOptions::NestingDepth, 4},
+    {"locals", &GeneratorOptions::Locals, 8},
+    {"switch-cases", &GeneratorOptions::SwitchCases, 16},
+    {"global-array", &GeneratorOptions::GlobalArraySize, 256},
+    {"macros", &GeneratorOptions::Macros, 16},
+};
+
+struct Measurement {
+  unsigned Value = 0;
+  size_t SourceSize = 0;
+  double WallMs = 0;
+  long PeakRSSKB = 0;
+  /// The summed time of each phase in milliseconds.
+  std::map<std::string, double> PhaseMs;
+};
+
+/// Sum the durations of the phase events of the trace at @TracePath. The
+/// trace is written by miniCC with one event per line, so it is enough to
+/// look for the fields of the events.
+static std::map<std::string, double> ReadPhaseTimes(const fs::path &TracePath) {
+  std::map<std::string, double> Result;
+  std::ifstream Trace(TracePath);
+
+  auto GetField = [](const std::string &Line, const std::string &Key) {
+    const auto Start = Line.find("\"" + Key + "\":");
+    if (Start == std::string::npos)
+      return std::string();
+    auto Pos = Start + Key.size() + 3;
+    if (Line[Pos] == '"')
+      return Line.substr(Pos + 1, Line.find('"', Pos + 1) - Pos - 1);
+    return Line.substr(Pos, Line.find_first_of(",}", Pos) - Pos);
+  };
+
+  for (std::string Line; std::getline(Trace, Line);) {
+    const auto Category = GetField(Line, "cat");
+    if (Category != "frontend" && Category != "codegen")
+      continue;
+    Result[GetField(Line, "name")] +=
+        std::strtod(GetField(Line, "dur").c_str(), nullptr) / 1000.0;
+  }
+
+  return Result;
+}
+
+/// Compile @InputPath with @Compiler and fill the times and the peak memory
+/// usage of @M. Return false if the compilation failed.
+static bool Measure(const std::string &Compiler,
+                    const std::vector<std::string> &Flags,
+                    const fs::path &InputPath, const fs::path &WorkDir,
+                    Measurement &M) {
+  const auto TracePath = WorkDir / "trace.json";
+  const auto ErrorPath = WorkDir / "errors.txt";
+
+  std::vector<std::string> Args = {Compiler,
+                                   "-ftime-trace=" + TracePath.string()};
+  Args.insert(Args.end(), Flags.begin(), Flags.end());
+  Args.push_back(InputPath.string());
+
+  const auto Start = std::chrono::steady_clock::now();
+
+  pid_t PID = fork();
+  if (PID < 0)
+    return false;
+
+  if (PID == 0) {
+    // The assembly is not needed, the errors are kept for the report
+    int Null = open("/dev/null", O_WRONLY);
+    int Errors = open(ErrorPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    dup2(Null, STDOUT_FILENO);
+    dup2(Errors, STDERR_FILENO);
+
+    std::vector<char *> Argv;
+    for (auto &Arg : Args)
+      Argv.push_back(Arg.data());
+    Argv.push_back(nullptr);
+
+    execv(Argv[0], Argv.data());
+    _exit(127);
+  }
+
+  int Status;
+  rusage Usage;
+  if (wait4(PID, &Status, 0, &Usage) != PID)
+    return false;
+
+  M.WallMs = std::chrono::duration<double, std::milli>(
+                 std::chrono::steady_clock::now() - Start)
+                 .count();
+  M.PeakRSSKB = Usage.ru_maxrss;
+
+  if (!WIFEXITED(Status) || WEXITSTATUS(Status) != 0) {
+    std::ifstream Errors(ErrorPath);
+    std::cerr << "Error: The compilation of '" << InputPath.string()
+              << "' failed:" << std::endl
+              << Errors.rdbuf() << std::endl;
+    return false;
+  }
+
+  M.PhaseMs = ReadPhaseTimes(TracePath);
+  return true;
+}
+
+/// Return the growth exponent of @To over @From, based on @Get.
+template <typename GetT>
+static double GetGrowth(const Measurement &From, const Measurement &To,
+                        GetT Get) {
+  const double Base = Get(From), Current = Get(To);
+  if (Base <= 0 || Current <= 0)
+    return 0;
+  return std::log(Current / Base) / std::log(double(To.Value) / From.Value);
+}
+
+static void PrintTable(const Parameter &Param,
+                       const std::vector<Measurement> &Results) {
+  std::cout << std::endl << "Growing " << Param.Name << ":" << std::endl;
+
+  std::cout << std::setw(12) << Param.Name << std::setw(10) << "Bytes"
+            << std::setw(10) << "Wall ms" << std::setw(9) << "RSS MB"
+            << std::setw(8) << "Growth";
+  for (auto &[Phase, Title] : Phases)
+    std::cout << std::setw(8) << Title;
+  std::cout << "  Fastest growing phase" << std::endl;
+
+  for (size_t i = 0; i < Results.size(); i++) {
+    auto &M = Results[i];
+    std::cout << std::fixed << std::setprecision(1) << std::setw(12) << M.Value
+              << std::setw(10) << M.SourceSize << std::setw(10) << M.WallMs
+              << std::setw(9) << M.PeakRSSKB / 1024.0;
+
+    if (i == 0)
+      std::cout << std::setw(8) << "-";
+    else
+      std::cout << std::setw(8) << std::setprecision(2)
+                << GetGrowth(Results[i - 1], M, [](const Measurement &X) {
+                     return X.WallMs;
+                   });
+
+    std::cout << std::setprecision(1);
+    for (auto &[Phase, Title] : Phases) {
+      auto It = M.PhaseMs.find(Phase);
+      std::cout << std::setw(8) << (It != M.PhaseMs.end() ? It->second : 0.0);
+    }
+
+    // The phases taking less than a millisecond are too noisy to tell
+    if (i > 0) {
+      std::string WorstPhase;
+      double WorstGrowth = 0;
+      for (auto &[Phase, Ms] : M.PhaseMs) {
+        if (Ms < 1.0)
+          continue;
+        auto Growth = GetGrowth(Results[i - 1], M, [&](const Measurement &X) {
+          auto It = X.PhaseMs.find(Phase);
+          return It != X.PhaseMs.end() ? It->second : 0.0;
+        });
+        if (Growth > WorstGrowth) {
+          WorstGrowth = Growth;
+          WorstPhase = Phase;
+        }
+      }
+      if (!WorstPhase.empty())
+        std::cout << "  " << WorstPhase << " (" << std::setprecision(2)
+                  << WorstGrowth << ")";
+    }
+    std::cout << std::endl;
+  }
+}
+
+static void WriteJSON(std::ostream &OS,
+                      const std::vector<std::pair<const Parameter *,
+                                                  std::vector<Measurement>>>
+                          &Sweeps) {
+  OS << "{" << std::endl;
+  for (size_t s = 0; s < Sweeps.size(); s++) {
+    auto &[Param, Results] = Sweeps[s];
+    OS << "  \"" << Param->Name << "\": [" << std::endl;
+    for (size_t i = 0; i < Results.size(); i++) {
+      auto &M = Results[i];
+      OS << "    {\"value\": " << M.Value << ", \"bytes\": " << M.SourceSize
+         << ", \"wall_ms\": " << M.WallMs << ", \"peak_rss_kb\": "
+         << M.PeakRSSKB << ", \"phases_ms\": {";
+      bool First = true;
+      for (auto &[Phase, Ms] : M.PhaseMs) {
+        OS << (First ? "" : ", ") << "\"" << Phase << "\": " << Ms;
+        First = false;
+      }
+      OS << "}}" << (i + 1 < Results.size() ? "," : "") << std::endl;
+    }
+    OS << "  ]" << (s + 1 < Sweeps.size() ? "," : "") << std::endl;
+  }
+  OS << "}" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  GeneratorOptions Base;
+  std::vector<const Parameter *> Sweep;
+  std::vector<std::string> CompilerFlags;
+  std::string Compiler =
+      (fs::read_symlink("/proc/self/exe").parent_path() / "miniCC").string();
+  std::string OutputPath;
+  unsigned Steps = 5;
+  unsigned Factor = 2;
+  bool Generate = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string Arg = argv[i];
+    const auto Eq = Arg.find('=');
+    const auto Name = Arg.substr(1, Eq == std::string::npos ? Eq : Eq - 1);
+    const auto Value = Eq == std::string::npos ? "" : Arg.substr(Eq + 1);
+
+    if (Arg == "--") {
+      CompilerFlags.assign(argv + i + 1, argv + argc);
+      break;
+    } else if (Arg == "-generate") {
+      Generate = true;
+    } else if (Name == "compiler") {
+      Compiler = Value;
+    } else if (Name == "output") {
+      OutputPath = Value;
+    } else if (Name == "steps") {
+      Steps = std::max(std::atoi(Value.c_str()), 1);
+    } else if (Name == "factor") {
+      Factor = std::max(std::atoi(Value.c_str()), 2);
+    } else if (Name == "sweep") {
+      std::stringstream List(Value);
+      for (std::string Item; std::getline(List, Item, ',');) {
+        bool Found = false;
+        for (auto &Param : Parameters)
+          if (Item == "all" || Item == Param.Name) {
+            Sweep.push_back(&Param);
+            Found = true;
+          }
+        if (!Found) {
+          std::cerr << "Error: Unknown parameter '" << Item << "'"
+                    << std::endl;
+          return 1;
+        }
+      }
+    } else {
+      bool Found = false;
+      for (auto &Param : Parameters)
+        if (Name == Param.Name && !Value.empty()) {
+          Base.*Param.Field = std::atoi(Value.c_str());
+          Found = true;
+        }
+      if (!Found) {
+        std::cerr << "Error: Unknown argument '" << Arg << "'" << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  if (Generate) {
+    std::cout << GenerateSource(Base);
+    return 0;
+  }
+
+  if (Sweep.empty())
+    for (auto &Param : Parameters)
+      Sweep.push_back(&Param);
+
+  const auto WorkDir =
+      fs::temp_directory_path() / ("scaling-benchmark-" +
+                                   std::to_string(getpid()));
+  fs::create_directories(WorkDir);
+  const auto InputPath = WorkDir / "input.c";
+
+  std::cout << "Compiler: " << Compiler;
+  for (auto &Flag : CompilerFlags)
+    std::cout << " " << Flag;
+  std::cout << std::endl;
+
+  int Result = 0;
+  std::vector<std::pair<const Parameter *, std::vector<Measurement>>> Sweeps;
+  for (auto Param : Sweep) {
+    auto Opts = Base;
+    auto &Value = Opts.*Param->Field;
+    if (Value == 0)
+      Value = Param->DefaultStart;
+
+    std::vector<Measurement> Results;
+    for (unsigned Step = 0; Step < Steps; Step++, Value *= Factor) {
+      const auto Source = GenerateSource(Opts);
+      std::ofstream(InputPath) << Source;
+
+      Measurement M;
+      M.Value = Value;
+      M.SourceSize = Source.size();
+      if (!Measure(Compiler, CompilerFlags, InputPath, WorkDir, M)) {
+        Result = 1;
+        break;
+      }
+      Results.push_back(std::move(M));
+    }
+
+    PrintTable(*Param, Results);
+    Sweeps.emplace_back(Param, std::move(Results));
+  }
+
+  if (!OutputPath.empty()) {
+    std::ofstream OS(OutputPath);
+    WriteJSON(OS, Sweeps);
+  }
+
+  fs::remove_all(WorkDir);
+  return Result;
+}
@@ -0,0 +1,128 @@
+// Measures the throughput of the lexer in MB/s with every character scanning
+// implementation supported by the CPU.
+//
+// Usage: lexer-benchmark [-iterations=N] [-size=MB] [files...]
+//
+// Without input files a synthetic source of the given size is lexed. The input
+// files should be already preprocessed, since the lexer stops at the first
+// directive.
+
+#include "../frontend/SourceManager.hpp"
+#include "../frontend/lexer/CharScanner.hpp"
+#include "../frontend/lexer/Lexer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/// Create a C source of at least @Size bytes, which has a mix of the typical
+/// tokens, comments and whitespaces.
+static std::string GenerateSource(size_t Size) {
+  std::string Source;
+  Source.reserve(Size + 1024);
+
+  for (unsigned i = 0; Source.size() < Size; i++) {
+    auto Id = std::to_string(i);
+    Source += "/* Compute the sum of the elements of the array, multiplied by\n"
+              " * the given factor. */\n"
+              "unsigned long long accumulate_elements_" + Id +
+              "(const int *input_array, unsigned element_count, int factor) {\n"
+              "  unsigned long long running_total = 0x" + Id + ";\n"
+              "  // iterate over the elements\n"
+              "  for (unsigned index = 0; index < element_count; index++) {\n"
+              "    running_total += input_array[index] * factor + 42;\n"
+              "    if (running_total > 1000000 && factor != 'x')\n"
+              "      printf(\"overflow at %u in \\\"accumulate\\\"\\n\", index);\n"
+              "  }\n"
+              "\n"
+              "  return running_total;\n"
+              "}\n\n";
+  }
+
+  return Source;
+}
+
+/// Lex the whole @Buffer and return the number of tokens. The lexer does not
+/// advance on invalid tokens, so lexing stops at them.
+static size_t LexBuffer(const SourceBuffer &Buffer) {
+  Lexer L(Buffer);
+  size_t TokenCount = 0;
+
+  for (auto Kind = L.Lex().GetKind();
+       Kind != Token::EndOfFile && Kind != Token::Invalid;
+       Kind = L.Lex().GetKind())
+    TokenCount++;
+
+  return TokenCount;
+}
+
+int main(int argc, char *argv[]) {
+  unsigned Iterations = 10;
+  size_t SizeInMB = 16;
+  std::vector<std::string> Files;
+
+  for (int i = 1; i < argc; i++) {
+    std::string Arg(argv[i]);
+
+    if (Arg.rfind("-iterations=", 0) == 0)
+      Iterations = std::stoul(Arg.substr(12));
+    else if (Arg.rfind("-size=", 0) == 0)
+      SizeInMB = std::stoul(Arg.substr(6));
+    else
+      Files.push_back(Arg);
+  }
+
+  SourceManager SM;
+  std::vector<const SourceBuffer *> Inputs;
+
+  if (Files.empty())
+    Inputs.push_back(
+        SM.CreateBuffer("<synthetic>", GenerateSource(SizeInMB << 20)));
+
+  for (auto &File : Files) {
+    auto Buffer = SM.GetFileBuffer(File);
+    if (!Buffer) {
+      std::cerr << "Error: Unable to open file '" << File << "'" << std::endl;
+      return 1;
+    }
+    Inputs.push_back(Buffer);
+  }
+
+  size_t TotalBytes = 0;
+  for (auto Input : Inputs)
+    TotalBytes += Input->GetSize();
+
+  size_t ExpectedTokenCount = 0;
+
+  for (auto Kind : {CharScanner::Scalar, CharScanner::SSE2, CharScanner::AVX2}) {
+    if (!CharScanner::SetImplementation(Kind))
+      continue;
+
+    size_t TokenCount = 0;
+    auto Start = std::chrono::steady_clock::now();
+
+    for (unsigned i = 0; i < Iterations; i++)
+      for (auto Input : Inputs)
+        TokenCount += LexBuffer(*Input);
+
+    std::chrono::duration<double> Elapsed =
+        std::chrono::steady_clock::now() - Start;
+
+    // every implementation must give the same result
+    if (ExpectedTokenCount == 0)
+      ExpectedTokenCount = TokenCount;
+    else if (ExpectedTokenCount != TokenCount) {
+      std::cerr << "Error: token count mismatch with "
+                << CharScanner::ToString(Kind) << std::endl;
+      return 1;
+    }
+
+    const double MegaBytes = double(TotalBytes) * Iterations / (1 << 20);
+    std::printf("%-8s %10.2f MB/s  (%zu tokens, %.3f s)\n",
+                CharScanner::ToString(Kind), MegaBytes / Elapsed.count(),
+                TokenCount / Iterations, Elapsed.count());
+  }
+
+  return 0;
+}
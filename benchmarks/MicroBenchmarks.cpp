@@ -0,0 +1,673 @@
+// Microbenchmarks of the components of the compiler in isolation: the lexer,
+// the parser, the implemented IR passes, the register allocator and the
+// assembly emitter.
+// Every benchmark runs on a fixed corpus, the files of tests/algorithms and a
+// few generated programs. The inputs are prepared up to the measured component
+// outside of the measurement, then only the component itself is timed.
+//
+// The results are given per unit of work: per token for the lexer and the
+// parser and per instruction for the rest, both as time and as the number of
+// heap allocations. They can be saved as a baseline and later runs can be
+// compared to it, failing if any of them got slower than a threshold.
+//
+// Usage: miniCC-bench [options] [files...]
+//   -corpus=<dir>          the directory of the C inputs, by default the
+//                          tests/algorithms of the source tree
+//   -no-generated          skip the generated inputs
+//   -filter=<text>         only run the benchmarks whose name contains it
+//   -min-time=<seconds>    the minimal measured time of a benchmark on an
+//                          input (default 0.1)
+//   -save-baseline=<file>  save the results as a JSON baseline
+//   -compare=<file>        compare the results to the baseline and fail if
+//                          any got worse than the threshold
+//   -threshold=<percent>   the allowed regression (default 10)
+//   -verbose               print the results of each input as well
+//
+// The system headers are looked up in the include directory of the source
+// tree the benchmark was built from (MINICC_SOURCE_DIR), so it can be run from
+// any directory, but that tree must still be there.
+
+#include "../backend/AssemblyEmitter.hpp"
+#include "../backend/IRtoLLIR.hpp"
+#include "../backend/InsturctionSelection.hpp"
+#include "../backend/MachineInstructionLegalizer.hpp"
+#include "../backend/PrologueEpilogInsertion.hpp"
+#include "../backend/RegisterAllocator.hpp"
+#include "../backend/RegisterClassSelection.hpp"
+#include "../backend/TargetArchs/AArch64/AArch64TargetMachine.hpp"
+#include "../backend/TargetArchs/AArch64/AArch64XRegToWRegFixPass.hpp"
+#include "../frontend/ErrorLogger.hpp"
+#include "../frontend/SourceManager.hpp"
+#include "../frontend/ast/Semantics.hpp"
+#include "../frontend/lexer/Lexer.hpp"
+#include "../frontend/parser/Parser.hpp"
+#include "../frontend/preprocessor/PreProcessor.hpp"
+#include "../middle_end/IR/IRFactory.hpp"
+#include "../middle_end/Transforms/PassManager.hpp"
+#include "SourceGenerator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+//===----------------------------------------------------------------------===//
+// Allocation counting
+//===----------------------------------------------------------------------===//
+
+/// The number of heap allocations since the start of the program. The
+/// benchmarks run on a single thread, so it needs no synchronization.
+static size_t NumAllocations = 0;
+
+void *operator new(size_t Size) {
+  NumAllocations++;
+  if (void *Ptr = std::malloc(Size ? Size : 1))
+    return Ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t Size) { return operator new(Size); }
+
+void *operator new(size_t Size, const std::nothrow_t &) noexcept {
+  NumAllocations++;
+  return std::malloc(Size ? Size : 1);
+}
+
+void *operator new[](size_t Size, const std::nothrow_t &Tag) noexcept {
+  return operator new(Size, Tag);
+}
+
+void *operator new(size_t Size, std::align_val_t Align) {
+  NumAllocations++;
+  const auto Alignment = static_cast<size_t>(Align);
+  // aligned_alloc needs the size to be a multiple of the alignment
+  if (void *Ptr = std::aligned_alloc(
+          Alignment, (std::max<size_t>(Size, 1) + Alignment - 1) /
+                         Alignment * Alignment))
+    return Ptr;
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t Size, std::align_val_t Align) {
+  return operator new(Size, Align);
+}
+
+void operator delete(void *Ptr) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr) noexcept { std::free(Ptr); }
+void operator delete(void *Ptr, size_t) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr, size_t) noexcept { std::free(Ptr); }
+void operator delete(void *Ptr, std::align_val_t) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
+void operator delete(void *Ptr, size_t, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
+void operator delete[](void *Ptr, size_t, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
+
+//===----------------------------------------------------------------------===//
+// Inputs
+//===----------------------------------------------------------------------===//
+
+/// A preprocessed input of the corpus.
+struct Input {
+  std::string Name;
+  std::string Source;
+};
+
+/// The generated inputs, a typical and a large one.
+static std::vector<std::pair<std::string, GeneratorOptions>>
+GetGeneratedInputs() {
+  GeneratorOptions Large;
+  Large.Functions = 32;
+  Large.Statements = 48;
+  Large.Locals = 16;
+  Large.SwitchCases = 16;
+  Large.GlobalArraySize = 256;
+  Large.Macros = 16;
+
+  return {{"<generated>", GeneratorOptions()}, {"<generated-large>", Large}};
+}
+
+/// Preprocess the file at @Path into @Result. Return false if it cannot be
+/// opened.
+static bool Preprocess(const std::string &Path, Input &Result) {
+  SourceManager SM;
+  PreProcessor PP(SM, Path);
+  PP.SetSystemIncludeDir(std::string(MINICC_SOURCE_DIR) + "/include");
+  auto Source = PP.Run();
+  if (!Source)
+    return false;
+
+  Result.Name = fs::path(Path).filename().string();
+  Result.Source = std::string(Source->GetBuffer());
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Pipeline
+//===----------------------------------------------------------------------===//
+
+/// The state of compiling an input, constructed up to the IR. The members
+/// refer to each other, so it cannot be moved.
+class Compilation {
+public:
+  Compilation(const Input &In, TargetMachine *TM)
+      : Source(SM.CreateBuffer(In.Name, In.Source)), IRF(IRModule, TM),
+        ErrorLog(In.Name, *Source), TM(TM) {}
+
+  Compilation(const Compilation &) = delete;
+  Compilation &operator=(const Compilation &) = delete;
+
+  /// Parse the input. Return false if it has errors.
+  bool Parse() {
+    Parser P(*Source, ASTCtx, &IRF, ErrorLog);
+    AST = P.Parse();
+    return !ErrorLog.HasErrors();
+  }
+
+  /// Run the frontend and generate the IR. Return false on errors.
+  bool GenerateIR() {
+    if (!Parse())
+      return false;
+
+    Semantics Sema(ErrorLog);
+    AST->Accept(&Sema);
+    if (ErrorLog.HasErrors())
+      return false;
+
+    AST->IRCodegen(&IRF);
+    return true;
+  }
+
+  /// Lower the IR and run the backend up to the register allocation.
+  void LowerToSelectedInstructions() {
+    IRtoLLIR(IRModule, &LLIRModule, TM).GenerateLLIRFromIR();
+    MachineInstructionLegalizer(&LLIRModule, TM).Run();
+    RegisterClassSelection(&LLIRModule, TM).Run();
+    InsturctionSelection(&LLIRModule, TM).InstrSelect();
+  }
+
+  size_t GetNumIRInstructions() {
+    size_t Result = 0;
+    for (auto &F : IRModule.GetFunctions())
+      Result += F.GetNumberOfInstructions();
+    return Result;
+  }
+
+  size_t GetNumMachineInstructions() {
+    size_t Result = 0;
+    for (auto &MFunc : LLIRModule.GetFunctions())
+      for (auto &MBB : MFunc.GetBasicBlocks())
+        Result += MBB.GetInstructions().size();
+    return Result;
+  }
+
+  SourceManager SM;
+  SourceBuffer *Source;
+  Module IRModule;
+  IRFactory IRF;
+  ErrorLogger ErrorLog;
+  ASTContext ASTCtx;
+  Node *AST = nullptr;
+  MachineIRModule LLIRModule;
+  TargetMachine *TM;
+};
+
+//===----------------------------------------------------------------------===//
+// Benchmarks
+//===----------------------------------------------------------------------===//
+
+/// The measured work of a single iteration.
+struct Sample {
+  double Seconds = 0;
+  size_t Units = 0;
+  size_t Allocations = 0;
+};
+
+/// Measures the work in between Start and Stop. The preparation of the input
+/// happens outside of it.
+class Measurement {
+public:
+  void Start() {
+    StartAllocations = NumAllocations;
+    StartTime = std::chrono::steady_clock::now();
+  }
+
+  void Stop(size_t Units) {
+    const auto EndTime = std::chrono::steady_clock::now();
+    Result.Allocations = NumAllocations - StartAllocations;
+    Result.Seconds = std::chrono::duration<double>(EndTime - StartTime).count();
+    Result.Units = Units;
+  }
+
+  const Sample &GetSample() const { return Result; }
+
+private:
+  std::chrono::steady_clock::time_point StartTime;
+  size_t StartAllocations = 0;
+  Sample Result;
+};
+
+/// A benchmark runs an iteration on an input, it returns false if the input
+/// cannot be compiled.
+struct Benchmark {
+  std::string Name;
+  /// The unit of work, like "token".
+  std::string Unit;
+  std::function<bool(const Input &, TargetMachine *, Measurement &)> Run;
+};
+
+static size_t CountTokens(const SourceBuffer &Buffer) {
+  Lexer L(Buffer);
+  size_t Count = 0;
+  for (auto Kind = L.Lex().GetKind();
+       Kind != Token::EndOfFile && Kind != Token::Invalid;
+       Kind = L.Lex().GetKind())
+    Count++;
+  return Count;
+}
+
+/// Return the benchmark of the IR pass @PassT.
+template <typename PassT> static Benchmark GetPassBenchmark(std::string Name) {
+  return {Name, "instruction",
+          [](const Input &In, TargetMachine *TM, Measurement &M) {
+            Compilation C(In, TM);
+            if (!C.GenerateIR())
+              return false;
+
+            const auto Units = C.GetNumIRInstructions();
+            PassT Pass;
+            M.Start();
+            for (auto &F : C.IRModule.GetFunctions())
+              Pass.RunOnFunction(F);
+            M.Stop(Units);
+            return true;
+          }};
+}
+
+static std::vector<Benchmark> GetBenchmarks() {
+  std::vector<Benchmark> Benchmarks;
+
+  Benchmarks.push_back(
+      {"Lexer", "token", [](const Input &In, TargetMachine *, Measurement &M) {
+         SourceManager SM;
+         auto Buffer = SM.CreateBuffer(In.Name, In.Source);
+         M.Start();
+         const auto Units = CountTokens(*Buffer);
+         M.Stop(Units);
+         return true;
+       }});
+
+  Benchmarks.push_back(
+      {"Parser", "token", [](const Input &In, TargetMachine *TM,
+                             Measurement &M) {
+         Compilation C(In, TM);
+         const auto Units = CountTokens(*C.Source);
+         M.Start();
+         const bool Success = C.Parse();
+         M.Stop(Units);
+         return Success;
+       }});
+
+  Benchmarks.push_back(GetPassBenchmark<CopyPropagationPass>(
+      "CopyPropagationPass"));
+  Benchmarks.push_back(GetPassBenchmark<CSEPass>("CSEPass"));
+  Benchmarks.push_back(GetPassBenchmark<DeadCodeEliminationPass>(
+      "DeadCodeEliminationPass"));
+
+  Benchmarks.push_back(
+      {"RegisterAllocator", "instruction",
+       [](const Input &In, TargetMachine *TM, Measurement &M) {
+         Compilation C(In, TM);
+         if (!C.GenerateIR())
+           return false;
+         C.LowerToSelectedInstructions();
+
+         const auto Units = C.GetNumMachineInstructions();
+         RegisterAllocator RA(&C.LLIRModule, TM);
+         M.Start();
+         RA.RunRA();
+         M.Stop(Units);
+         return true;
+       }});
+
+  Benchmarks.push_back(
+      {"AssemblyEmitter", "instruction",
+       [](const Input &In, TargetMachine *TM, Measurement &M) {
+         Compilation C(In, TM);
+         if (!C.GenerateIR())
+           return false;
+         C.LowerToSelectedInstructions();
+         RegisterAllocator(&C.LLIRModule, TM).RunRA();
+         PrologueEpilogInsertion(&C.LLIRModule, TM).Run();
+         AArch64XRegToWRegFixPass(&C.LLIRModule, TM).Run();
+
+         const auto Units = C.GetNumMachineInstructions();
+         std::ostringstream OS;
+         AssemblyEmitter AE(&C.LLIRModule, TM);
+         M.Start();
+         AE.GenerateAssembly(OS);
+         M.Stop(Units);
+         return true;
+       }});
+
+  return Benchmarks;
+}
+
+/// The summed result of a benchmark over the inputs.
+struct Result {
+  std::string Unit;
+  double Seconds = 0;
+  size_t Units = 0;
+  size_t Allocations = 0;
+
+  double GetNsPerUnit() const { return Units ? Seconds * 1e9 / Units : 0; }
+  double GetAllocationsPerUnit() const {
+    return Units ? double(Allocations) / Units : 0;
+  }
+};
+
+/// Run @B on @In until at least @MinTime is measured and return the fastest
+/// iteration. The preparation of the input can take much longer than the
+/// measured part, so the iterations are limited by the elapsed time as well.
+/// Return false if the input cannot be compiled.
+static bool RunBenchmark(const Benchmark &B, const Input &In,
+                         TargetMachine *TM, double MinTime, Sample &Best) {
+  const auto Start = std::chrono::steady_clock::now();
+  auto GetElapsed = [&]() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         Start)
+        .count();
+  };
+
+  double Total = 0;
+  for (unsigned Iteration = 0;
+       Iteration < 3 || (Total < MinTime && GetElapsed() < 10 * MinTime);
+       Iteration++) {
+    Measurement M;
+    if (!B.Run(In, TM, M))
+      return false;
+
+    auto &S = M.GetSample();
+    Total += S.Seconds;
+    if (Iteration == 0 || S.Seconds < Best.Seconds)
+      Best = S;
+  }
+
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Baseline
+//===----------------------------------------------------------------------===//
+
+/// Save @Results into @Path, one benchmark per line.
+static bool SaveBaseline(const std::string &Path,
+                         const std::map<std::string, Result> &Results) {
+  std::ofstream OS(Path);
+  OS << "{" << std::endl;
+  size_t i = 0;
+  for (auto &[Name, R] : Results)
+    OS << "  \"" << Name << "\": {\"unit\": \"" << R.Unit
+       << "\", \"ns_per_unit\": " << R.GetNsPerUnit()
+       << ", \"allocations_per_unit\": " << R.GetAllocationsPerUnit() << "}"
+       << (++i < Results.size() ? "," : "") << std::endl;
+  OS << "}" << std::endl;
+  return static_cast<bool>(OS);
+}
+
+struct BaselineEntry {
+  double NsPerUnit = 0;
+  double AllocationsPerUnit = 0;
+};
+
+/// Read a baseline written by SaveBaseline. Return false if it cannot be
+/// read.
+static bool ReadBaseline(const std::string &Path,
+                         std::map<std::string, BaselineEntry> &Baseline) {
+  std::ifstream IS(Path);
+  if (!IS)
+    return false;
+
+  auto GetNumber = [](const std::string &Line, const std::string &Key) {
+    const auto Pos = Line.find("\"" + Key + "\": ");
+    if (Pos == std::string::npos)
+      return 0.0;
+    return std::strtod(Line.c_str() + Pos + Key.size() + 4, nullptr);
+  };
+
+  for (std::string Line; std::getline(IS, Line);) {
+    const auto NameStart = Line.find('"');
+    if (NameStart == std::string::npos)
+      continue;
+    const auto NameEnd = Line.find('"', NameStart + 1);
+
+    auto &Entry = Baseline[Line.substr(NameStart + 1, NameEnd - NameStart - 1)];
+    Entry.NsPerUnit = GetNumber(Line, "ns_per_unit");
+    Entry.AllocationsPerUnit = GetNumber(Line, "allocations_per_unit");
+  }
+
+  return true;
+}
+
+/// Return the change from @Base to @Current in percent.
+static double GetChange(double Base, double Current) {
+  if (Base == 0)
+    return Current == 0 ? 0 : 100;
+  return (Current - Base) / Base * 100;
+}
+
+/// Print the comparison of @Results to @Baseline. Return false if any of
+/// them regressed more than @Threshold percent.
+static bool Compare(const std::map<std::string, Result> &Results,
+                    const std::map<std::string, BaselineEntry> &Baseline,
+                    double Threshold) {
+  bool Passed = true;
+
+  std::cout << std::endl
+            << "Compared to the baseline (threshold " << Threshold
+            << "%):" << std::endl;
+  std::cout << std::left << std::setw(26) << "Benchmark" << std::right
+            << std::setw(12) << "Base ns" << std::setw(12) << "ns"
+            << std::setw(12) << "Change" << std::setw(12) << "Base allocs"
+            << std::setw(10) << "Allocs" << std::setw(12) << "Change"
+            << std::endl;
+
+  for (auto &[Name, R] : Results) {
+    auto It = Baseline.find(Name);
+    if (It == Baseline.end()) {
+      std::cout << std::left << std::setw(26) << Name
+                << "not in the baseline" << std::right << std::endl;
+      continue;
+    }
+
+    auto &Base = It->second;
+    const double TimeChange = GetChange(Base.NsPerUnit, R.GetNsPerUnit());
+    const double AllocationChange =
+        GetChange(Base.AllocationsPerUnit, R.GetAllocationsPerUnit());
+    const bool Regressed =
+        TimeChange > Threshold || AllocationChange > Threshold;
+    Passed &= !Regressed;
+
+    std::cout << std::left << std::setw(26) << Name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(12)
+              << Base.NsPerUnit << std::setw(12) << R.GetNsPerUnit()
+              << std::setw(11) << std::showpos << std::setprecision(1)
+              << TimeChange << "%" << std::noshowpos << std::setprecision(3)
+              << std::setw(12) << Base.AllocationsPerUnit << std::setw(10)
+              << R.GetAllocationsPerUnit() << std::setw(11) << std::showpos
+              << std::setprecision(1) << AllocationChange << "%"
+              << std::noshowpos << (Regressed ? "  REGRESSION" : "")
+              << std::endl;
+  }
+
+  return Passed;
+}
+
+//===----------------------------------------------------------------------===//
+// Driver
+//===----------------------------------------------------------------------===//
+
+static void PrintResult(const std::string &Name, const Result &R) {
+  std::cout << std::left << std::setw(36) << Name << std::right << std::fixed
+            << std::setprecision(2) << std::setw(10) << R.GetNsPerUnit()
+            << " ns/" << std::left << std::setw(12) << R.Unit << std::right
+            << std::setprecision(3) << std::setw(8)
+            << R.GetAllocationsPerUnit() << " allocs/" << std::left
+            << std::setw(12) << R.Unit << std::right << std::setw(10)
+            << R.Units << " " << R.Unit << "s" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  std::string Corpus = std::string(MINICC_SOURCE_DIR) + "/tests/algorithms";
+  std::vector<std::string> Files;
+  std::string Filter;
+  std::string BaselinePath;
+  std::string ComparePath;
+  double MinTime = 0.1;
+  double Threshold = 10;
+  bool Generated = true;
+  bool Verbose = false;
+
+  for (int i = 1; i < argc; i++) {
+    std::string Arg(argv[i]);
+    auto GetValue = [&](const std::string &Option) {
+      return Arg.substr(Option.size());
+    };
+
+    if (Arg.rfind("-corpus=", 0) == 0)
+      Corpus = GetValue("-corpus=");
+    else if (Arg == "-no-generated")
+      Generated = false;
+    else if (Arg.rfind("-filter=", 0) == 0)
+      Filter = GetValue("-filter=");
+    else if (Arg.rfind("-min-time=", 0) == 0)
+      MinTime = std::strtod(GetValue("-min-time=").c_str(), nullptr);
+    else if (Arg.rfind("-save-baseline=", 0) == 0)
+      BaselinePath = GetValue("-save-baseline=");
+    else if (Arg.rfind("-compare=", 0) == 0)
+      ComparePath = GetValue("-compare=");
+    else if (Arg.rfind("-threshold=", 0) == 0)
+      Threshold = std::strtod(GetValue("-threshold=").c_str(), nullptr);
+    else if (Arg == "-verbose")
+      Verbose = true;
+    else if (Arg[0] == '-') {
+      std::cerr << "Error: Unknown argument '" << Arg << "'" << std::endl;
+      return 1;
+    } else
+      Files.push_back(Arg);
+  }
+
+  // The corpus is sorted, so the inputs are the same in every run
+  std::vector<std::string> Paths;
+  if (!Corpus.empty() && Files.empty()) {
+    std::error_code EC;
+    for (auto &Entry : fs::directory_iterator(Corpus, EC))
+      if (Entry.path().extension() == ".c")
+        Paths.push_back(Entry.path().string());
+    if (EC) {
+      std::cerr << "Error: Cannot read the corpus '" << Corpus
+                << "': " << EC.message() << std::endl;
+      return 1;
+    }
+    std::sort(Paths.begin(), Paths.end());
+  }
+  Paths.insert(Paths.end(), Files.begin(), Files.end());
+
+  std::vector<Input> Inputs;
+  for (auto &Path : Paths) {
+    if (!Preprocess(Path, Inputs.emplace_back())) {
+      std::cerr << "Error: Cannot open the file '" << Path << "'"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // The generated programs use macros as well, so they are preprocessed from
+  // a temporary file like the others
+  if (Generated) {
+    const auto TempPath = fs::temp_directory_path() /
+                          ("miniCC-bench-" + std::to_string(getpid()) + ".c");
+
+    for (auto &[Name, Opts] : GetGeneratedInputs()) {
+      std::ofstream(TempPath) << GenerateSource(Opts);
+      if (!Preprocess(TempPath.string(), Inputs.emplace_back())) {
+        std::cerr << "Error: Cannot write the file '" << TempPath.string()
+                  << "'" << std::endl;
+        return 1;
+      }
+      Inputs.back().Name = Name;
+    }
+
+    fs::remove(TempPath);
+  }
+
+  if (Inputs.empty()) {
+    std::cerr << "Error: No inputs" << std::endl;
+    return 1;
+  }
+
+  AArch64::AArch64TargetMachine TM;
+  std::map<std::string, Result> Results;
+
+  for (auto &B : GetBenchmarks()) {
+    if (B.Name.find(Filter) == std::string::npos)
+      continue;
+
+    auto &Total = Results[B.Name];
+    Total.Unit = B.Unit;
+
+    for (auto &In : Inputs) {
+      Sample S;
+      if (!RunBenchmark(B, In, &TM, MinTime, S)) {
+        std::cerr << "Error: The input '" << In.Name
+                  << "' cannot be compiled" << std::endl;
+        return 1;
+      }
+
+      Total.Seconds += S.Seconds;
+      Total.Units += S.Units;
+      Total.Allocations += S.Allocations;
+
+      if (Verbose) {
+        Result InputResult{B.Unit, S.Seconds, S.Units, S.Allocations};
+        PrintResult("  " + In.Name, InputResult);
+      }
+    }
+
+    PrintResult(B.Name, Total);
+  }
+
+  if (!BaselinePath.empty() && !SaveBaseline(BaselinePath, Results)) {
+    std::cerr << "Error: Cannot write the baseline '" << BaselinePath << "'"
+              << std::endl;
+    return 1;
+  }
+
+  if (!ComparePath.empty()) {
+    std::map<std::string, BaselineEntry> Baseline;
+    if (!ReadBaseline(ComparePath, Baseline)) {
+      std::cerr << "Error: Cannot read the baseline '" << ComparePath << "'"
+                << std::endl;
+      return 1;
+    }
+    if (!Compare(Results, Baseline, Threshold))
+      return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+#include "SourceGenerator.hpp"
+#include <algorithm>
+
+/// Return an operand for the @Index -th leaf of an expression. The leaves
+/// cycle through the locals, the constants, the macros and the global array.
+static std::string GetOperand(const GeneratorOptions &Opts, unsigned Locals,
+                              unsigned Index) {
+  const auto Local = "l" + std::to_string(Index % Locals);
+
+  switch (Index % 4) {
+  case 1:
+    return std::to_string(Index % 97 + 1);
+  case 2:
+    if (Opts.Macros > 0)
+      return "M" + std::to_string(Index / 4 % Opts.Macros) + "(" + Local +
+             ")";
+    break;
+  case 3:
+    if (Opts.GlobalArraySize > 0)
+      return "g_array[" +
+             std::to_string(Index / 4 % Opts.GlobalArraySize) + "]";
+    break;
+  default:
+    break;
+  }
+
+  return Local;
+}
+
+/// Return an expression of @Depth operators, starting with the @Index -th
+/// leaf.
+static std::string GetExpression(const GeneratorOptions &Opts,
+                                 unsigned Locals, unsigned Index,
+                                 unsigned Depth) {
+  static const char *Operators[] = {" + ", " * ", " - "};
+
+  auto Expr = GetOperand(Opts, Locals, Index);
+  for (unsigned i = 0; i < Depth; i++)
+    Expr = "(" + Expr + Operators[(Index + i) % 3] +
+           GetOperand(Opts, Locals, Index + i + 1) + ")";
+
+  return Expr;
+}
+
+std::string GenerateSource(const GeneratorOptions &Opts) {
+  std::string Source;
+  const unsigned Locals = std::max(Opts.Locals, 1u);
+
+  for (unsigned i = 0; i < Opts.Macros; i++)
+    Source += "#define M" + std::to_string(i) + "(x) ((x) * " +
+              std::to_string(i % 7 + 2) + " + " + std::to_string(i) + ")\n";
+  if (Opts.Macros > 0)
+    Source += "\n";
+
+  if (Opts.GlobalArraySize > 0) {
+    Source += "int g_array[" + std::to_string(Opts.GlobalArraySize) + "] = {";
+    for (unsigned i = 0; i < Opts.GlobalArraySize; i++)
+      Source += (i % 16 == 0 ? "\n  " : " ") + std::to_string(i % 1000) +
+                (i + 1 < Opts.GlobalArraySize ? "," : "");
+    Source += "\n};\n\n";
+  }
+
+  for (unsigned F = 0; F < Opts.Functions; F++) {
+    Source += "int f" + std::to_string(F) + "(int a, int b) {\n";
+
+    for (unsigned i = 0; i < Locals; i++)
+      Source += "  int l" + std::to_string(i) + " = a + " +
+                std::to_string(i) + ";\n";
+
+    if (F > 0)
+      Source += "  l0 = f" + std::to_string(F - 1) + "(b, l0);\n";
+
+    for (unsigned i = 0; i < Opts.Statements; i++)
+      Source += "  l" + std::to_string(i % Locals) + " = " +
+                GetExpression(Opts, Locals, F + i, Opts.NestingDepth) + ";\n";
+
+    if (Opts.SwitchCases > 0) {
+      Source += "  switch (b) {\n";
+      for (unsigned i = 0; i < Opts.SwitchCases; i++)
+        Source += "  case " + std::to_string(i) + ":\n    l" +
+                  std::to_string(i % Locals) + " = " +
+                  GetExpression(Opts, Locals, i, 1) + ";\n    break;\n";
+      Source += "  default:\n    l0 = 0;\n  }\n";
+    }
+
+    Source += "  return l0;\n}\n\n";
+  }
+
+  return Source;
+}
@@ -0,0 +1,32 @@
+#ifndef SOURCE_GENERATOR_HPP
+#define SOURCE_GENERATOR_HPP
+
+#include <string>
+
+/// The shape of a synthetic C program. Every parameter scales a different
+/// part of the compiler, so growing them one by one shows which part does not
+/// scale linearly.
+struct GeneratorOptions {
+  /// Number of functions, each one calls the previous one.
+  unsigned Functions = 8;
+  /// Number of statements in each function.
+  unsigned Statements = 16;
+  /// Depth of the expressions on the right hand side of the statements.
+  unsigned NestingDepth = 4;
+  /// Number of local variables in each function.
+  unsigned Locals = 8;
+  /// Number of cases of the switch in each function, 0 for no switch.
+  unsigned SwitchCases = 0;
+  /// Number of elements of the initialized global array, 0 for no array.
+  unsigned GlobalArraySize = 0;
+  /// Number of function like macros, which are used by the expressions.
+  unsigned Macros = 0;
+};
+
+/// Generate a C program shaped by @Opts. The output depends only on the
+/// options, and it only uses the subset of C supported by the compiler. The
+/// expressions are nested to the left, so the register pressure stays low
+/// regardless of their depth.
+std::string GenerateSource(const GeneratorOptions &Opts);
+
+#endif
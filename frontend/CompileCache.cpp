@@ -0,0 +1,221 @@
+#include "CompileCache.hpp"
+#include "../middle_end/IR/BasicBlock.hpp"
+#include "../middle_end/IR/Function.hpp"
+#include "../middle_end/IR/Instructions.hpp"
+#include "../middle_end/IR/Value.hpp"
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+/// The entries are stored with the labels of the first function, see
+/// RenumberLabels.
+static constexpr unsigned CanonicalFunctionCounter = 0;
+
+/// Return a string which changes whenever the compiler is rebuilt, so the
+/// entries generated by an older compiler are not used.
+static std::string GetCompilerIdentity() {
+  std::error_code EC;
+  const auto Executable = fs::read_symlink("/proc/self/exe", EC);
+  if (EC)
+    return "unknown";
+
+  const auto Size = fs::file_size(Executable, EC);
+  const auto ModificationTime = fs::last_write_time(Executable, EC);
+  if (EC)
+    return "unknown";
+
+  return std::to_string(Size) + ":" +
+         std::to_string(ModificationTime.time_since_epoch().count());
+}
+
+/// 64 bit FNV-1a hash of @Str.
+static uint64_t Hash(const std::string &Str) {
+  uint64_t Result = 14695981039346656037ull;
+  for (unsigned char C : Str) {
+    Result ^= C;
+    Result *= 1099511628211ull;
+  }
+  return Result;
+}
+
+/// The basic block labels of the assembly are prefixed with the index of the
+/// function in the module, like ".L3_for_end". Replace the prefix of the
+/// @From -th function with the one of the @To -th, so the same function
+/// can be reused at a different position.
+static std::string RenumberLabels(const std::string &Assembly, unsigned From,
+                                  unsigned To) {
+  if (From == To)
+    return Assembly;
+
+  const auto OldPrefix = ".L" + std::to_string(From) + "_";
+  const auto NewPrefix = ".L" + std::to_string(To) + "_";
+
+  std::string Result;
+  Result.reserve(Assembly.size());
+
+  size_t Pos = 0;
+  for (size_t Next; (Next = Assembly.find(OldPrefix, Pos)) != std::string::npos;
+       Pos = Next + OldPrefix.size()) {
+    Result.append(Assembly, Pos, Next - Pos);
+    Result += NewPrefix;
+  }
+  Result.append(Assembly, Pos, std::string::npos);
+
+  return Result;
+}
+
+CompileCache::CompileCache(const std::string &Directory,
+                           const std::string &Options)
+    : Directory(Directory),
+      Options(Options + " compiler=" + GetCompilerIdentity()) {
+  std::error_code EC;
+  fs::create_directories(this->Directory, EC);
+  if (EC)
+    std::cerr << "Warning: Cannot create the cache directory '" << Directory
+              << "': " << EC.message() << std::endl;
+}
+
+std::string CompileCache::GetKey(Function &F,
+                                 const FunctionMap &Functions) const {
+  std::ostringstream Key;
+  Key << Options << std::endl;
+  F.Print(Key);
+
+  // The dependencies outside of the function, each listed once in the order
+  // of their first use
+  std::ostringstream Dependencies;
+  std::set<Symbol> Structs, Callees, Globals;
+
+  // Only the name of a struct is part of the IR, so its members have to be
+  // added as well
+  std::function<void(const IRType &)> AddType = [&](const IRType &Type) {
+    if (!Type.IsStruct() || Type.GetStorage()->Body == nullptr ||
+        !Structs.insert(Type.GetStructName()).second)
+      return;
+
+    Dependencies << "struct." << Type.GetStructName() << " = {";
+    for (auto &Member : Type.GetMemberTypes())
+      Dependencies << " " << Member.AsString();
+    Dependencies << " }" << std::endl;
+
+    for (auto &Member : Type.GetMemberTypes())
+      AddType(Member);
+  };
+
+  AddType(F.GetReturnType());
+  for (auto &Param : F.GetParameters())
+    AddType(Param->GetType());
+
+  for (auto &BB : F.GetBasicBlocks())
+    for (auto &Instr : BB->GetInstructions()) {
+      AddType(Instr.GetType());
+
+      for (auto &Op : Instr.operands()) {
+        if (Op.Get() == nullptr)
+          continue;
+        AddType(Op.Get()->GetType());
+
+        // Only the address of a global is used, its initializer does not
+        // affect the code of the function
+        if (auto GV = dyn_cast<GlobalVariable>(Op.Get());
+            GV != nullptr && Globals.insert(GV->GetName()).second)
+          Dependencies << "global " << GV->GetName() << " : "
+                       << GV->GetType().AsString() << std::endl;
+      }
+
+      auto Call = dyn_cast<CallInstruction>(&Instr);
+      if (Call == nullptr || !Callees.insert(Call->GetName()).second)
+        continue;
+
+      auto It = Functions.find(Call->GetName());
+      if (It == Functions.end())
+        continue;
+
+      auto &Callee = *It->second;
+      Dependencies << "callee " << Callee.GetName() << " (";
+      for (auto &Param : Callee.GetParameters()) {
+        Dependencies << " " << Param->GetType().AsString();
+        AddType(Param->GetType());
+      }
+      Dependencies << " ) -> " << Callee.GetReturnType().AsString()
+                   << std::endl;
+      AddType(Callee.GetReturnType());
+    }
+
+  Key << Dependencies.str();
+  return Key.str();
+}
+
+fs::path CompileCache::GetEntryPath(const std::string &Key) const {
+  std::ostringstream Name;
+  Name << std::hex << std::setw(16) << std::setfill('0') << Hash(Key);
+  return Directory / Name.str();
+}
+
+bool CompileCache::Lookup(const std::string &Key, unsigned FunctionCounter,
+                          std::string &Assembly) {
+  // An entry is the size of the key, the key itself, then the assembly
+  std::ifstream Entry(GetEntryPath(Key), std::ios::binary);
+  size_t KeySize = 0;
+  std::string StoredKey;
+
+  if (Entry && Entry >> KeySize && Entry.get() == '\n' &&
+      KeySize == Key.size()) {
+    StoredKey.resize(KeySize);
+    Entry.read(StoredKey.data(), KeySize);
+  }
+
+  if (!Entry || StoredKey != Key) {
+    NumMisses++;
+    return false;
+  }
+
+  std::ostringstream Content;
+  Content << Entry.rdbuf();
+  Assembly = RenumberLabels(Content.str(), CanonicalFunctionCounter,
+                            FunctionCounter);
+  NumHits++;
+  return true;
+}
+
+void CompileCache::Store(const std::string &Key, unsigned FunctionCounter,
+                         const std::string &Assembly) {
+  const auto EntryPath = GetEntryPath(Key);
+  auto TempPath = EntryPath;
+  TempPath += ".tmp" + std::to_string(getpid()) + "_" +
+              std::to_string(NumStores++);
+
+  {
+    std::ofstream Entry(TempPath, std::ios::binary);
+    Entry << Key.size() << '\n'
+          << Key
+          << RenumberLabels(Assembly, FunctionCounter,
+                            CanonicalFunctionCounter);
+    if (!Entry) {
+      Entry.close();
+      std::error_code EC;
+      fs::remove(TempPath, EC);
+      return;
+    }
+  }
+
+  // The rename is atomic, so the readers either see the old or the new entry
+  std::error_code EC;
+  fs::rename(TempPath, EntryPath, EC);
+  if (EC)
+    fs::remove(TempPath, EC);
+}
+
+void CompileCache::PrintStatistics(std::ostream &OS) const {
+  const unsigned Total = NumHits + NumMisses;
+  OS << "Function cache: " << NumHits << " hits, " << NumMisses << " misses";
+  if (Total > 0)
+    OS << " (" << NumHits * 100 / Total << "% hit rate)";
+  OS << std::endl;
+}
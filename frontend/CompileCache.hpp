@@ -0,0 +1,64 @@
+#ifndef COMPILE_CACHE_HPP
+#define COMPILE_CACHE_HPP
+
+#include "../support/Symbol.hpp"
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+class Function;
+
+/// On disk cache of the generated assembly of the functions. An entry is
+/// addressed by the content of the function: its unoptimized IR, the layout of
+/// the structs it uses, the signature of its callees, the globals it refers,
+/// the target and the code generation options. On a hit the whole middle end
+/// and backend is skipped for the function and the cached assembly is used
+/// instead.
+///
+/// Every entry holds its full key as well, so a hash collision can only cause
+/// a miss, never a wrong code. The cache can be shared by concurrent
+/// compilations, the entries are written into temporary files and renamed
+/// into place.
+class CompileCache {
+public:
+  using FunctionMap = std::unordered_map<Symbol, Function *>;
+
+  /// Use @Directory as the cache, it is created if it does not exist.
+  /// @Options describes everything besides the function which affects the
+  /// generated code, like the target and the optimizations.
+  CompileCache(const std::string &Directory, const std::string &Options);
+
+  /// Return the key of @F. The callees are looked up in @Functions, which
+  /// has to contain every function of the module by name.
+  std::string GetKey(Function &F, const FunctionMap &Functions) const;
+
+  /// Look up @Key and return true on a hit, in which case @Assembly is set to
+  /// the cached assembly, with the labels of the @FunctionCounter -th
+  /// function of the module.
+  bool Lookup(const std::string &Key, unsigned FunctionCounter,
+              std::string &Assembly);
+
+  /// Store the @Assembly of the @FunctionCounter -th function under @Key.
+  void Store(const std::string &Key, unsigned FunctionCounter,
+             const std::string &Assembly);
+
+  unsigned GetNumHits() const { return NumHits; }
+  unsigned GetNumMisses() const { return NumMisses; }
+
+  void PrintStatistics(std::ostream &OS = std::cerr) const;
+
+private:
+  std::filesystem::path GetEntryPath(const std::string &Key) const;
+
+  std::filesystem::path Directory;
+  std::string Options;
+
+  std::atomic<unsigned> NumHits = 0;
+  std::atomic<unsigned> NumMisses = 0;
+  /// Used to give unique names to the temporary files of the entries.
+  std::atomic<unsigned> NumStores = 0;
+};
+
+#endif
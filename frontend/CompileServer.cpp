@@ -0,0 +1,282 @@
+#include "CompileServer.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Every message is a sequence of 32 bit native endian integers and length
+// prefixed strings. The client and the server are always on the same machine,
+// so there is no need for a portable encoding.
+
+/// The longest string accepted in a message, so a broken or malicious client
+/// cannot make the server allocate an arbitrary amount of memory.
+static constexpr int32_t MaxStringSize = 64 << 20;
+
+/// The most strings accepted in a request.
+static constexpr int32_t MaxRequestStrings = 1 << 16;
+
+/// The server serves one request at a time, so a client which stops sending
+/// or receiving would block every other client. Such connections are dropped
+/// after this many seconds of inactivity.
+static constexpr int RequestTimeoutSeconds = 5;
+
+static bool WriteAll(int FD, const void *Data, size_t Size) {
+  auto Ptr = static_cast<const char *>(Data);
+  while (Size > 0) {
+    auto Written = write(FD, Ptr, Size);
+    if (Written < 0 && errno == EINTR)
+      continue;
+    if (Written <= 0)
+      return false;
+    Ptr += Written;
+    Size -= Written;
+  }
+  return true;
+}
+
+static bool ReadAll(int FD, void *Data, size_t Size) {
+  auto Ptr = static_cast<char *>(Data);
+  while (Size > 0) {
+    auto Read = read(FD, Ptr, Size);
+    if (Read < 0 && errno == EINTR)
+      continue;
+    if (Read <= 0)
+      return false;
+    Ptr += Read;
+    Size -= Read;
+  }
+  return true;
+}
+
+static bool WriteInt(int FD, int32_t Value) {
+  return WriteAll(FD, &Value, sizeof(Value));
+}
+
+static bool ReadInt(int FD, int32_t &Value) {
+  return ReadAll(FD, &Value, sizeof(Value));
+}
+
+static bool WriteString(int FD, const std::string &Str) {
+  return WriteInt(FD, Str.size()) && WriteAll(FD, Str.data(), Str.size());
+}
+
+static bool ReadString(int FD, std::string &Str) {
+  int32_t Size;
+  if (!ReadInt(FD, Size) || Size < 0 || Size > MaxStringSize)
+    return false;
+  Str.resize(Size);
+  return ReadAll(FD, Str.data(), Size);
+}
+
+/// Fill @Addr with @SocketPath. Return false if the path is too long.
+static bool GetSocketAddress(const std::string &SocketPath, sockaddr_un &Addr) {
+  std::memset(&Addr, 0, sizeof(Addr));
+  Addr.sun_family = AF_UNIX;
+  if (SocketPath.size() >= sizeof(Addr.sun_path)) {
+    std::cerr << "Error: The socket path '" << SocketPath << "' is too long"
+              << std::endl;
+    return false;
+  }
+  std::strcpy(Addr.sun_path, SocketPath.c_str());
+  return true;
+}
+
+/// Limit the time a single read or write can block on the connection @FD.
+/// A read or write which times out fails like a closed connection.
+static bool SetTimeout(int FD) {
+  timeval Timeout = {};
+  Timeout.tv_sec = RequestTimeoutSeconds;
+  return setsockopt(FD, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout)) ==
+             0 &&
+         setsockopt(FD, SOL_SOCKET, SO_SNDTIMEO, &Timeout, sizeof(Timeout)) ==
+             0;
+}
+
+/// Run @Compile with @Args in @WorkingDir, while collecting the standard
+/// output and error into @Out and @Err.
+static int ServeRequest(const CompileServer::CompileFunction &Compile,
+                        const std::string &WorkingDir,
+                        const std::vector<std::string> &Args, std::string &Out,
+                        std::string &Err) {
+  std::ostringstream OutStream, ErrStream;
+
+  if (chdir(WorkingDir.c_str()) != 0) {
+    Err = "Error: Cannot change to the directory '" + WorkingDir + "'\n";
+    return 1;
+  }
+
+  auto OldOut = std::cout.rdbuf(OutStream.rdbuf());
+  auto OldErr = std::cerr.rdbuf(ErrStream.rdbuf());
+
+  const int Result = Compile(Args);
+
+  std::cout.flush();
+  std::cout.rdbuf(OldOut);
+  std::cerr.rdbuf(OldErr);
+
+  Out = OutStream.str();
+  Err = ErrStream.str();
+  return Result;
+}
+
+/// Make the path of @Addr free for a new server. Only the socket of a server
+/// which was not shut down properly is removed, that is a socket nobody
+/// listens on anymore. Return false if anything else is at the path.
+static bool RemoveStaleSocket(const sockaddr_un &Addr) {
+  struct stat Stat;
+  if (lstat(Addr.sun_path, &Stat) != 0) {
+    if (errno == ENOENT)
+      return true;
+    std::cerr << "Error: Cannot access '" << Addr.sun_path
+              << "': " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  if (!S_ISSOCK(Stat.st_mode)) {
+    std::cerr << "Error: '" << Addr.sun_path << "' exists and is not a socket"
+              << std::endl;
+    return false;
+  }
+
+  int FD = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (FD < 0) {
+    std::cerr << "Error: Cannot create socket: " << std::strerror(errno)
+              << std::endl;
+    return false;
+  }
+
+  const bool Refused =
+      connect(FD, reinterpret_cast<const sockaddr *>(&Addr), sizeof(Addr)) !=
+          0 &&
+      errno == ECONNREFUSED;
+  close(FD);
+
+  if (!Refused) {
+    std::cerr << "Error: '" << Addr.sun_path
+              << "' is in use, another compile server may be running on it"
+              << std::endl;
+    return false;
+  }
+
+  unlink(Addr.sun_path);
+  return true;
+}
+
+int CompileServer::Serve(const std::string &SocketPath,
+                         const CompileFunction &Compile) {
+  // The working directory changes with the requests, so the socket has to be
+  // referred by its absolute path to be able to remove it at the end
+  const auto AbsoluteSocketPath = std::filesystem::absolute(SocketPath);
+
+  sockaddr_un Addr;
+  if (!GetSocketAddress(AbsoluteSocketPath, Addr) || !RemoveStaleSocket(Addr))
+    return 1;
+
+  int ListenFD = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (ListenFD < 0) {
+    std::cerr << "Error: Cannot create socket: " << std::strerror(errno)
+              << std::endl;
+    return 1;
+  }
+
+  if (bind(ListenFD, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) != 0 ||
+      listen(ListenFD, 16) != 0) {
+    std::cerr << "Error: Cannot listen on '" << SocketPath
+              << "': " << std::strerror(errno) << std::endl;
+    close(ListenFD);
+    return 1;
+  }
+
+  // A client which disappears before reading its response must not kill
+  // the server
+  std::signal(SIGPIPE, SIG_IGN);
+
+  bool Running = true;
+  while (Running) {
+    int FD = accept(ListenFD, nullptr, nullptr);
+    if (FD < 0) {
+      if (errno == EINTR)
+        continue;
+      std::cerr << "Error: accept failed: " << std::strerror(errno)
+                << std::endl;
+      break;
+    }
+
+    // A request which is malformed, too large or does not arrive in time is
+    // dropped without a response
+    int32_t NumStrings;
+    std::string WorkingDir;
+    std::vector<std::string> Args;
+    bool Valid = SetTimeout(FD) && ReadInt(FD, NumStrings) &&
+                 NumStrings > 0 && NumStrings <= MaxRequestStrings &&
+                 ReadString(FD, WorkingDir);
+    for (int32_t i = 1; Valid && i < NumStrings; i++)
+      Valid = ReadString(FD, Args.emplace_back());
+
+    if (!Valid) {
+      close(FD);
+      continue;
+    }
+
+    std::string Out, Err;
+    int Result = 0;
+    if (Args.size() == 1 && Args[0] == ShutdownRequest)
+      Running = false;
+    else
+      Result = ServeRequest(Compile, WorkingDir, Args, Out, Err);
+
+    WriteInt(FD, Result) && WriteString(FD, Out) && WriteString(FD, Err);
+    close(FD);
+  }
+
+  close(ListenFD);
+  unlink(Addr.sun_path);
+  return 0;
+}
+
+int CompileServer::SendRequest(const std::string &SocketPath,
+                               const std::vector<std::string> &Args) {
+  sockaddr_un Addr;
+  if (!GetSocketAddress(SocketPath, Addr))
+    return -1;
+
+  int FD = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (FD < 0 ||
+      connect(FD, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) != 0) {
+    std::cerr << "Error: Cannot connect to the compile server at '"
+              << SocketPath << "': " << std::strerror(errno) << std::endl;
+    if (FD >= 0)
+      close(FD);
+    return -1;
+  }
+
+  std::error_code EC;
+  const auto WorkingDir = std::filesystem::current_path(EC).string();
+
+  bool Sent = WriteInt(FD, Args.size() + 1) && WriteString(FD, WorkingDir);
+  for (size_t i = 0; Sent && i < Args.size(); i++)
+    Sent = WriteString(FD, Args[i]);
+
+  int32_t Result;
+  std::string Out, Err;
+  if (!Sent || !ReadInt(FD, Result) || !ReadString(FD, Out) ||
+      !ReadString(FD, Err)) {
+    std::cerr << "Error: The compile server closed the connection"
+              << std::endl;
+    close(FD);
+    return -1;
+  }
+  close(FD);
+
+  std::cout << Out;
+  std::cerr << Err;
+  return Result;
+}
@@ -0,0 +1,39 @@
+#ifndef COMPILE_SERVER_HPP
+#define COMPILE_SERVER_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Long running compiler process, which serves compile requests over a Unix
+/// domain socket. The target machines, the interned symbols, the uniqued
+/// types and the mapped source files (see FileCache) survive between the
+/// requests, so a request only pays for the compilation itself.
+///
+/// A request is the working directory of the client followed by the command
+/// line arguments, the response is the exit code and whatever the compilation
+/// printed to the standard output and error. The requests are served one at a
+/// time, since the standard streams and the working directory are switched
+/// for the duration of a request. A request can still use -j to compile on
+/// multiple threads. So that a stuck client cannot block the others, its
+/// connection is dropped if it stops sending or receiving for a few seconds.
+class CompileServer {
+public:
+  /// Compile with the given command line arguments and return the exit code.
+  using CompileFunction = std::function<int(const std::vector<std::string> &)>;
+
+  /// The only argument of the request which stops the server.
+  static constexpr const char *ShutdownRequest = "--shutdown";
+
+  /// Listen on @SocketPath and serve the requests with @Compile until a
+  /// shutdown request arrives. Return the exit code of the server.
+  static int Serve(const std::string &SocketPath,
+                   const CompileFunction &Compile);
+
+  /// Send @Args to the server listening on @SocketPath, print its output and
+  /// return its exit code.
+  static int SendRequest(const std::string &SocketPath,
+                         const std::vector<std::string> &Args);
+};
+
+#endif
@@ -1,8 +1,7 @@
 #include "ErrorLogger.hpp"
 
-std::string CreateCodePointerString(const Token &T) {
-  size_t StartIdx = T.GetColNum();
-  std::string Spaces(StartIdx, ' ');
+std::string CreateCodePointerString(const Token &T, unsigned Column) {
+  std::string Spaces(Column, ' ');
   std::string Hats(T.GetString().length(), '^');
   return Spaces + Hats;
 }
@@ -17,12 +16,13 @@ void ErrorLogger::AddMessage(const std::string &Msg, const char *Type) {
 
 void ErrorLogger::AddMessage(const std::string &Msg, const char *Type,
                              const Token &T) {
-  assert(T.GetLineNum() < Source.size() && "Out of bound index");
-  std::string MsgWithLineNums = ":" + std::to_string(T.GetLineNum() + 1) + ":" +
-                                std::to_string(T.GetColNum() + 1) +
+  auto [Line, Column] = Source.GetLineAndColumn(T.GetLocation());
+  assert(Line < Source.GetLineCount() && "Out of bound index");
+  std::string MsgWithLineNums = ":" + std::to_string(Line + 1) + ":" +
+                                std::to_string(Column + 1) +
                                 std::string(": ") + Type + std::string(": ") +
-                                Msg + "\n" + Source[T.GetLineNum()] + "\n" +
-                                CreateCodePointerString(T);
+                                Msg + "\n" + std::string(Source.GetLine(Line)) +
+                                "\n" + CreateCodePointerString(T, Column);
   AddMessage(MsgWithLineNums);
 }
 
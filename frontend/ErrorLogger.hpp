@@ -1,6 +1,7 @@
 #ifndef ERROR_LOGGER_H
 #define ERROR_LOGGER_H
 
+#include "SourceManager.hpp"
 #include "lexer/Token.hpp"
 #include <iostream>
 #include <string>
@@ -9,8 +10,8 @@
 
 class ErrorLogger {
 public:
-  ErrorLogger(std::string FileName, std::vector<std::string> Source)
-      : FileName(std::move(FileName)), Source(std::move(Source)) {}
+  ErrorLogger(std::string FileName, const SourceBuffer &Source)
+      : FileName(std::move(FileName)), Source(Source) {}
 
   void AddMessage(const std::string &Msg);
   void AddMessage(const std::string &Msg, const char *Type);
@@ -31,7 +32,7 @@ public:
 
 private:
   std::string FileName;
-  const std::vector<std::string> Source;
+  const SourceBuffer &Source;
   std::vector<std::string> ErrorMessages;
   bool HasError = false;
   bool HasWarning = false;
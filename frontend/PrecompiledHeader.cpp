@@ -0,0 +1,166 @@
+#include "PrecompiledHeader.hpp"
+#include "ast/TypeContext.hpp"
+
+/// Changes whenever the format of the file changes.
+static constexpr std::string_view Magic = "miniCC-PCH-1\n";
+
+PCHWriter::PCHWriter() { Buffer.append(Magic); }
+
+void PCHWriter::WriteInt(uint64_t Value) {
+  // 7 bits at a time, the highest bit tells if there are more bytes
+  while (Value >= 0x80) {
+    Buffer.push_back(static_cast<char>(Value | 0x80));
+    Value >>= 7;
+  }
+  Buffer.push_back(static_cast<char>(Value));
+}
+
+void PCHWriter::WriteString(std::string_view Str) {
+  WriteInt(Str.size());
+  Buffer.append(Str);
+}
+
+void PCHWriter::WriteType(const Type &T) {
+  auto S = T.GetStorage();
+
+  // 0 means a new type follows, otherwise it is the index of an already
+  // written one plus one
+  if (auto It = TypeIndices.find(S); It != TypeIndices.end()) {
+    WriteInt(It->second + 1);
+    return;
+  }
+  WriteInt(0);
+
+  auto WriteTypeList = [this](const std::vector<Type> *List) {
+    WriteBool(List != nullptr);
+    if (!List)
+      return;
+    WriteInt(List->size());
+    for (auto &Elem : *List)
+      WriteType(Elem);
+  };
+
+  WriteSymbol(S->Name);
+  WriteInt(S->Ty);
+  WriteInt(S->Kind);
+  WriteInt(S->PointerLevel);
+  WriteBool(S->VarArg);
+  WriteInt(S->Qualifiers);
+  WriteTypeList(S->TypeList);
+  WriteTypeList(S->ParameterList);
+
+  WriteBool(S->Dimensions != nullptr);
+  if (S->Dimensions) {
+    WriteInt(S->Dimensions->size());
+    for (auto Dim : *S->Dimensions)
+      WriteInt(Dim);
+  }
+
+  // The nested types got their indices already, so the reader sees the types
+  // finished in the same order
+  const unsigned Index = TypeIndices.size();
+  TypeIndices[S] = Index;
+}
+
+void PCHWriter::WriteToken(const Token &T) {
+  WriteInt(T.GetKind());
+  WriteString(T.GetString());
+  WriteInt(T.GetLocation());
+}
+
+PCHReader::PCHReader(std::string_view Data) : Data(Data) {
+  if (Data.substr(0, Magic.size()) != Magic)
+    Error = true;
+  Pos = Magic.size();
+}
+
+uint64_t PCHReader::ReadInt() {
+  uint64_t Value = 0;
+
+  for (unsigned Shift = 0; !Error; Shift += 7) {
+    if (Pos >= Data.size() || Shift >= 64) {
+      Error = true;
+      break;
+    }
+
+    const auto Byte = static_cast<unsigned char>(Data[Pos++]);
+    Value |= static_cast<uint64_t>(Byte & 0x7f) << Shift;
+    if (!(Byte & 0x80))
+      return Value;
+  }
+
+  return 0;
+}
+
+std::string_view PCHReader::ReadString() {
+  const auto Size = ReadInt();
+  if (Error || Size > Data.size() - Pos) {
+    Error = true;
+    return {};
+  }
+
+  auto Str = Data.substr(Pos, Size);
+  Pos += Size;
+  return Str;
+}
+
+Symbol PCHReader::ReadSymbol() {
+  auto Str = ReadString();
+  return Str.empty() ? Symbol() : Symbol::Intern(Str);
+}
+
+Type PCHReader::ReadType() {
+  const auto Index = ReadInt();
+  if (Index > 0) {
+    if (Index > Types.size()) {
+      Error = true;
+      return Type();
+    }
+    return Types[Index - 1];
+  }
+
+  auto &Context = TypeContext::Get();
+
+  Type::Storage Key;
+  Key.Name = ReadSymbol();
+  Key.Ty = static_cast<Type::VariantKind>(ReadInt());
+  Key.Kind = static_cast<Type::TypeKind>(ReadInt());
+  Key.PointerLevel = ReadInt();
+  Key.VarArg = ReadBool();
+  Key.Qualifiers = ReadInt();
+
+  if (Key.Ty > Type::Double || Key.Kind > Type::Struct)
+    Error = true;
+
+  for (auto List : {&Key.TypeList, &Key.ParameterList}) {
+    if (!ReadBool())
+      continue;
+
+    std::vector<Type> Elems;
+    for (auto Size = ReadInt(); !Error && Elems.size() < Size;)
+      Elems.push_back(ReadType());
+    *List = Context.GetTypeList(std::move(Elems));
+  }
+
+  if (ReadBool()) {
+    std::vector<unsigned> Dims;
+    for (auto Size = ReadInt(); !Error && Dims.size() < Size;)
+      Dims.push_back(ReadInt());
+    Key.Dimensions = Context.GetDimensions(std::move(Dims));
+  }
+
+  if (Error)
+    return Type();
+
+  Types.push_back(Context.GetType(Key));
+  return Types.back();
+}
+
+Token PCHReader::ReadToken() {
+  const auto Kind = static_cast<Token::TokenKind>(ReadInt());
+  // The text of the token has to outlive the reader, the interned string of
+  // the symbol does
+  const auto Sym = Symbol::Intern(ReadString());
+  const auto Location = static_cast<SourceLocation>(ReadInt());
+  return Token(Kind, Sym.Str(), Location, Sym);
+}
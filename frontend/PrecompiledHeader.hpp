@@ -0,0 +1,73 @@
+#ifndef PRECOMPILED_HEADER_HPP
+#define PRECOMPILED_HEADER_HPP
+
+#include "ast/Type.hpp"
+#include "lexer/Token.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// A precompiled header is the state of the preprocessor and the parser after
+// processing a header, so a translation unit starting with that header can
+// continue from there instead of processing it again. The file consists of
+//  - the magic and the format version
+//  - the state of the preprocessor (see PreProcessor::WritePCH), including
+//    the preprocessed text of the header, which becomes the beginning of the
+//    translation unit, so the source locations of the saved tokens stay valid
+//  - the state of the parser (see Parser::WritePCH)
+//
+// The integers are variable length encoded and the types are written once,
+// later occurrences refer to the first one by index. The file is only
+// meaningful for the compiler which created it.
+
+/// Serializes the state into a precompiled header.
+class PCHWriter {
+public:
+  PCHWriter();
+
+  void WriteInt(uint64_t Value);
+  void WriteBool(bool Value) { WriteInt(Value); }
+  void WriteString(std::string_view Str);
+  void WriteSymbol(Symbol Sym) { WriteString(Sym.IsEmpty() ? "" : Sym.Str()); }
+  void WriteType(const Type &T);
+  void WriteToken(const Token &T);
+
+  const std::string &GetBuffer() const { return Buffer; }
+
+private:
+  std::string Buffer;
+
+  /// The index of the already written types.
+  std::unordered_map<const Type::Storage *, unsigned> TypeIndices;
+};
+
+/// Reads back the state written by PCHWriter. Reading past the end or
+/// reading malformed data sets the error flag and returns empty values, so
+/// the callers only need to check HasError() at the end.
+class PCHReader {
+public:
+  /// @Data has to outlive the reader and the strings returned by it.
+  explicit PCHReader(std::string_view Data);
+
+  uint64_t ReadInt();
+  bool ReadBool() { return ReadInt() != 0; }
+  std::string_view ReadString();
+  Symbol ReadSymbol();
+  Type ReadType();
+  Token ReadToken();
+
+  bool HasError() const { return Error; }
+  void SetError() { Error = true; }
+
+private:
+  std::string_view Data;
+  size_t Pos = 0;
+  bool Error = false;
+
+  /// The types read so far, in the order they were written.
+  std::vector<Type> Types;
+};
+
+#endif
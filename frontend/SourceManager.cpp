@@ -0,0 +1,174 @@
+#include "SourceManager.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SourceBuffer::~SourceBuffer() {
+  if (IsMapped)
+    munmap(const_cast<char *>(Data), Size);
+}
+
+std::unique_ptr<SourceBuffer>
+SourceBuffer::CreateFromFile(const std::string &Path) {
+  int FD = open(Path.c_str(), O_RDONLY);
+  if (FD < 0)
+    return nullptr;
+
+  struct stat FileStat;
+  if (fstat(FD, &FileStat) != 0 || !S_ISREG(FileStat.st_mode)) {
+    close(FD);
+    return nullptr;
+  }
+
+  const size_t FileSize = FileStat.st_size;
+
+  // mmap does not allow 0 sized mappings
+  if (FileSize == 0) {
+    close(FD);
+    return std::make_unique<SourceBuffer>(Path, std::string());
+  }
+
+  void *Mapping = mmap(nullptr, FileSize, PROT_READ, MAP_PRIVATE, FD, 0);
+  close(FD);
+
+  // If mapping is not possible, then fall back to simply reading the file
+  if (Mapping == MAP_FAILED) {
+    std::ifstream In(Path, std::ios::binary);
+    if (!In)
+      return nullptr;
+
+    std::stringstream Content;
+    Content << In.rdbuf();
+    return std::make_unique<SourceBuffer>(Path, Content.str());
+  }
+
+  return std::unique_ptr<SourceBuffer>(
+      new SourceBuffer(Path, static_cast<const char *>(Mapping), FileSize));
+}
+
+void SourceBuffer::ComputeLineOffsets() const {
+  if (Size == 0)
+    return;
+
+  std::call_once(LineOffsetsComputed, [this] {
+    // Rough estimate to avoid most of the reallocations
+    LineOffsets.reserve(Size / 32 + 1);
+    LineOffsets.push_back(0);
+
+    const char *Ptr = Data;
+    const char *End = Data + Size;
+    while (auto NewLine =
+               static_cast<const char *>(std::memchr(Ptr, '\n', End - Ptr))) {
+      Ptr = NewLine + 1;
+      // a trailing new line is not the start of a new line
+      if (Ptr == End)
+        break;
+      LineOffsets.push_back(Ptr - Data);
+    }
+  });
+}
+
+unsigned SourceBuffer::GetLineCount() const {
+  ComputeLineOffsets();
+  return LineOffsets.size();
+}
+
+std::string_view SourceBuffer::GetLine(unsigned LineIdx) const {
+  ComputeLineOffsets();
+  assert(LineIdx < LineOffsets.size() && "Out of bound index");
+
+  const size_t Start = LineOffsets[LineIdx];
+  size_t End = LineIdx + 1 < LineOffsets.size() ? LineOffsets[LineIdx + 1] - 1
+                                                 : Size;
+  // strip the terminating '\n' of the last line if any
+  if (End > Start && Data[End - 1] == '\n')
+    End--;
+
+  return {Data + Start, End - Start};
+}
+
+std::pair<unsigned, unsigned>
+SourceBuffer::GetLineAndColumn(SourceLocation Loc) const {
+  ComputeLineOffsets();
+  if (LineOffsets.empty())
+    return {0, 0};
+
+  auto It = std::upper_bound(LineOffsets.begin(), LineOffsets.end(), Loc);
+  const unsigned Line = std::distance(LineOffsets.begin(), It) - 1;
+
+  return {Line, Loc - LineOffsets[Line]};
+}
+
+FileCache &FileCache::Get() {
+  static FileCache Cache;
+  return Cache;
+}
+
+std::shared_ptr<SourceBuffer>
+FileCache::GetFileBuffer(const std::string &Path) {
+  struct stat FileStat;
+  if (stat(Path.c_str(), &FileStat) != 0)
+    return nullptr;
+
+  // The same file can be referred by different relative paths, depending on
+  // the working directory of the compilation
+  std::error_code EC;
+  auto Key = std::filesystem::absolute(Path, EC).lexically_normal().string();
+  if (EC)
+    return SourceBuffer::CreateFromFile(Path);
+
+  const int64_t ModificationTime =
+      int64_t(FileStat.st_mtim.tv_sec) * 1000000000 + FileStat.st_mtim.tv_nsec;
+
+  std::lock_guard<std::mutex> Guard(Lock);
+
+  if (auto It = Entries.find(Key); It != Entries.end()) {
+    auto &E = It->second;
+    if (E.Size == uint64_t(FileStat.st_size) &&
+        E.Inode == uint64_t(FileStat.st_ino) &&
+        E.ModificationTime == ModificationTime) {
+      NumHits++;
+      return E.Buffer;
+    }
+  }
+
+  NumMisses++;
+  std::shared_ptr<SourceBuffer> Buffer = SourceBuffer::CreateFromFile(Path);
+  if (!Buffer)
+    return nullptr;
+
+  if (Entries.size() >= MaxEntries)
+    Entries.clear();
+
+  Entries[Key] = {Buffer, uint64_t(FileStat.st_size),
+                  uint64_t(FileStat.st_ino), ModificationTime};
+  return Buffer;
+}
+
+SourceBuffer *SourceManager::GetFileBuffer(const std::string &Path) {
+  if (auto It = FileBuffers.find(Path); It != FileBuffers.end())
+    return It->second.get();
+
+  std::shared_ptr<SourceBuffer> Buffer =
+      Cache ? Cache->GetFileBuffer(Path) : SourceBuffer::CreateFromFile(Path);
+  if (!Buffer)
+    return nullptr;
+
+  auto Result = Buffer.get();
+  FileBuffers[Path] = std::move(Buffer);
+  return Result;
+}
+
+SourceBuffer *SourceManager::CreateBuffer(std::string Name,
+                                          std::string Content) {
+  MemoryBuffers.push_back(
+      std::make_unique<SourceBuffer>(std::move(Name), std::move(Content)));
+  return MemoryBuffers.back().get();
+}
@@ -0,0 +1,125 @@
+#ifndef SOURCE_MANAGER_H
+#define SOURCE_MANAGER_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Byte offset into a SourceBuffer.
+using SourceLocation = unsigned;
+
+/// A contiguous, read-only view of a source file. Files are memory-mapped
+/// once, buffers created from memory (like the preprocessed translation unit)
+/// own their content. The line table is only built on the first request for
+/// line based information, which is usually just a diagnostic.
+class SourceBuffer {
+public:
+  SourceBuffer(std::string Name, std::string Content)
+      : Name(std::move(Name)), OwnedContent(std::move(Content)) {
+    Data = OwnedContent.data();
+    Size = OwnedContent.size();
+  }
+
+  ~SourceBuffer();
+
+  SourceBuffer(const SourceBuffer &) = delete;
+  SourceBuffer &operator=(const SourceBuffer &) = delete;
+
+  /// Map the file at @Path into memory. Return nullptr if it cannot be opened.
+  static std::unique_ptr<SourceBuffer> CreateFromFile(const std::string &Path);
+
+  const std::string &GetName() const { return Name; }
+
+  std::string_view GetBuffer() const { return {Data, Size}; }
+  size_t GetSize() const { return Size; }
+
+  /// Number of lines, where a trailing new line does not start a new one.
+  unsigned GetLineCount() const;
+
+  /// Return the content of the @LineIdx-th (0 based) line without the
+  /// line terminator.
+  std::string_view GetLine(unsigned LineIdx) const;
+
+  /// Translate @Loc to a 0 based (line, column) pair.
+  std::pair<unsigned, unsigned> GetLineAndColumn(SourceLocation Loc) const;
+
+private:
+  SourceBuffer(std::string Name, const char *Data, size_t Size)
+      : Name(std::move(Name)), Data(Data), Size(Size), IsMapped(true) {}
+
+  void ComputeLineOffsets() const;
+
+  std::string Name;
+  const char *Data = nullptr;
+  size_t Size = 0;
+  bool IsMapped = false;
+  std::string OwnedContent;
+
+  /// Start offset of each line, filled in lazily by ComputeLineOffsets.
+  mutable std::vector<SourceLocation> LineOffsets;
+
+  /// A buffer can be shared by concurrent compilations through the FileCache,
+  /// so the line table is computed at most once.
+  mutable std::once_flag LineOffsetsComputed;
+};
+
+/// Process wide cache of the mapped source files, shared by the
+/// SourceManagers of the compilations, so the files used by most of them (like
+/// the headers under include/) are mapped only once. A cached buffer is only
+/// reused while the size, the modification time and the inode of the file are
+/// unchanged, so edited files are picked up by a long running process.
+class FileCache {
+public:
+  static FileCache &Get();
+
+  /// Return the buffer of the file at @Path, or nullptr if the file cannot be
+  /// opened.
+  std::shared_ptr<SourceBuffer> GetFileBuffer(const std::string &Path);
+
+  size_t GetNumHits() const { return NumHits; }
+  size_t GetNumMisses() const { return NumMisses; }
+
+private:
+  /// The cache is emptied when it reaches this size, the buffers in use
+  /// are kept alive by their SourceManagers.
+  static constexpr size_t MaxEntries = 1024;
+
+  struct Entry {
+    std::shared_ptr<SourceBuffer> Buffer;
+    uint64_t Size;
+    uint64_t Inode;
+    int64_t ModificationTime;
+  };
+
+  std::mutex Lock;
+  std::unordered_map<std::string, Entry> Entries;
+  size_t NumHits = 0;
+  size_t NumMisses = 0;
+};
+
+/// Owns every SourceBuffer of a compilation, so a file is mapped only once no
+/// matter how many times it is requested. If a FileCache is given, then the
+/// files are taken from there instead of mapping them again.
+class SourceManager {
+public:
+  explicit SourceManager(FileCache *Cache = nullptr) : Cache(Cache) {}
+
+  /// Return the buffer of the file at @Path, mapping it on first use.
+  /// Return nullptr if the file cannot be opened.
+  SourceBuffer *GetFileBuffer(const std::string &Path);
+
+  /// Create a buffer from memory, used for the output of the preprocessor.
+  SourceBuffer *CreateBuffer(std::string Name, std::string Content);
+
+private:
+  FileCache *Cache;
+  std::map<std::string, std::shared_ptr<SourceBuffer>> FileBuffers;
+  std::vector<std::unique_ptr<SourceBuffer>> MemoryBuffers;
+};
+
+#endif
@@ -48,19 +48,19 @@ static IRType GetIRTypeFromVK(Type::VariantKind VK, TargetMachine *TM) {
   }
 }
 
-static IRType GetIRTypeFromASTType(Type &CT, TargetMachine *TM) {
+static IRType GetIRTypeFromASTType(const Type &CT, TargetMachine *TM) {
   IRType Result = GetIRTypeFromVK(CT.GetTypeVariant(), TM);
   assert((CT.GetTypeVariant() != Type::Void || CT.GetPointerLevel() != 0) &&
          "void type is only allowed to be a pointer");
 
   if (Result.IsStruct()) {
-    auto StructName = CT.GetName();
-    Result.SetStructName(StructName);
+    Result.SetStructName(CT.GetName());
 
     // convert each member's AST type to IRType (recursive)
+    std::vector<IRType> MemberTypes;
     for (auto &MemberASTType : CT.GetTypeList())
-      Result.GetMemberTypes().push_back(
-          GetIRTypeFromASTType(MemberASTType, TM));
+      MemberTypes.push_back(GetIRTypeFromASTType(MemberASTType, TM));
+    Result.SetMemberTypes(std::move(MemberTypes));
   }
   if (CT.IsArray()) {
     Result.SetDimensions(CT.GetDimensions());
@@ -124,7 +124,7 @@ Value *IfStatement::IRCodegen(IRFactory *IRF) {
   }
 
   // if Condition was a compare instruction then just revert its relation
-  if (auto CMP = dynamic_cast<CompareInstruction *>(Cond); CMP != nullptr) {
+  if (auto CMP = dyn_cast<CompareInstruction>(Cond); CMP != nullptr) {
     CMP->InvertRelation();
     IRF->CreateBR(Cond, HaveElse ? Else.get() : IfEnd.get());
   } else {
@@ -191,7 +191,7 @@ Value *SwitchStatement::IRCodegen(IRFactory *IRF) {
   // through cases could refer to it
   size_t CaseIdx = 0;
   for (auto &[CaseExpr, Statements] : Cases) {
-    auto CaseConst = dynamic_cast<IntegerLiteralExpression *>(CaseExpr.get())
+    auto CaseConst = dynamic_cast<IntegerLiteralExpression *>(CaseExpr)
                          ->GetSIntValue();
     auto CMP_res = IRF->CreateCMP(CompareInstruction::EQ, Cond,
                                   IRF->GetConstant((uint64_t)CaseConst));
@@ -265,7 +265,7 @@ Value *WhileStatement::IRCodegen(IRFactory *IRF) {
 
   // if Condition was a compare instruction then just revert its relation
   if (!IsEndlessLoop) {
-    if (auto CMP = dynamic_cast<CompareInstruction *>(Cond); CMP != nullptr) {
+    if (auto CMP = dyn_cast<CompareInstruction>(Cond); CMP != nullptr) {
       CMP->InvertRelation();
       IRF->CreateBR(Cond, LoopEnd.get());
     } else {
@@ -397,7 +397,7 @@ Value *ForStatement::IRCodegen(IRFactory *IRF) {
   auto Cond = Condition->IRCodegen(IRF);
 
   // if Condition was a compare instruction then just revert its relation
-  if (auto CMP = dynamic_cast<CompareInstruction *>(Cond); CMP != nullptr) {
+  if (auto CMP = dyn_cast<CompareInstruction>(Cond); CMP != nullptr) {
     CMP->InvertRelation();
     IRF->CreateBR(Cond, LoopEnd.get());
   } else {
@@ -540,8 +540,7 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
     break;
   }
 
-  auto NameStr = Name.GetString();
-  IRF->CreateNewFunction(NameStr, RetType);
+  IRF->CreateNewFunction(Name.GetSymbol(), RetType);
   IRF->GetCurrentFunction()->SetReturnsNumber(ReturnsNumber);
 
   if (Body == nullptr) {
@@ -550,7 +549,7 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
   }
 
   if (ImplicitStructPtr) {
-    auto ParamName = ImplicitStructPtr->GetName();
+    auto ParamName = Symbol::Intern(ImplicitStructPtr->GetName());
     IRF->AddToSymbolTable(ParamName, ImplicitStructPtr.get());
     IRF->Insert(std::move(ImplicitStructPtr));
   }
@@ -560,13 +559,13 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
 
   // iterate over the statements and find returns
   if (NeedIgnore) {
-    auto CS = dynamic_cast<CompoundStatement *>(Body.get());
+    auto CS = dynamic_cast<CompoundStatement *>(Body);
     assert(CS);
     for (auto &Stmt : CS->GetStatements())
       if (Stmt->IsRet()) {
-        auto RetStmt = dynamic_cast<ReturnStatement *>(Stmt.get());
+        auto RetStmt = dynamic_cast<ReturnStatement *>(Stmt);
         auto RefExpr =
-            dynamic_cast<ReferenceExpression *>(RetStmt->GetRetVal().get());
+            dynamic_cast<ReferenceExpression *>(RetStmt->GetRetVal());
         if (RefExpr) {
           auto ID = RefExpr->GetIdentifier();
           IRF->GetCurrentFunction()->SetIgnorableStructVarName(ID);
@@ -596,7 +595,7 @@ Value *FunctionDeclaration::IRCodegen(IRFactory *IRF) {
 
     for (auto &BB : IRF->GetCurrentFunction()->GetBasicBlocks())
       for (auto &Instr : BB->GetInstructions())
-        if (auto Jump = dynamic_cast<JumpInstruction *>(Instr.get());
+        if (auto Jump = dyn_cast<JumpInstruction>(&Instr);
             Jump && Jump->GetTargetBB() == nullptr)
           Jump->SetTargetBB(RetBBPtr);
   }
@@ -631,7 +630,7 @@ Value *FunctionParameterDeclaration::IRCodegen(IRFactory *IRF) {
   auto Param = std::make_unique<FunctionParameter>(ParamName, ParamType);
 
   auto SA = IRF->CreateSA(ParamName, ParamType);
-  IRF->AddToSymbolTable(ParamName, SA);
+  IRF->AddToSymbolTable(Name.GetSymbol(), SA);
   IRF->CreateSTR(Param.get(), SA);
   IRF->Insert(std::move(Param));
 
@@ -640,7 +639,7 @@ Value *FunctionParameterDeclaration::IRCodegen(IRFactory *IRF) {
 
 Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
   auto Type = GetIRTypeFromASTType(AType, IRF->GetTargetMachine());
-  auto VarName = Name.GetString();
+  auto VarName = Name.GetSymbol();
 
   // If an array type, then change Type to reflect this
   if (AType.IsArray())
@@ -654,26 +653,24 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
     // add support for arbitrary dimension
     // TODO: clean up this mess
     if (auto InitListExpr =
-            dynamic_cast<InitializerListExpression *>(Init.get());
+            dynamic_cast<InitializerListExpression *>(Init);
         InitListExpr != nullptr ||
-        dynamic_cast<ImplicitCastExpression *>(Init.get())) {
+        dynamic_cast<ImplicitCastExpression *>(Init)) {
 
       if (!InitListExpr) {
-        auto CastedExpr = dynamic_cast<ImplicitCastExpression *>(Init.get())
-                              ->GetCastableExpression()
-                              .get();
+        auto CastedExpr = dynamic_cast<ImplicitCastExpression *>(Init)
+                              ->GetCastableExpression();
         InitListExpr = dynamic_cast<InitializerListExpression *>(CastedExpr);
       }
 
       for (auto &Expr : InitListExpr->GetExprList())
         if (auto ConstExpr =
-                dynamic_cast<IntegerLiteralExpression *>(Expr.get());
+                dynamic_cast<IntegerLiteralExpression *>(Expr);
             ConstExpr != nullptr ||
-            dynamic_cast<ImplicitCastExpression *>(Expr.get())) {
+            dynamic_cast<ImplicitCastExpression *>(Expr)) {
           if (!ConstExpr) {
-            auto CastedExpr = dynamic_cast<ImplicitCastExpression *>(Expr.get())
-                                  ->GetCastableExpression()
-                                  .get();
+            auto CastedExpr = dynamic_cast<ImplicitCastExpression *>(Expr)
+                                  ->GetCastableExpression();
             assert(dynamic_cast<IntegerLiteralExpression *>(CastedExpr) &&
                    "Only support int literals for now");
             ConstExpr = dynamic_cast<IntegerLiteralExpression *>(CastedExpr);
@@ -681,28 +678,26 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
 
           InitList.push_back(ConstExpr->GetUIntValue());
         } else if (auto InitListExpr2nd =
-                       dynamic_cast<InitializerListExpression *>(Expr.get());
+                       dynamic_cast<InitializerListExpression *>(Expr);
                    InitListExpr2nd != nullptr ||
-                   dynamic_cast<ImplicitCastExpression *>(Expr.get())) {
+                   dynamic_cast<ImplicitCastExpression *>(Expr)) {
 
           if (!InitListExpr2nd) {
-            auto CastedExpr = dynamic_cast<ImplicitCastExpression *>(Expr.get())
-                                  ->GetCastableExpression()
-                                  .get();
+            auto CastedExpr = dynamic_cast<ImplicitCastExpression *>(Expr)
+                                  ->GetCastableExpression();
             InitListExpr2nd =
                 dynamic_cast<InitializerListExpression *>(CastedExpr);
           }
 
           for (auto &Expr2nd : InitListExpr2nd->GetExprList())
             if (auto ConstExpr2nd =
-                    dynamic_cast<IntegerLiteralExpression *>(Expr2nd.get());
+                    dynamic_cast<IntegerLiteralExpression *>(Expr2nd);
                 ConstExpr2nd != nullptr ||
-                dynamic_cast<ImplicitCastExpression *>(Expr2nd.get())) {
+                dynamic_cast<ImplicitCastExpression *>(Expr2nd)) {
               if (!ConstExpr2nd) {
                 auto CastedExpr =
-                    dynamic_cast<ImplicitCastExpression *>(Expr2nd.get())
-                        ->GetCastableExpression()
-                        .get();
+                    dynamic_cast<ImplicitCastExpression *>(Expr2nd)
+                        ->GetCastableExpression();
                 assert(dynamic_cast<IntegerLiteralExpression *>(CastedExpr) &&
                        "Only support int literals for now");
                 ConstExpr2nd =
@@ -717,13 +712,13 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
     // FIXME: for now only IntegerLiteralExpression, add support for const
     // expressions like 1 + 2 - 4 * 12
     else {
-      if (auto ConstExpr = dynamic_cast<IntegerLiteralExpression *>(Init.get());
+      if (auto ConstExpr = dynamic_cast<IntegerLiteralExpression *>(Init);
           ConstExpr != nullptr) {
         InitList.push_back(ConstExpr->GetUIntValue());
       }
       // string literal case like: char *str = "Hello World"
       else if (auto StringLitExpr =
-                   dynamic_cast<StringLiteralExpression *>(Init.get());
+                   dynamic_cast<StringLiteralExpression *>(Init);
                StringLitExpr != nullptr) {
         // generate code for the string literal -> create a global var for it
         auto GVStr = StringLitExpr->IRCodegen(IRF);
@@ -741,13 +736,14 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
     else if (Init) {
       assert(AType.IsArray());
 
-      auto InitializerName = "__const." + IRF->GetCurrentFunction()->GetName() +
-                             "." + Name.GetString();
+      auto InitializerName = Symbol::Intern(
+          "__const." + IRF->GetCurrentFunction()->GetName() + "." +
+          Name.GetString());
       auto InitializerGV =
           IRF->CreateGlobalVar(InitializerName, Type, std::move(InitList));
       IRF->AddGlobalVariable(InitializerGV);
 
-      auto SA = IRF->CreateSA(VarName, Type);
+      auto SA = IRF->CreateSA(VarName.ToString(), Type);
 
       IRF->CreateMEMCOPY(
           SA, InitializerGV,
@@ -758,7 +754,7 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
     }
   }
 
-  if (IRF->GetCurrentFunction()->GetIgnorableStructVarName() == VarName) {
+  if (IRF->GetCurrentFunction()->GetIgnorableStructVarName() == VarName.Str()) {
     auto ParamValue =
         IRF->GetCurrentFunction()
             ->GetParameters()
@@ -770,28 +766,27 @@ Value *VariableDeclaration::IRCodegen(IRFactory *IRF) {
 
   // Otherwise we are in a local scope of a function. Allocate space on
   // stack and update the local symbol table.
-  auto SA = IRF->CreateSA(VarName, Type);
+  auto SA = IRF->CreateSA(VarName.ToString(), Type);
 
   // TODO: This needs some serious clean up and upgrade
   if (Init) {
     // If initialized with initializer list then assuming its only 1 dimensional
     // and only contain integer literal expressions.
     if (auto InitListExpr =
-            dynamic_cast<InitializerListExpression *>(Init.get());
+            dynamic_cast<InitializerListExpression *>(Init);
         InitListExpr != nullptr) {
       unsigned LoopCounter = 0;
       for (auto &Expr : InitListExpr->GetExprList()) {
         if (auto ConstExpr =
-                dynamic_cast<IntegerLiteralExpression *>(Expr.get());
+                dynamic_cast<IntegerLiteralExpression *>(Expr);
             ConstExpr != nullptr ||
-            dynamic_cast<ImplicitCastExpression *>(Expr.get())) {
+            dynamic_cast<ImplicitCastExpression *>(Expr)) {
           // basically storing each entry to the right stack area
           // TODO: problematic for big arrays, Clang and GCC create a global
           // array to store there the initial values and use memcopy
           if (!ConstExpr) {
-            auto CastedExpr = dynamic_cast<ImplicitCastExpression *>(Expr.get())
-                                  ->GetCastableExpression()
-                                  .get();
+            auto CastedExpr = dynamic_cast<ImplicitCastExpression *>(Expr)
+                                  ->GetCastableExpression();
             assert(dynamic_cast<IntegerLiteralExpression *>(CastedExpr) &&
                    "Only support int literals for now");
             ConstExpr = dynamic_cast<IntegerLiteralExpression *>(CastedExpr);
@@ -869,7 +864,7 @@ Value *CallExpression::IRCodegen(IRFactory *IRF) {
   }
 
   auto RetType = GetResultType().GetReturnType();
-  auto FuncName = Name.GetString();
+  auto FuncName = Name.GetSymbol();
 
   IRType IRRetType;
   StackAllocationInstruction *StructTemp = nullptr;
@@ -914,7 +909,7 @@ Value *CallExpression::IRCodegen(IRFactory *IRF) {
     // If the return type is a struct, then also make a stack allocation
     // to use that as a temporary, where the result would be copied to after
     // the call
-    StructTemp = IRF->CreateSA(FuncName + ".temp", IRRetType);
+    StructTemp = IRF->CreateSA(FuncName + std::string(".temp"), IRRetType);
 
     // check if the call expression is returning a non pointer struct which is
     // to big to be returned back. In this case the called function were already
@@ -965,7 +960,7 @@ Value *CallExpression::IRCodegen(IRFactory *IRF) {
 }
 
 Value *ReferenceExpression::IRCodegen(IRFactory *IRF) {
-  auto Local = IRF->GetSymbolValue(GetIdentifier());
+  auto Local = IRF->GetSymbolValue(Identifier.GetSymbol());
 
   if (Local && this->GetResultType().IsStruct())
     return Local;
@@ -977,7 +972,7 @@ Value *ReferenceExpression::IRCodegen(IRFactory *IRF) {
       return IRF->CreateLD(Local->GetType(), Local);
   }
 
-  auto GV = IRF->GetGlobalVar(GetIdentifier());
+  auto GV = IRF->GetGlobalVar(Identifier.GetSymbol());
   assert(GV && "Cannot be null");
 
   // If LValue, then return as a ptr to the global val
@@ -1001,8 +996,8 @@ Value *ArrayExpression::IRCodegen(IRFactory *IRF) {
   // case when a pointer is tha base and not an array
   if (ResultType.IsPTR() && !ResultType.IsArray()) {
     // if the base value is on the stack or a global variable
-    if (dynamic_cast<StackAllocationInstruction *>(BaseValue) != nullptr ||
-        dynamic_cast<GlobalVariable *>(BaseValue) != nullptr) {
+    if (isa<StackAllocationInstruction>(BaseValue) ||
+        isa<GlobalVariable>(BaseValue)) {
       // then load it in first
       BaseValue = IRF->CreateLD(ResultType, BaseValue);
       // since we loaded it in, therefore the result indirection level decreased
@@ -1043,18 +1038,18 @@ Value *ImplicitCastExpression::IRCodegen(IRFactory *IRF) {
   if (SourceType.IsArray() && DestType.IsPointerType()) {
     assert(SourceTypeVariant == DestTypeVariant);
 
-    auto RefExp = dynamic_cast<ReferenceExpression *>(CastableExpression.get());
+    auto RefExp = dynamic_cast<ReferenceExpression *>(CastableExpression);
 
     // StringLiteral case
     if (RefExp == nullptr) {
       auto StrLitExpr =
-          dynamic_cast<StringLiteralExpression *>(CastableExpression.get());
+          dynamic_cast<StringLiteralExpression *>(CastableExpression);
       assert(StrLitExpr && "It must be either a reference or a string literal");
 
       return StrLitExpr->IRCodegen(IRF);
     }
 
-    auto ReferredSymbol = RefExp->GetIdentifier();
+    auto ReferredSymbol = RefExp->GetIdentifierToken().GetSymbol();
     auto Val = IRF->GetSymbolValue(ReferredSymbol);
     if (!Val)
       Val = IRF->GetGlobalVar(ReferredSymbol);
@@ -1244,9 +1239,9 @@ Value *UnaryExpression::IRCodegen(IRFactory *IRF) {
   switch (GetOperationKind()) {
   case ADDRESS: {
     Value *Res = nullptr;
-    if (auto RefExp = dynamic_cast<ReferenceExpression *>(Expr.get());
+    if (auto RefExp = dynamic_cast<ReferenceExpression *>(Expr);
         RefExp != nullptr) {
-      auto Referee = RefExp->GetIdentifier();
+      auto Referee = RefExp->GetIdentifierToken().GetSymbol();
 
       Res = IRF->GetSymbolValue(Referee);
 
@@ -1294,7 +1289,7 @@ Value *UnaryExpression::IRCodegen(IRFactory *IRF) {
     IRF->CreateSTR(IRF->GetConstant((uint64_t)1), Result);
 
     // if L was a compare instruction then just revert its relation
-    if (auto LCMP = dynamic_cast<CompareInstruction *>(E); LCMP != nullptr) {
+    if (auto LCMP = dyn_cast<CompareInstruction>(E); LCMP != nullptr) {
       LCMP->InvertRelation();
       IRF->CreateBR(E, FinalBB.get());
     } else {
@@ -1317,11 +1312,16 @@ Value *UnaryExpression::IRCodegen(IRFactory *IRF) {
     return IRF->CreateXOR(E, IRF->GetConstant((u_int64_t)-1ll));
   }
   case MINUS: {
-    if (auto ConstE = dynamic_cast<IntegerLiteralExpression *>(Expr.get());
+    if (auto ConstE = dynamic_cast<IntegerLiteralExpression *>(Expr);
         ConstE != nullptr) {
       ConstE->SetValue(-ConstE->GetSIntValue());
       return Expr->IRCodegen(IRF);
     }
+    if (auto ConstE = dynamic_cast<FloatLiteralExpression *>(Expr);
+        ConstE != nullptr) {
+      ConstE->SetValue(-ConstE->GetValue());
+      return Expr->IRCodegen(IRF);
+    }
 
     E = Expr->IRCodegen(IRF);
     return IRF->CreateSUB(IRF->GetConstant((uint64_t)0), E);
@@ -1446,7 +1446,7 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
     }
 
     // if L was a compare instruction then just revert its relation
-    if (auto LCMP = dynamic_cast<CompareInstruction *>(L); LCMP != nullptr) {
+    if (auto LCMP = dyn_cast<CompareInstruction>(L); LCMP != nullptr) {
       LCMP->InvertRelation();
       IRF->CreateBR(L, IsAND ? FalseBB.get() : TestRhsBB.get());
     } else {
@@ -1463,7 +1463,7 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
     auto R = Right->IRCodegen(IRF);
 
     // if R was a compare instruction then just revert its relation
-    if (auto RCMP = dynamic_cast<CompareInstruction *>(R); RCMP != nullptr) {
+    if (auto RCMP = dyn_cast<CompareInstruction>(R); RCMP != nullptr) {
       RCMP->InvertRelation();
       IRF->CreateBR(R, FalseBB.get());
     } else {
@@ -1498,7 +1498,7 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
 
     if (R->GetTypeRef().IsStruct() && L->GetTypeRef().GetPointerLevel() == 1 &&
         R->GetTypeRef().GetPointerLevel() == 1 &&
-        (dynamic_cast<StackAllocationInstruction *>(L) ||
+        (isa<StackAllocationInstruction>(L) ||
          !GetResultType().IsPointerType())) {
       IRF->CreateMEMCOPY(L, R, R->GetTypeRef().GetBaseTypeByteSize());
     } else
@@ -1565,8 +1565,7 @@ Value *BinaryExpression::IRCodegen(IRFactory *IRF) {
       }
       // TODO: Revisit this. Its not necessary guaranteed that it will be a load
       // for now it seems fine
-      auto Load = dynamic_cast<LoadInstruction *>(L);
-      assert(Load);
+      auto Load = cast<LoadInstruction>(L);
       IRF->CreateSTR(OperationResult, Load->GetMemoryLocation());
       return OperationResult;
     }
@@ -1694,7 +1693,7 @@ Value *TernaryExpression::IRCodegen(IRFactory *IRF) {
   // Condition Test
 
   // if L was a compare instruction then just revert its relation
-  if (auto LCMP = dynamic_cast<CompareInstruction *>(C); LCMP != nullptr) {
+  if (auto LCMP = dyn_cast<CompareInstruction>(C); LCMP != nullptr) {
     LCMP->InvertRelation();
     IRF->CreateBR(C, FalseBB.get());
   } else {
@@ -1732,8 +1731,7 @@ Value *FloatLiteralExpression::IRCodegen(IRFactory *IRF) {
 }
 
 Value *StringLiteralExpression::IRCodegen(IRFactory *IRF) {
-  static unsigned counter = 0; // used to create unique names
-  std::string Name = ".L.str" + std::to_string(counter++);
+  auto Name = IRF->CreateStringLiteralName();
   auto Type = GetIRTypeFromASTType(ResultType, IRF->GetTargetMachine());
   // the global variable is now a pointer to the data
   Type.IncrementPointerLevel();
@@ -1747,7 +1745,7 @@ Value *TranslationUnit::IRCodegen(IRFactory *IRF) {
   for (auto &Declaration : Declarations) {
     IRF->SetGlobalScope();
     if (auto Decl = Declaration->IRCodegen(IRF); Decl != nullptr) {
-      assert(dynamic_cast<GlobalVariable *>(Decl));
+      assert(isa<GlobalVariable>(Decl));
       IRF->AddGlobalVariable(Decl);
     }
   }
@@ -64,16 +64,16 @@ public:
 
   Type GetType() const { return AType; }
 
-  std::unique_ptr<Expression> const &GetInitExpr() const { return Init; }
-  void SetInitExpr(std::unique_ptr<Expression> e) { Init = std::move(e); }
+  Expression *GetInitExpr() const { return Init; }
+  void SetInitExpr(Expression *e) { Init = e; }
 
   VariableDeclaration(const Token &Name, Type Ty, std::vector<unsigned> Dim)
       : Name(Name), AType(std::move(Ty), std::move(Dim)) {}
 
   VariableDeclaration(const Token &Name, Type Ty)
       : Name(Name), AType(std::move(Ty)) {}
-  VariableDeclaration(const Token &Name, Type Ty, std::unique_ptr<Expression> E)
-      : Name(Name), AType(std::move(Ty)), Init(std::move(E)) {}
+  VariableDeclaration(const Token &Name, Type Ty, Expression *E)
+      : Name(Name), AType(std::move(Ty)), Init(E) {}
 
   VariableDeclaration() = default;
 
@@ -86,7 +86,7 @@ public:
 private:
   Token Name;
   Type AType;
-  std::unique_ptr<Expression> Init = nullptr;
+  Expression *Init = nullptr;
 };
 
 class MemberDeclaration : public Statement {
@@ -119,15 +119,14 @@ private:
 class StructDeclaration : public Statement {
 public:
   std::string GetName() const { return Name.GetString(); }
+  Token const &GetNameToken() const { return Name; }
 
-  std::vector<std::unique_ptr<MemberDeclaration>> const &GetMembers() const {
-    return Members;
-  }
+  std::vector<MemberDeclaration *> const &GetMembers() const { return Members; }
 
   const Type &GetType() const { return SType; }
 
   StructDeclaration(const Token &Name,
-                    std::vector<std::unique_ptr<MemberDeclaration>> &M,
+                    std::vector<MemberDeclaration *> &M,
                     Type &StructType)
       : Name(Name), Members(std::move(M)), SType(StructType) {}
 
@@ -142,7 +141,7 @@ public:
 private:
   Type SType;
   Token Name;
-  std::vector<std::unique_ptr<MemberDeclaration>> Members;
+  std::vector<MemberDeclaration *> Members;
 };
 
 class EnumDeclaration : public Statement {
@@ -171,7 +170,7 @@ private:
 };
 
 class CompoundStatement : public Statement {
-  using StmtVec = std::vector<std::unique_ptr<Statement>>;
+  using StmtVec = std::vector<Statement *>;
 
 public:
   StmtVec &GetStatements() { return Statements; }
@@ -198,10 +197,8 @@ private:
 
 class ExpressionStatement : public Statement {
 public:
-  [[nodiscard]] std::unique_ptr<Expression> const &GetExpression() const {
-    return Expr;
-  }
-  void SetExpression(std::unique_ptr<Expression> e) { Expr = std::move(e); }
+  [[nodiscard]] Expression *GetExpression() const { return Expr; }
+  void SetExpression(Expression *e) { Expr = e; }
 
   void Accept(ASTVisitor *visitor) const override {
     visitor->VisitExpressionStatement(this);
@@ -210,25 +207,19 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  std::unique_ptr<Expression> Expr;
+  Expression *Expr = nullptr;
 };
 
 class IfStatement : public Statement {
 public:
-  [[nodiscard]] std::unique_ptr<Expression> const &GetCondition() const {
-    return Condition;
-  }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
+  [[nodiscard]] Expression *GetCondition() const { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
 
-  [[nodiscard]] std::unique_ptr<Statement> const &GetIfBody() const {
-    return IfBody;
-  }
-  void SetIfBody(std::unique_ptr<Statement> ib) { IfBody = std::move(ib); }
+  [[nodiscard]] Statement *GetIfBody() const { return IfBody; }
+  void SetIfBody(Statement *ib) { IfBody = ib; }
 
-  [[nodiscard]] std::unique_ptr<Statement> const &GetElseBody() const {
-    return ElseBody;
-  }
-  void SetElseBody(std::unique_ptr<Statement> eb) { ElseBody = std::move(eb); }
+  [[nodiscard]] Statement *GetElseBody() const { return ElseBody; }
+  void SetElseBody(Statement *eb) { ElseBody = eb; }
 
   void Accept(ASTVisitor *visitor) const override {
     visitor->VisitIfStatement(this);
@@ -237,19 +228,19 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  std::unique_ptr<Expression> Condition;
-  std::unique_ptr<Statement> IfBody;
-  std::unique_ptr<Statement> ElseBody = nullptr;
+  Expression *Condition = nullptr;
+  Statement *IfBody = nullptr;
+  Statement *ElseBody = nullptr;
 };
 
 class SwitchStatement : public Statement {
 public:
-  using VecOfStmts = std::vector<std::unique_ptr<Statement>>;
+  using VecOfStmts = std::vector<Statement *>;
   using VecOfCasesData =
-      std::vector<std::pair<std::unique_ptr<Expression>, VecOfStmts>>;
+      std::vector<std::pair<Expression *, VecOfStmts>>;
 
-  std::unique_ptr<Expression> const &GetCondition() const { return Condition; }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
+  Expression *GetCondition() const { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
 
   VecOfCasesData const &GetCaseBodies() const { return Cases; }
   void SetCaseBodies(VecOfCasesData c) { Cases = std::move(c); }
@@ -264,22 +255,18 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  std::unique_ptr<Expression> Condition;
+  Expression *Condition = nullptr;
   VecOfCasesData Cases;
   VecOfStmts DefaultBody;
 };
 
 class WhileStatement : public Statement {
 public:
-  [[nodiscard]] std::unique_ptr<Expression> const &GetCondition() const {
-    return Condition;
-  }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
+  [[nodiscard]] Expression *GetCondition() const { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
 
-  [[nodiscard]] std::unique_ptr<Statement> const &GetBody() const {
-    return Body;
-  }
-  void SetBody(std::unique_ptr<Statement> b) { Body = std::move(b); }
+  [[nodiscard]] Statement *GetBody() const { return Body; }
+  void SetBody(Statement *b) { Body = b; }
 
   void Accept(ASTVisitor *visitor) const override {
     visitor->VisitWhileStatement(this);
@@ -288,21 +275,17 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  std::unique_ptr<Expression> Condition;
-  std::unique_ptr<Statement> Body;
+  Expression *Condition = nullptr;
+  Statement *Body = nullptr;
 };
 
 class DoWhileStatement : public Statement {
 public:
-  [[nodiscard]] std::unique_ptr<Expression> const &GetCondition() const {
-    return Condition;
-  }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
+  [[nodiscard]] Expression *GetCondition() const { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
 
-  [[nodiscard]] std::unique_ptr<Statement> const &GetBody() const {
-    return Body;
-  }
-  void SetBody(std::unique_ptr<Statement> b) { Body = std::move(b); }
+  [[nodiscard]] Statement *GetBody() const { return Body; }
+  void SetBody(Statement *b) { Body = b; }
 
   void Accept(ASTVisitor *visitor) const override {
     visitor->VisitDoWhileStatement(this);
@@ -311,28 +294,28 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  std::unique_ptr<Expression> Condition;
-  std::unique_ptr<Statement> Body;
+  Expression *Condition = nullptr;
+  Statement *Body = nullptr;
 };
 
 class ForStatement : public Statement {
 public:
-  using StmtVec = std::vector<std::unique_ptr<VariableDeclaration>>;
+  using StmtVec = std::vector<VariableDeclaration *>;
 
   StmtVec const &GetVarDecls() const { return VarDecls; }
   void SetVarDecls(StmtVec v) { VarDecls = std::move(v); }
 
-  std::unique_ptr<Expression> const &GetInit() const { return Init; }
-  void SetInit(std::unique_ptr<Expression> c) { Init = std::move(c); }
+  Expression *GetInit() const { return Init; }
+  void SetInit(Expression *c) { Init = c; }
 
-  std::unique_ptr<Expression> const &GetCondition() const { return Condition; }
-  void SetCondition(std::unique_ptr<Expression> c) { Condition = std::move(c); }
+  Expression *GetCondition() const { return Condition; }
+  void SetCondition(Expression *c) { Condition = c; }
 
-  std::unique_ptr<Expression> const &GetIncrement() const { return Increment; }
-  void SetIncrement(std::unique_ptr<Expression> c) { Increment = std::move(c); }
+  Expression *GetIncrement() const { return Increment; }
+  void SetIncrement(Expression *c) { Increment = c; }
 
-  std::unique_ptr<Statement> const &GetBody() const { return Body; }
-  void SetBody(std::unique_ptr<Statement> b) { Body = std::move(b); }
+  Statement *GetBody() const { return Body; }
+  void SetBody(Statement *b) { Body = b; }
 
   void Accept(ASTVisitor *visitor) const override {
     visitor->VisitForStatement(this);
@@ -342,20 +325,20 @@ public:
 
 private:
   StmtVec VarDecls;
-  std::unique_ptr<Expression> Init = nullptr;
-  std::unique_ptr<Expression> Condition;
-  std::unique_ptr<Expression> Increment;
-  std::unique_ptr<Statement> Body;
+  Expression *Init = nullptr;
+  Expression *Condition = nullptr;
+  Expression *Increment = nullptr;
+  Statement *Body = nullptr;
 };
 
 class ReturnStatement : public Statement {
 public:
-  std::unique_ptr<Expression> &GetRetVal() {
+  Expression *&GetRetVal() {
     assert(HasValue() && "Must have a value to return it.");
     return ReturnValue.value();
   }
 
-  [[nodiscard]] std::unique_ptr<Expression> const &GetRetVal() const {
+  [[nodiscard]] Expression *GetRetVal() const {
     assert(HasValue() && "Must have a value to return it.");
     return ReturnValue.value();
   }
@@ -363,8 +346,7 @@ public:
   [[nodiscard]] bool HasValue() const { return ReturnValue.has_value(); }
 
   ReturnStatement() { AddInfo(Statement::RETURN); }
-  explicit ReturnStatement(std::unique_ptr<Expression> e)
-      : ReturnValue(std::move(e)) {
+  explicit ReturnStatement(Expression *e) : ReturnValue(e) {
     AddInfo(Statement::RETURN);
   }
 
@@ -375,7 +357,7 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  std::optional<std::unique_ptr<Expression>> ReturnValue;
+  std::optional<Expression *> ReturnValue;
 };
 
 class BreakStatement : public Statement {
@@ -422,7 +404,7 @@ private:
 };
 
 class FunctionDeclaration : public Statement {
-  using ParamVec = std::vector<std::unique_ptr<FunctionParameterDeclaration>>;
+  using ParamVec = std::vector<FunctionParameterDeclaration *>;
 
 public:
   Type GetType() const { return T; }
@@ -432,28 +414,30 @@ public:
 
   ParamVec const &GetArguments() const { return Arguments; }
 
-  std::unique_ptr<CompoundStatement> const &GetBody() const { return Body; }
+  CompoundStatement *GetBody() const { return Body; }
+
+  unsigned GetReturnsNumber() const { return ReturnsNumber; }
 
   static Type CreateType(const Type &t, const ParamVec &params) {
     Type ResultType(t);
+    std::vector<Type> ArgTypes;
 
-    for (const auto &param : params) {
-      auto type = param->GetType();
-      ResultType.GetArgTypes().push_back(type);
-    }
+    for (const auto &param : params)
+      ArgTypes.push_back(param->GetType());
     // if there are no arguments then set it to void
     if (params.empty())
-      ResultType.GetArgTypes().emplace_back(Type::Void);
+      ArgTypes.emplace_back(Type::Void);
 
+    ResultType.SetArgTypes(std::move(ArgTypes));
     return ResultType;
   }
 
   FunctionDeclaration() = delete;
 
   FunctionDeclaration(Type FT, Token Name, ParamVec &Args,
-                      std::unique_ptr<CompoundStatement> &Body, unsigned RetNum)
+                      CompoundStatement *Body, unsigned RetNum)
       : T(std::move(FT)), Name(Name), Arguments(std::move(Args)),
-        Body(std::move(Body)), ReturnsNumber(RetNum) {}
+        Body(Body), ReturnsNumber(RetNum) {}
 
   void Accept(ASTVisitor *visitor) const override {
     visitor->VisitFunctionDeclaration(this);
@@ -465,12 +449,12 @@ private:
   Type T;
   Token Name;
   ParamVec Arguments;
-  std::unique_ptr<CompoundStatement> Body;
+  CompoundStatement *Body = nullptr;
   unsigned ReturnsNumber;
 };
 
 class BinaryExpression : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
   enum BinaryOperation {
@@ -595,9 +579,9 @@ public:
 
   Token GetOperation() const { return Operation; }
 
-  ExprPtr const &GetLeftExpr() const { return Left; }
+  ExprPtr GetLeftExpr() const { return Left; }
 
-  ExprPtr const &GetRightExpr() const { return Right; }
+  ExprPtr GetRightExpr() const { return Right; }
 
   bool IsConditional() const { return GetOperationKind() >= NOT; }
   bool IsModulo() const {
@@ -609,9 +593,9 @@ public:
   bool IsAssignment() const { return GetOperationKind() <= LSR_ASSIGN; }
 
   BinaryExpression(ExprPtr L, Token Op, ExprPtr R) {
-    Left = std::move(L);
+    Left = L;
     Operation = Op;
-    Right = std::move(R);
+    Right = R;
 
     if (IsConditional())
       ResultType = Type(Type::Int);
@@ -629,25 +613,24 @@ public:
 
 private:
   Token Operation;
-  std::unique_ptr<Expression> Left;
-  std::unique_ptr<Expression> Right;
+  Expression *Left = nullptr;
+  Expression *Right = nullptr;
 };
 
 class TernaryExpression : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
-  ExprPtr const &GetCondition() const { return Condition; }
+  ExprPtr GetCondition() const { return Condition; }
 
-  ExprPtr const &GetExprIfTrue() const { return ExprIfTrue; }
+  ExprPtr GetExprIfTrue() const { return ExprIfTrue; }
 
-  ExprPtr const &GetExprIfFalse() const { return ExprIfFalse; }
+  ExprPtr GetExprIfFalse() const { return ExprIfFalse; }
 
   TernaryExpression() = default;
 
-  TernaryExpression(ExprPtr &Cond, ExprPtr &True, ExprPtr &False)
-      : Condition(std::move(Cond)), ExprIfTrue(std::move(True)),
-        ExprIfFalse(std::move(False)) {
+  TernaryExpression(ExprPtr Cond, ExprPtr True, ExprPtr False)
+      : Condition(Cond), ExprIfTrue(True), ExprIfFalse(False) {
     ResultType = ExprIfTrue->GetResultType();
   }
 
@@ -658,24 +641,24 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  ExprPtr Condition;
-  ExprPtr ExprIfTrue;
-  ExprPtr ExprIfFalse;
+  ExprPtr Condition = nullptr;
+  ExprPtr ExprIfTrue = nullptr;
+  ExprPtr ExprIfFalse = nullptr;
 };
 
 class StructMemberReference : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
   std::string GetMemberId() const { return MemberIdentifier.GetString(); }
   const Token &GetMemberIdToken() const { return MemberIdentifier; }
 
-  ExprPtr const &GetExpr() const { return StructTypedExpression; }
+  ExprPtr GetExpr() const { return StructTypedExpression; }
 
   bool IsArrow() const { return Arrow; }
 
   StructMemberReference(ExprPtr Expr, Token &Id, size_t Idx, bool Arrow)
-      : StructTypedExpression(std::move(Expr)), MemberIdentifier(Id),
+      : StructTypedExpression(Expr), MemberIdentifier(Id),
         MemberIndex(Idx), Arrow(Arrow) {
     auto STEType = StructTypedExpression->GetResultType();
     if (MemberIndex < STEType.GetTypeList().size())
@@ -692,7 +675,7 @@ public:
 
 private:
   bool Arrow{};
-  ExprPtr StructTypedExpression;
+  ExprPtr StructTypedExpression = nullptr;
   Token MemberIdentifier;
   size_t MemberIndex{};
 };
@@ -700,7 +683,7 @@ private:
 class StructInitExpression : public Expression {
 public:
   using UintList = std::vector<unsigned>;
-  using ExprPtrList = std::vector<std::unique_ptr<Expression>>;
+  using ExprPtrList = std::vector<Expression *>;
 
   ExprPtrList const &GetInitList() const { return InitValues; }
 
@@ -724,7 +707,7 @@ private:
 };
 
 class UnaryExpression : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
   enum UnaryOperation {
@@ -766,12 +749,12 @@ public:
 
   Token GetOperation() const { return Operation; }
 
-  ExprPtr const &GetExpr() const { return Expr; }
+  ExprPtr GetExpr() const { return Expr; }
 
   UnaryExpression(Token Op, ExprPtr E, bool PostFix = false) {
     Operation = Op;
     if (E)
-      Expr = std::move(E);
+      Expr = E;
     IsPostFix = PostFix;
 
     switch (GetOperationKind()) {
@@ -821,13 +804,13 @@ public:
 
 private:
   Token Operation;
-  std::unique_ptr<Expression> Expr = nullptr;
+  Expression *Expr = nullptr;
   bool IsPostFix = false;
   std::optional<Type> SizeOfType = std::nullopt;
 };
 
 class CallExpression : public Expression {
-  using ExprVec = std::vector<std::unique_ptr<Expression>>;
+  using ExprVec = std::vector<Expression *>;
 
 public:
   std::string GetName() const { return Name.GetString(); }
@@ -838,7 +821,7 @@ public:
   CallExpression(const Token &Name, ExprVec &Args, Type T)
       : Name(Name), Arguments(std::move(Args)), FuncType(std::move(T)) {
     Type ResultType = FuncType;
-    ResultType.GetParameterList().clear();
+    ResultType.SetArgTypes({});
     GetResultType() = ResultType;
   }
 
@@ -934,15 +917,15 @@ private:
 };
 
 class ArrayExpression : public Expression {
-  using ExprPtr = std::unique_ptr<Expression>;
+  using ExprPtr = Expression *;
 
 public:
-  ExprPtr const &GetIndexExpression() const { return IndexExpression; }
+  ExprPtr GetIndexExpression() const { return IndexExpression; }
 
-  ExprPtr const &GetBaseExpression() const { return BaseExpression; }
+  ExprPtr GetBaseExpression() const { return BaseExpression; }
 
-  ArrayExpression(ExprPtr &Base, ExprPtr &Index, const Type &Ct = Type())
-      : BaseExpression(std::move(Base)), IndexExpression(std::move(Index)) {
+  ArrayExpression(ExprPtr Base, ExprPtr Index, const Type &Ct = Type())
+      : BaseExpression(Base), IndexExpression(Index) {
     ResultType = Ct;
   }
 
@@ -953,24 +936,22 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  ExprPtr BaseExpression;
-  ExprPtr IndexExpression;
+  ExprPtr BaseExpression = nullptr;
+  ExprPtr IndexExpression = nullptr;
 };
 
 class ImplicitCastExpression : public Expression {
 public:
-  ImplicitCastExpression(std::unique_ptr<Expression> e, Type t, bool c = false)
-      : CastableExpression(std::move(e)), Expression(std::move(t)),
+  ImplicitCastExpression(Expression *e, Type t, bool c = false)
+      : CastableExpression(e), Expression(std::move(t)),
         IsExplicitCast(c) {}
 
-  std::unique_ptr<Expression> &GetCastableExpression() {
+  Expression *&GetCastableExpression() {
     return CastableExpression;
   }
   bool IsExplicit() const { return IsExplicitCast; }
 
-  std::unique_ptr<Expression> const &GetCastableExpression() const {
-    return CastableExpression;
-  }
+  Expression *GetCastableExpression() const { return CastableExpression; }
 
   void Accept(ASTVisitor *visitor) const override {
     visitor->VisitImplicitCastExpression(this);
@@ -979,12 +960,12 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  std::unique_ptr<Expression> CastableExpression;
+  Expression *CastableExpression = nullptr;
   bool IsExplicitCast = false;
 };
 
 class InitializerListExpression : public Expression {
-  using ExprList = std::vector<std::unique_ptr<Expression>>;
+  using ExprList = std::vector<Expression *>;
 
 public:
   ExprList &GetExprList() { return Expressions; }
@@ -1005,17 +986,17 @@ private:
 
 class TranslationUnit : public Statement {
 public:
-  std::vector<std::unique_ptr<Statement>> const &GetDeclarations() const {
+  std::vector<Statement *> const &GetDeclarations() const {
     return Declarations;
   }
 
-  void AddDeclaration(std::unique_ptr<Statement> s) {
+  void AddDeclaration(Statement *s) {
     Declarations.push_back(std::move(s));
   }
 
   TranslationUnit() = default;
 
-  explicit TranslationUnit(std::vector<std::unique_ptr<Statement>> s)
+  explicit TranslationUnit(std::vector<Statement *> s)
       : Declarations(std::move(s)) {}
 
   void Accept(ASTVisitor *visitor) const override {
@@ -1025,7 +1006,7 @@ public:
   Value *IRCodegen(IRFactory *IRF) override;
 
 private:
-  std::vector<std::unique_ptr<Statement>> Declarations;
+  std::vector<Statement *> Declarations;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "ASTContext.hpp"
+#include "AST.hpp"
+
+ASTContext::~ASTContext() {
+  for (auto It = Nodes.rbegin(); It != Nodes.rend(); ++It)
+    (*It)->~Node();
+}
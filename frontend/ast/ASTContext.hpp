@@ -0,0 +1,41 @@
+#ifndef AST_CONTEXT_HPP
+#define AST_CONTEXT_HPP
+
+#include "../../support/BumpAllocator.hpp"
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class Node;
+
+/// Owns every AST node of a translation unit. Nodes are placed into a bump
+/// allocated arena in parse order, the tree itself only links them with raw
+/// pointers. All nodes live until the context is destroyed, when the arena is
+/// released at once.
+class ASTContext {
+public:
+  ASTContext() = default;
+  ~ASTContext();
+
+  ASTContext(const ASTContext &) = delete;
+  ASTContext &operator=(const ASTContext &) = delete;
+
+  template <typename T, typename... Args> T *Create(Args &&...args) {
+    static_assert(std::is_base_of_v<Node, T>, "Only AST nodes are allowed");
+    auto N = new (Arena.Allocate<T>()) T(std::forward<Args>(args)...);
+    Nodes.push_back(N);
+    return N;
+  }
+
+  size_t GetNumNodes() const { return Nodes.size(); }
+  size_t GetBytesAllocated() const { return Arena.GetBytesAllocated(); }
+
+private:
+  BumpAllocator Arena;
+
+  /// The nodes still own some heap memory through their members (vectors,
+  /// strings), so their destructors have to be run before the arena is freed.
+  std::vector<Node *> Nodes;
+};
+
+#endif
@@ -12,11 +12,11 @@ void Semantics::InsertToSymTable(const Token &SymName, const Type &SymType,
   SymbolTableStack::Entry SymEntry(SymName, SymType, SymValue);
   auto SymNameStr = SymName.GetString();
 
-  std::optional<SymbolTableStack::Entry> ExistingEntry =
-      ToGlobal ? SymbolTables.ContainsInGlobalScope(SymNameStr)
-               : SymbolTables.ContainsInCurrentScope(SymNameStr);
+  auto ExistingEntry =
+      ToGlobal ? SymbolTables.ContainsInGlobalScope(SymName.GetSymbol())
+               : SymbolTables.ContainsInCurrentScope(SymName.GetSymbol());
 
-  bool IsRedefinition = ExistingEntry.has_value();
+  bool IsRedefinition = ExistingEntry != nullptr;
 
   // If the existing definition is just a prototype, then it is not an error
   if (auto FuncDecl = GetFuncDecl(SymNameStr);
@@ -29,7 +29,7 @@ void Semantics::InsertToSymTable(const Token &SymName, const Type &SymType,
     ErrorLog.AddError(Msg, SymName);
 
     Msg = "previous definition was here";
-    ErrorLog.AddNote(Msg, std::get<0>(ExistingEntry.value()));
+    ErrorLog.AddNote(Msg, std::get<0>(*ExistingEntry));
   } else if (ToGlobal)
     SymbolTables.InsertGlobalEntry(SymEntry);
   else
@@ -48,7 +48,7 @@ static Expression *GetExprIgnoreImplicitCast(Expression *Expr) {
   Expression *CastedExpr = Expr;
 
   while (auto ICE = dynamic_cast<ImplicitCastExpression *>(CastedExpr))
-    CastedExpr = ICE->GetCastableExpression().get();
+    CastedExpr = ICE->GetCastableExpression();
 
   return CastedExpr;
 }
@@ -69,8 +69,10 @@ void Semantics::VisitVariableDeclaration(const VariableDeclaration *node) {
 void Semantics::VisitMemberDeclaration(const MemberDeclaration *node) {}
 
 void Semantics::VisitStructDeclaration(const StructDeclaration *node) {
+  const auto Name = node->GetNameToken().GetSymbol();
+
   // Register the incomplete type
-  UserDefinedTypes[node->GetName()] = {node->GetType(), {}};
+  UserDefinedTypes[Name] = {node->GetType(), {}};
 
   for (auto &M : node->GetMembers())
     M->Accept(this);
@@ -80,8 +82,7 @@ void Semantics::VisitStructDeclaration(const StructDeclaration *node) {
   for (auto &Member : node->GetMembers())
     StructMemberIdentifiers.push_back(Member->GetNameToken());
 
-  UserDefinedTypes[node->GetName()] = {node->GetType(),
-                                       {StructMemberIdentifiers}};
+  UserDefinedTypes[Name] = {node->GetType(), {StructMemberIdentifiers}};
 }
 
 void Semantics::VisitEnumDeclaration(const EnumDeclaration *node) {}
@@ -115,7 +116,7 @@ void Semantics::VisitSwitchStatement(const SwitchStatement *node) {
 
   for (auto &[CaseConst, CaseBody] : node->GetCaseBodies()) {
     // If non const value used as label
-    if (!dynamic_cast<IntegerLiteralExpression *>(CaseConst.get())) {
+    if (!dynamic_cast<IntegerLiteralExpression *>(CaseConst)) {
       // TODO: Add somehow line and col number info
       std::string Msg = "case label does not reduce to an integer constant";
       ErrorLog.AddError(Msg);
@@ -242,7 +243,7 @@ void Semantics::VisitBinaryExpression(const BinaryExpression *node) {
        (!LeftType.IsIntegerType() || !RightType.IsIntegerType())) ||
       (node->IsShift() && !RightType.IsIntegerType())) {
     std::string Msg = "invalid operands to binary expression ('" +
-                      GetExprIgnoreImplicitCast(node->GetLeftExpr().get())
+                      GetExprIgnoreImplicitCast(node->GetLeftExpr())
                           ->GetResultType()
                           .ToString() +
                       "' and '" + RightType.ToString() + "')";
@@ -320,7 +321,7 @@ void Semantics::VisitUnaryExpression(const UnaryExpression *node) {
 }
 
 void Semantics::VisitCallExpression(const CallExpression *node) {
-  auto CalledFunc = SymbolTables.Contains(node->GetName());
+  auto CalledFunc = SymbolTables.Contains(node->GetNameToken().GetSymbol());
 
   if (!CalledFunc) {
     std::string Msg =
@@ -328,7 +329,7 @@ void Semantics::VisitCallExpression(const CallExpression *node) {
     ErrorLog.AddWarning(Msg, node->GetNameToken());
   } else {
     // Calling the function with too many argument
-    auto &[CalledFuncName, CalledFuncType, _] = CalledFunc.value();
+    auto &[CalledFuncName, CalledFuncType, _] = *CalledFunc;
     const auto FuncArgNum = CalledFuncType.GetArgTypes().size();
     const auto CallArgNum = node->GetArguments().size();
     if (!CalledFuncType.HasVarArg() && FuncArgNum != CallArgNum &&
@@ -348,7 +349,7 @@ void Semantics::VisitCallExpression(const CallExpression *node) {
 }
 
 void Semantics::VisitReferenceExpression(const ReferenceExpression *node) {
-  if (!SymbolTables.Contains(node->GetIdentifier())) {
+  if (!SymbolTables.Contains(node->GetIdentifierToken().GetSymbol())) {
     std::string Msg = "symbol is undefined '" + node->GetIdentifier() + "'";
     ErrorLog.AddError(Msg, node->GetIdentifierToken());
   }
@@ -4,7 +4,7 @@
 #include "../ErrorLogger.hpp"
 #include "../parser/SymbolTable.hpp"
 #include "ASTVisitor.hpp"
-#include <map>
+#include <unordered_map>
 
 class Semantics : public ASTVisitor {
 public:
@@ -57,7 +57,8 @@ private:
   SymbolTableStack SymbolTables;
   ErrorLogger &ErrorLog;
   std::vector<const FunctionDeclaration *> FuncDeclList;
-  std::map<std::string, std::tuple<Type, std::vector<Token>>> UserDefinedTypes;
+  std::unordered_map<Symbol, std::tuple<Type, std::vector<Token>>>
+      UserDefinedTypes;
 };
 
 #endif
@@ -1,4 +1,109 @@
 #include "Type.hpp"
+#include "TypeContext.hpp"
+
+Type::Type() : S(TypeContext::Get().GetBasicStorage(Invalid)) {}
+
+Type::Type(TypeKind tk) {
+  Storage Key;
+  Key.Kind = tk;
+  Key.Ty = (tk == Array || tk == Struct) ? Composite : Invalid;
+  S = TypeContext::Get().GetStorage(Key);
+}
+
+Type::Type(VariantKind vk) : S(TypeContext::Get().GetBasicStorage(vk)) {}
+
+Type::Type(const Type &t, std::vector<unsigned> d) : Type(t) {
+  if (!d.empty())
+    SetDimensions(std::move(d));
+}
+
+Type::Type(const Type &t, std::vector<Type> a) {
+  auto &Context = TypeContext::Get();
+  Storage Key;
+  Key.Ty = t.GetTypeVariant();
+  Key.ParameterList = Context.GetTypeList(std::move(a));
+  S = Context.GetStorage(Key);
+}
+
+void Type::Update(const Storage &Modified) {
+  S = TypeContext::Get().GetStorage(Modified);
+}
+
+void Type::SetName(Symbol n) {
+  auto Modified = *S;
+  Modified.Name = n;
+  Update(Modified);
+}
+
+void Type::SetTypeKind(TypeKind t) {
+  auto Modified = *S;
+  Modified.Kind = t;
+  Update(Modified);
+}
+
+void Type::SetTypeVariant(VariantKind t) {
+  auto Modified = *S;
+  Modified.Ty = t;
+  Update(Modified);
+}
+
+void Type::SetQualifiers(unsigned q) {
+  auto Modified = *S;
+  Modified.Qualifiers = q;
+  Update(Modified);
+}
+
+void Type::IncrementPointerLevel() {
+  auto Modified = *S;
+  Modified.PointerLevel++;
+  Update(Modified);
+}
+
+void Type::DecrementPointerLevel() {
+  if (S->PointerLevel == 0)
+    return;
+  auto Modified = *S;
+  Modified.PointerLevel--;
+  Update(Modified);
+}
+
+void Type::SetVarArg(bool p) {
+  auto Modified = *S;
+  Modified.VarArg = p;
+  Update(Modified);
+}
+
+void Type::SetTypeList(std::vector<Type> Members) {
+  auto Modified = *S;
+  Modified.TypeList = TypeContext::Get().GetTypeList(std::move(Members));
+  Update(Modified);
+}
+
+void Type::SetArgTypes(std::vector<Type> Args) {
+  auto Modified = *S;
+  Modified.ParameterList = TypeContext::Get().GetTypeList(std::move(Args));
+  Update(Modified);
+}
+
+void Type::SetDimensions(std::vector<unsigned> D) {
+  auto Modified = *S;
+  Modified.Kind = Array;
+  Modified.Dimensions = TypeContext::Get().GetDimensions(std::move(D));
+  Update(Modified);
+}
+
+void Type::RemoveFirstDimension() {
+  assert(IsArray() && "Must be an Array type to access Dimensions.");
+  assert(!S->Dimensions->empty());
+
+  std::vector<unsigned> Remaining(S->Dimensions->begin() + 1,
+                                  S->Dimensions->end());
+  auto Modified = *S;
+  if (Remaining.empty())
+    Modified.Kind = Simple; // TODO: what if its an array of struct objects?
+  Modified.Dimensions = TypeContext::Get().GetDimensions(std::move(Remaining));
+  Update(Modified);
+}
 
 std::string Type::ToString(const Type *t) {
   std::string Result;
@@ -65,6 +170,7 @@ std::string Type::ToString(const Type *t) {
 std::string Type::ToString() const {
   if (IsFunction()) {
     auto TyStr = Type::ToString(this);
+    auto &ParameterList = GetArgTypes();
     auto ArgSize = ParameterList.size();
     if (ArgSize > 0)
       TyStr += " (";
@@ -73,16 +179,16 @@ std::string Type::ToString() const {
       if (i + 1 < ArgSize)
         TyStr += ",";
       else {
-        if (VarArg)
+        if (HasVarArg())
           TyStr += ", ...";
         TyStr += ")";
       }
     }
     return TyStr;
-  } else if (Kind == Array) {
+  } else if (IsArray()) {
     auto TyStr = Type::ToString(this);
 
-    for (unsigned int Dimension : Dimensions)
+    for (unsigned int Dimension : GetDimensions())
       TyStr += "[" + std::to_string(Dimension) + "]";
     return TyStr;
   } else {
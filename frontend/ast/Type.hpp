@@ -1,10 +1,17 @@
 #ifndef TYPE_HPP
 #define TYPE_HPP
 
+#include "../../support/Symbol.hpp"
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <vector>
 
+/// A type of the source language. A Type is only a handle of a canonical,
+/// immutable storage owned by the TypeContext, therefore copying it is free
+/// and comparing two types is a pointer compare. Modifying a type (like
+/// incrementing its pointer level) makes the handle refer to the storage of
+/// the modified type.
 class Type {
 public:
   /// Basic type variants. Numerical ones are ordered by conversion rank.
@@ -30,27 +37,51 @@ public:
   enum TypeKind { Simple, Array, Struct };
   enum TypeQualifier : unsigned { None, Typedef, Const };
 
-  std::string GetName() const { return Name; }
-  void SetName(std::string &n) { Name = n; }
+  /// The uniqued representation of a type. The lists are uniqued as well, so
+  /// two storages are identical if all of their fields are equal.
+  struct Storage {
+    Symbol Name; // For structs
+    VariantKind Ty = Invalid;
+    TypeKind Kind = Simple;
+    uint8_t PointerLevel = 0;
+    /// To indicate whether the function type has variable arguments or not
+    bool VarArg = false;
+    unsigned Qualifiers = None;
+    const std::vector<Type> *TypeList = nullptr;
+    const std::vector<Type> *ParameterList = nullptr;
+    const std::vector<unsigned> *Dimensions = nullptr;
+
+    /// The storage of this type without the properties which are irrelevant
+    /// for operator==, so equality is decided by comparing these.
+    const Storage *EqualityClass = nullptr;
+
+    bool IsIdentical(const Storage &RHS) const {
+      return Name == RHS.Name && Ty == RHS.Ty && Kind == RHS.Kind &&
+             PointerLevel == RHS.PointerLevel && VarArg == RHS.VarArg &&
+             Qualifiers == RHS.Qualifiers && TypeList == RHS.TypeList &&
+             ParameterList == RHS.ParameterList &&
+             Dimensions == RHS.Dimensions;
+    }
+  };
 
-  void SetTypeKind(TypeKind t) { Kind = t; }
+  Symbol GetName() const { return S->Name; }
+  void SetName(Symbol n);
 
-  VariantKind GetTypeVariant() const { return Ty; }
-  void SetTypeVariant(VariantKind t) { Ty = t; }
+  void SetTypeKind(TypeKind t);
 
-  void SetQualifiers(unsigned q) { Qualifiers = q; }
+  VariantKind GetTypeVariant() const { return S->Ty; }
+  void SetTypeVariant(VariantKind t);
 
-  uint8_t GetPointerLevel() const { return PointerLevel; }
-  void IncrementPointerLevel() { PointerLevel++; }
-  void DecrementPointerLevel() {
-    if (PointerLevel > 0)
-      PointerLevel--;
-  }
+  void SetQualifiers(unsigned q);
 
-  bool IsPointerType() const { return PointerLevel != 0; }
+  uint8_t GetPointerLevel() const { return S->PointerLevel; }
+  void IncrementPointerLevel();
+  void DecrementPointerLevel();
 
-  bool HasVarArg() const { return VarArg; }
-  void SetVarArg(bool p) { VarArg = p; }
+  bool IsPointerType() const { return S->PointerLevel != 0; }
+
+  bool HasVarArg() const { return S->VarArg; }
+  void SetVarArg(bool p);
 
   static std::string ToString(const Type *t);
 
@@ -158,49 +189,21 @@ public:
     return false;
   }
 
-  Type() : Kind(Simple), Ty(Invalid) {}
-  explicit Type(TypeKind tk) {
-    Kind = tk;
-    switch (tk) {
-    case Array:
-    case Struct:
-      Ty = Composite;
-      break;
-    case Simple:
-    default:
-      Ty = Invalid;
-      break;
-    }
-  }
-  explicit Type(VariantKind vk) {
-    Kind = Simple;
-    Ty = vk;
-  }
-
-  Type(const Type &t, std::vector<unsigned> d) : Type(t) {
-    if (d.empty()) {
-      Kind = t.Kind;
-    } else {
-      Kind = Array;
-      Dimensions = std::move(d);
-    }
-  }
+  Type();
+  explicit Type(TypeKind tk);
+  explicit Type(VariantKind vk);
 
-  Type(const Type &t, std::vector<Type> a) {
-    ParameterList = std::move(a);
-    Ty = t.GetTypeVariant();
-    Kind = Simple;
-  }
+  Type(const Type &t, std::vector<unsigned> d);
+  Type(const Type &t, std::vector<Type> a);
 
-  Type(Type &&ct) = default;
   Type(const Type &ct) = default;
   Type &operator=(const Type &ct) = default;
 
-  bool IsArray() const { return Kind == Array; }
-  bool IsFunction() const { return !ParameterList.empty(); }
-  bool IsStruct() const { return Kind == Struct; }
+  bool IsArray() const { return S->Kind == Array; }
+  bool IsFunction() const { return !S->ParameterList->empty(); }
+  bool IsStruct() const { return S->Kind == Struct; }
   bool IsIntegerType() const {
-    switch (Ty) {
+    switch (S->Ty) {
     case Char:
     case UnsignedChar:
     case Short:
@@ -218,7 +221,7 @@ public:
   }
 
   bool IsUnsigned() const {
-    switch (Ty) {
+    switch (S->Ty) {
     case UnsignedChar:
     case UnsignedShort:
     case UnsignedInt:
@@ -230,88 +233,57 @@ public:
     }
   }
 
-  bool IsFloatingPoint() const { return Ty == Float || Ty == Double; }
-  bool IsVoid() const { return Ty == Void && PointerLevel == 0; }
-  bool IsConst() const { return Qualifiers & Const; }
-  bool IsTypedef() const { return Qualifiers & Typedef; }
+  bool IsFloatingPoint() const { return S->Ty == Float || S->Ty == Double; }
+  bool IsVoid() const { return S->Ty == Void && S->PointerLevel == 0; }
+  bool IsConst() const { return S->Qualifiers & Const; }
+  bool IsTypedef() const { return S->Qualifiers & Typedef; }
 
-  std::vector<Type> &GetTypeList() { return TypeList; }
-  std::vector<Type> &GetParameterList() { return ParameterList; }
-  VariantKind GetReturnType() const { return Ty; }
+  /// Member types of structs
+  const std::vector<Type> &GetTypeList() const { return *S->TypeList; }
+  void SetTypeList(std::vector<Type> Members);
 
-  std::vector<unsigned> &GetDimensions() {
-    assert(IsArray() && "Must be an Array type to access Dimensions.");
-    return Dimensions;
-  }
-
-  void SetDimensions(std::vector<unsigned> D) {
-    Kind = Array;
-    Dimensions = std::move(D);
-  }
+  VariantKind GetReturnType() const { return S->Ty; }
 
-  void RemoveFirstDimension() {
+  const std::vector<unsigned> &GetDimensions() const {
     assert(IsArray() && "Must be an Array type to access Dimensions.");
-    assert(!Dimensions.empty());
-    Dimensions.erase(Dimensions.begin());
-    if (Dimensions.empty())
-      Kind = Simple; // TODO: what if its an array of struct objects?
+    return *S->Dimensions;
   }
 
-  std::vector<Type> &GetArgTypes() { return ParameterList; }
+  void SetDimensions(std::vector<unsigned> D);
 
-  friend bool operator==(const Type &lhs, const Type &rhs) {
-    bool result = lhs.Kind == rhs.Kind && lhs.Ty == rhs.Ty;
-    result &= lhs.GetPointerLevel() == rhs.GetPointerLevel();
+  void RemoveFirstDimension();
 
-    if (!result)
-      return false;
-
-    if (lhs.ParameterList.size() != rhs.ParameterList.size())
-      return false;
+  const std::vector<Type> &GetArgTypes() const { return *S->ParameterList; }
+  void SetArgTypes(std::vector<Type> Args);
 
-    // at this point both type's parameter list has the same size
-    if (!lhs.ParameterList.empty()) {
-      for (size_t i = 0; i < lhs.ParameterList.size(); i++)
-        if (lhs.ParameterList[i] != rhs.ParameterList[i])
-          return false;
-    }
-
-    switch (lhs.Kind) {
-    case Array:
-      if (lhs.Dimensions.size() != rhs.Dimensions.size())
-        return false;
-      else
-        for (size_t i = 0; i < lhs.Dimensions.size(); i++)
-          if (lhs.Dimensions[i] != rhs.Dimensions[i])
-            return false;
-      break;
-    default:
-      break;
-    }
-    return true;
+  /// Types are equal if their kind, variant, pointer level, parameter types
+  /// and array dimensions are the same. Qualifiers and struct names are not
+  /// considered.
+  friend bool operator==(const Type &lhs, const Type &rhs) {
+    return lhs.S->EqualityClass == rhs.S->EqualityClass;
   }
 
   friend bool operator!=(const Type &lhs, const Type &rhs) {
     return !(lhs == rhs);
   }
 
+  /// Return true if every property of the types are the same, unlike
+  /// operator== which ignores some of them.
+  bool IsIdentical(const Type &RHS) const { return S == RHS.S; }
+
+  const Storage *GetStorage() const { return S; }
+
   std::string ToString() const;
 
 private:
-  std::string Name; // For structs
-  VariantKind Ty;
-  uint8_t PointerLevel = 0;
-
-  TypeKind Kind;
-  unsigned Qualifiers = None;
-  // TODO: revisit the use of union, deleted from here since
-  // it just made things complicated
-  std::vector<Type> TypeList;
-  std::vector<Type> ParameterList;
-  std::vector<unsigned> Dimensions;
-
-  /// To indicate whether the function type has variable arguments or not
-  bool VarArg = false;
+  explicit Type(const Storage *S) : S(S) {}
+
+  /// Replace the storage with the canonical one of @Modified.
+  void Update(const Storage &Modified);
+
+  const Storage *S;
+
+  friend class TypeContext;
 };
 
 // Hold an integer or a float value
@@ -0,0 +1,146 @@
+#include "TypeContext.hpp"
+
+static void HashCombine(size_t &Seed, size_t Value) {
+  Seed ^= Value + 0x9e3779b97f4a7c15ULL + (Seed << 6) + (Seed >> 2);
+}
+
+size_t TypeContext::StorageHash::operator()(const Type::Storage *S) const {
+  size_t Hash = S->Name.GetID();
+  HashCombine(Hash, S->Ty);
+  HashCombine(Hash, S->Kind);
+  HashCombine(Hash, S->PointerLevel);
+  HashCombine(Hash, S->VarArg);
+  HashCombine(Hash, S->Qualifiers);
+  HashCombine(Hash, reinterpret_cast<uintptr_t>(S->TypeList));
+  HashCombine(Hash, reinterpret_cast<uintptr_t>(S->ParameterList));
+  HashCombine(Hash, reinterpret_cast<uintptr_t>(S->Dimensions));
+  return Hash;
+}
+
+size_t
+TypeContext::TypeListHash::operator()(const std::vector<Type> *L) const {
+  size_t Hash = L->size();
+  for (auto &T : *L)
+    HashCombine(Hash, reinterpret_cast<uintptr_t>(T.GetStorage()));
+  return Hash;
+}
+
+bool TypeContext::TypeListEq::operator()(const std::vector<Type> *L,
+                                         const std::vector<Type> *R) const {
+  if (L->size() != R->size())
+    return false;
+  for (size_t i = 0; i < L->size(); i++)
+    if (!(*L)[i].IsIdentical((*R)[i]))
+      return false;
+  return true;
+}
+
+size_t
+TypeContext::DimensionsHash::operator()(const std::vector<unsigned> *D) const {
+  size_t Hash = D->size();
+  for (auto Dim : *D)
+    HashCombine(Hash, Dim);
+  return Hash;
+}
+
+TypeContext &TypeContext::Get() {
+  static TypeContext Context;
+  return Context;
+}
+
+TypeContext::TypeContext() {
+  EmptyTypeList = GetTypeListImpl({});
+  EmptyDimensions = GetDimensionsImpl({});
+
+  for (unsigned VK = Type::Invalid; VK <= Type::Double; VK++) {
+    Type::Storage Key;
+    Key.Ty = static_cast<Type::VariantKind>(VK);
+    BasicTypes[VK] = GetStorageImpl(Key);
+  }
+}
+
+const Type::Storage *TypeContext::GetStorage(const Type::Storage &Key) {
+  // Most of the types created while parsing are basic ones, which are
+  // available without taking the lock
+  if (Key.Name.IsEmpty() && Key.Kind == Type::Simple && !Key.PointerLevel &&
+      !Key.VarArg && Key.Qualifiers == Type::None &&
+      (!Key.TypeList || Key.TypeList == EmptyTypeList) &&
+      (!Key.ParameterList || Key.ParameterList == EmptyTypeList) &&
+      (!Key.Dimensions || Key.Dimensions == EmptyDimensions))
+    return BasicTypes[Key.Ty];
+
+  std::lock_guard<std::mutex> Guard(Lock);
+  return GetStorageImpl(Key);
+}
+
+const std::vector<Type> *TypeContext::GetTypeList(std::vector<Type> Types) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  return GetTypeListImpl(std::move(Types));
+}
+
+const std::vector<unsigned> *
+TypeContext::GetDimensions(std::vector<unsigned> Dims) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  return GetDimensionsImpl(std::move(Dims));
+}
+
+size_t TypeContext::GetNumTypes() {
+  std::lock_guard<std::mutex> Guard(Lock);
+  return Storages.size();
+}
+
+const Type::Storage *TypeContext::GetStorageImpl(const Type::Storage &Key) {
+  Type::Storage Canonical = Key;
+  Canonical.EqualityClass = nullptr;
+  if (!Canonical.TypeList)
+    Canonical.TypeList = EmptyTypeList;
+  if (!Canonical.ParameterList)
+    Canonical.ParameterList = EmptyTypeList;
+  if (!Canonical.Dimensions)
+    Canonical.Dimensions = EmptyDimensions;
+
+  if (auto It = UniqueStorages.find(&Canonical); It != UniqueStorages.end())
+    return *It;
+
+  auto &New = Storages.emplace_back(Canonical);
+  UniqueStorages.insert(&New);
+
+  // Strip everything that operator== does not care about. The parameters are
+  // compared with operator== too, so they are replaced by their classes.
+  Type::Storage Class;
+  Class.Ty = New.Ty;
+  Class.Kind = New.Kind;
+  Class.PointerLevel = New.PointerLevel;
+  Class.TypeList = EmptyTypeList;
+  Class.Dimensions = New.Kind == Type::Array ? New.Dimensions : EmptyDimensions;
+
+  std::vector<Type> ParamClasses;
+  ParamClasses.reserve(New.ParameterList->size());
+  for (auto &Param : *New.ParameterList)
+    ParamClasses.push_back(Type(Param.GetStorage()->EqualityClass));
+  Class.ParameterList = GetTypeListImpl(std::move(ParamClasses));
+
+  New.EqualityClass =
+      Class.IsIdentical(New) ? &New : GetStorageImpl(Class);
+  return &New;
+}
+
+const std::vector<Type> *
+TypeContext::GetTypeListImpl(std::vector<Type> Types) {
+  if (auto It = UniqueTypeLists.find(&Types); It != UniqueTypeLists.end())
+    return *It;
+
+  auto &New = TypeLists.emplace_back(std::move(Types));
+  UniqueTypeLists.insert(&New);
+  return &New;
+}
+
+const std::vector<unsigned> *
+TypeContext::GetDimensionsImpl(std::vector<unsigned> Dims) {
+  if (auto It = UniqueDimensions.find(&Dims); It != UniqueDimensions.end())
+    return *It;
+
+  auto &New = DimensionLists.emplace_back(std::move(Dims));
+  UniqueDimensions.insert(&New);
+  return &New;
+}
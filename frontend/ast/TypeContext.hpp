@@ -0,0 +1,90 @@
+#ifndef TYPE_CONTEXT_HPP
+#define TYPE_CONTEXT_HPP
+
+#include "Type.hpp"
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/// Uniquely owns every distinct type, so each of them is stored only once
+/// and a Type is just a pointer to its canonical storage. Type lists (struct
+/// members, function parameters) and array dimensions are uniqued as well.
+///
+/// The context is process wide and lives until the end of the program. It is
+/// safe to use from multiple threads. The basic types, like Type(Type::Int),
+/// are created up front and are available without locking.
+class TypeContext {
+public:
+  static TypeContext &Get();
+
+  /// Return the canonical storage which is identical to @Key.
+  const Type::Storage *GetStorage(const Type::Storage &Key);
+
+  /// Return the type whose storage is identical to @Key.
+  Type GetType(const Type::Storage &Key) { return Type(GetStorage(Key)); }
+
+  /// Return the storage of the unqualified, non pointer @VK type.
+  const Type::Storage *GetBasicStorage(Type::VariantKind VK) const {
+    return BasicTypes[VK];
+  }
+
+  const std::vector<Type> *GetTypeList(std::vector<Type> Types);
+  const std::vector<unsigned> *GetDimensions(std::vector<unsigned> Dims);
+
+  /// Number of distinct types created so far.
+  size_t GetNumTypes();
+
+private:
+  TypeContext();
+
+  const Type::Storage *GetStorageImpl(const Type::Storage &Key);
+  const std::vector<Type> *GetTypeListImpl(std::vector<Type> Types);
+  const std::vector<unsigned> *GetDimensionsImpl(std::vector<unsigned> Dims);
+
+  struct StorageHash {
+    size_t operator()(const Type::Storage *S) const;
+  };
+  struct StorageEq {
+    bool operator()(const Type::Storage *L, const Type::Storage *R) const {
+      return L->IsIdentical(*R);
+    }
+  };
+  struct TypeListHash {
+    size_t operator()(const std::vector<Type> *L) const;
+  };
+  struct TypeListEq {
+    bool operator()(const std::vector<Type> *L,
+                    const std::vector<Type> *R) const;
+  };
+  struct DimensionsHash {
+    size_t operator()(const std::vector<unsigned> *D) const;
+  };
+  struct DimensionsEq {
+    bool operator()(const std::vector<unsigned> *L,
+                    const std::vector<unsigned> *R) const {
+      return *L == *R;
+    }
+  };
+
+  std::mutex Lock;
+
+  // Deques, since they never move their elements
+  std::deque<Type::Storage> Storages;
+  std::deque<std::vector<Type>> TypeLists;
+  std::deque<std::vector<unsigned>> DimensionLists;
+
+  std::unordered_set<const Type::Storage *, StorageHash, StorageEq>
+      UniqueStorages;
+  std::unordered_set<const std::vector<Type> *, TypeListHash, TypeListEq>
+      UniqueTypeLists;
+  std::unordered_set<const std::vector<unsigned> *, DimensionsHash,
+                     DimensionsEq>
+      UniqueDimensions;
+
+  const std::vector<Type> *EmptyTypeList;
+  const std::vector<unsigned> *EmptyDimensions;
+  const Type::Storage *BasicTypes[Type::Double + 1];
+};
+
+#endif
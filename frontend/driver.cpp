@@ -11,45 +11,34 @@
 #include "../backend/TargetArchs/RISCV/RISCVTargetMachine.hpp"
 #include "../middle_end/IR/IRFactory.hpp"
 #include "../middle_end/Transforms/PassManager.hpp"
+#include "../support/Statistic.hpp"
+#include "../support/ThreadPool.hpp"
+#include "../support/TimeProfiler.hpp"
+#include "CompileCache.hpp"
+#include "CompileServer.hpp"
 #include "ErrorLogger.hpp"
+#include "PrecompiledHeader.hpp"
+#include "SourceManager.hpp"
 #include "ast/ASTPrint.hpp"
 #include "ast/Semantics.hpp"
 #include "lexer/Lexer.hpp"
 #include "parser/Parser.hpp"
 #include "preprocessor/PreProcessor.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
-/*
- * It will iterate through all the lines in file and
- * put them in given vector
- */
-bool getFileContent(const std::string &fileName,
-                    std::vector<std::string> &vecOfStrs) {
-  // Open the File
-  std::ifstream in(fileName.c_str());
-  // Check if object is valid
-  if (!in) {
-    std::cerr << "Cannot open the File : " << fileName << std::endl;
-    return false;
-  }
-  std::string str;
-  // Read the next line from File until it reaches the end.
-  while (std::getline(in, str)) {
-    // Line contains string of length > 0 then save it in vector
-    vecOfStrs.push_back(str);
-  }
-  // Close The File
-  in.close();
-  return true;
-}
-
-/// TODO: Make a proper driver
-int main(int argc, char *argv[]) {
-  std::string FilePath = "tests/test.txt";
+/// The options of the compilation, they are the same for every input file.
+struct DriverOptions {
   bool DumpPreProcessedFile = false;
   bool DumpTokens = false;
   bool DumpAST = false;
@@ -59,199 +48,703 @@ int main(int argc, char *argv[]) {
   std::set<Optimization> RequestedOptimizations;
   bool RunLLIROpt = false;
   std::string TargetArch = "aarch64";
+  unsigned Jobs = 1;
+  /// The cache of the generated functions, or null if it is disabled.
+  CompileCache *Cache = nullptr;
+  /// The precompiled header included before every input, empty if none.
+  std::string PCHPath;
+
+  /// Return true if anything besides the assembly is printed to the standard
+  /// output.
+  bool HasDumps() const {
+    return DumpPreProcessedFile || DumpTokens || DumpAST || DumpIR ||
+           PrintBeforePasses;
+  }
+};
+
+/// Serializes the diagnostics of the concurrently compiled files, so the
+/// messages of a file are not interleaved with the others.
+static std::mutex DiagnosticsLock;
+
+/// Compile the functions of @IRModule on @Jobs threads. Every function goes
+/// through the whole pipeline, from the IR optimizations to the assembly, in
+/// a single task and the assembly is written into a buffer of its own. The
+/// buffers are printed in source order, so the output is the same as the
+/// single threaded one. The functions found in the cache are not compiled at
+/// all, their cached assembly is printed instead.
+static void CompileInParallel(Module &IRModule, TargetMachine *TM,
+                              const DriverOptions &Opts, std::ostream &OS) {
+  auto &Optimizations = Opts.RequestedOptimizations;
+  const bool Optimize = !Optimizations.empty();
+  const bool DumpIR = Opts.DumpIR;
+  const bool IsAArch64 = Opts.TargetArch == "aarch64";
+
+  std::vector<Function *> Functions;
+  for (auto &F : IRModule.GetFunctions())
+    if (!F.IsDeclarationOnly())
+      Functions.push_back(&F);
+
+  // There is no use of more threads than functions
+  ThreadPool Pool(
+      std::min<size_t>(Opts.Jobs, std::max<size_t>(Functions.size(), 1)));
+
+  std::vector<std::string> Assembly(Functions.size());
+
+  // The keys are taken from the unoptimized IR, so the cache has to be
+  // checked before anything else
+  std::vector<std::string> CacheKeys(Functions.size());
+  std::vector<char> IsCached(Functions.size());
+  if (Opts.Cache) {
+    CompileCache::FunctionMap FunctionsByName;
+    for (auto &F : IRModule.GetFunctions())
+      FunctionsByName[F.GetName()] = &F;
+
+    for (size_t i = 0; i < Functions.size(); i++)
+      Pool.Async([&, i] {
+        TimeScope Scope("codegen", "CacheLookup",
+                        Functions[i]->GetName().Str());
+        CacheKeys[i] = Opts.Cache->GetKey(*Functions[i], FunctionsByName);
+        IsCached[i] = Opts.Cache->Lookup(CacheKeys[i], i, Assembly[i]);
+      });
+    Pool.Wait();
+  }
 
-  for (int i = 0; i < argc; i++)
-    if (argv[i][0] != '-')
-      FilePath = std::string(argv[i]);
-    else {
-      if (!std::string(&argv[i][1]).compare("llir-opt")) {
-        RunLLIROpt = true;
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("copy-propagation")) {
-        RequestedOptimizations.insert(Optimization::CopyPropagation);
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("cse")) {
-        RequestedOptimizations.insert(Optimization::CopyPropagation);
-        RequestedOptimizations.insert(Optimization::CSE);
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("O")) {
-        RequestedOptimizations.insert(Optimization::CopyPropagation);
-        RequestedOptimizations.insert(Optimization::CSE);
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("E")) {
-        DumpPreProcessedFile = true;
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("Wall")) {
-        Wall = true;
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("dump-tokens")) {
-        DumpTokens = true;
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("dump-ast")) {
-        DumpAST = true;
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("dump-ir")) {
-        DumpIR = true;
-        continue;
-      } else if (!std::string(&argv[i][1]).compare("print-before-passes")) {
-        PrintBeforePasses = true;
-        continue;
-      } else if (!std::string(&argv[i][1]).compare(0, 5, "arch=")) {
-        TargetArch = std::string(&argv[i][6]);
-        continue;
-      } else {
-        std::cerr << "Error: Unknown argument '" << argv[i] << "'" << std::endl;
-        return -1;
+  // The dumped IR has to be the optimized one, so in that case the
+  // optimizations have to be finished everywhere before the rest can start
+  if (Optimize && DumpIR) {
+    for (auto &F : IRModule.GetFunctions())
+      Pool.Async([&, FPtr = &F] {
+        PassManager(&IRModule, Optimizations).RunOnFunction(*FPtr);
+      });
+    Pool.Wait();
+  }
+
+  if (DumpIR)
+    IRModule.Print();
+
+  // The machine functions are created upfront, so the tasks do not modify
+  // the module, only their own function
+  MachineIRModule LLIRModule;
+  LLIRModule.GetFunctions().resize(Functions.size());
+
+  for (size_t i = 0; i < Functions.size(); i++) {
+    if (IsCached[i])
+      continue;
+
+    Pool.Async([&, i] {
+      auto &F = *Functions[i];
+      auto &MFunc = LLIRModule.GetFunctions()[i];
+      TimeScope Scope("function", F.GetName().Str());
+
+      if (Optimize && !DumpIR)
+        PassManager(&IRModule, Optimizations).RunOnFunction(F);
+
+      IRtoLLIR(IRModule, &LLIRModule, TM).GenerateLLIRFromFunction(F, &MFunc);
+      if (Opts.RunLLIROpt)
+        LLIROptimizer(&LLIRModule, TM).RunOnFunction(MFunc);
+      MachineInstructionLegalizer(&LLIRModule, TM).RunOnFunction(MFunc);
+      RegisterClassSelection(&LLIRModule, TM).RunOnFunction(MFunc);
+      InsturctionSelection(&LLIRModule, TM).RunOnFunction(MFunc);
+      RegisterAllocator(&LLIRModule, TM).RunOnFunction(MFunc);
+      PrologueEpilogInsertion(&LLIRModule, TM).RunOnFunction(MFunc);
+      if (IsAArch64)
+        AArch64XRegToWRegFixPass(&LLIRModule, TM).RunOnFunction(MFunc);
+
+      std::ostringstream FunctionOS;
+      AssemblyEmitter(&LLIRModule, TM).EmitFunction(MFunc, i, FunctionOS);
+      Assembly[i] = FunctionOS.str();
+
+      if (Opts.Cache) {
+        TimeScope StoreScope("codegen", "CacheStore", F.GetName().Str());
+        Opts.Cache->Store(CacheKeys[i], i, Assembly[i]);
       }
-    }
+    });
+  }
+  Pool.Wait();
+
+  IRtoLLIR(IRModule, &LLIRModule, TM).GenerateGlobalData();
 
-  if (DumpTokens) {
-    std::vector<std::string> src;
-    getFileContent(FilePath.c_str(), src);
+  for (auto &FunctionAssembly : Assembly)
+    OS << FunctionAssembly;
+  AssemblyEmitter(&LLIRModule, TM).EmitGlobalData(OS);
+}
+
+/// Compile @FilePath and print its assembly to @OS. The dumps go to the
+/// standard output. Return 0 on success.
+static int CompileFile(const std::string &FilePath, const DriverOptions &Opts,
+                       TargetMachine *TM, std::ostream &OS) {
+  TimeScope FileScope("file", FilePath);
+  SourceManager SM(&FileCache::Get());
+
+  if (Opts.DumpTokens) {
+    auto FileBuffer = SM.GetFileBuffer(FilePath);
+    if (!FileBuffer) {
+      std::cerr << "Cannot open the File : " << FilePath << std::endl;
+      FileBuffer = SM.CreateBuffer(FilePath, "");
+    }
 
-    Lexer lexer(src);
+    Lexer lexer(*FileBuffer);
 
     auto t1 = lexer.Lex();
     while (t1.GetKind() != Token::EndOfFile && t1.GetKind() != Token::Invalid) {
-      std::cout << t1.ToString() << std::endl;
+      std::cout << t1.ToString(*FileBuffer) << std::endl;
       t1 = lexer.Lex();
     }
   }
 
-  std::vector<std::string> src;
-  auto Success = getFileContent(FilePath.c_str(), src);
-  assert(Success && "Unable to open file");
-
-  PreProcessor(src, FilePath).Run();
-
-  if (DumpPreProcessedFile) {
-    for (auto &Line : src)
-      std::cout << Line << std::endl;
-    std::cout << std::endl;
+  // The precompiled header is mapped into memory by the source manager, the
+  // reader refers into it
+  std::unique_ptr<PCHReader> PCH;
+  if (!Opts.PCHPath.empty())
+    if (auto PCHBuffer = SM.GetFileBuffer(Opts.PCHPath))
+      PCH = std::make_unique<PCHReader>(PCHBuffer->GetBuffer());
+
+  auto ReportInvalidPCH = [&]() {
+    std::lock_guard<std::mutex> Guard(DiagnosticsLock);
+    std::cerr << "Error: The precompiled header '" << Opts.PCHPath
+              << "' is missing, invalid or out of date" << std::endl;
+    return 1;
+  };
+
+  PreProcessor PP(SM, FilePath);
+  SourceBuffer *Source;
+  {
+    TimeScope Scope("frontend", "PreProcessor", FilePath);
+    if (!Opts.PCHPath.empty() && (!PCH || !PP.ReadPCH(*PCH)))
+      return ReportInvalidPCH();
+
+    Source = PP.Run();
   }
 
-  std::unique_ptr<TargetMachine> TM;
+  if (!Source) {
+    std::lock_guard<std::mutex> Guard(DiagnosticsLock);
+    std::cerr << "Error: Cannot open the file '" << FilePath << "'"
+              << std::endl;
+    return 1;
+  }
 
-  if (TargetArch == "riscv32")
-    TM = std::make_unique<RISCV::RISCVTargetMachine>();
-  else
-    TM = std::make_unique<AArch64::AArch64TargetMachine>();
+  if (Opts.DumpPreProcessedFile)
+    std::cout << Source->GetBuffer() << std::endl;
 
   Module IRModule;
-  IRFactory IRF(IRModule, TM.get());
-  ErrorLogger ErrorLog(FilePath, src);
-  Parser parser(src, &IRF, ErrorLog);
-  auto AST = parser.Parse();
+  IRFactory IRF(IRModule, TM);
+  ErrorLogger ErrorLog(FilePath, *Source);
+  ASTContext ASTCtx;
+  Parser parser(*Source, ASTCtx, &IRF, ErrorLog);
+  Node *AST;
+  {
+    TimeScope Scope("frontend", "Parser", FilePath);
+    if (PCH && !parser.ReadPCH(*PCH))
+      return ReportInvalidPCH();
+    AST = parser.Parse();
+  }
 
-  if (ErrorLog.HasErrors(Wall)) {
+  if (ErrorLog.HasErrors(Opts.Wall)) {
+    std::lock_guard<std::mutex> Guard(DiagnosticsLock);
     ErrorLog.ReportErrors();
-    exit(1);
+    return 1;
   }
 
-  if (DumpAST) {
+  if (Opts.DumpAST) {
     auto AstPrinter = std::make_unique<ASTPrint>();
     AST->Accept(AstPrinter.get());
   }
 
   // Do semantic analysis on the AST
-  auto Sema = std::make_unique<Semantics>(ErrorLog);
-  AST->Accept(Sema.get());
+  {
+    TimeScope Scope("frontend", "Semantics", FilePath);
+    auto Sema = std::make_unique<Semantics>(ErrorLog);
+    AST->Accept(Sema.get());
+  }
 
-  if (ErrorLog.HasErrors(Wall)) {
+  if (ErrorLog.HasErrors(Opts.Wall)) {
+    std::lock_guard<std::mutex> Guard(DiagnosticsLock);
     ErrorLog.ReportErrors();
-    exit(1);
+    return 1;
   }
 
-  AST->IRCodegen(&IRF);
+  {
+    TimeScope Scope("frontend", "IRCodegen", FilePath);
+    AST->IRCodegen(&IRF);
+  }
 
-  const bool Optimize = !RequestedOptimizations.empty();
+  // Printing the module between the backend passes needs every function to be
+  // at the same stage, therefore that is only done on a single thread. The
+  // cache works on individual functions, so it needs the parallel pipeline
+  // even if there is only one job.
+  if ((Opts.Jobs > 1 || Opts.Cache) && !Opts.PrintBeforePasses) {
+    CompileInParallel(IRModule, TM, Opts, OS);
+    return 0;
+  }
+
+  const bool Optimize = !Opts.RequestedOptimizations.empty();
   if (Optimize) {
-    PassManager PM(&IRModule, RequestedOptimizations);
+    PassManager PM(&IRModule, Opts.RequestedOptimizations);
     PM.RunAll();
   }
 
-  if (DumpIR)
+  if (Opts.DumpIR)
     IRModule.Print();
 
   MachineIRModule LLIRModule;
-  IRtoLLIR I2LLIR(IRModule, &LLIRModule, TM.get());
+  IRtoLLIR I2LLIR(IRModule, &LLIRModule, TM);
   I2LLIR.GenerateLLIRFromIR();
 
-  if (PrintBeforePasses) {
-    if (RunLLIROpt)
+  if (Opts.PrintBeforePasses) {
+    if (Opts.RunLLIROpt)
       std::cout << "<<<<< Before LLIR Optimizer >>>>>" << std::endl
                 << std::endl;
     else
       std::cout << "<<<<< Before Legalizer >>>>>" << std::endl << std::endl;
-    LLIRModule.Print(TM.get());
+    LLIRModule.Print(TM);
     std::cout << std::endl;
   }
 
-  if (RunLLIROpt) {
-    LLIROptimizer LLIROpt(&LLIRModule, TM.get());
+  if (Opts.RunLLIROpt) {
+    LLIROptimizer LLIROpt(&LLIRModule, TM);
     LLIROpt.Run();
 
-    if (PrintBeforePasses) {
+    if (Opts.PrintBeforePasses) {
       std::cout << "<<<<< Before Legalizer >>>>>" << std::endl << std::endl;
-      LLIRModule.Print(TM.get());
+      LLIRModule.Print(TM);
       std::cout << std::endl;
     }
   }
 
-  MachineInstructionLegalizer Legalizer(&LLIRModule, TM.get());
+  MachineInstructionLegalizer Legalizer(&LLIRModule, TM);
   Legalizer.Run();
 
-  if (PrintBeforePasses) {
+  if (Opts.PrintBeforePasses) {
     std::cout << "<<<<< Before Register Class Selection >>>>>" << std::endl
               << std::endl;
-    LLIRModule.Print(TM.get());
+    LLIRModule.Print(TM);
     std::cout << std::endl;
   }
 
-  RegisterClassSelection RCS(&LLIRModule, TM.get());
+  RegisterClassSelection RCS(&LLIRModule, TM);
   RCS.Run();
 
-  if (PrintBeforePasses) {
+  if (Opts.PrintBeforePasses) {
     std::cout << "<<<<< Before Instruction Selection >>>>>" << std::endl
               << std::endl;
-    LLIRModule.Print(TM.get());
+    LLIRModule.Print(TM);
     std::cout << std::endl;
   }
 
-  InsturctionSelection IS(&LLIRModule, TM.get());
+  InsturctionSelection IS(&LLIRModule, TM);
   IS.InstrSelect();
 
-  if (PrintBeforePasses) {
+  if (Opts.PrintBeforePasses) {
     std::cout << "<<<<< Before Register Allocation >>>>>" << std::endl
               << std::endl;
-    LLIRModule.Print(TM.get());
+    LLIRModule.Print(TM);
     std::cout << std::endl;
   }
 
-  RegisterAllocator RA(&LLIRModule, TM.get());
+  RegisterAllocator RA(&LLIRModule, TM);
   RA.RunRA();
 
-  if (PrintBeforePasses) {
+  if (Opts.PrintBeforePasses) {
     std::cout << "<<<<< Before Prologue/Epilog Insertion >>>>>" << std::endl
               << std::endl;
-    LLIRModule.Print(TM.get());
+    LLIRModule.Print(TM);
     std::cout << std::endl;
   }
-  PrologueEpilogInsertion PEI(&LLIRModule, TM.get());
+  PrologueEpilogInsertion PEI(&LLIRModule, TM);
   PEI.Run();
 
-  if (TargetArch == "aarch64")
-    AArch64XRegToWRegFixPass(&LLIRModule, TM.get()).Run();
+  if (Opts.TargetArch == "aarch64")
+    AArch64XRegToWRegFixPass(&LLIRModule, TM).Run();
 
-  if (PrintBeforePasses) {
+  if (Opts.PrintBeforePasses) {
     std::cout << "<<<<< Before Emitting Assembly >>>>>" << std::endl
               << std::endl;
-    LLIRModule.Print(TM.get());
+    LLIRModule.Print(TM);
     std::cout << std::endl;
   }
 
-  AssemblyEmitter AE(&LLIRModule, TM.get());
-  AE.GenerateAssembly();
+  AssemblyEmitter AE(&LLIRModule, TM);
+  AE.GenerateAssembly(OS);
+
+  return 0;
+}
+
+/// Preprocess and parse the header at @HeaderPath and save the resulting
+/// state into @OutputPath, so it can be used by -include-pch. Return 0 on
+/// success.
+static int EmitPrecompiledHeader(const std::string &HeaderPath,
+                                 const std::string &OutputPath) {
+  SourceManager SM(&FileCache::Get());
+  PreProcessor PP(SM, HeaderPath);
+
+  auto Source = PP.Run();
+  if (!Source) {
+    std::cerr << "Error: Cannot open the file '" << HeaderPath << "'"
+              << std::endl;
+    return 1;
+  }
+
+  ErrorLogger ErrorLog(HeaderPath, *Source);
+  ASTContext ASTCtx;
+  Parser parser(*Source, ASTCtx, nullptr, ErrorLog);
+  auto TU = dynamic_cast<TranslationUnit *>(parser.Parse());
+
+  if (ErrorLog.HasErrors()) {
+    ErrorLog.ReportErrors();
+    return 1;
+  }
+
+  PCHWriter W;
+  PP.WritePCH(W, *Source);
+  if (!TU || !parser.WritePCH(W, *TU)) {
+    std::cerr << "Error: The header '" << HeaderPath
+              << "' can only have type and function declarations to be "
+                 "precompiled"
+              << std::endl;
+    return 1;
+  }
+
+  std::ofstream OS(OutputPath, std::ios::binary);
+  OS << W.GetBuffer();
+  OS.close();
+  if (!OS) {
+    std::cerr << "Error: Cannot write the file '" << OutputPath << "'"
+              << std::endl;
+    std::filesystem::remove(OutputPath);
+    return 1;
+  }
 
   return 0;
 }
+
+/// Decide where the assembly of each input goes, an empty path means the
+/// standard output. A single input is printed to the standard output, or
+/// written to @OutputPath if it is given. Multiple inputs are written to
+/// "<name>.s" files, into the @OutputPath directory if it is given, or into the
+/// current directory otherwise. A single input is written into @OutputPath as
+/// well if it is an existing directory.
+static bool GetOutputPaths(const std::vector<std::string> &InputFiles,
+                           const std::string &OutputPath,
+                           std::vector<std::string> &OutputPaths) {
+  namespace fs = std::filesystem;
+
+  const bool ToDirectory =
+      InputFiles.size() > 1 ||
+      (!OutputPath.empty() && fs::is_directory(OutputPath));
+
+  if (!ToDirectory) {
+    OutputPaths.push_back(OutputPath == "-" ? "" : OutputPath);
+    return true;
+  }
+
+  fs::path Directory(OutputPath);
+  if (!OutputPath.empty()) {
+    std::error_code EC;
+    fs::create_directories(Directory, EC);
+    if (EC) {
+      std::cerr << "Error: Cannot create the output directory '" << OutputPath
+                << "': " << EC.message() << std::endl;
+      return false;
+    }
+  }
+
+  std::set<std::string> UsedPaths;
+  for (auto &InputFile : InputFiles) {
+    auto Name = fs::path(InputFile).filename().replace_extension(".s");
+    auto Path = (Directory / Name).string();
+
+    if (!UsedPaths.insert(Path).second) {
+      std::cerr << "Error: Multiple inputs would be written to '" << Path
+                << "'" << std::endl;
+      return false;
+    }
+    OutputPaths.push_back(Path);
+  }
+
+  return true;
+}
+
+/// Compile @InputFile into @OutputPath, or to the standard output if the path
+/// is empty. The output file is removed if the compilation fails.
+static int CompileToFile(const std::string &InputFile,
+                         const std::string &OutputPath,
+                         const DriverOptions &Opts, TargetMachine *TM) {
+  if (OutputPath.empty())
+    return CompileFile(InputFile, Opts, TM, std::cout);
+
+  std::ofstream OS(OutputPath);
+  if (!OS) {
+    std::lock_guard<std::mutex> Guard(DiagnosticsLock);
+    std::cerr << "Error: Cannot open the output file '" << OutputPath << "'"
+              << std::endl;
+    return 1;
+  }
+
+  const int Result = CompileFile(InputFile, Opts, TM, OS);
+  OS.close();
+
+  if (Result != 0)
+    std::filesystem::remove(OutputPath);
+
+  return Result;
+}
+
+/// Return the target machine of @Arch. The target machines are created on
+/// the first use and kept for the lifetime of the process, which spares
+/// building the target tables again for every request of the compile server.
+static TargetMachine *GetTargetMachine(const std::string &Arch) {
+  static std::mutex Lock;
+  static std::map<std::string, std::unique_ptr<TargetMachine>> TargetMachines;
+
+  std::lock_guard<std::mutex> Guard(Lock);
+  auto &TM = TargetMachines[Arch];
+  if (!TM) {
+    if (Arch == "riscv32")
+      TM = std::make_unique<RISCV::RISCVTargetMachine>();
+    else
+      TM = std::make_unique<AArch64::AArch64TargetMachine>();
+  }
+
+  return TM.get();
+}
+
+/// Compile according to the command line arguments @Args, without the name of
+/// the program. Return the exit code.
+/// TODO: Make a proper driver
+static int RunDriver(const std::vector<std::string> &Args) {
+  DriverOptions Opts;
+  std::vector<std::string> InputFiles;
+  std::string OutputPath;
+  std::string CacheDir;
+  bool PrintCacheStats = false;
+  bool EmitPCH = false;
+  bool TimeReport = false;
+  /// Empty if the statistics are not printed, otherwise "text" or "json".
+  std::string StatsFormat;
+  std::string TimeTracePath;
+
+  for (size_t i = 0; i < Args.size(); i++)
+    if (Args[i][0] != '-')
+      InputFiles.push_back(Args[i]);
+    else {
+      if (!Args[i].substr(1).compare("llir-opt")) {
+        Opts.RunLLIROpt = true;
+        continue;
+      } else if (!Args[i].substr(1).compare("copy-propagation")) {
+        Opts.RequestedOptimizations.insert(Optimization::CopyPropagation);
+        continue;
+      } else if (!Args[i].substr(1).compare("cse")) {
+        Opts.RequestedOptimizations.insert(Optimization::CopyPropagation);
+        Opts.RequestedOptimizations.insert(Optimization::CSE);
+        continue;
+      } else if (!Args[i].substr(1).compare("O")) {
+        Opts.RequestedOptimizations.insert(Optimization::CopyPropagation);
+        Opts.RequestedOptimizations.insert(Optimization::CSE);
+        continue;
+      } else if (!Args[i].substr(1).compare("E")) {
+        Opts.DumpPreProcessedFile = true;
+        continue;
+      } else if (!Args[i].substr(1).compare("Wall")) {
+        Opts.Wall = true;
+        continue;
+      } else if (!Args[i].substr(1).compare("dump-tokens")) {
+        Opts.DumpTokens = true;
+        continue;
+      } else if (!Args[i].substr(1).compare("dump-ast")) {
+        Opts.DumpAST = true;
+        continue;
+      } else if (!Args[i].substr(1).compare("dump-ir")) {
+        Opts.DumpIR = true;
+        continue;
+      } else if (!Args[i].substr(1).compare("print-before-passes")) {
+        Opts.PrintBeforePasses = true;
+        continue;
+      } else if (!Args[i].substr(1).compare(0, 5, "arch=")) {
+        Opts.TargetArch = Args[i].substr(6);
+        continue;
+      } else if (!Args[i].substr(1).compare(0, 10, "cache-dir=")) {
+        CacheDir = Args[i].substr(11);
+        continue;
+      } else if (!Args[i].substr(1).compare("cache-stats")) {
+        PrintCacheStats = true;
+        continue;
+      } else if (!Args[i].substr(1).compare("ftime-report")) {
+        TimeReport = true;
+        continue;
+      } else if (!Args[i].substr(1).compare(0, 12, "ftime-trace=")) {
+        TimeTracePath = Args[i].substr(13);
+        if (TimeTracePath.empty()) {
+          std::cerr << "Error: Missing file name after '-ftime-trace='"
+                    << std::endl;
+          return -1;
+        }
+        continue;
+      } else if (!Args[i].substr(1).compare("stats")) {
+        StatsFormat = "text";
+        continue;
+      } else if (!Args[i].substr(1).compare(0, 6, "stats=")) {
+        StatsFormat = Args[i].substr(7);
+        if (StatsFormat != "text" && StatsFormat != "json") {
+          std::cerr << "Error: Unknown statistics format '" << StatsFormat
+                    << "', expected 'text' or 'json'" << std::endl;
+          return -1;
+        }
+        continue;
+      } else if (!Args[i].substr(1).compare("emit-pch")) {
+        EmitPCH = true;
+        continue;
+      } else if (!Args[i].substr(1).compare("include-pch")) {
+        if (i + 1 >= Args.size()) {
+          std::cerr << "Error: Missing file name after '-include-pch'"
+                    << std::endl;
+          return -1;
+        }
+        Opts.PCHPath = Args[++i];
+        continue;
+      } else if (!Args[i].substr(1).compare("o")) {
+        if (i + 1 >= Args.size()) {
+          std::cerr << "Error: Missing file name after '-o'" << std::endl;
+          return -1;
+        }
+        OutputPath = Args[++i];
+        continue;
+      } else if (Args[i][1] == 'j') {
+        // both "-j N" and "-jN" are accepted
+        const char *JobsStr = Args[i][2] ? &Args[i][2]
+                              : i + 1 < Args.size() ? Args[++i].c_str() : "";
+        char *End = nullptr;
+        const long N = std::strtol(JobsStr, &End, 10);
+        if (End == JobsStr || *End != '\0' || N < 1) {
+          std::cerr << "Error: Invalid number of jobs '" << JobsStr << "'"
+                    << std::endl;
+          return -1;
+        }
+        Opts.Jobs = N;
+        continue;
+      } else {
+        std::cerr << "Error: Unknown argument '" << Args[i] << "'" << std::endl;
+        return -1;
+      }
+    }
+
+  if (InputFiles.empty())
+    InputFiles.push_back("tests/test.txt");
+
+  if (EmitPCH) {
+    if (InputFiles.size() != 1) {
+      std::cerr << "Error: -emit-pch expects a single header" << std::endl;
+      return -1;
+    }
+    return EmitPrecompiledHeader(InputFiles[0], OutputPath.empty()
+                                                    ? InputFiles[0] + ".pch"
+                                                    : OutputPath);
+  }
+
+  std::vector<std::string> OutputPaths;
+  if (!GetOutputPaths(InputFiles, OutputPath, OutputPaths))
+    return -1;
+
+  // The target tables are only read during the compilation, so a single
+  // target machine is shared by every input
+  auto TM = GetTargetMachine(Opts.TargetArch);
+
+  // Everything which affects the generated code of a function, besides the
+  // function itself
+  std::unique_ptr<CompileCache> Cache;
+  if (!CacheDir.empty()) {
+    std::string CacheOptions = "arch=" + Opts.TargetArch + " opts=";
+    for (auto Opt : Opts.RequestedOptimizations)
+      CacheOptions += std::to_string(static_cast<int>(Opt)) + ",";
+    if (Opts.RunLLIROpt)
+      CacheOptions += " llir-opt";
+
+    Cache = std::make_unique<CompileCache>(CacheDir, CacheOptions);
+    Opts.Cache = Cache.get();
+  }
+
+  std::vector<int> Results(InputFiles.size());
+
+  // The counters are process wide, they have to be cleared from the previous
+  // requests of the compile server
+  auto &Statistics = StatisticRegistry::Get();
+  if (!StatsFormat.empty())
+    Statistics.ResetAll();
+
+  auto &Profiler = TimeProfiler::Get();
+  if (TimeReport || !TimeTracePath.empty())
+    Profiler.Start();
+
+  // The dumps would be interleaved, so in that case the files are compiled
+  // one after the other
+  if (InputFiles.size() == 1 || Opts.Jobs == 1 || Opts.HasDumps()) {
+    for (size_t i = 0; i < InputFiles.size(); i++)
+      Results[i] = CompileToFile(InputFiles[i], OutputPaths[i], Opts, TM);
+  } else {
+    // Each file is compiled on its own thread, and its functions one after
+    // the other on the same thread
+    DriverOptions FileOpts = Opts;
+    FileOpts.Jobs = 1;
+
+    ThreadPool Pool(std::min<size_t>(Opts.Jobs, InputFiles.size()));
+    for (size_t i = 0; i < InputFiles.size(); i++)
+      Pool.Async([&, i] {
+        Results[i] = CompileToFile(InputFiles[i], OutputPaths[i], FileOpts, TM);
+      });
+    Pool.Wait();
+  }
+
+  if (Profiler.IsEnabled()) {
+    Profiler.Stop();
+
+    if (TimeReport)
+      Profiler.PrintReport();
+
+    if (!TimeTracePath.empty() && !Profiler.WriteTrace(TimeTracePath)) {
+      std::cerr << "Error: Cannot write the time trace '" << TimeTracePath
+                << "'" << std::endl;
+      return 1;
+    }
+  }
+
+  if (StatsFormat == "text")
+    Statistics.PrintText();
+  else if (StatsFormat == "json")
+    Statistics.PrintJSON();
+
+  if (PrintCacheStats) {
+    if (Cache)
+      Cache->PrintStatistics();
+    else
+      std::cerr << "Function cache: disabled, use -cache-dir=<dir>"
+                << std::endl;
+  }
+
+  for (auto Result : Results)
+    if (Result != 0)
+      return 1;
+
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  std::vector<std::string> Args(argv + 1, argv + argc);
+
+  if (!Args.empty() && Args[0] == "--server") {
+    if (Args.size() != 2) {
+      std::cerr << "Usage: " << argv[0] << " --server <socket>" << std::endl;
+      return -1;
+    }
+    return CompileServer::Serve(Args[1], RunDriver);
+  }
+
+  if (!Args.empty() && Args[0] == "--connect") {
+    if (Args.size() < 2) {
+      std::cerr << "Usage: " << argv[0] << " --connect <socket> [args...]"
+                << std::endl;
+      return -1;
+    }
+    return CompileServer::SendRequest(Args[1], {Args.begin() + 2, Args.end()});
+  }
+
+  return RunDriver(Args);
+}
@@ -0,0 +1,263 @@
+#include "CharScanner.hpp"
+
+#if defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+#define HAS_X86_SIMD
+#include <immintrin.h>
+#endif
+
+static bool IsWhitespace(char C) {
+  return C == ' ' || (C >= '\t' && C <= '\r') || C == '\0';
+}
+
+static bool IsIdentifierChar(char C) {
+  return (C >= 'a' && C <= 'z') || (C >= 'A' && C <= 'Z') ||
+         (C >= '0' && C <= '9') || C == '_';
+}
+
+static size_t SkipWhitespacesScalar(std::string_view Src, size_t Pos) {
+  while (Pos < Src.size() && IsWhitespace(Src[Pos]))
+    Pos++;
+  return Pos;
+}
+
+static size_t SkipIdentifierCharsScalar(std::string_view Src, size_t Pos) {
+  while (Pos < Src.size() && IsIdentifierChar(Src[Pos]))
+    Pos++;
+  return Pos;
+}
+
+static size_t FindEitherCharScalar(std::string_view Src, size_t Pos, char C1,
+                                   char C2) {
+  while (Pos < Src.size() && Src[Pos] != C1 && Src[Pos] != C2)
+    Pos++;
+  return Pos;
+}
+
+#ifdef HAS_X86_SIMD
+
+// The vectorized versions process full chunks only, the remaining tail is
+// handled by the scalar versions, so nothing is read past the buffer.
+//
+// Character ranges are checked with the unsigned "(C - Low) <= (High - Low)"
+// trick, where the comparison is done by min(X, Limit) == X since there is no
+// unsigned byte comparison instruction.
+
+static __m128i InRangeSSE2(__m128i Chunk, char Low, char High) {
+  auto Offset = _mm_sub_epi8(Chunk, _mm_set1_epi8(Low));
+  auto Limited = _mm_min_epu8(Offset, _mm_set1_epi8(High - Low));
+  return _mm_cmpeq_epi8(Limited, Offset);
+}
+
+static size_t SkipWhitespacesSSE2(std::string_view Src, size_t Pos) {
+  for (; Pos + 16 <= Src.size(); Pos += 16) {
+    auto Chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Src.data() + Pos));
+
+    auto IsSpace = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(Chunk, _mm_set1_epi8(' ')),
+                     _mm_cmpeq_epi8(Chunk, _mm_setzero_si128())),
+        InRangeSSE2(Chunk, '\t', '\r'));
+
+    unsigned NonSpaceMask = ~_mm_movemask_epi8(IsSpace) & 0xFFFF;
+    if (NonSpaceMask)
+      return Pos + __builtin_ctz(NonSpaceMask);
+  }
+
+  return SkipWhitespacesScalar(Src, Pos);
+}
+
+static size_t SkipIdentifierCharsSSE2(std::string_view Src, size_t Pos) {
+  for (; Pos + 16 <= Src.size(); Pos += 16) {
+    auto Chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Src.data() + Pos));
+
+    // setting the 0x20 bit maps the upper case letters to lower case ones
+    auto Lowered = _mm_or_si128(Chunk, _mm_set1_epi8(0x20));
+    auto IsIdChar = _mm_or_si128(
+        _mm_or_si128(InRangeSSE2(Lowered, 'a', 'z'),
+                     InRangeSSE2(Chunk, '0', '9')),
+        _mm_cmpeq_epi8(Chunk, _mm_set1_epi8('_')));
+
+    unsigned NonIdMask = ~_mm_movemask_epi8(IsIdChar) & 0xFFFF;
+    if (NonIdMask)
+      return Pos + __builtin_ctz(NonIdMask);
+  }
+
+  return SkipIdentifierCharsScalar(Src, Pos);
+}
+
+static size_t FindEitherCharSSE2(std::string_view Src, size_t Pos, char C1,
+                                 char C2) {
+  const auto Pattern1 = _mm_set1_epi8(C1);
+  const auto Pattern2 = _mm_set1_epi8(C2);
+
+  for (; Pos + 16 <= Src.size(); Pos += 16) {
+    auto Chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(Src.data() + Pos));
+
+    unsigned Mask = _mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(Chunk, Pattern1), _mm_cmpeq_epi8(Chunk, Pattern2)));
+    if (Mask)
+      return Pos + __builtin_ctz(Mask);
+  }
+
+  return FindEitherCharScalar(Src, Pos, C1, C2);
+}
+
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+
+AVX2_FUNCTION static __m256i InRangeAVX2(__m256i Chunk, char Low, char High) {
+  auto Offset = _mm256_sub_epi8(Chunk, _mm256_set1_epi8(Low));
+  auto Limited = _mm256_min_epu8(Offset, _mm256_set1_epi8(High - Low));
+  return _mm256_cmpeq_epi8(Limited, Offset);
+}
+
+AVX2_FUNCTION static size_t SkipWhitespacesAVX2(std::string_view Src,
+                                                size_t Pos) {
+  for (; Pos + 32 <= Src.size(); Pos += 32) {
+    auto Chunk = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(Src.data() + Pos));
+
+    auto IsSpace = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8(' ')),
+                        _mm256_cmpeq_epi8(Chunk, _mm256_setzero_si256())),
+        InRangeAVX2(Chunk, '\t', '\r'));
+
+    unsigned NonSpaceMask =
+        ~static_cast<unsigned>(_mm256_movemask_epi8(IsSpace));
+    if (NonSpaceMask)
+      return Pos + __builtin_ctz(NonSpaceMask);
+  }
+
+  return SkipWhitespacesSSE2(Src, Pos);
+}
+
+AVX2_FUNCTION static size_t SkipIdentifierCharsAVX2(std::string_view Src,
+                                                    size_t Pos) {
+  for (; Pos + 32 <= Src.size(); Pos += 32) {
+    auto Chunk = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(Src.data() + Pos));
+
+    auto Lowered = _mm256_or_si256(Chunk, _mm256_set1_epi8(0x20));
+    auto IsIdChar = _mm256_or_si256(
+        _mm256_or_si256(InRangeAVX2(Lowered, 'a', 'z'),
+                        InRangeAVX2(Chunk, '0', '9')),
+        _mm256_cmpeq_epi8(Chunk, _mm256_set1_epi8('_')));
+
+    unsigned NonIdMask =
+        ~static_cast<unsigned>(_mm256_movemask_epi8(IsIdChar));
+    if (NonIdMask)
+      return Pos + __builtin_ctz(NonIdMask);
+  }
+
+  return SkipIdentifierCharsSSE2(Src, Pos);
+}
+
+AVX2_FUNCTION static size_t FindEitherCharAVX2(std::string_view Src,
+                                               size_t Pos, char C1, char C2) {
+  const auto Pattern1 = _mm256_set1_epi8(C1);
+  const auto Pattern2 = _mm256_set1_epi8(C2);
+
+  for (; Pos + 32 <= Src.size(); Pos += 32) {
+    auto Chunk = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(Src.data() + Pos));
+
+    unsigned Mask = _mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, Pattern1),
+                        _mm256_cmpeq_epi8(Chunk, Pattern2)));
+    if (Mask)
+      return Pos + __builtin_ctz(Mask);
+  }
+
+  return FindEitherCharSSE2(Src, Pos, C1, C2);
+}
+
+#endif // HAS_X86_SIMD
+
+static bool IsSupported(CharScanner::Implementation Kind) {
+  switch (Kind) {
+  case CharScanner::Scalar:
+    return true;
+#ifdef HAS_X86_SIMD
+  case CharScanner::SSE2:
+    return __builtin_cpu_supports("sse2");
+  case CharScanner::AVX2:
+    return __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+const CharScanner::ImplementationInfo *
+CharScanner::GetInfo(Implementation Kind) {
+  static const ImplementationInfo ScalarInfo = {
+      Scalar, SkipWhitespacesScalar, SkipIdentifierCharsScalar,
+      FindEitherCharScalar};
+#ifdef HAS_X86_SIMD
+  static const ImplementationInfo SSE2Info = {
+      SSE2, SkipWhitespacesSSE2, SkipIdentifierCharsSSE2, FindEitherCharSSE2};
+  static const ImplementationInfo AVX2Info = {
+      AVX2, SkipWhitespacesAVX2, SkipIdentifierCharsAVX2, FindEitherCharAVX2};
+
+  if (Kind == AVX2)
+    return &AVX2Info;
+  if (Kind == SSE2)
+    return &SSE2Info;
+#endif
+  return &ScalarInfo;
+}
+
+static CharScanner::Implementation GetBestImplementation() {
+  if (IsSupported(CharScanner::AVX2))
+    return CharScanner::AVX2;
+  if (IsSupported(CharScanner::SSE2))
+    return CharScanner::SSE2;
+  return CharScanner::Scalar;
+}
+
+const CharScanner::ImplementationInfo *CharScanner::Impl =
+    CharScanner::GetInfo(GetBestImplementation());
+
+bool CharScanner::SetImplementation(Implementation Kind) {
+  if (!IsSupported(Kind))
+    return false;
+
+  Impl = GetInfo(Kind);
+  return true;
+}
+
+const char *CharScanner::ToString(Implementation Kind) {
+  switch (Kind) {
+  case Scalar:
+    return "scalar";
+  case SSE2:
+    return "sse2";
+  case AVX2:
+    return "avx2";
+  }
+  return "unknown";
+}
+
+size_t CharScanner::FindBlockCommentEnd(std::string_view Src, size_t Pos) {
+  while (true) {
+    Pos = Impl->FindEitherChar(Src, Pos, '*', '*');
+    if (Pos + 1 >= Src.size())
+      return Src.size();
+    if (Src[Pos + 1] == '/')
+      return Pos;
+    Pos++;
+  }
+}
+
+size_t CharScanner::FindStringLiteralEnd(std::string_view Src, size_t Pos) {
+  while (true) {
+    Pos = Impl->FindEitherChar(Src, Pos, '"', '\\');
+    if (Pos >= Src.size() || Src[Pos] == '"')
+      return Pos;
+    // skip the escaped character
+    Pos += 2;
+    if (Pos >= Src.size())
+      return Src.size();
+  }
+}
@@ -0,0 +1,62 @@
+#ifndef CHAR_SCANNER_H
+#define CHAR_SCANNER_H
+
+#include <cstddef>
+#include <string_view>
+
+/// Finds the end of character runs in a contiguous buffer, used by the lexer
+/// to skip over whitespaces, identifiers, comments and string literals. On
+/// x86 the scanning is done 16 (SSE2) or 32 (AVX2) bytes at a time. The best
+/// implementation supported by the CPU is selected at startup, the scalar one
+/// is used everywhere else.
+///
+/// All functions take the buffer @Src and the starting position @Pos, and
+/// return a position in the [Pos, Src.size()] range.
+class CharScanner {
+public:
+  enum Implementation { Scalar, SSE2, AVX2 };
+
+  /// Return the first position which is not a whitespace or '\0'.
+  static size_t SkipWhitespaces(std::string_view Src, size_t Pos) {
+    // Most of the runs are a single space between two tokens, which is not
+    // worth a call into the vectorized version
+    if (Pos + 1 < Src.size() && Src[Pos] == ' ' && Src[Pos + 1] > ' ')
+      return Pos + 1;
+    return Impl->SkipWhitespaces(Src, Pos);
+  }
+
+  /// Return the first position which is not a letter, digit or '_'.
+  static size_t SkipIdentifierChars(std::string_view Src, size_t Pos) {
+    return Impl->SkipIdentifierChars(Src, Pos);
+  }
+
+  /// Return the position of the first "*/" or Src.size() if there is none.
+  static size_t FindBlockCommentEnd(std::string_view Src, size_t Pos);
+
+  /// Return the position of the first '"' which is not escaped by a '\' or
+  /// Src.size() if there is none. @Pos must be after the opening '"'.
+  static size_t FindStringLiteralEnd(std::string_view Src, size_t Pos);
+
+  static Implementation GetImplementation() { return Impl->Kind; }
+
+  /// Use the @Kind implementation from now on, used for benchmarking. Return
+  /// false if the CPU does not support it.
+  static bool SetImplementation(Implementation Kind);
+
+  static const char *ToString(Implementation Kind);
+
+private:
+  struct ImplementationInfo {
+    Implementation Kind;
+    size_t (*SkipWhitespaces)(std::string_view, size_t);
+    size_t (*SkipIdentifierChars)(std::string_view, size_t);
+    /// Find the first occurrence of either @C1 or @C2
+    size_t (*FindEitherChar)(std::string_view, size_t, char C1, char C2);
+  };
+
+  static const ImplementationInfo *GetInfo(Implementation Kind);
+
+  static const ImplementationInfo *Impl;
+};
+
+#endif
@@ -1,93 +1,144 @@
 #include "Lexer.hpp"
+#include "CharScanner.hpp"
 #include <cassert>
 #include <cctype>
 
-std::unordered_map<std::string, Token::TokenKind> Lexer::Keywords =
-    std::unordered_map<std::string, Token::TokenKind>{
-        {"const", Token::Const},
-        {"int", Token::Int},
-        {"short", Token::Short},
-        {"long", Token::Long},
-        {"float", Token::Float},
-        {"double", Token::Double},
-        {"unsigned", Token::Unsigned},
-        {"signed", Token::Signed},
-        {"void", Token::Void},
-        {"char", Token::Char},
-        {"if", Token::If},
-        {"switch", Token::Switch},
-        {"case", Token::Case},
-        {"default", Token::Default},
-        {"break", Token::Break},
-        {"else", Token::Else},
-        {"for", Token::For},
-        {"while", Token::While},
-        {"return", Token::Return},
-        {"do", Token::Do},
-        {"struct", Token::Struct},
-        {"sizeof", Token::Sizeof},
-        {"enum", Token::Enum},
-        {"typedef", Token::Typedef},
-        {"continue", Token::Continue},
-        {"_Bool", Token::Bool},
-        {"_Alignas", Token::Alignas},
-        {"_Alignof", Token::Alignof},
-        {"_Atomic", Token::Atomic},
-        {"_Complex", Token::Complex},
-        {"_Generic", Token::Generic},
-        {"_Imaginary", Token::Imaginary},
-        {"_Noreturn", Token::Noreturn},
-        {"_Static_assert", Token::StaticAssert},
-        {"_Thread_local", Token::ThreadLocal},
-    };
-
-Lexer::Lexer(std::vector<std::string> &s) {
-  Source = std::move(s);
-  TokenBuffer = std::vector<Token>();
-  LineIndex = 0;
-  ColumnIndex = 0;
+namespace {
+
+struct Keyword {
+  std::string_view Spelling;
+  Token::TokenKind Kind;
+};
+
+constexpr Keyword Keywords[] = {
+    {"const", Token::Const},
+    {"int", Token::Int},
+    {"short", Token::Short},
+    {"long", Token::Long},
+    {"float", Token::Float},
+    {"double", Token::Double},
+    {"unsigned", Token::Unsigned},
+    {"signed", Token::Signed},
+    {"void", Token::Void},
+    {"char", Token::Char},
+    {"if", Token::If},
+    {"switch", Token::Switch},
+    {"case", Token::Case},
+    {"default", Token::Default},
+    {"break", Token::Break},
+    {"else", Token::Else},
+    {"for", Token::For},
+    {"while", Token::While},
+    {"return", Token::Return},
+    {"do", Token::Do},
+    {"struct", Token::Struct},
+    {"sizeof", Token::Sizeof},
+    {"enum", Token::Enum},
+    {"typedef", Token::Typedef},
+    {"continue", Token::Continue},
+    {"_Bool", Token::Bool},
+    {"_Alignas", Token::Alignas},
+    {"_Alignof", Token::Alignof},
+    {"_Atomic", Token::Atomic},
+    {"_Complex", Token::Complex},
+    {"_Generic", Token::Generic},
+    {"_Imaginary", Token::Imaginary},
+    {"_Noreturn", Token::Noreturn},
+    {"_Static_assert", Token::StaticAssert},
+    {"_Thread_local", Token::ThreadLocal},
+};
+
+constexpr size_t MinKeywordLength = 2;
+constexpr size_t MaxKeywordLength = 14;
+constexpr unsigned KeywordTableSize = 128;
+
+/// Perfect hash over the keywords. The coefficients were chosen so that none
+/// of the keywords collide, which is verified at compile time below. @Word
+/// must be at least MinKeywordLength long.
+constexpr unsigned HashKeyword(std::string_view Word) {
+  return (Word.size() + Word[1] * 6u + Word.back() * 10u) %
+         KeywordTableSize;
+}
+
+/// Table indexed by the hash of the keywords, empty spellings mark the
+/// unused slots.
+using KeywordTable = std::array<Keyword, KeywordTableSize>;
+
+constexpr KeywordTable CreateKeywordTable() {
+  KeywordTable Table{};
+  for (auto &KW : Keywords)
+    Table[HashKeyword(KW.Spelling)] = KW;
+  return Table;
+}
+
+constexpr KeywordTable KeywordLookUpTable = CreateKeywordTable();
+
+constexpr bool IsKeywordHashPerfect() {
+  for (auto &KW : Keywords)
+    if (KeywordLookUpTable[HashKeyword(KW.Spelling)].Spelling != KW.Spelling)
+      return false;
+  return true;
+}
+
+static_assert(IsKeywordHashPerfect(),
+              "Keyword hash has collisions, update the HashKeyword function");
+
+/// Return the kind of the keyword @Word or Token::Invalid if @Word is not a
+/// keyword.
+constexpr Token::TokenKind LookUpKeyword(std::string_view Word) {
+  if (Word.size() < MinKeywordLength || Word.size() > MaxKeywordLength)
+    return Token::Invalid;
+
+  auto &Candidate = KeywordLookUpTable[HashKeyword(Word)];
+  return Candidate.Spelling == Word ? Candidate.Kind : Token::Invalid;
+}
+
+static_assert(LookUpKeyword("_Generic") == Token::Generic);
+static_assert(LookUpKeyword("integer") == Token::Invalid);
+
+} // namespace
+
+Lexer::Lexer(const SourceBuffer &Buffer) {
+  Source = Buffer.GetBuffer();
+  Index = 0;
+
+  LookAhead(1);
+}
+
+void Lexer::SetPosition(SourceLocation Loc) {
+  Index = Loc;
+  BufferHead = 0;
+  BufferedTokens = 0;
 
   LookAhead(1);
 }
 
 void Lexer::ConsumeCurrentToken() {
-  assert(!TokenBuffer.empty() && "TokenBuffer is empty.");
-  TokenBuffer.erase(TokenBuffer.begin());
+  assert(BufferedTokens > 0 && "TokenBuffer is empty.");
+  BufferHead = (BufferHead + 1) % MaxLookAhead;
+  BufferedTokens--;
 }
 
 int Lexer::GetNextChar() {
-  // If it is an empty line then move forward by calling EatNextChar() which
-  // will advance to the next line's first character.
-  if (LineIndex < Source.size() && Source[LineIndex].length() == 0)
-    EatNextChar();
-  if (LineIndex >= Source.size() || (LineIndex == Source.size() - 1 &&
-                                     ColumnIndex == Source[LineIndex].length()))
+  if (Index >= Source.size())
     return EOF;
-  return Source[LineIndex][ColumnIndex];
+  return Source[Index];
 }
 
 int Lexer::GetNextNthCharOnSameLine(unsigned n) {
-  if (LineIndex >= Source.size() ||
-      (ColumnIndex + n >= Source[LineIndex].length()))
-    return EOF;
-  return Source[LineIndex][ColumnIndex + n];
+  for (unsigned i = 1; i <= n; i++)
+    if (Index + i >= Source.size() || Source[Index + i] == '\n')
+      return EOF;
+  return Source[Index + n];
 }
 
 void Lexer::EatNextChar() {
-  if (LineIndex < Source.size()) {
-    if (Source[LineIndex].empty() ||
-        ColumnIndex >= Source[LineIndex].size() - 1) {
-      ColumnIndex = 0;
-      LineIndex++;
-    } else {
-      ColumnIndex++;
-    }
-  }
+  if (Index < Source.size())
+    Index++;
 }
 
 std::optional<Token> Lexer::LexNumber() {
-  unsigned StartLineIndex = LineIndex;
-  unsigned StartColumnIndex = ColumnIndex;
+  SourceLocation StartIndex = Index;
   unsigned Length = 0;
   auto TokenKind = Token::Integer;
   unsigned TokenValue = 0;
@@ -141,60 +192,33 @@ std::optional<Token> Lexer::LexNumber() {
   if (Length == 0)
     return std::nullopt;
 
-  std::string_view StringValue{&Source[StartLineIndex][StartColumnIndex],
-                               Length};
-  return Token(TokenKind, StringValue, StartLineIndex, StartColumnIndex,
-               TokenValue);
+  auto StringValue = Source.substr(StartIndex, Length);
+  return Token(TokenKind, StringValue, StartIndex, TokenValue);
 }
 
 std::optional<Token> Lexer::LexIdentifier() {
-  unsigned StartLineIndex = LineIndex;
-  unsigned StartColumnIndex = ColumnIndex;
-  unsigned Length = 0;
+  SourceLocation StartIndex = Index;
 
   // Cannot start with a digit
   if (isdigit(GetNextChar()))
     return std::nullopt;
 
-  while (isalnum(GetNextChar()) || GetNextChar() == '_') {
-    Length++;
-    EatNextChar();
-  }
-
-  if (Length == 0)
-    return std::nullopt;
-
-  std::string_view StringValue{&Source[StartLineIndex][StartColumnIndex],
-                               Length};
-  return Token(Token::Identifier, StringValue, StartLineIndex,
-               StartColumnIndex);
-}
-
-std::optional<Token> Lexer::LexKeyword() {
-  std::size_t WordEnd = Source[LineIndex]
-                            .substr(ColumnIndex)
-                            .find_first_of("\t\n\v\f\r;(){}[]:* ");
+  Index = CharScanner::SkipIdentifierChars(Source, Index);
 
-  auto Word = Source[LineIndex].substr(ColumnIndex, WordEnd);
-
-  if (!Keywords.count(Word))
+  if (Index == StartIndex)
     return std::nullopt;
 
-  unsigned StartLineIndex = LineIndex;
-  unsigned StartColumnIndex = ColumnIndex;
+  auto StringValue = Source.substr(StartIndex, Index - StartIndex);
 
-  for (int i = Word.length(); i > 0; i--)
-    EatNextChar();
+  if (auto Kind = LookUpKeyword(StringValue); Kind != Token::Invalid)
+    return Token(Kind, StringValue, StartIndex);
 
-  std::string_view StringValue{&Source[StartLineIndex][StartColumnIndex],
-                               Word.length()};
-  return Token(Lexer::Keywords[Word], StringValue, StartLineIndex,
-               StartColumnIndex);
+  return Token(Token::Identifier, StringValue, StartIndex,
+               Symbol::Intern(StringValue));
 }
 
 std::optional<Token> Lexer::LexCharLiteral() {
-  unsigned StartLineIndex = LineIndex;
-  unsigned StartColumnIndex = ColumnIndex;
+  SourceLocation StartIndex = Index;
 
   // It must start with a ' char
   if (GetNextChar() != '\'')
@@ -242,44 +266,28 @@ std::optional<Token> Lexer::LexCharLiteral() {
 
   EatNextChar(); // eat ending ' char
 
-  std::string_view StringValue{&Source[StartLineIndex][StartColumnIndex],
-                               ColumnIndex - StartColumnIndex + 1};
-  return Token(Token::CharacterLiteral, StringValue, StartLineIndex,
-               StartColumnIndex, value);
+  auto StringValue = Source.substr(StartIndex, Index - StartIndex);
+  return Token(Token::CharacterLiteral, StringValue, StartIndex, value);
 }
 
 std::optional<Token> Lexer::LexStringLiteral() {
-  unsigned StartLineIndex = LineIndex;
-  unsigned StartColumnIndex = ColumnIndex;
-  unsigned Length = 0;
+  SourceLocation StartIndex = Index;
 
   // It must start with a " char
   if (GetNextChar() != '"')
     return std::nullopt;
 
   EatNextChar(); // eat " char
-  Length++;
 
-  bool lastCharIsEscape = false; // used to determine if encountered a '\"'
-
-  while ((GetNextChar() != '"' || (GetNextChar() == '"' && lastCharIsEscape)) &&
-         GetNextChar() != EOF) {
-    char c = GetNextChar();
-    lastCharIsEscape = c == '\\';
-    EatNextChar();
-    Length++;
-  }
+  Index = CharScanner::FindStringLiteralEnd(Source, Index);
 
   if (GetNextChar() != '"')
     return Token(Token::Invalid);
 
   EatNextChar(); // eat " char
-  Length++;
 
-  std::string_view StringValue{&Source[StartLineIndex][StartColumnIndex],
-                               Length};
-  return Token(Token::StringLiteral, StringValue, StartLineIndex,
-               StartColumnIndex);
+  auto StringValue = Source.substr(StartIndex, Index - StartIndex);
+  return Token(Token::StringLiteral, StringValue, StartIndex);
 }
 
 std::optional<Token> Lexer::LexSymbol() {
@@ -461,92 +469,73 @@ std::optional<Token> Lexer::LexSymbol() {
     break;
   }
 
-  std::string_view StringValue{&Source[LineIndex][ColumnIndex], Size};
-  auto Result = Token(TokenKind, StringValue, LineIndex, ColumnIndex);
-
-  EatNextChar();
-  if (Size >= 2)
-    EatNextChar();
-  if (Size == 3)
-    EatNextChar();
+  auto Result = Token(TokenKind, Source.substr(Index, Size), Index);
+  Index += Size;
 
   return Result;
 }
 
-Token Lexer::LookAhead(unsigned n) {
+const Token &Lexer::LookAhead(unsigned n) {
+  assert(n > 0 && n <= MaxLookAhead && "Invalid look ahead distance");
+
   // fill in the TokenBuffer to have at least n element
-  for (size_t i = TokenBuffer.size(); i < n; i++)
-    TokenBuffer.push_back(Lex(true));
+  for (; BufferedTokens < n; BufferedTokens++)
+    TokenBuffer[(BufferHead + BufferedTokens) % MaxLookAhead] = LexToken();
 
-  return TokenBuffer[n - 1];
+  return TokenBuffer[(BufferHead + n - 1) % MaxLookAhead];
 }
 
 bool Lexer::Is(Token::TokenKind tk) {
-  // fill in the buffer with one token if it is empty
-  if (TokenBuffer.size() == 0)
-    LookAhead(1);
-
   return GetCurrentToken().GetKind() == tk;
 }
 
 bool Lexer::IsNot(Token::TokenKind tk) { return !Is(tk); }
 
-Token Lexer::Lex(bool LookAhead) {
-  // if the TokenBuffer not empty then return the Token from there
-  // and remove it from the stack
-  if (TokenBuffer.size() > 0 && !LookAhead) {
-    auto CurrentToken = GetCurrentToken();
-    ConsumeCurrentToken();
-    return CurrentToken;
-  }
-
-  int CurrentCharacter = GetNextChar();
-  std::string WhiteSpaceChars("\t\n\v\f\r ");
+Token Lexer::Lex() {
+  auto CurrentToken = GetCurrentToken();
+  ConsumeCurrentToken();
+  return CurrentToken;
+}
 
+Token Lexer::LexToken() {
   // consume white space characters
-  while (WhiteSpaceChars.find(CurrentCharacter) != std::string::npos ||
-         CurrentCharacter == '\0') {
-    EatNextChar();
-    CurrentCharacter = GetNextChar();
-  }
+  Index = CharScanner::SkipWhitespaces(Source, Index);
 
-  if (CurrentCharacter == EOF) {
+  if (GetNextChar() == EOF) {
     return Token(Token::EndOfFile);
   }
 
-  auto Result = LexKeyword();
+  // Only try the lexing functions which can match the first character
+  const int FirstChar = GetNextChar();
+  std::optional<Token> Result;
 
-  if (!Result)
-    Result = LexSymbol();
-  if (!Result)
-    Result = LexNumber();
-  if (!Result)
-    Result = LexCharLiteral();
-  if (!Result)
-    Result = LexStringLiteral();
-  if (!Result)
+  if (isalpha(FirstChar) || FirstChar == '_')
     Result = LexIdentifier();
+  else if (isdigit(FirstChar))
+    Result = LexNumber();
+  else {
+    Result = LexSymbol();
+    if (!Result)
+      Result = LexCharLiteral();
+    if (!Result)
+      Result = LexStringLiteral();
+  }
 
   // Handle single line comment. If "//" detected, then advance to next line and
   // lex again.
   if (Result.has_value() &&
       Result.value().GetKind() == Token::DoubleForwardSlash) {
-    LineIndex++;
-    ColumnIndex = 0;
-    return Lex();
+    auto LineEnd = Source.find('\n', Index);
+    Index = LineEnd == std::string_view::npos ? Source.size() : LineEnd + 1;
+    return LexToken();
   }
 
   // Handle multiline comments like /* ... */
   if (Result.has_value() &&
       Result.value().GetKind() == Token::ForwardSlashAstrix) {
-    while (GetNextChar() != EOF &&
-           (GetNextChar() != '*' || GetNextNthCharOnSameLine(1) != '/')) {
-      EatNextChar();
-    }
-    EatNextChar();
-    EatNextChar();
-
-    return Lex();
+    auto CommentEnd = CharScanner::FindBlockCommentEnd(Source, Index);
+    Index = CommentEnd == Source.size() ? CommentEnd : CommentEnd + 2;
+    return LexToken();
   }
 
   if (Result)
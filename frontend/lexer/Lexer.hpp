@@ -1,12 +1,13 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include "../SourceManager.hpp"
 #include "Token.hpp"
+#include <array>
 #include <cassert>
 #include <optional>
 #include <string>
-#include <unordered_map>
-#include <vector>
+#include <string_view>
 
 class Lexer {
 public:
@@ -14,32 +15,52 @@ public:
   int GetNextChar();
   int GetNextNthCharOnSameLine(unsigned n);
 
-  // Update LineIndex and ColumnIndex to make them point to the next
-  // input character
+  // Update Index to make it point to the next input character
   void EatNextChar();
 
   // For matching an integer or real number
   std::optional<Token> LexNumber();
+  /// Lex an identifier or a keyword.
   std::optional<Token> LexIdentifier();
-  std::optional<Token> LexKeyword();
   std::optional<Token> LexCharLiteral();
   std::optional<Token> LexStringLiteral();
   std::optional<Token> LexSymbol();
-  Token LookAhead(unsigned n);
-  Token GetCurrentToken() { return LookAhead(1); }
+
+  /// Return the @n-th upcoming token without consuming it, where 1 is the
+  /// current token. The reference is valid until the token is consumed.
+  const Token &LookAhead(unsigned n);
+  const Token &GetCurrentToken() { return LookAhead(1); }
   bool Is(Token::TokenKind tk);
   bool IsNot(Token::TokenKind tk);
 
-  Token Lex(bool LookAhead = false);
+  /// Consume and return the current token.
+  Token Lex();
+
+  explicit Lexer(const SourceBuffer &Buffer);
+
+  /// The offset of the source after the already lexed tokens.
+  SourceLocation GetPosition() const { return Index; }
+
+  /// Drop the already lexed tokens and continue lexing from @Loc.
+  void SetPosition(SourceLocation Loc);
 
-  explicit Lexer(std::vector<std::string> &s);
+  /// The maximum number of tokens which can be looked ahead. Must be a power
+  /// of 2.
+  static constexpr unsigned MaxLookAhead = 8;
 
 private:
-  static std::unordered_map<std::string, Token::TokenKind> Keywords;
-  std::vector<std::string> Source;
-  std::vector<Token> TokenBuffer;
-  unsigned LineIndex;
-  unsigned ColumnIndex;
+  /// Lex the next token from the source, skipping whitespaces and comments.
+  Token LexToken();
+
+  std::string_view Source;
+
+  /// Circular buffer of the already lexed, but not yet consumed tokens.
+  /// BufferedTokens many of them are valid starting from BufferHead.
+  std::array<Token, MaxLookAhead> TokenBuffer;
+  unsigned BufferHead = 0;
+  unsigned BufferedTokens = 0;
+
+  SourceLocation Index;
 };
 
 #endif
\ No newline at end of file
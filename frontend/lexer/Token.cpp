@@ -1,6 +1,8 @@
 #include "Token.hpp"
 
-std::string Token::ToString() const {
+std::string Token::ToString(const SourceBuffer &Source) const {
+  auto [LineNumber, ColumnNumber] = Source.GetLineAndColumn(Location);
+
   std::string Result;
   Result += "\"" + std::string(StringValue) + "\", ";
   Result += "Line: " + std::to_string(LineNumber + 1) + ", ";
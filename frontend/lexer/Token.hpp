@@ -1,6 +1,8 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include "../../support/Symbol.hpp"
+#include "../SourceManager.hpp"
 #include <cassert>
 #include <string>
 #include <unordered_map>
@@ -121,35 +123,47 @@ public:
 
   explicit Token(TokenKind tk) : Kind(tk) {}
 
-  Token(TokenKind tk, std::string_view sv, unsigned l, unsigned c)
-      : Kind(tk), StringValue(sv), LineNumber(l), ColumnNumber(c) {}
+  Token(TokenKind tk, std::string_view sv, SourceLocation Loc)
+      : Kind(tk), StringValue(sv), Location(Loc) {}
 
-  Token(TokenKind tk, std::string_view sv, unsigned l, unsigned c, unsigned v)
-      : Kind(tk), StringValue(sv), LineNumber(l), ColumnNumber(c), Value(v) {}
+  Token(TokenKind tk, std::string_view sv, SourceLocation Loc, unsigned v)
+      : Kind(tk), StringValue(sv), Location(Loc), Value(v) {}
+
+  /// For identifiers, which are interned when lexed.
+  Token(TokenKind tk, std::string_view sv, SourceLocation Loc, Symbol Sym)
+      : Kind(tk), StringValue(sv), Location(Loc), Sym(Sym) {}
 
   [[nodiscard]] std::string GetString() const {
     return std::string(StringValue);
   }
+  [[nodiscard]] std::string_view GetStringView() const { return StringValue; }
   [[nodiscard]] TokenKind GetKind() const { return Kind; }
 
-  [[nodiscard]] unsigned GetLineNum() const { return LineNumber; }
-  [[nodiscard]] unsigned GetColNum() const { return ColumnNumber; }
+  /// Return the interned text of the token. It is free for identifiers,
+  /// others are interned on demand.
+  [[nodiscard]] Symbol GetSymbol() const {
+    return Sym.IsEmpty() ? Symbol::Intern(StringValue) : Sym;
+  }
+
+  [[nodiscard]] SourceLocation GetLocation() const { return Location; }
   [[nodiscard]] unsigned GetValue() const { return Value; }
 
-  [[nodiscard]] std::string ToString() const;
+  /// @Source is the buffer the token was lexed from, used to translate the
+  /// location to line and column numbers.
+  [[nodiscard]] std::string ToString(const SourceBuffer &Source) const;
 
   static std::string ToString(TokenKind tk);
 
-  bool operator==(const Token &RHS) {
-    return GetString() == RHS.GetString() && Kind == RHS.Kind;
+  bool operator==(const Token &RHS) const {
+    return Kind == RHS.Kind && StringValue == RHS.StringValue;
   }
 
 private:
   TokenKind Kind;
   std::string_view StringValue;
-  unsigned LineNumber{};
-  unsigned ColumnNumber{};
+  SourceLocation Location{};
   unsigned Value = 0;
+  Symbol Sym;
 };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "Parser.hpp"
+#include "../PrecompiledHeader.hpp"
 #include "../Support.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <memory>
 
@@ -25,39 +28,39 @@ static bool IsUnsupported(const Token &T) {
 }
 
 Token Parser::Expect(Token::TokenKind TKind) {
-  auto t = GetCurrentToken();
+  const auto &t = GetCurrentToken();
 
-  if (t.GetKind() != TKind) {
-    if (t.GetKind() != Token::EndOfFile) {
-      std::string Msg = "Unexpected symbol `" + t.GetString() +
-                        "`, expected is `" + Token::ToString(TKind) + "`";
-      ErrorLog.AddError(Msg, t);
+  if (t.GetKind() == TKind)
+    return Lex(); // consume Tokens
 
-      if (IsUnsupported(t)) {
-        Msg = "'" + t.GetString() + "' is unsupported";
-        ErrorLog.AddNote(Msg, t);
-      }
-    } else {
-      std::string Error = "Reached the end of the file, but expected `" +
-                          Token::ToString(TKind) + "`";
-      ErrorLog.AddError(Error);
+  if (t.GetKind() != Token::EndOfFile) {
+    std::string Msg = "Unexpected symbol `" + t.GetString() +
+                      "`, expected is `" + Token::ToString(TKind) + "`";
+    ErrorLog.AddError(Msg, t);
+
+    if (IsUnsupported(t)) {
+      Msg = "'" + t.GetString() + "' is unsupported";
+      ErrorLog.AddNote(Msg, t);
     }
-    if (t.GetKind() == Token::Identifier)
-      Lex();
-  } else
-    Lex(); // consume Tokens
+  } else {
+    std::string Error = "Reached the end of the file, but expected `" +
+                        Token::ToString(TKind) + "`";
+    ErrorLog.AddError(Error);
+  }
+
+  if (t.GetKind() == Token::Identifier)
+    return Lex();
 
-  return t; // consume Tokens
+  return t;
 }
 
-std::unique_ptr<Node> Parser::Parse() { return ParseExternalDeclaration(); }
+Node *Parser::Parse() { return ParseExternalDeclaration(); }
 
 void Parser::InsertToSymTable(const Token &SymName, const Type &SymType,
                               const bool ToGlobal = false,
                               ValueType SymValue = ValueType()) {
 
   SymbolTableStack::Entry SymEntry(SymName, SymType, SymValue);
-  auto SymNameStr = SymName.GetString();
 
   if (ToGlobal)
     SymTabStack.InsertGlobalEntry(SymEntry);
@@ -65,11 +68,11 @@ void Parser::InsertToSymTable(const Token &SymName, const Type &SymType,
     SymTabStack.InsertEntry(SymEntry);
 }
 
-bool Parser::IsUserDefined(const std::string &Name) {
+bool Parser::IsUserDefined(Symbol Name) {
   return UserDefinedTypes.count(Name) > 0 || TypeDefinitions.count(Name);
 }
 
-std::vector<Token> Parser::GetUserDefinedTypeMembers(std::string Name) {
+std::vector<Token> Parser::GetUserDefinedTypeMembers(Symbol Name) {
   assert(IsUserDefined(Name));
 
   if (TypeDefinitions.count(Name) > 0)
@@ -77,7 +80,7 @@ std::vector<Token> Parser::GetUserDefinedTypeMembers(std::string Name) {
   return std::get<1>(UserDefinedTypes[Name]);
 }
 
-Type Parser::GetUserDefinedType(const std::string &Name) {
+Type Parser::GetUserDefinedType(Symbol Name) {
   assert(IsUserDefined(Name));
 
   if (UserDefinedTypes.count(Name) > 0)
@@ -86,7 +89,7 @@ Type Parser::GetUserDefinedType(const std::string &Name) {
     return TypeDefinitions[Name];
 }
 
-bool Parser::IsTypeSpecifier(Token T) {
+bool Parser::IsTypeSpecifier(const Token &T) {
   switch (T.GetKind()) {
   case Token::Char:
   case Token::Short:
@@ -100,8 +103,7 @@ bool Parser::IsTypeSpecifier(Token T) {
   case Token::Void:
     return true;
   case Token::Identifier: {
-    auto Id = T.GetString();
-    if (TypeDefinitions.count(Id) != 0)
+    if (TypeDefinitions.count(T.GetSymbol()) != 0)
       return true;
   }
   default:
@@ -127,7 +129,7 @@ static bool IsUnaryOperator(Token::TokenKind tk) {
   }
 }
 
-bool Parser::IsReturnTypeSpecifier(Token T) {
+bool Parser::IsReturnTypeSpecifier(const Token &T) {
   return T.GetKind() == Token::Void || IsTypeSpecifier(T);
 }
 
@@ -143,7 +145,7 @@ bool IsQualifier(Token::TokenKind tk) {
   return false;
 }
 
-bool Parser::IsQualifiedType(Token T) {
+bool Parser::IsQualifiedType(const Token &T) {
   return IsQualifier(T.GetKind()) || IsTypeSpecifier(T);
 }
 
@@ -187,7 +189,7 @@ Type Parser::ParseType(Token::TokenKind tk) {
     Result.SetTypeVariant(Type::Int);
     break;
   case Token::Long: {
-    auto NextTokenKind = lexer.LookAhead(2).GetKind();
+    auto NextTokenKind = LookAhead(2).GetKind();
     if (NextTokenKind == Token::Long) {
       Lex(); // eat 'long'
       Result.SetTypeVariant(Type::LongLong);
@@ -197,7 +199,7 @@ Type Parser::ParseType(Token::TokenKind tk) {
     break;
   }
   case Token::Unsigned: {
-    auto NextTokenKind = lexer.LookAhead(2).GetKind();
+    auto NextTokenKind = LookAhead(2).GetKind();
     if (NextTokenKind == Token::Int || NextTokenKind == Token::Char ||
         NextTokenKind == Token::Short || NextTokenKind == Token::Long)
       Lex(); // eat 'unsigned'
@@ -208,7 +210,7 @@ Type Parser::ParseType(Token::TokenKind tk) {
       return Result;
     }
 
-    auto CurrToken = lexer.GetCurrentToken();
+    const auto &CurrToken = GetCurrentToken();
 
     switch (CurrToken.GetKind()) {
     case Token::Char:
@@ -221,7 +223,7 @@ Type Parser::ParseType(Token::TokenKind tk) {
       Result.SetTypeVariant(Type::UnsignedInt);
       break;
     case Token::Long: {
-      auto NextTK = lexer.LookAhead(2).GetKind();
+      auto NextTK = LookAhead(2).GetKind();
       if (NextTK == Token::Long) {
         Lex(); // eat 'long'
         Result.SetTypeVariant(Type::UnsignedLongLong);
@@ -237,7 +239,7 @@ Type Parser::ParseType(Token::TokenKind tk) {
   }
   case Token::Signed: {
     Lex();
-    auto CurrToken = lexer.GetCurrentToken();
+    auto CurrToken = GetCurrentToken();
     Result = ParseType(CurrToken.GetKind());
     // TODO: Move this into semantics. For now here is the most appropriate
     // to handle it.
@@ -256,18 +258,16 @@ Type Parser::ParseType(Token::TokenKind tk) {
     break;
   case Token::Struct: {
     Lex(); // eat 'struct' here
-    auto CurrToken = lexer.GetCurrentToken();
+    const auto &CurrToken = GetCurrentToken();
 
-    std::string Name = CurrToken.GetString();
-    Result = std::get<0>(UserDefinedTypes[Name]);
+    Result = std::get<0>(UserDefinedTypes[CurrToken.GetSymbol()]);
     break;
   }
   case Token::Identifier: {
     // assuming we parsing the current token
     // TODO: Change this function expect the Token and not the TokenKind
     assert(GetCurrentTokenKind() == Token::Identifier);
-    auto Id = GetCurrentToken().GetString();
-    Result = TypeDefinitions[Id];
+    Result = TypeDefinitions[GetCurrentToken().GetSymbol()];
     break;
   }
   default:
@@ -301,7 +301,7 @@ void Parser::ParseArrayDimensions(Type &type) {
 
 /// Issues an implicit cast for the &Expr if it is needed and possible for
 /// the given @ExpectedType
-void DoImplicitCastIfNeeded(std::unique_ptr<Expression> &Expr,
+void DoImplicitCastIfNeeded(ASTContext &Ctx, Expression *&Expr,
                             const Type &ExpectedType) {
   if ((ExpectedType != Expr->GetResultType()) &&
       !Type::OnlySigndnessDifference(ExpectedType.GetTypeVariant(),
@@ -316,8 +316,7 @@ void DoImplicitCastIfNeeded(std::unique_ptr<Expression> &Expr,
     if (!IsImplicitlyCastable) {
       assert(!"Invalid initialization");
     } else {
-      Expr = std::make_unique<ImplicitCastExpression>(std::move(Expr),
-                                                      ExpectedType);
+      Expr = Ctx.Create<ImplicitCastExpression>(Expr, ExpectedType);
     }
   }
 }
@@ -336,7 +335,9 @@ void DetermineUnspecifiedDimension(Expression *InitExpr, Type &type) {
     // TODO: only 1 dimensional init list are handled here now, although C
     // only allows the first dimension to be a unspecified so arr[][] would
     // be invalid anyway
-    type.GetDimensions()[0] = InitListExpr->GetExprList().size();
+    auto Dimensions = type.GetDimensions();
+    Dimensions[0] = InitListExpr->GetExprList().size();
+    type.SetDimensions(std::move(Dimensions));
   }
 }
 
@@ -345,8 +346,8 @@ void DetermineUnspecifiedDimension(Expression *InitExpr, Type &type) {
 //
 // First set : {void, int, double}
 // Second set : {Identifier}
-std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
-  std::unique_ptr<TranslationUnit> TU = std::make_unique<TranslationUnit>();
+Node *Parser::ParseExternalDeclaration() {
+  TranslationUnit *TU = Ctx.Create<TranslationUnit>(PrecompiledDeclarations);
   auto Token = GetCurrentToken();
 
   while (IsReturnTypeSpecifier(Token) || lexer.Is(Token::Struct) ||
@@ -358,19 +359,20 @@ std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
     Type BaseType;
 
     if (lexer.Is(Token::Struct) &&
-        (lexer.LookAhead(2).GetKind() == Token::LeftCurly ||
-         (lexer.LookAhead(2).GetKind() == Token::Identifier &&
-          lexer.LookAhead(3).GetKind() == Token::LeftCurly))) {
+        (LookAhead(2).GetKind() == Token::LeftCurly ||
+         (LookAhead(2).GetKind() == Token::Identifier &&
+          LookAhead(3).GetKind() == Token::LeftCurly))) {
       auto SD = ParseStructDeclaration(Qualifiers);
-      auto SDPtr = SD.get();
+      auto SDPtr = SD;
 
-      TU->AddDeclaration(std::move(SD));
+      TU->AddDeclaration(SD);
       Token = GetCurrentToken();
 
       if (Token.GetKind() == Token::Identifier ||
           Token.GetKind() == Token::Astrix) {
         IsAlsoStuctVariableDeclaration = true;
-        BaseType = std::get<0>(UserDefinedTypes[SDPtr->GetName()]);
+        BaseType =
+            std::get<0>(UserDefinedTypes[SDPtr->GetNameToken().GetSymbol()]);
       } else {
         Expect(Token::SemiColon);
         Token = GetCurrentToken();
@@ -402,7 +404,7 @@ std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
     auto NameStr = Name.GetString();
 
     if (Qualifiers & Type::Typedef) {
-      TypeDefinitions[NameStr] = CurrentType;
+      TypeDefinitions[Name.GetSymbol()] = CurrentType;
       Expect(Token::SemiColon);
       Token = GetCurrentToken();
       continue;
@@ -437,7 +439,7 @@ std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
         ParseArrayDimensions(CurrentType);
 
         // If the variable initialized
-        std::unique_ptr<Expression> InitExpr = nullptr;
+        Expression *InitExpr = nullptr;
         if (lexer.Is(Token::Equal)) {
           Lex(); // eat '='
 
@@ -454,18 +456,18 @@ std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
             InitExpr = ParseExpression();
 
           if (!IsInitList &&
-              !dynamic_cast<StringLiteralExpression *>(InitExpr.get()) &&
+              !dynamic_cast<StringLiteralExpression *>(InitExpr) &&
               !ExpectedType.IsStruct())
-            DoImplicitCastIfNeeded(InitExpr, ExpectedType);
+            DoImplicitCastIfNeeded(Ctx, InitExpr, ExpectedType);
         }
 
         if (CurrentType.IsArray() && !CurrentType.GetDimensions().empty())
-          DetermineUnspecifiedDimension(InitExpr.get(), CurrentType);
+          DetermineUnspecifiedDimension(InitExpr, CurrentType);
 
         InsertToSymTable(Name, CurrentType);
 
-        TU->AddDeclaration(std::make_unique<VariableDeclaration>(
-            Name, CurrentType, std::move(InitExpr)));
+        TU->AddDeclaration(Ctx.Create<VariableDeclaration>(
+            Name, CurrentType, InitExpr));
 
         // TODO: typedef is not allowed for now, because complex typedefs
         // not supported yet like
@@ -503,8 +505,8 @@ std::unique_ptr<Node> Parser::ParseExternalDeclaration() {
 //                             <ParameterList>? ')' ';'
 //			   | <ReturnTypeSpecifier> <Identifier>
 //                             '(' <ParameterList>? ')' <CompoundStatement>
-std::unique_ptr<FunctionDeclaration>
-Parser::ParseFunctionDeclaration(const Type &ReturnType, const Token &Name) {
+FunctionDeclaration *Parser::ParseFunctionDeclaration(const Type &ReturnType,
+                                                      const Token &Name) {
   Expect(Token::LeftParen); // consume '('
 
   // Creating new scope by pushing a new symbol table to the stack
@@ -522,7 +524,7 @@ Parser::ParseFunctionDeclaration(const Type &ReturnType, const Token &Name) {
   InsertToSymTable(Name, FuncType, true);
 
   ReturnsNumber = 0;
-  std::unique_ptr<CompoundStatement> Body = nullptr;
+  CompoundStatement *Body = nullptr;
   if (lexer.Is(Token::SemiColon))
     Lex(); // eat ';'
   else
@@ -531,15 +533,15 @@ Parser::ParseFunctionDeclaration(const Type &ReturnType, const Token &Name) {
   // Removing the function's scope since we have done with its parsing
   SymTabStack.PopSymTable();
 
-  return std::make_unique<FunctionDeclaration>(FuncType, Name, PL, Body,
-                                               ReturnsNumber);
+  return Ctx.Create<FunctionDeclaration>(FuncType, Name, PL, Body,
+                                         ReturnsNumber);
 }
 
 // <ParameterList> ::= <ParameterDeclaration>?
 //                      {',' <ParameterDeclaration> }* (',' '...')?
-std::vector<std::unique_ptr<FunctionParameterDeclaration>>
+std::vector<FunctionParameterDeclaration *>
 Parser::ParseParameterList(bool &HasVarArg) {
-  std::vector<std::unique_ptr<FunctionParameterDeclaration>> Params;
+  std::vector<FunctionParameterDeclaration *> Params;
 
   if (!IsQualifiedType(GetCurrentToken()) && lexer.Is(Token::RightParen))
     return Params;
@@ -559,10 +561,9 @@ Parser::ParseParameterList(bool &HasVarArg) {
 }
 
 // <ParameterDeclaration> ::= { <TypeSpecifier> '*'* <Identifier>? }?
-std::unique_ptr<FunctionParameterDeclaration>
-Parser::ParseParameterDeclaration() {
-  std::unique_ptr<FunctionParameterDeclaration> FPD =
-      std::make_unique<FunctionParameterDeclaration>();
+FunctionParameterDeclaration *Parser::ParseParameterDeclaration() {
+  FunctionParameterDeclaration *FPD =
+      Ctx.Create<FunctionParameterDeclaration>();
 
   Type type = ParseTypeSpecifier();
   Lex();
@@ -616,10 +617,10 @@ Type Parser::ParseTypeSpecifier() {
 }
 
 // <CompoundStatement> ::= '{' <VariableDeclaration>* <Statement>* '}'
-std::unique_ptr<CompoundStatement> Parser::ParseCompoundStatement() {
+CompoundStatement *Parser::ParseCompoundStatement() {
   Expect(Token::LeftCurly);
 
-  std::vector<std::unique_ptr<Statement>> Statements;
+  std::vector<Statement *> Statements;
 
   while (
       (IsQualifiedType(GetCurrentToken()) || lexer.IsNot(Token::RightCurly)) &&
@@ -627,25 +628,25 @@ std::unique_ptr<CompoundStatement> Parser::ParseCompoundStatement() {
     if (IsQualifiedType(GetCurrentToken())) {
       auto Declarations = ParseVariableDeclarationList();
       for (auto &Declaration : Declarations)
-        Statements.push_back(std::move(Declaration));
+        Statements.push_back(Declaration);
     } else
       Statements.push_back(ParseStatement());
   }
   Expect(Token::RightCurly);
 
-  return std::make_unique<CompoundStatement>(Statements);
+  return Ctx.Create<CompoundStatement>(Statements);
 }
 
 // <VariableDeclarationList> ::= <TypeSpecifier> <VariableDeclaration>
 //                             |               {,<VariableDeclaration>} ';'
-std::vector<std::unique_ptr<VariableDeclaration>>
+std::vector<VariableDeclaration *>
 Parser::ParseVariableDeclarationList() {
   Type type = ParseTypeSpecifier();
   Lex();
 
   // using a vector since one line can have multiple declarations like
   // "int a, b;"
-  std::vector<std::unique_ptr<VariableDeclaration>> VariableDeclarations;
+  std::vector<VariableDeclaration *> VariableDeclarations;
 
   while (lexer.IsNot(Token::SemiColon) && lexer.IsNot(Token::EndOfFile)) {
     VariableDeclarations.push_back(ParseVariableDeclaration(type));
@@ -663,8 +664,7 @@ Parser::ParseVariableDeclarationList() {
 
 // <VariableDeclaration> ::= '*'* <Identifier>
 //                           {'[' <IntegerConstant> ]'}* { = <Expression> }?
-std::unique_ptr<VariableDeclaration>
-Parser::ParseVariableDeclaration(Type type) {
+VariableDeclaration *Parser::ParseVariableDeclaration(Type type) {
   while (lexer.Is(Token::Astrix)) {
     type.IncrementPointerLevel();
     Lex(); // Eat the * character
@@ -675,7 +675,7 @@ Parser::ParseVariableDeclaration(Type type) {
   ParseArrayDimensions(type);
 
   // If the variable initialized
-  std::unique_ptr<Expression> InitExpr = nullptr;
+  Expression *InitExpr = nullptr;
   if (lexer.Is(Token::Equal)) {
     Token T = Lex(); // eat '='
 
@@ -698,28 +698,28 @@ Parser::ParseVariableDeclaration(Type type) {
       }
 
       if (!IsInitList &&
-          !dynamic_cast<StringLiteralExpression *>(InitExpr.get()) &&
+          !dynamic_cast<StringLiteralExpression *>(InitExpr) &&
           !ExpectedType.IsStruct())
-        DoImplicitCastIfNeeded(InitExpr, ExpectedType);
+        DoImplicitCastIfNeeded(Ctx, InitExpr, ExpectedType);
     }
   }
 
   if (type.IsArray() && !type.GetDimensions().empty())
-    DetermineUnspecifiedDimension(InitExpr.get(), type);
+    DetermineUnspecifiedDimension(InitExpr, type);
 
   InsertToSymTable(Name, type);
 
-  auto VD = std::make_unique<VariableDeclaration>(Name, type);
+  auto VD = Ctx.Create<VariableDeclaration>(Name, type);
 
   if (InitExpr)
-    VD->SetInitExpr(std::move(InitExpr));
+    VD->SetInitExpr(InitExpr);
 
   return VD;
 }
 
 // <VariableDeclaration> ::= <TypeSpecifier> '*'* <Identifier>
 //                           {'[' <IntegerConstant> ]'}* ';'
-std::unique_ptr<MemberDeclaration> Parser::ParseMemberDeclaration() {
+MemberDeclaration *Parser::ParseMemberDeclaration() {
   Type type = ParseTypeSpecifier();
   Lex();
 
@@ -739,13 +739,12 @@ std::unique_ptr<MemberDeclaration> Parser::ParseMemberDeclaration() {
 
   Expect(Token::SemiColon);
 
-  return std::make_unique<MemberDeclaration>(Name, type, Dimensions);
+  return Ctx.Create<MemberDeclaration>(Name, type, Dimensions);
 }
 
 // <StructDeclaration> ::= 'struct' <Identifier>
 //                                  '{' <StructDeclarationList>+ '}'
-std::unique_ptr<StructDeclaration>
-Parser::ParseStructDeclaration(unsigned Qualifiers = 0) {
+StructDeclaration *Parser::ParseStructDeclaration(unsigned Qualifiers = 0) {
   Token T = Expect(Token::Struct);
 
   if (lexer.IsNot(Token::Identifier)) {
@@ -754,43 +753,43 @@ Parser::ParseStructDeclaration(unsigned Qualifiers = 0) {
   }
 
   Token Name = Expect(Token::Identifier);
-  auto NameStr = Name.GetString();
-
   Expect(Token::LeftCurly);
 
-  std::vector<std::unique_ptr<MemberDeclaration>> Members;
+  std::vector<MemberDeclaration *> Members;
   Type type(Type::Struct);
-  type.SetName(NameStr);
+  type.SetName(Name.GetSymbol());
   type.SetQualifiers(Qualifiers);
 
   // register the type already even though it is an incomplete type
   // at this time of parsing
-  UserDefinedTypes[NameStr] = {type, {}};
+  UserDefinedTypes[Name.GetSymbol()] = {type, {}};
 
+  std::vector<Type> MemberTypes;
   std::vector<Token> StructMemberIdentifiers;
   while (lexer.IsNot(Token::RightCurly)) {
     auto MD = ParseMemberDeclaration();
-    type.GetTypeList().push_back(MD->GetType());
+    MemberTypes.push_back(MD->GetType());
     StructMemberIdentifiers.push_back(MD->GetNameToken());
-    Members.push_back(std::move(MD));
+    Members.push_back(MD);
   }
 
   Expect(Token::RightCurly);
+  type.SetTypeList(std::move(MemberTypes));
 
   if (Qualifiers & Type::Typedef) {
-    auto AliasName = Expect(Token::Identifier).GetString();
+    auto AliasName = Expect(Token::Identifier).GetSymbol();
     TypeDefinitions[AliasName] = type;
   }
 
   // saving the struct type and name
-  UserDefinedTypes[NameStr] = {type, std::move(StructMemberIdentifiers)};
+  UserDefinedTypes[Name.GetSymbol()] = {type,
+                                       std::move(StructMemberIdentifiers)};
 
-  return std::make_unique<StructDeclaration>(Name, Members, type);
+  return Ctx.Create<StructDeclaration>(Name, Members, type);
 }
 
 // <EnumDeclaration> ::= 'enum' '{' <Identifier> (, <Identifier>)* '}' ';'
-std::unique_ptr<EnumDeclaration>
-Parser::ParseEnumDeclaration(unsigned Qualifiers) {
+EnumDeclaration *Parser::ParseEnumDeclaration(unsigned Qualifiers) {
   Expect(Token::Enum);
   Expect(Token::LeftCurly);
 
@@ -812,21 +811,20 @@ Parser::ParseEnumDeclaration(unsigned Qualifiers) {
   } while (lexer.Is(Token::Comma));
 
   if (lexer.Is(Token::Equal)) {
-    Token T = GetCurrentToken();
     std::string Msg = "assigning values to enumerations are not supported yet";
-    ErrorLog.AddNote(Msg, T);
+    ErrorLog.AddNote(Msg, GetCurrentToken());
   }
 
   Expect(Token::RightCurly);
 
   if (Qualifiers & Type::Typedef) {
-    auto AliasName = Expect(Token::Identifier).GetString();
+    auto AliasName = Expect(Token::Identifier).GetSymbol();
     TypeDefinitions[AliasName] = Type(Type::Int);
   }
 
   Expect(Token::SemiColon);
 
-  return std::make_unique<EnumDeclaration>(Enumerators);
+  return Ctx.Create<EnumDeclaration>(Enumerators);
 }
 
 unsigned Parser::ParseIntegerConstant() {
@@ -879,7 +877,7 @@ double Parser::ParseRealConstant() {
 //               | <SwitchStatement>
 //               | <CompoundStatement>
 //               | <ReturnStatement>
-std::unique_ptr<Statement> Parser::ParseStatement() {
+Statement *Parser::ParseStatement() {
   if (lexer.Is(Token::If))
     return ParseIfStatement();
   if (lexer.Is(Token::Switch))
@@ -902,8 +900,8 @@ std::unique_ptr<Statement> Parser::ParseStatement() {
 }
 
 // <IfStatement> ::= if '(' <Expression> ')' <Statement> {else <Statement>}?
-std::unique_ptr<IfStatement> Parser::ParseIfStatement() {
-  std::unique_ptr<IfStatement> IS = std::make_unique<IfStatement>();
+IfStatement *Parser::ParseIfStatement() {
+  IfStatement *IS = Ctx.Create<IfStatement>();
 
   Expect(Token::If);
   Token T = Expect(Token::LeftParen);
@@ -915,10 +913,9 @@ std::unique_ptr<IfStatement> Parser::ParseIfStatement() {
   }
 
   if (Condition && !Condition->GetResultType().IsIntegerType())
-    Condition = std::make_unique<ImplicitCastExpression>(std::move(Condition),
-                                                         Type(Type::Int));
+    Condition = Ctx.Create<ImplicitCastExpression>(Condition, Type(Type::Int));
 
-  IS->SetCondition(std::move(Condition));
+  IS->SetCondition(Condition);
   Expect(Token::RightParen);
   IS->SetIfBody(ParseStatement());
 
@@ -933,8 +930,8 @@ std::unique_ptr<IfStatement> Parser::ParseIfStatement() {
 //                       'case' <Constant> ':' <Statement>*
 //                       'default' ':' <Statement>*
 //                       '}'
-std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
-  std::unique_ptr<SwitchStatement> SS = std::make_unique<SwitchStatement>();
+SwitchStatement *Parser::ParseSwitchStatement() {
+  SwitchStatement *SS = Ctx.Create<SwitchStatement>();
 
   Expect(Token::Switch);
   Token T = Expect(Token::LeftParen);
@@ -943,7 +940,7 @@ std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
     std::string Msg = "expected expression here";
     ErrorLog.AddError(Msg, T);
   }
-  SS->SetCondition(std::move(Condition));
+  SS->SetCondition(Condition);
   Expect(Token::RightParen);
   Expect(Token::LeftCurly);
 
@@ -955,7 +952,7 @@ std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
     const bool IsCase = lexer.Is(Token::Case);
     Token Label = Lex(); // eat 'case' or 'default'
 
-    std::unique_ptr<Expression> CaseExpr;
+    Expression *CaseExpr;
 
     if (IsCase)
       CaseExpr = ParseExpression();
@@ -973,7 +970,7 @@ std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
       Statements.push_back(ParseStatement());
 
     if (IsCase)
-      CasesData.push_back({std::move(CaseExpr), std::move(Statements)});
+      CasesData.push_back({CaseExpr, std::move(Statements)});
     else {
       FoundDefaults++;
       // TODO: move to semantic check
@@ -993,8 +990,8 @@ std::unique_ptr<SwitchStatement> Parser::ParseSwitchStatement() {
 }
 
 // <WhileStatement> ::= while '(' <Expression> ')' <Statement>
-std::unique_ptr<WhileStatement> Parser::ParseWhileStatement() {
-  std::unique_ptr<WhileStatement> WS = std::make_unique<WhileStatement>();
+WhileStatement *Parser::ParseWhileStatement() {
+  WhileStatement *WS = Ctx.Create<WhileStatement>();
 
   Expect(Token::While);
   Token T = Expect(Token::LeftParen);
@@ -1006,10 +1003,9 @@ std::unique_ptr<WhileStatement> Parser::ParseWhileStatement() {
   }
 
   if (Condition && !Condition->GetResultType().IsIntegerType())
-    Condition = std::make_unique<ImplicitCastExpression>(std::move(Condition),
-                                                         Type(Type::Int));
+    Condition = Ctx.Create<ImplicitCastExpression>(Condition, Type(Type::Int));
 
-  WS->SetCondition(std::move(Condition));
+  WS->SetCondition(Condition);
   Expect(Token::RightParen);
   WS->SetBody(ParseStatement());
 
@@ -1017,8 +1013,8 @@ std::unique_ptr<WhileStatement> Parser::ParseWhileStatement() {
 }
 
 // <DoWhileStatement> ::= do <Statement> while '(' <Expression> ')' ';'
-std::unique_ptr<DoWhileStatement> Parser::ParseDoWhileStatement() {
-  std::unique_ptr<DoWhileStatement> DWS = std::make_unique<DoWhileStatement>();
+DoWhileStatement *Parser::ParseDoWhileStatement() {
+  DoWhileStatement *DWS = Ctx.Create<DoWhileStatement>();
 
   Expect(Token::Do);
   DWS->SetBody(ParseStatement());
@@ -1032,10 +1028,9 @@ std::unique_ptr<DoWhileStatement> Parser::ParseDoWhileStatement() {
   }
 
   if (Condition && !Condition->GetResultType().IsIntegerType())
-    Condition = std::make_unique<ImplicitCastExpression>(std::move(Condition),
-                                                         Type(Type::Int));
+    Condition = Ctx.Create<ImplicitCastExpression>(Condition, Type(Type::Int));
 
-  DWS->SetCondition(std::move(Condition));
+  DWS->SetCondition(Condition);
   Expect(Token::RightParen);
   Expect(Token::SemiColon);
 
@@ -1046,8 +1041,8 @@ std::unique_ptr<DoWhileStatement> Parser::ParseDoWhileStatement() {
 //                            <Statement>
 //                  | for '(' <VariableDeclaration> <Expression> ';'
 //                            <Expression> ')' <Statement>
-std::unique_ptr<ForStatement> Parser::ParseForStatement() {
-  std::unique_ptr<ForStatement> FS = std::make_unique<ForStatement>();
+ForStatement *Parser::ParseForStatement() {
+  ForStatement *FS = Ctx.Create<ForStatement>();
 
   Expect(Token::For);
   Expect(Token::LeftParen);
@@ -1065,10 +1060,9 @@ std::unique_ptr<ForStatement> Parser::ParseForStatement() {
 
   auto Condition = ParseExpression();
   if (Condition && !Condition->GetResultType().IsIntegerType())
-    Condition = std::make_unique<ImplicitCastExpression>(std::move(Condition),
-                                                         Type(Type::Int));
+    Condition = Ctx.Create<ImplicitCastExpression>(Condition, Type(Type::Int));
 
-  FS->SetCondition(std::move(Condition));
+  FS->SetCondition(Condition);
   Expect(Token::SemiColon);
 
   FS->SetIncrement(ParseExpression());
@@ -1081,9 +1075,8 @@ std::unique_ptr<ForStatement> Parser::ParseForStatement() {
 }
 
 // <ExpressionStatement> ::= <Expression>? ';'
-std::unique_ptr<ExpressionStatement> Parser::ParseExpressionStatement() {
-  std::unique_ptr<ExpressionStatement> ES =
-      std::make_unique<ExpressionStatement>();
+ExpressionStatement *Parser::ParseExpressionStatement() {
+  ExpressionStatement *ES = Ctx.Create<ExpressionStatement>();
 
   if (lexer.IsNot(Token::SemiColon))
     ES->SetExpression(ParseExpression());
@@ -1100,21 +1093,21 @@ std::unique_ptr<ExpressionStatement> Parser::ParseExpressionStatement() {
 }
 
 // <BreakStatement> ::= 'break' ';'
-std::unique_ptr<BreakStatement> Parser::ParseBreakStatement() {
+BreakStatement *Parser::ParseBreakStatement() {
   Expect(Token::Break);
   Expect(Token::SemiColon);
-  return std::make_unique<BreakStatement>();
+  return Ctx.Create<BreakStatement>();
 }
 
 // <ContinueStatement> ::= 'continue' ';'
-std::unique_ptr<ContinueStatement> Parser::ParseContinueStatement() {
+ContinueStatement *Parser::ParseContinueStatement() {
   Expect(Token::Continue);
   Expect(Token::SemiColon);
-  return std::make_unique<ContinueStatement>();
+  return Ctx.Create<ContinueStatement>();
 }
 
 // <ReturnStatement> ::= return <Expression>? ';'
-std::unique_ptr<ReturnStatement> Parser::ParseReturnStatement() {
+ReturnStatement *Parser::ParseReturnStatement() {
   ReturnsNumber++;
 
   Expect(Token::Return);
@@ -1122,20 +1115,19 @@ std::unique_ptr<ReturnStatement> Parser::ParseReturnStatement() {
 
   if (Expr == nullptr) {
     Expect(Token::SemiColon);
-    return std::make_unique<ReturnStatement>(nullptr);
+    return Ctx.Create<ReturnStatement>(nullptr);
   }
 
   auto LeftType = CurrentFuncRetType.GetTypeVariant();
   auto RightType = Expr->GetResultType().GetTypeVariant();
-  std::unique_ptr<ReturnStatement> RS;
+  ReturnStatement *RS;
 
   if (LeftType != RightType) {
-    std::unique_ptr<Expression> CastExpr =
-        std::make_unique<ImplicitCastExpression>(std::move(Expr),
-                                                 Type(LeftType));
-    RS = std::make_unique<ReturnStatement>(std::move(CastExpr));
+    Expression *CastExpr =
+        Ctx.Create<ImplicitCastExpression>(Expr, Type(LeftType));
+    RS = Ctx.Create<ReturnStatement>(CastExpr);
   } else {
-    RS = std::make_unique<ReturnStatement>(std::move(Expr));
+    RS = Ctx.Create<ReturnStatement>(Expr);
   }
 
   Expect(Token::SemiColon);
@@ -1143,11 +1135,11 @@ std::unique_ptr<ReturnStatement> Parser::ParseReturnStatement() {
 }
 
 // <Expression> ::= <AssignmentExpression>
-std::unique_ptr<Expression> Parser::ParseExpression() {
+Expression *Parser::ParseExpression() {
   return ParseBinaryExpression();
 }
 
-static bool IsPostfixOperator(Token tk) {
+static bool IsPostfixOperator(const Token &tk) {
   switch (tk.GetKind()) {
   case Token::PlusPlus:
   case Token::MinusMinus:
@@ -1171,19 +1163,19 @@ static bool IsPostfixOperator(Token tk) {
 //                       | <PostFixExpression> '.' <Identifier>
 //                       | <PostFixExpression> '->' <Identifier>
 //                       | ( TypeName ) '{' <Initializer-List> '}'
-std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
-  auto CurrentToken = lexer.GetCurrentToken();
+Expression *Parser::ParsePostFixExpression() {
+  auto CurrentToken = GetCurrentToken();
 
   // Struct initializing case
   if (lexer.Is(Token::LeftParen) &&
-      ((lexer.LookAhead(2).GetKind() == Token::Identifier &&
-        IsUserDefined(lexer.LookAhead(2).GetString())) ||
-       (lexer.LookAhead(2).GetKind() == Token::Struct &&
-        IsUserDefined(lexer.LookAhead(3).GetString())))) {
+      ((LookAhead(2).GetKind() == Token::Identifier &&
+        IsUserDefined(LookAhead(2).GetSymbol())) ||
+       (LookAhead(2).GetKind() == Token::Struct &&
+        IsUserDefined(LookAhead(3).GetSymbol())))) {
     Expect(Token::LeftParen);
     if (lexer.Is(Token::Struct))
       Lex();
-    auto TypeName = Expect(Token::Identifier).GetString();
+    auto TypeName = Expect(Token::Identifier).GetSymbol();
     Expect(Token::RightParen);
 
     Expect(Token::LeftCurly);
@@ -1223,7 +1215,7 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
       bool Found = false;
 
       for (auto &TypeMemberName : MemberNames) {
-        if (TypeMemberName == Member) {
+        if (TypeMemberName.GetSymbol() == Member.GetSymbol()) {
           InitOrder.push_back(Order);
           Found = true;
           break;
@@ -1241,21 +1233,19 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
     }
 
     auto ResTy = GetUserDefinedType(TypeName);
-    return std::make_unique<StructInitExpression>(ResTy, std::move(InitList),
-                                                  std::move(InitOrder));
+    return Ctx.Create<StructInitExpression>(ResTy, std::move(InitList),
+                                            std::move(InitOrder));
   }
 
   auto Expr = ParsePrimaryExpression();
   if (!Expr)
     return nullptr;
 
-  while (IsPostfixOperator(lexer.GetCurrentToken())) {
+  while (IsPostfixOperator(GetCurrentToken())) {
     if (lexer.Is(Token::PlusPlus) || lexer.Is(Token::MinusMinus)) {
-      auto Operation = lexer.GetCurrentToken();
-      Lex(); // eat the token
+      auto Operation = Lex(); // eat the token
       Expr->SetLValueness(true);
-      Expr =
-          std::make_unique<UnaryExpression>(Operation, std::move(Expr), true);
+      Expr = Ctx.Create<UnaryExpression>(Operation, Expr, true);
     }
     // Parse a CallExpression here
     else if (lexer.Is(Token::LeftParen)) {
@@ -1263,7 +1253,7 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
     }
     // parse ArrayExpression
     else if (lexer.Is(Token::LeftBracket)) {
-      Expr = ParseArrayExpression(std::move(Expr));
+      Expr = ParseArrayExpression(Expr);
     }
     // parse StructMemberAccess
     else if (lexer.Is(Token::Dot) || lexer.Is(Token::MinusGreaterThan)) {
@@ -1273,19 +1263,18 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
       auto MemberIdStr = MemberId.GetString();
 
       // find the type of the member
-      auto StructDataTuple = UserDefinedTypes[Expr->GetResultType().GetName()];
-      auto StructType = std::get<0>(StructDataTuple);
-      auto StructMemberNames = std::get<1>(StructDataTuple);
+      auto &StructMemberNames =
+          std::get<1>(UserDefinedTypes[Expr->GetResultType().GetName()]);
 
       size_t MemberIndex = -1;
       for (size_t i = 0; i < StructMemberNames.size(); i++)
-        if (StructMemberNames[i] == MemberId) {
+        if (StructMemberNames[i].GetSymbol() == MemberId.GetSymbol()) {
           MemberIndex = i;
           break;
         }
 
-      Expr = std::make_unique<StructMemberReference>(std::move(Expr), MemberId,
-                                                     MemberIndex, IsArrow);
+      Expr = Ctx.Create<StructMemberReference>(Expr, MemberId,
+                                               MemberIndex, IsArrow);
       if (Expr->GetResultType().IsStruct() || Expr->GetResultType().IsArray())
         Expr->SetLValueness(true);
     }
@@ -1294,17 +1283,17 @@ std::unique_ptr<Expression> Parser::ParsePostFixExpression() {
   return Expr;
 }
 
-std::unique_ptr<Expression> Parser::ParseUnaryExpression() {
+Expression *Parser::ParseUnaryExpression() {
   auto UnaryOperation = GetCurrentToken();
 
   // cast expression case
   if (GetCurrentToken().GetKind() == Token::LeftParen &&
-      IsTypeSpecifier(lexer.LookAhead(2)) &&
+      IsTypeSpecifier(LookAhead(2)) &&
       // and it is not a struct initialization like "(StructType) { ..."
-      !((lexer.LookAhead(2).GetKind() == Token::Identifier &&
-         lexer.LookAhead(4).GetKind() == Token::LeftCurly) ||
-        (lexer.LookAhead(2).GetKind() == Token::Struct &&
-         lexer.LookAhead(5).GetKind() == Token::LeftCurly))) {
+      !((LookAhead(2).GetKind() == Token::Identifier &&
+         LookAhead(4).GetKind() == Token::LeftCurly) ||
+        (LookAhead(2).GetKind() == Token::Struct &&
+         LookAhead(5).GetKind() == Token::LeftCurly))) {
     Lex(); // eat the '('
 
     auto type = ParseType(GetCurrentToken().GetKind());
@@ -1318,8 +1307,7 @@ std::unique_ptr<Expression> Parser::ParseUnaryExpression() {
     Expect(Token::RightParen);
 
     auto ExprToCast = ParseExpression();
-    return std::make_unique<ImplicitCastExpression>(std::move(ExprToCast), type,
-                                                    true);
+    return Ctx.Create<ImplicitCastExpression>(ExprToCast, type, true);
   }
 
   if (!IsUnaryOperator(UnaryOperation.GetKind()))
@@ -1327,18 +1315,18 @@ std::unique_ptr<Expression> Parser::ParseUnaryExpression() {
 
   Lex(); // eat the unary operation char
 
-  std::unique_ptr<Expression> Expr;
+  Expression *Expr;
   bool hasSizeofParenthesis = false;
 
   // 'sizeof' handling
   if (UnaryOperation.GetKind() == Token::Sizeof) {
-    if (lexer.GetCurrentToken().GetKind() == Token::LeftParen) {
+    if (GetCurrentToken().GetKind() == Token::LeftParen) {
       Lex();
       hasSizeofParenthesis = true;
     }
 
-    if (IsTypeSpecifier(lexer.GetCurrentToken())) {
-      auto type = ParseType(lexer.GetCurrentToken().GetKind());
+    if (IsTypeSpecifier(GetCurrentToken())) {
+      auto type = ParseType(GetCurrentToken().GetKind());
       Lex();
 
       while (lexer.Is(Token::Astrix)) {
@@ -1349,7 +1337,7 @@ std::unique_ptr<Expression> Parser::ParseUnaryExpression() {
       if (hasSizeofParenthesis)
         Expect(Token::RightParen);
 
-      auto UE = std::make_unique<UnaryExpression>(UnaryOperation, nullptr);
+      auto UE = Ctx.Create<UnaryExpression>(UnaryOperation, nullptr);
       UE->SetSizeOfType(type);
       return UE;
     }
@@ -1364,8 +1352,7 @@ std::unique_ptr<Expression> Parser::ParseUnaryExpression() {
     if (UnaryOperation.GetKind() == Token::PlusPlus ||
         UnaryOperation.GetKind() == Token::MinusMinus)
       UnaryExpr->SetLValueness(true);
-    return std::make_unique<UnaryExpression>(UnaryOperation,
-                                             std::move(UnaryExpr));
+    return Ctx.Create<UnaryExpression>(UnaryOperation, UnaryExpr);
   }
 
   // TODO: Add semantic check that only pointer types are dereferenced
@@ -1377,7 +1364,7 @@ std::unique_ptr<Expression> Parser::ParseUnaryExpression() {
   if (UnaryOperation.GetKind() == Token::PlusPlus ||
       UnaryOperation.GetKind() == Token::MinusMinus)
     Expr->SetLValueness(true);
-  return std::make_unique<UnaryExpression>(UnaryOperation, std::move(Expr));
+  return Ctx.Create<UnaryExpression>(UnaryOperation, Expr);
 }
 
 static int GetBinOpPrecedence(Token::TokenKind TK) {
@@ -1427,21 +1414,20 @@ static int GetBinOpPrecedence(Token::TokenKind TK) {
   }
 }
 
-std::unique_ptr<Expression> Parser::ParseBinaryExpression() {
+Expression *Parser::ParseBinaryExpression() {
   auto LeftExpression = ParseUnaryExpression();
   if (!LeftExpression)
     return nullptr;
 
   // TODO: see other call sites...
   if (lexer.Is(Token::QuestionMark))
-    LeftExpression = ParseTernaryExpression(std::move(LeftExpression));
+    LeftExpression = ParseTernaryExpression(LeftExpression);
 
-  return ParseBinaryExpressionRHS(0, std::move(LeftExpression));
+  return ParseBinaryExpressionRHS(0, LeftExpression);
 }
 
-std::unique_ptr<Expression>
-Parser::ParseBinaryExpressionRHS(int Precedence,
-                                 std::unique_ptr<Expression> LeftExpression) {
+Expression *Parser::ParseBinaryExpressionRHS(int Precedence,
+                                 Expression *LeftExpression) {
   while (true) {
     int TokenPrecedence = GetBinOpPrecedence(GetCurrentTokenKind());
 
@@ -1485,22 +1471,22 @@ Parser::ParseBinaryExpressionRHS(int Precedence,
 
     if (IsArithmetic && Type::IsSmallerThanInt(
                             LeftExpression->GetResultType().GetTypeVariant())) {
-      LeftExpression = std::make_unique<ImplicitCastExpression>(
-          std::move(LeftExpression), Type(Type::Int));
+      LeftExpression = Ctx.Create<ImplicitCastExpression>(
+          LeftExpression, Type(Type::Int));
     }
 
     if (IsArithmetic &&
         Type::IsSmallerThanInt(
             RightExpression->GetResultType().GetTypeVariant())) {
-      RightExpression = std::make_unique<ImplicitCastExpression>(
-          std::move(RightExpression), Type(Type::Int));
+      RightExpression = Ctx.Create<ImplicitCastExpression>(
+          RightExpression, Type(Type::Int));
     }
 
     // If it is an assignment and the left hand side is an LValue.
     // TODO: Should be solved in a better way. Seems like LLVM using
     // ImplicitCast for this purpose as well. Should investigate that solution.
     if (IsAssignment) {
-      const auto LHS = LeftExpression.get();
+      const auto LHS = LeftExpression;
 
       if (instanceof <ArrayExpression>(LHS) ||
           instanceof <ReferenceExpression>(LHS) || instanceof
@@ -1528,7 +1514,7 @@ Parser::ParseBinaryExpressionRHS(int Precedence,
     }
     if (TokenPrecedence < NextTokenPrec)
       RightExpression = ParseBinaryExpressionRHS(
-          TokenPrecedence + Associativity, std::move(RightExpression));
+          TokenPrecedence + Associativity, RightExpression);
 
     // Implicit cast insertion if needed.
     auto LeftType = LeftExpression->GetResultType();
@@ -1540,8 +1526,8 @@ Parser::ParseBinaryExpressionRHS(int Precedence,
       // left-hand side if it is allowed
       if (IsAssignment) {
         if (Type::IsImplicitlyCastable(RightType, LeftType))
-          RightExpression = std::make_unique<ImplicitCastExpression>(
-              std::move(RightExpression), LeftType);
+          RightExpression = Ctx.Create<ImplicitCastExpression>(
+              RightExpression, LeftType);
       }
       // Otherwise cast the one with lower conversion rank to the higher one
       else if (Type::IsImplicitlyCastable(RightType, LeftType) ||
@@ -1554,11 +1540,11 @@ Parser::ParseBinaryExpressionRHS(int Precedence,
 
         // If left-hand side needs the conversion
         if (LeftNeedConv)
-          LeftExpression = std::make_unique<ImplicitCastExpression>(
-              std::move(LeftExpression), RightType);
+          LeftExpression = Ctx.Create<ImplicitCastExpression>(
+              LeftExpression, RightType);
         else // if the right one
-          RightExpression = std::make_unique<ImplicitCastExpression>(
-              std::move(RightExpression), LeftType);
+          RightExpression = Ctx.Create<ImplicitCastExpression>(
+              RightExpression, LeftType);
       }
     }
 
@@ -1566,31 +1552,29 @@ Parser::ParseBinaryExpressionRHS(int Precedence,
     //  parenthesis, which for the time being is sufficient. Make it work as it
     //  should.
     if (lexer.Is(Token::QuestionMark))
-      RightExpression = ParseTernaryExpression(std::move(RightExpression));
+      RightExpression = ParseTernaryExpression(RightExpression);
 
-    LeftExpression = std::make_unique<BinaryExpression>(
-        std::move(LeftExpression), BinaryOperator, std::move(RightExpression));
+    LeftExpression = Ctx.Create<BinaryExpression>(
+        LeftExpression, BinaryOperator, RightExpression);
   }
 }
 
 // <TernaryExpression> ::= <Expression> '?' <Expression> ':' <Expression>
-std::unique_ptr<Expression>
-Parser::ParseTernaryExpression(std::unique_ptr<Expression> Condition) {
+Expression *Parser::ParseTernaryExpression(Expression *Condition) {
   if (Condition && !Condition->GetResultType().IsIntegerType())
-    Condition = std::make_unique<ImplicitCastExpression>(std::move(Condition),
-                                                         Type(Type::Int));
+    Condition = Ctx.Create<ImplicitCastExpression>(Condition, Type(Type::Int));
   Expect(Token::QuestionMark);
   auto TrueExpr = ParseExpression();
   Expect(Token::Colon);
   auto FalseExpr = ParseExpression();
 
-  return std::make_unique<TernaryExpression>(Condition, TrueExpr, FalseExpr);
+  return Ctx.Create<TernaryExpression>(Condition, TrueExpr, FalseExpr);
 }
 
 // <PrimaryExpression> ::= <IdentifierExpression>
 //                       | '(' <Expression> ')'
 //                       | <ConstantExpression>
-std::unique_ptr<Expression> Parser::ParsePrimaryExpression() {
+Expression *Parser::ParsePrimaryExpression() {
   if (lexer.Is(Token::LeftParen)) {
     Lex();
     auto Expression = ParseExpression();
@@ -1610,7 +1594,7 @@ std::unique_ptr<Expression> Parser::ParsePrimaryExpression() {
 // <ConstantExpression> ::= -?[1-9][0-9]*
 //                        | -?[0-9]+.[0-9]+
 //                        | -?'\'' \?. '\''
-std::unique_ptr<Expression> Parser::ParseConstantExpression() {
+Expression *Parser::ParseConstantExpression() {
   // Handle enumerator constant cases
   bool IsNegative = false;
   if (lexer.Is(Token::Minus)) {
@@ -1622,8 +1606,7 @@ std::unique_ptr<Expression> Parser::ParseConstantExpression() {
   if (lexer.Is(Token::CharacterLiteral)) {
     auto CharToken = Expect(Token::CharacterLiteral);
 
-    auto IntLit =
-        std::make_unique<IntegerLiteralExpression>(CharToken.GetValue());
+    auto IntLit = Ctx.Create<IntegerLiteralExpression>(CharToken.GetValue());
     if (IsNegative)
       IntLit->SetValue(-IntLit->GetSIntValue());
 
@@ -1634,17 +1617,16 @@ std::unique_ptr<Expression> Parser::ParseConstantExpression() {
     auto StringToken = Expect(Token::StringLiteral);
 
     assert(StringToken.GetString().length() >= 2);
-    return std::make_unique<StringLiteralExpression>(
+    return Ctx.Create<StringLiteralExpression>(
         // removing the quotes (") with substr
         StringToken.GetString().substr(1,
                                        StringToken.GetString().length() - 2));
   } else if (lexer.Is(Token::Identifier)) {
     auto Id = Expect(Token::Identifier);
-    auto IdStr = Id.GetString();
 
-    if (auto SymEntry = SymTabStack.Contains(IdStr)) {
-      if (auto Val = std::get<2>(SymEntry.value()); !Val.IsEmpty()) {
-        auto Enum = std::make_unique<IntegerLiteralExpression>(Val.GetIntVal());
+    if (auto SymEntry = SymTabStack.Contains(Id.GetSymbol())) {
+      if (auto Val = std::get<2>(*SymEntry); !Val.IsEmpty()) {
+        auto Enum = Ctx.Create<IntegerLiteralExpression>(Val.GetIntVal());
         if (IsNegative)
           Enum->SetValue(-Enum->GetSIntValue());
         return Enum;
@@ -1653,8 +1635,7 @@ std::unique_ptr<Expression> Parser::ParseConstantExpression() {
     } else
       assert(!"Not an enumerator constant");
   } else if (lexer.Is(Token::Integer)) {
-    auto IntLit =
-        std::make_unique<IntegerLiteralExpression>(ParseIntegerConstant());
+    auto IntLit = Ctx.Create<IntegerLiteralExpression>(ParseIntegerConstant());
     if (IsNegative)
       IntLit->SetValue(-IntLit->GetSIntValue());
     // TODO: currently 1 ull would be valid since the lexer will ignore the
@@ -1680,23 +1661,23 @@ std::unique_ptr<Expression> Parser::ParseConstantExpression() {
     }
     return IntLit;
   } else {
-    auto FPLit = std::make_unique<FloatLiteralExpression>(ParseRealConstant());
+    auto FPLit = Ctx.Create<FloatLiteralExpression>(ParseRealConstant());
     if (IsNegative)
       FPLit->SetValue(-FPLit->GetValue());
     return FPLit;
   }
 }
 
-std::unique_ptr<Expression> Parser::ParseCallExpression(Token Id) {
+Expression *Parser::ParseCallExpression(const Token &Id) {
   assert(Id.GetKind() == Token::Identifier && "Identifier expected");
   Lex(); // eat the '('
 
   Type FuncType = Type(Type::Int); // default return type is int
 
-  if (auto SymEntry = SymTabStack.Contains(Id.GetString()))
-    FuncType = std::get<1>(SymEntry.value());
+  if (auto SymEntry = SymTabStack.Contains(Id.GetSymbol()))
+    FuncType = std::get<1>(*SymEntry);
 
-  std::vector<std::unique_ptr<Expression>> CallArgs;
+  std::vector<Expression *> CallArgs;
 
   if (lexer.IsNot(Token::RightParen))
     CallArgs.push_back(ParseExpression());
@@ -1719,19 +1700,18 @@ std::unique_ptr<Expression> Parser::ParseCallExpression(Token Id) {
       if (CallArgType != FuncArgTypes[i]) {
         // Cast if allowed
         if (Type::IsImplicitlyCastable(CallArgType, FuncArgTypes[i]))
-          CallArgs[i] = std::make_unique<ImplicitCastExpression>(
-              std::move(CallArgs[i]), FuncArgTypes[i]);
+          CallArgs[i] = Ctx.Create<ImplicitCastExpression>(
+              CallArgs[i], FuncArgTypes[i]);
       }
     }
   }
 
   Expect(Token::RightParen);
 
-  return std::make_unique<CallExpression>(Id, CallArgs, FuncType);
+  return Ctx.Create<CallExpression>(Id, CallArgs, FuncType);
 }
 
-std::unique_ptr<Expression>
-Parser::ParseArrayExpression(std::unique_ptr<Expression> Base) {
+Expression *Parser::ParseArrayExpression(Expression *Base) {
   Lex();
   auto IndexExpr = ParseExpression();
   Expect(Token::RightBracket);
@@ -1742,37 +1722,35 @@ Parser::ParseArrayExpression(std::unique_ptr<Expression> Base) {
   /// ActualType is 'int arr[5][10]' and our reference is 'arr[0]'
   /// then the result type of 'arr[0]' is 'int[10]'.
   if (!type.IsPointerType() && type.IsArray()) {
-    type.GetDimensions().erase(type.GetDimensions().begin());
-    // if the result is now a scalar, then change the type to Simple (scalar)
-    if (type.GetDimensions().empty())
-      type.SetTypeKind(Type::Simple);
+    // if the result is now a scalar, then the type is changed to Simple too
+    type.RemoveFirstDimension();
   } else if (type.IsPointerType())
     type.DecrementPointerLevel();
 
   Base->SetLValueness(true);
-  return std::make_unique<ArrayExpression>(Base, IndexExpr, type);
+  return Ctx.Create<ArrayExpression>(Base, IndexExpr, type);
 }
 
 // <IdentifierExpression> ::= Identifier
-std::unique_ptr<Expression> Parser::ParseIdentifierExpression() {
+Expression *Parser::ParseIdentifierExpression() {
   auto Id = Expect(Token::Identifier);
 
   // Identifier case
-  auto RE = std::make_unique<ReferenceExpression>(Id);
-  auto IdStr = Id.GetString();
+  auto RE = Ctx.Create<ReferenceExpression>(Id);
+  auto IdSym = Id.GetSymbol();
 
-  if (auto SymEntry = SymTabStack.Contains(IdStr)) {
+  if (auto SymEntry = SymTabStack.Contains(IdSym)) {
     // If the symbol value is a know constant like in case of enumerators, then
     // return just a constant expression
     // TODO: Maybe do ths check earlier to save ourself from creating RE for
     // nothing
-    if (auto Val = std::get<2>(SymEntry.value()); !Val.IsEmpty())
-      return std::make_unique<IntegerLiteralExpression>(Val.GetIntVal());
+    if (auto Val = std::get<2>(*SymEntry); !Val.IsEmpty())
+      return Ctx.Create<IntegerLiteralExpression>(Val.GetIntVal());
 
-    auto Type = std::get<1>(SymEntry.value());
+    auto Type = std::get<1>(*SymEntry);
     RE->SetType(Type);
-  } else if (UserDefinedTypes.count(IdStr) > 0) {
-    auto Type = std::get<0>(UserDefinedTypes[IdStr]);
+  } else if (UserDefinedTypes.count(IdSym) > 0) {
+    auto Type = std::get<0>(UserDefinedTypes[IdSym]);
     RE->SetType(Type);
   }
 
@@ -1783,11 +1761,10 @@ std::unique_ptr<Expression> Parser::ParseIdentifierExpression() {
 //                                      <InitializerListExpression>}
 //                                     {',' {<ConstantExpression> |
 //                                      <InitializerListExpression>} }* '}'
-std::unique_ptr<Expression>
-Parser::ParseInitializerListExpression(const Type &LHSType) {
+Expression *Parser::ParseInitializerListExpression(const Type &LHSType) {
   Expect(Token::LeftCurly);
 
-  std::unique_ptr<Expression> E;
+  Expression *E;
 
   auto ExpectedType = LHSType;
   // TODO: Investigate that the expected type should always be an array
@@ -1805,12 +1782,12 @@ Parser::ParseInitializerListExpression(const Type &LHSType) {
 
   // For now do not casting InitializerLists
   // TODO: might be nice to do it in the future
-  if (!IsInitList && !dynamic_cast<StringLiteralExpression *>(E.get()) &&
+  if (!IsInitList && !dynamic_cast<StringLiteralExpression *>(E) &&
       !ExpectedType.IsStruct())
-    DoImplicitCastIfNeeded(E, ExpectedType);
+    DoImplicitCastIfNeeded(Ctx, E, ExpectedType);
 
-  std::vector<std::unique_ptr<Expression>> ExprList;
-  ExprList.push_back(std::move(E));
+  std::vector<Expression *> ExprList;
+  ExprList.push_back(E);
 
   while (lexer.Is(Token::Comma)) {
     Lex(); // eat ','
@@ -1821,14 +1798,207 @@ Parser::ParseInitializerListExpression(const Type &LHSType) {
     else
       E = ParseConstantExpression();
 
-    if (!IsInitList && !dynamic_cast<StringLiteralExpression *>(E.get())
+    if (!IsInitList && !dynamic_cast<StringLiteralExpression *>(E)
         && !ExpectedType.IsStruct())
-      DoImplicitCastIfNeeded(E, ExpectedType);
+      DoImplicitCastIfNeeded(Ctx, E, ExpectedType);
 
-    ExprList.push_back(std::move(E));
+    ExprList.push_back(E);
   }
 
   Expect(Token::RightCurly);
 
-  return std::make_unique<InitializerListExpression>(std::move(ExprList));
+  return Ctx.Create<InitializerListExpression>(std::move(ExprList));
+}
+
+/// The kinds of the declarations in a precompiled header.
+enum PCHDeclarationKind { PCHStruct, PCHEnum, PCHFunction };
+
+/// Sort @Map by the names, so the written file does not depend on the order
+/// of the hash map.
+template <typename T>
+static std::vector<std::pair<Symbol, T>>
+SortByName(const std::unordered_map<Symbol, T> &Map) {
+  std::vector<std::pair<Symbol, T>> Result(Map.begin(), Map.end());
+  std::sort(Result.begin(), Result.end(), [](auto &LHS, auto &RHS) {
+    return LHS.first.Str() < RHS.first.Str();
+  });
+  return Result;
+}
+
+bool Parser::WritePCH(PCHWriter &W, const TranslationUnit &TU) {
+  assert(lexer.Is(Token::EndOfFile) && "The header is not parsed yet");
+
+  // The header is the beginning of the translation units using it
+  W.WriteInt(lexer.GetPosition());
+
+  auto SortedUserDefinedTypes = SortByName(UserDefinedTypes);
+  W.WriteInt(SortedUserDefinedTypes.size());
+  for (auto &[Name, TypeAndMembers] : SortedUserDefinedTypes) {
+    auto &[UDType, MemberNames] = TypeAndMembers;
+    W.WriteSymbol(Name);
+    W.WriteType(UDType);
+    W.WriteInt(MemberNames.size());
+    for (auto &MemberName : MemberNames)
+      W.WriteToken(MemberName);
+  }
+
+  auto SortedTypeDefinitions = SortByName(TypeDefinitions);
+  W.WriteInt(SortedTypeDefinitions.size());
+  for (auto &[Name, TypedefType] : SortedTypeDefinitions) {
+    W.WriteSymbol(Name);
+    W.WriteType(TypedefType);
+  }
+
+  auto GlobalEntries = SymTabStack.GetGlobalEntries();
+  W.WriteInt(GlobalEntries.size());
+  for (auto &[SymName, SymType, SymValue] : GlobalEntries) {
+    W.WriteToken(SymName);
+    W.WriteType(SymType);
+
+    auto Value = SymValue;
+    W.WriteInt(Value.IsInt() ? 1 : Value.IsFloat() ? 2 : 0);
+    if (Value.IsInt())
+      W.WriteInt(static_cast<unsigned>(Value.GetIntVal()));
+    else if (Value.IsFloat()) {
+      const double FloatVal = Value.GetFloatVal();
+      uint64_t Bits;
+      std::memcpy(&Bits, &FloatVal, sizeof(Bits));
+      W.WriteInt(Bits);
+    }
+  }
+
+  auto &Declarations = TU.GetDeclarations();
+  W.WriteInt(Declarations.size());
+  for (auto Decl : Declarations) {
+    if (auto SD = dynamic_cast<StructDeclaration *>(Decl)) {
+      W.WriteInt(PCHStruct);
+      W.WriteToken(SD->GetNameToken());
+      W.WriteType(SD->GetType());
+      W.WriteInt(SD->GetMembers().size());
+      for (auto Member : SD->GetMembers()) {
+        W.WriteToken(Member->GetNameToken());
+        W.WriteType(Member->GetType());
+      }
+    } else if (auto ED = dynamic_cast<EnumDeclaration *>(Decl)) {
+      W.WriteInt(PCHEnum);
+      W.WriteType(ED->GetBaseType());
+      W.WriteInt(ED->GetEnumerators().size());
+      for (auto &[Name, Value] : ED->GetEnumerators()) {
+        W.WriteString(Name);
+        W.WriteInt(static_cast<unsigned>(Value));
+      }
+    } else if (auto FD = dynamic_cast<FunctionDeclaration *>(Decl);
+               FD != nullptr && FD->GetBody() == nullptr) {
+      W.WriteInt(PCHFunction);
+      W.WriteType(FD->GetType());
+      W.WriteToken(FD->GetNameToken());
+      W.WriteInt(FD->GetReturnsNumber());
+      W.WriteInt(FD->GetArguments().size());
+      for (auto Param : FD->GetArguments()) {
+        W.WriteToken(Param->GetNameToken());
+        W.WriteType(Param->GetType());
+      }
+    } else
+      return false;
+  }
+
+  return true;
+}
+
+bool Parser::ReadPCH(PCHReader &R) {
+  const auto HeaderEnd = R.ReadInt();
+
+  for (auto Num = R.ReadInt(); Num > 0 && !R.HasError(); Num--) {
+    auto Name = R.ReadSymbol();
+    auto UDType = R.ReadType();
+    std::vector<Token> MemberNames;
+    for (auto NumMembers = R.ReadInt(); NumMembers > 0 && !R.HasError();
+         NumMembers--)
+      MemberNames.push_back(R.ReadToken());
+    UserDefinedTypes[Name] = {UDType, std::move(MemberNames)};
+  }
+
+  for (auto Num = R.ReadInt(); Num > 0 && !R.HasError(); Num--) {
+    auto Name = R.ReadSymbol();
+    TypeDefinitions[Name] = R.ReadType();
+  }
+
+  for (auto Num = R.ReadInt(); Num > 0 && !R.HasError(); Num--) {
+    auto SymName = R.ReadToken();
+    auto SymType = R.ReadType();
+
+    switch (R.ReadInt()) {
+    case 1: {
+      const auto IntVal = static_cast<unsigned>(R.ReadInt());
+      InsertToSymTable(SymName, SymType, true, ValueType(IntVal));
+      break;
+    }
+    case 2: {
+      const uint64_t Bits = R.ReadInt();
+      double FloatVal;
+      std::memcpy(&FloatVal, &Bits, sizeof(FloatVal));
+      InsertToSymTable(SymName, SymType, true, ValueType(FloatVal));
+      break;
+    }
+    default:
+      InsertToSymTable(SymName, SymType, true);
+      break;
+    }
+  }
+
+  for (auto Num = R.ReadInt(); Num > 0 && !R.HasError(); Num--) {
+    switch (R.ReadInt()) {
+    case PCHStruct: {
+      auto Name = R.ReadToken();
+      auto SType = R.ReadType();
+      std::vector<MemberDeclaration *> Members;
+      for (auto NumMembers = R.ReadInt(); NumMembers > 0 && !R.HasError();
+           NumMembers--) {
+        auto MemberName = R.ReadToken();
+        Members.push_back(
+            Ctx.Create<MemberDeclaration>(MemberName, R.ReadType()));
+      }
+      PrecompiledDeclarations.push_back(
+          Ctx.Create<StructDeclaration>(Name, Members, SType));
+      break;
+    }
+    case PCHEnum: {
+      auto BaseType = R.ReadType();
+      EnumDeclaration::EnumList Enumerators;
+      for (auto NumEnums = R.ReadInt(); NumEnums > 0 && !R.HasError();
+           NumEnums--) {
+        std::string Name(R.ReadString());
+        Enumerators.push_back({Name, static_cast<int>(R.ReadInt())});
+      }
+      PrecompiledDeclarations.push_back(
+          Ctx.Create<EnumDeclaration>(BaseType, std::move(Enumerators)));
+      break;
+    }
+    case PCHFunction: {
+      auto FuncType = R.ReadType();
+      auto Name = R.ReadToken();
+      auto ReturnsNum = R.ReadInt();
+      std::vector<FunctionParameterDeclaration *> Params;
+      for (auto NumParams = R.ReadInt(); NumParams > 0 && !R.HasError();
+           NumParams--) {
+        auto Param = Ctx.Create<FunctionParameterDeclaration>();
+        Param->SetName(R.ReadToken());
+        Param->SetType(R.ReadType());
+        Params.push_back(Param);
+      }
+      PrecompiledDeclarations.push_back(Ctx.Create<FunctionDeclaration>(
+          FuncType, Name, Params, nullptr, ReturnsNum));
+      break;
+    }
+    default:
+      R.SetError();
+      break;
+    }
+  }
+
+  if (R.HasError())
+    return false;
+
+  lexer.SetPosition(HeaderEnd);
+  return true;
 }
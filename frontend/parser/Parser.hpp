@@ -4,25 +4,37 @@
 #include "../../middle_end/IR/IRFactory.hpp"
 #include "../ErrorLogger.hpp"
 #include "../ast/AST.hpp"
+#include "../ast/ASTContext.hpp"
 #include "../lexer/Lexer.hpp"
 #include "../lexer/Token.hpp"
 #include "SymbolTable.hpp"
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+class PCHReader;
+class PCHWriter;
+
 class Parser {
 public:
-  std::unique_ptr<Node> Parse();
+  Node *Parse();
 
   Parser() = delete;
 
-  Parser(std::vector<std::string> &s, IRFactory *IRF, ErrorLogger &EL)
-      : lexer(s), IRF(IRF), ErrorLog(EL) {}
+  Parser(const SourceBuffer &Source, ASTContext &Ctx, IRFactory *IRF,
+         ErrorLogger &EL)
+      : lexer(Source), Ctx(Ctx), IRF(IRF), ErrorLog(EL) {}
 
   Token Lex() { return lexer.Lex(); }
 
-  Token GetCurrentToken() { return lexer.GetCurrentToken(); }
+  /// Peek the current token. The reference is only valid until the token is
+  /// consumed.
+  const Token &GetCurrentToken() { return lexer.GetCurrentToken(); }
+
+  /// Peek the @n-th upcoming token, where the current one is the 1st. The
+  /// reference is only valid until the token is consumed.
+  const Token &LookAhead(unsigned n) { return lexer.LookAhead(n); }
 
   Token::TokenKind GetCurrentTokenKind() {
     return lexer.GetCurrentToken().GetKind();
@@ -35,75 +47,86 @@ public:
   void InsertToSymTable(const Token &SymName, const Type &SymType,
                         bool ToGlobal, ValueType SymValue);
 
-  bool IsUserDefined(const std::string &Name);
-  Type GetUserDefinedType(const std::string &Name);
-  std::vector<Token> GetUserDefinedTypeMembers(std::string Name);
+  bool IsUserDefined(Symbol Name);
+  Type GetUserDefinedType(Symbol Name);
+  std::vector<Token> GetUserDefinedTypeMembers(Symbol Name);
 
   unsigned ParseQualifiers();
   Type ParseType(Token::TokenKind tk);
-  bool IsTypeSpecifier(Token T);
-  bool IsReturnTypeSpecifier(Token T);
+  bool IsTypeSpecifier(const Token &T);
+  bool IsReturnTypeSpecifier(const Token &T);
   void ParseArrayDimensions(Type &type);
-  bool IsQualifiedType(Token T);
-
-  std::unique_ptr<Node> ParseTranslationUnit();
-  std::unique_ptr<Node> ParseExternalDeclaration();
-  std::unique_ptr<FunctionDeclaration>
-  ParseFunctionDeclaration(const Type &ReturnType, const Token &Name);
-  std::unique_ptr<VariableDeclaration> ParseVariableDeclaration(Type type);
-  std::vector<std::unique_ptr<VariableDeclaration>>
-  ParseVariableDeclarationList();
-  std::unique_ptr<MemberDeclaration> ParseMemberDeclaration();
-  std::unique_ptr<StructDeclaration>
-  ParseStructDeclaration(unsigned Qualifiers);
-  std::unique_ptr<EnumDeclaration> ParseEnumDeclaration(unsigned Qualifiers);
+  bool IsQualifiedType(const Token &T);
+
+  Node *ParseTranslationUnit();
+  Node *ParseExternalDeclaration();
+  FunctionDeclaration *ParseFunctionDeclaration(const Type &ReturnType,
+                                                const Token &Name);
+  VariableDeclaration *ParseVariableDeclaration(Type type);
+  std::vector<VariableDeclaration *> ParseVariableDeclarationList();
+  MemberDeclaration *ParseMemberDeclaration();
+  StructDeclaration *ParseStructDeclaration(unsigned Qualifiers);
+  EnumDeclaration *ParseEnumDeclaration(unsigned Qualifiers);
   Node ParseReturnTypeSpecifier();
-  std::vector<std::unique_ptr<FunctionParameterDeclaration>>
+  std::vector<FunctionParameterDeclaration *>
   ParseParameterList(bool &HasVarArg);
-  std::unique_ptr<FunctionParameterDeclaration> ParseParameterDeclaration();
+  FunctionParameterDeclaration *ParseParameterDeclaration();
   Type ParseTypeSpecifier();
-  std::unique_ptr<CompoundStatement> ParseCompoundStatement();
-  std::unique_ptr<ReturnStatement> ParseReturnStatement();
-  std::unique_ptr<BreakStatement> ParseBreakStatement();
-  std::unique_ptr<ContinueStatement> ParseContinueStatement();
-  std::unique_ptr<Statement> ParseStatement();
-  std::unique_ptr<ExpressionStatement> ParseExpressionStatement();
-  std::unique_ptr<Expression> ParseExpression();
-  std::unique_ptr<Expression> ParsePostFixExpression();
-  std::unique_ptr<Expression> ParseUnaryExpression();
-  std::unique_ptr<Expression> ParseBinaryExpression();
-  std::unique_ptr<Expression>
-  ParseTernaryExpression(std::unique_ptr<Expression> Condition);
-  std::unique_ptr<Expression>
-  ParseBinaryExpressionRHS(int Precedence, std::unique_ptr<Expression> LHS);
-  std::unique_ptr<Expression> ParseCallExpression(Token ID);
-  std::unique_ptr<Expression>
-  ParseArrayExpression(std::unique_ptr<Expression> Base);
-  std::unique_ptr<Expression> ParseIdentifierExpression();
-  std::unique_ptr<Expression> ParsePrimaryExpression();
-  std::unique_ptr<Expression>
-  ParseInitializerListExpression(const Type &ExpectedType);
-  std::unique_ptr<WhileStatement> ParseWhileStatement();
-  std::unique_ptr<DoWhileStatement> ParseDoWhileStatement();
-  std::unique_ptr<ForStatement> ParseForStatement();
-  std::unique_ptr<IfStatement> ParseIfStatement();
-  std::unique_ptr<SwitchStatement> ParseSwitchStatement();
-  std::unique_ptr<Expression> ParseConstantExpression();
+  CompoundStatement *ParseCompoundStatement();
+  ReturnStatement *ParseReturnStatement();
+  BreakStatement *ParseBreakStatement();
+  ContinueStatement *ParseContinueStatement();
+  Statement *ParseStatement();
+  ExpressionStatement *ParseExpressionStatement();
+  Expression *ParseExpression();
+  Expression *ParsePostFixExpression();
+  Expression *ParseUnaryExpression();
+  Expression *ParseBinaryExpression();
+  Expression *ParseTernaryExpression(Expression *Condition);
+  Expression *ParseBinaryExpressionRHS(int Precedence, Expression *LHS);
+  Expression *ParseCallExpression(const Token &ID);
+  Expression *ParseArrayExpression(Expression *Base);
+  Expression *ParseIdentifierExpression();
+  Expression *ParsePrimaryExpression();
+  Expression *ParseInitializerListExpression(const Type &ExpectedType);
+  WhileStatement *ParseWhileStatement();
+  DoWhileStatement *ParseDoWhileStatement();
+  ForStatement *ParseForStatement();
+  IfStatement *ParseIfStatement();
+  SwitchStatement *ParseSwitchStatement();
+  Expression *ParseConstantExpression();
   unsigned ParseIntegerConstant();
   double ParseRealConstant();
 
   ErrorLogger &GetErrorLog() { return ErrorLog; }
 
+  /// Save the declared types, the global symbols and the declarations of @TU
+  /// into @W, after parsing a header. Return false if @TU has anything else
+  /// than type and function declarations, which cannot be precompiled.
+  bool WritePCH(PCHWriter &W, const TranslationUnit &TU);
+
+  /// Restore the state saved by WritePCH before Parse(). The source has to
+  /// start with the preprocessed header, parsing continues after it. Return
+  /// false if the data is malformed.
+  bool ReadPCH(PCHReader &R);
+
 private:
   Lexer lexer;
+  /// Owner of every node created by the parser
+  ASTContext &Ctx;
   SymbolTableStack SymTabStack;
   IRFactory *IRF;
 
   /// Type name to type, and the list of names for the struct field
-  std::map<std::string, std::tuple<Type, std::vector<Token>>> UserDefinedTypes;
+  std::unordered_map<Symbol, std::tuple<Type, std::vector<Token>>>
+      UserDefinedTypes;
 
   /// Mapping identifiers to types. Eg: "typedef int i32" -> {"i32", Type::Int}
-  std::map<std::string, Type> TypeDefinitions;
+  std::unordered_map<Symbol, Type> TypeDefinitions;
+
+  /// The declarations of the precompiled header, they are the first ones of
+  /// the translation unit.
+  std::vector<Statement *> PrecompiledDeclarations;
 
   /// Used for determining if implicit cast need or not in return statements
   Type CurrentFuncRetType = Type(Type::Invalid);
@@ -1,33 +1,90 @@
 #include "SymbolTable.hpp"
-#include <tuple>
-
-std::optional<SymbolTableStack::Entry>
-SymbolTableStack::Contains(const std::string &sym) {
-  for (int i = Size() - 1; i >= 0; i--) {
-    auto table = SymTabStack[i];
-    for (int j = table.size() - 1; j >= 0; j--)
-      if (sym == std::get<0>(table[j]).GetString())
-        return table[j];
+
+static Symbol GetName(const SymbolTableStack::Entry &e) {
+  return std::get<0>(e).GetSymbol();
+}
+
+void SymbolTableStack::Insert(const Entry &e, unsigned Scope) {
+  assert(Scope < Scopes.size() && "Invalid scope");
+
+  DeclRef NewRef{Scope, static_cast<unsigned>(Scopes[Scope].size())};
+  auto &Visible = VisibleDecls[GetName(e)];
+
+  // The usual case, the new declaration hides every other with the same name
+  if (!Visible.IsValid() || Visible.Scope <= Scope) {
+    Scopes[Scope].push_back({e, Visible});
+    Visible = NewRef;
+    return;
   }
-  return std::nullopt;
+
+  // A global declaration made from a nested scope, like an implicit function
+  // declaration, is still hidden by the declarations of the inner scopes, so
+  // it has to be linked into the middle of the shadow chain.
+  auto Ref = Visible;
+  while (GetDecl(Ref).Shadowed.IsValid() &&
+         GetDecl(Ref).Shadowed.Scope > Scope)
+    Ref = GetDecl(Ref).Shadowed;
+
+  Scopes[Scope].push_back({e, GetDecl(Ref).Shadowed});
+  GetDecl(Ref).Shadowed = NewRef;
 }
 
-std::optional<SymbolTableStack::Entry>
-SymbolTableStack::ContainsInCurrentScope(const std::string &sym) {
-  auto table = SymTabStack.back();
-  for (int j = table.size() - 1; j >= 0; j--)
-    if (sym == std::get<0>(table[j]).GetString())
-      return table[j];
+std::vector<SymbolTableStack::Entry>
+SymbolTableStack::GetGlobalEntries() const {
+  std::vector<Entry> Entries;
+  for (auto &D : Scopes[0])
+    Entries.push_back(D.E);
+  return Entries;
+}
+
+void SymbolTableStack::PopSymTable() {
+  assert(!Scopes.empty() && "Popping item from empty stack.");
+
+  // Restore the declarations hidden by this scope. Going in reverse order,
+  // since the later declarations are shadowing the earlier ones.
+  auto &Scope = Scopes.back();
+  for (auto It = Scope.rbegin(); It != Scope.rend(); ++It) {
+    auto Visible = VisibleDecls.find(GetName(It->E));
+    assert(Visible != VisibleDecls.end());
 
-  return std::nullopt;
+    if (It->Shadowed.IsValid())
+      Visible->second = It->Shadowed;
+    else
+      VisibleDecls.erase(Visible);
+  }
+
+  Scopes.pop_back();
+}
+
+const SymbolTableStack::Entry *
+SymbolTableStack::Contains(Symbol sym) const {
+  auto Visible = VisibleDecls.find(sym);
+  if (Visible == VisibleDecls.end())
+    return nullptr;
+
+  return &GetDecl(Visible->second).E;
 }
 
-std::optional<SymbolTableStack::Entry>
-SymbolTableStack::ContainsInGlobalScope(const std::string &sym) {
-  auto table = SymTabStack[0];
-  for (int j = table.size() - 1; j >= 0; j--)
-    if (sym == std::get<0>(table[j]).GetString())
-      return table[j];
+const SymbolTableStack::Entry *
+SymbolTableStack::ContainsInCurrentScope(Symbol sym) const {
+  auto Visible = VisibleDecls.find(sym);
+  if (Visible == VisibleDecls.end() ||
+      Visible->second.Scope != Scopes.size() - 1)
+    return nullptr;
+
+  return &GetDecl(Visible->second).E;
+}
+
+const SymbolTableStack::Entry *
+SymbolTableStack::ContainsInGlobalScope(Symbol sym) const {
+  auto Visible = VisibleDecls.find(sym);
+  if (Visible == VisibleDecls.end())
+    return nullptr;
+
+  // the global declaration is the last one in the chain, if there is any
+  auto Ref = Visible->second;
+  while (Ref.Scope != 0 && GetDecl(Ref).Shadowed.IsValid())
+    Ref = GetDecl(Ref).Shadowed;
 
-  return std::nullopt;
+  return Ref.Scope == 0 ? &GetDecl(Ref).E : nullptr;
 }
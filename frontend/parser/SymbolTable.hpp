@@ -4,48 +4,68 @@
 #include "../ast/Type.hpp"
 #include "../lexer/Token.hpp"
 #include <cassert>
-#include <optional>
-#include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
-/// Holds a stack (vector) of SymbolTables (vector of tuples).
-/// TODO: An unordered_map would be more appropriate, but
-/// had trouble with it so rather than wasting too much time
-/// with it currently vectors used. Later improve this.
+/// Scoped symbol table. Every name maps to the most recent visible
+/// declaration, which links to the declaration it shadows, so lookups are a
+/// single hash probe. Pushing a scope is O(1), popping it restores the
+/// shadowed declarations of the names declared in it.
 class SymbolTableStack {
 public:
   using Entry = std::tuple<Token, Type, ValueType>;
-  using Table = std::vector<Entry>;
 
   /// Adding the first empty table when constructed
-  SymbolTableStack() { SymTabStack.emplace_back(); }
+  SymbolTableStack() { PushSymTable(); }
 
-  void PushSymTable(Table t = Table()) { SymTabStack.push_back(std::move(t)); }
+  void PushSymTable() { Scopes.emplace_back(); }
 
-  Table PopSymTable() {
-    assert(!SymTabStack.empty() && "Popping item from empty stack.");
-    Table t = SymTabStack[SymTabStack.size() - 1];
-    SymTabStack.pop_back();
-    return t;
-  }
+  void PopSymTable();
 
-  size_t Size() { return SymTabStack.size(); }
+  size_t Size() const { return Scopes.size(); }
 
-  void InsertEntry(const Entry &e) {
-    auto idx = Size() > 0 ? Size() - 1 : 0;
-    SymTabStack[idx].push_back(e);
-  }
+  void InsertEntry(const Entry &e) { Insert(e, Scopes.size() - 1); }
 
-  void InsertGlobalEntry(const Entry &e) { SymTabStack[0].push_back(e); }
+  void InsertGlobalEntry(const Entry &e) { Insert(e, 0); }
 
-  std::optional<Entry> Contains(const std::string &sym);
+  /// Return the visible entry of @sym or nullptr if there is none. The
+  /// returned pointer is invalidated by the next insertion or pop.
+  const Entry *Contains(Symbol sym) const;
 
-  std::optional<Entry> ContainsInCurrentScope(const std::string &sym);
+  const Entry *ContainsInCurrentScope(Symbol sym) const;
 
-  std::optional<Entry> ContainsInGlobalScope(const std::string &sym);
+  const Entry *ContainsInGlobalScope(Symbol sym) const;
+
+  /// Return the entries of the global scope in declaration order.
+  std::vector<Entry> GetGlobalEntries() const;
 
 private:
-  std::vector<Table> SymTabStack;
+  /// Identifies a declaration by its scope and its index in that scope
+  struct DeclRef {
+    unsigned Scope = ~0u;
+    unsigned Index = ~0u;
+
+    bool IsValid() const { return Scope != ~0u; }
+  };
+
+  struct Decl {
+    Entry E;
+    /// The declaration with the same name which is hidden by this one
+    DeclRef Shadowed;
+  };
+
+  void Insert(const Entry &e, unsigned Scope);
+
+  const Decl &GetDecl(DeclRef Ref) const { return Scopes[Ref.Scope][Ref.Index]; }
+  Decl &GetDecl(DeclRef Ref) { return Scopes[Ref.Scope][Ref.Index]; }
+
+  /// The declarations of each scope in declaration order, the global scope is
+  /// the first one.
+  std::vector<std::vector<Decl>> Scopes;
+
+  /// The visible declaration of each name.
+  std::unordered_map<Symbol, DeclRef> VisibleDecls;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,16 +1,23 @@
 #include "PPLexer.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cctype>
 
-std::unordered_map<std::string, PPToken::PPTokenKind> PPLexer::Keywords =
-    std::unordered_map<std::string, PPToken::PPTokenKind>{
+std::unordered_map<std::string_view, PPToken::PPTokenKind> PPLexer::Keywords =
+    std::unordered_map<std::string_view, PPToken::PPTokenKind>{
         {"define", PPToken::Define},
+        {"undef", PPToken::Undef},
         {"include", PPToken::Include},
+        {"if", PPToken::If},
+        {"ifdef", PPToken::IfDef},
         {"ifndef", PPToken::IfNotDef},
+        {"elif", PPToken::ElIf},
+        {"else", PPToken::Else},
         {"endif", PPToken::EndIf},
+        {"pragma", PPToken::Pragma},
     };
 
-PPLexer::PPLexer(std::string &s) {
+PPLexer::PPLexer(std::string_view s) {
   Source = s;
   PPTokenBuffer = std::vector<PPToken>();
   LineIndex = 0;
@@ -30,7 +37,7 @@ int PPLexer::GetNextChar() {
 }
 
 int PPLexer::GetNextNthCharOnSameLine(unsigned n) {
-  if (LineIndex >= Source.size())
+  if (LineIndex + n >= Source.size())
     return EOF;
   return Source[LineIndex + n];
 }
@@ -58,20 +65,59 @@ std::optional<PPToken> PPLexer::LexIdentifier() {
 }
 
 std::optional<PPToken> PPLexer::LexKeyword() {
-  std::size_t WordEnd = Source.substr(LineIndex).find_first_of("\t\n\v\f\r;: ");
+  // all the keywords are lower case words, so do not bother to look up
+  // anything else
+  if (!islower(GetNextChar()))
+    return std::nullopt;
+
+  auto Remaining = Source.substr(LineIndex);
+  auto Word = Remaining.substr(0, Remaining.find_first_of("\t\n\v\f\r;: "));
+
+  auto It = Keywords.find(Word);
+  if (It == Keywords.end())
+    return std::nullopt;
+
+  LineIndex += Word.length();
 
-  auto Word = Source.substr(LineIndex, WordEnd);
+  return PPToken(It->second, Word);
+}
 
-  if (!Keywords.count(Word))
+/// Lex a preprocessing number, which is a digit optionally preceded by a '.'
+/// followed by letters, digits, '_' and '.', like 10, 0x1F, 1.5f or 10ull.
+std::optional<PPToken> PPLexer::LexNumber() {
+  if (!isdigit(GetNextChar()) &&
+      !(GetNextChar() == '.' && isdigit(GetNextNthCharOnSameLine(1))))
     return std::nullopt;
 
   unsigned StartLineIndex = LineIndex;
+  while (isalnum(GetNextChar()) || GetNextChar() == '_' ||
+         GetNextChar() == '.')
+    EatNextChar();
+
+  return PPToken(PPToken::Number,
+                 Source.substr(StartLineIndex, LineIndex - StartLineIndex));
+}
+
+/// Lex a string or character literal including its quotes.
+std::optional<PPToken> PPLexer::LexQuoted() {
+  const int Quote = GetNextChar();
+  if (Quote != '"' && Quote != '\'')
+    return std::nullopt;
 
-  for (int i = Word.length(); i > 0; i--)
+  unsigned StartLineIndex = LineIndex;
+  EatNextChar(); // eat the opening quote
+
+  while (GetNextChar() != EOF && GetNextChar() != Quote) {
+    // skip the escaped character, so \" does not terminate the literal
+    if (GetNextChar() == '\\')
+      EatNextChar();
     EatNextChar();
+  }
+  EatNextChar(); // eat the closing quote
 
-  std::string_view StringValue{&Source[StartLineIndex], Word.length()};
-  return PPToken(PPLexer::Keywords[Word], StringValue);
+  auto Length = std::min<size_t>(LineIndex, Source.size()) - StartLineIndex;
+  return PPToken(Quote == '"' ? PPToken::StringLiteral : PPToken::CharLiteral,
+                 Source.substr(StartLineIndex, Length));
 }
 
 std::optional<PPToken> PPLexer::LexSymbol() {
@@ -93,9 +139,6 @@ std::optional<PPToken> PPLexer::LexSymbol() {
   case ')':
     PPTokenKind = PPToken::RightParen;
     break;
-  case '"':
-    PPTokenKind = PPToken::DoubleQuote;
-    break;
   case '/':
     PPTokenKind = PPToken::ForwardSlash;
     break;
@@ -106,7 +149,7 @@ std::optional<PPToken> PPLexer::LexSymbol() {
     PPTokenKind = PPToken::GreaterThan;
     break;
   default:
-    return std::nullopt;
+    PPTokenKind = PPToken::Other;
     break;
   }
 
@@ -146,10 +189,9 @@ PPToken PPLexer::Lex(bool LookAhead) {
   }
 
   int CurrentCharacter = GetNextChar();
-  std::string WhiteSpaceChars("\t\n\v\f\r ");
 
   // consume white space characters
-  while (WhiteSpaceChars.find(CurrentCharacter) != std::string::npos) {
+  while (CurrentCharacter != EOF && isspace(CurrentCharacter)) {
     EatNextChar();
     CurrentCharacter = GetNextChar();
   }
@@ -159,10 +201,14 @@ PPToken PPLexer::Lex(bool LookAhead) {
 
   auto Result = LexKeyword();
 
-  if (!Result)
-    Result = LexSymbol();
   if (!Result)
     Result = LexIdentifier();
+  if (!Result)
+    Result = LexNumber();
+  if (!Result)
+    Result = LexQuoted();
+  if (!Result)
+    Result = LexSymbol();
 
   if (Result)
     return Result.value();
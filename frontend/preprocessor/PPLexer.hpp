@@ -5,6 +5,7 @@
 #include <cassert>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -19,28 +20,38 @@ public:
 
   std::optional<PPToken> LexIdentifier();
   std::optional<PPToken> LexKeyword();
+  std::optional<PPToken> LexNumber();
+  std::optional<PPToken> LexQuoted();
   std::optional<PPToken> LexSymbol();
   PPToken LookAhead(unsigned n);
   PPToken GetCurrentPPToken() { return LookAhead(1); }
   bool Is(PPToken::PPTokenKind tk);
   bool IsNot(PPToken::PPTokenKind tk);
 
-  std::string &GetSource() { return Source; }
-  std::string GetRemainingText() {
+  std::string_view GetSource() const { return Source; }
+  std::string_view GetRemainingText() const {
     if (LineIndex > Source.length())
       return "";
     return Source.substr(LineIndex);
   }
 
+  /// Return the offset of @T in the source, the end of the source for
+  /// tokens not referring to it like EndOfFile.
+  size_t GetOffset(const PPToken &T) const {
+    if (T.GetStringView().data() == nullptr)
+      return Source.size();
+    return T.GetStringView().data() - Source.data();
+  }
+
   unsigned GetLineIndex() const { return LineIndex; }
 
   PPToken Lex(bool LookAhead = false);
 
-  explicit PPLexer(std::string &s);
+  explicit PPLexer(std::string_view s);
 
 private:
-  static std::unordered_map<std::string, PPToken::PPTokenKind> Keywords;
-  std::string Source;
+  static std::unordered_map<std::string_view, PPToken::PPTokenKind> Keywords;
+  std::string_view Source;
   std::vector<PPToken> PPTokenBuffer;
   unsigned LineIndex = 0;
 };
@@ -12,6 +12,9 @@ public:
     Invalid,
 
     Identifier,
+    Number,
+    StringLiteral,
+    CharLiteral,
 
     // Symbols
     Dot,
@@ -19,16 +22,22 @@ public:
     Hashtag,
     LeftParen,
     RightParen,
-    DoubleQuote,
     ForwardSlash,
     LessThan,
     GreaterThan,
+    Other,
 
     // Keywords
     Define,
+    Undef,
     Include,
+    If,
+    IfDef,
     IfNotDef,
+    ElIf,
+    Else,
     EndIf,
+    Pragma,
   };
 
   PPToken() : Kind(Invalid) {}
@@ -40,6 +49,7 @@ public:
   [[nodiscard]] std::string GetString() const {
     return std::string(StringValue);
   }
+  [[nodiscard]] std::string_view GetStringView() const { return StringValue; }
   [[nodiscard]] PPTokenKind GetKind() const { return Kind; }
 
   [[nodiscard]] std::string ToString() const {
@@ -56,6 +66,12 @@ public:
       return "Invalid";
     case Identifier:
       return "Identifier";
+    case Number:
+      return "Number";
+    case StringLiteral:
+      return "String Literal";
+    case CharLiteral:
+      return "Character Literal";
     case Dot:
       return ".";
     case Colon:
@@ -66,22 +82,34 @@ public:
       return "(";
     case RightParen:
       return ")";
-    case DoubleQuote:
-      return "\"";
     case ForwardSlash:
       return "/";
     case LessThan:
       return "<";
     case GreaterThan:
       return ">";
+    case Other:
+      return "Other";
     case Define:
       return "define";
+    case Undef:
+      return "undef";
     case Include:
       return "include";
+    case If:
+      return "if";
+    case IfDef:
+      return "ifdef";
     case IfNotDef:
       return "ifndef";
+    case ElIf:
+      return "elif";
+    case Else:
+      return "else";
     case EndIf:
       return "endif";
+    case Pragma:
+      return "pragma";
 
     default:
       assert(false && "Unhandled token type.");
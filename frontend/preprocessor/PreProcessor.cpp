@@ -1,33 +1,445 @@
 #include "PreProcessor.hpp"
+#include "../PrecompiledHeader.hpp"
 #include "PPLexer.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
 #include <filesystem>
-#include <fstream>
-
-static bool getFileContent(const std::string &fileName,
-                           std::vector<std::string> &vecOfStrs) {
-  // Open the File
-  std::ifstream in(fileName.c_str());
-  // Check if object is valid
-  if (!in)
-    return false;
-
-  std::string str;
-  // Read the next line from File until it reaches the end.
-  while (std::getline(in, str))
-    // Line contains string of length > 0 then save it in vector
-    vecOfStrs.push_back(str);
-
-  // Close The File
-  in.close();
-  return true;
+#include <optional>
+
+PreProcessor::PreProcessor(SourceManager &SM, const std::string &Path)
+    : SM(SM), MainFilePath(Path) {
+  FilePath = Path.substr(0, Path.rfind('/'));
+  if (FilePath.length() > 0 && FilePath[FilePath.length() - 1] != '/')
+    FilePath.push_back('/');
+
+  DefineMacro("__FILE__", "\"" + Path + "\"");
+  DefineMacro("__LINE__", "").IsLineMacro = true;
 }
 
-void PreProcessor::ParseDirective(std::string &Line, size_t LineIdx) {
+void PreProcessor::SetSystemIncludeDir(const std::string &Dir) {
+  SystemIncludeDir = Dir;
+  if (!SystemIncludeDir.empty() && SystemIncludeDir.back() != '/')
+    SystemIncludeDir.push_back('/');
+}
+
+PreProcessor::Macro &
+PreProcessor::DefineMacro(std::string_view Name, std::string Definition,
+                          bool IsFunctionLike,
+                          const std::vector<std::string_view> &Params) {
+  auto It = DefinedMacros.find(Name);
+  if (It == DefinedMacros.end()) {
+    MacroNames.emplace_back(Name);
+    It = DefinedMacros.emplace(MacroNames.back(), Macro()).first;
+  }
+
+  // The map nodes are never relocated, so the body parts can safely refer to
+  // the definition stored in the node.
+  auto &M = It->second;
+  M = Macro();
+  M.Definition = std::move(Definition);
+  M.IsFunctionLike = IsFunctionLike;
+  M.ParamCount = Params.size();
+
+  if (!IsFunctionLike) {
+    M.Body.push_back({M.Definition});
+    return M;
+  }
+
+  auto GetParamIdx = [&Params](const PPToken &T) {
+    if (T.GetKind() != PPToken::Identifier && !T.IsKeyword())
+      return -1;
+    for (size_t i = 0; i < Params.size(); i++)
+      if (Params[i] == T.GetStringView())
+        return (int)i;
+    return -1;
+  };
+
+  // Split up the body to text and parameter parts e.g.: with the below macro
+  //    #define MAX(A,B) (((A) > (B)) ? (A) : (B))
+  // the Body is "(((A) > (B)) ? (A) : (B))"
+  // and it became "(((", $0, ") > (", $1, ")) ? (", $0, ") : (", $1, "))"
+  // this will make the substitution easier later
+  std::string_view Def = M.Definition;
+  PPLexer lexer(Def);
+  size_t TextStart = 0;
+  bool NextIsPasted = false;
+
+  auto AddText = [&](size_t End) {
+    if (End > TextStart)
+      M.Body.push_back({Def.substr(TextStart, End - TextStart)});
+  };
+
+  for (auto T = lexer.Lex(); T.GetKind() != PPToken::EndOfFile;
+       T = lexer.Lex()) {
+    const size_t Offset = lexer.GetOffset(T);
+
+    if (T.GetKind() == PPToken::Hashtag && lexer.Is(PPToken::Hashtag)) {
+      // Token pasting ("A ## B"). Drop the whitespaces around the "##" and
+      // mark the operands, so they are not macro expanded.
+      size_t End = Offset;
+      while (End > TextStart && isspace(Def[End - 1]))
+        End--;
+      AddText(End);
+      if (!M.Body.empty())
+        M.Body.back().Paste = true;
+
+      lexer.Lex(); // eat the 2nd '#'
+      TextStart = lexer.GetOffset(lexer.GetCurrentPPToken());
+      NextIsPasted = true;
+      continue;
+    }
+
+    int ParamIdx = -1;
+    bool Stringify = false;
+
+    if (T.GetKind() == PPToken::Hashtag &&
+        (ParamIdx = GetParamIdx(lexer.GetCurrentPPToken())) >= 0) {
+      // If a '#' character precede the parameter, then the content of
+      // the parameter needs to be stringified.
+      Stringify = true;
+      T = lexer.Lex(); // eat the parameter
+    } else
+      ParamIdx = GetParamIdx(T);
+
+    if (ParamIdx < 0) {
+      if (NextIsPasted) {
+        AddText(Offset);
+        M.Body.push_back({Def.substr(Offset, T.GetStringView().size())});
+        M.Body.back().Paste = true;
+        TextStart = Offset + T.GetStringView().size();
+        NextIsPasted = false;
+      }
+      continue;
+    }
+
+    AddText(Offset);
+    M.Body.push_back({{}, ParamIdx, Stringify, NextIsPasted});
+    TextStart = lexer.GetOffset(T) + T.GetStringView().size();
+    NextIsPasted = false;
+  }
+  AddText(Def.size());
+
+  return M;
+}
+
+PreProcessor::Macro *PreProcessor::LookUpMacro(std::string_view Name) {
+  auto It = DefinedMacros.find(Name);
+  return It != DefinedMacros.end() ? &It->second : nullptr;
+}
+
+static std::string_view Trim(std::string_view Str) {
+  while (!Str.empty() && isspace(Str.front()))
+    Str.remove_prefix(1);
+  while (!Str.empty() && isspace(Str.back()))
+    Str.remove_suffix(1);
+  return Str;
+}
+
+/// Append @Arg as a string literal to @Out. Whitespace sequences are replaced
+/// by a single space and the '"' and '\\' characters in string and character
+/// literals are escaped.
+static void Stringify(std::string_view Arg, std::string &Out) {
+  Out.push_back('"');
+
+  char Quote = 0;
+  bool LastWasSpace = false;
+  for (auto C : Trim(Arg)) {
+    if (!Quote && isspace(C)) {
+      LastWasSpace = true;
+      continue;
+    }
+    if (LastWasSpace)
+      Out.push_back(' ');
+    LastWasSpace = false;
+
+    if (Quote && (C == '"' || C == '\\'))
+      Out.push_back('\\');
+    else if (!Quote && C == '"')
+      Out.push_back('\\');
+
+    if (!Quote && (C == '"' || C == '\''))
+      Quote = C;
+    else if (Quote == C && Out.back() != '\\')
+      Quote = 0;
+
+    Out.push_back(C);
+  }
+
+  Out.push_back('"');
+}
+
+void PreProcessor::SubstituteParams(const Macro &M,
+                                    const std::vector<std::string_view> &Args,
+                                    std::string &Out) {
+  // Arguments are macro expanded only once even if they are used multiple
+  // times in the body
+  std::vector<std::optional<std::string>> ExpandedArgs(Args.size());
+
+  for (auto &Part : M.Body) {
+    if (Part.ParamIdx < 0) {
+      Out.append(Part.Text);
+      continue;
+    }
+
+    auto Arg = Args[Part.ParamIdx];
+    if (Part.Stringify)
+      Stringify(Arg, Out);
+    else if (Part.Paste)
+      Out.append(Trim(Arg));
+    else {
+      auto &Expanded = ExpandedArgs[Part.ParamIdx];
+      if (!Expanded) {
+        Expanded = std::string();
+        SubstituteMacros(Arg, *Expanded);
+      }
+      Out.append(*Expanded);
+    }
+  }
+}
+
+namespace {
+
+/// Evaluates the controlling expression of #if and #elif directives. The
+/// macros must be already expanded and the "defined" operators replaced by
+/// their value. Remaining identifiers evaluates to 0.
+class ConditionEvaluator {
+public:
+  explicit ConditionEvaluator(std::string_view Expr) : Expr(Expr) {}
+
+  int64_t Evaluate() {
+    auto Result = ParseConditional();
+    SkipSpaces();
+    assert(Pos == Expr.size() && "Unexpected token in #if expression");
+    return Result;
+  }
+
+private:
+  void SkipSpaces() {
+    while (Pos < Expr.size() && isspace(Expr[Pos]))
+      Pos++;
+  }
+
+  bool Consume(std::string_view Op) {
+    SkipSpaces();
+    if (Expr.substr(Pos, Op.size()) != Op)
+      return false;
+    Pos += Op.size();
+    return true;
+  }
+
+  /// Return the precedence of the binary operator at the current position and
+  /// set @Op to it, or return -1 if there is no binary operator.
+  int PeekBinaryOperator(std::string_view &Op) {
+    // the longer operators have to be checked first, so for example "<<" is
+    // not taken as '<'
+    static const std::pair<std::string_view, int> Operators[] = {
+        {"||", 1}, {"&&", 2}, {"==", 6}, {"!=", 6}, {"<=", 7}, {">=", 7},
+        {"<<", 8}, {">>", 8}, {"|", 3},  {"^", 4},  {"&", 5},  {"<", 7},
+        {">", 7},  {"+", 9},  {"-", 9},  {"*", 10}, {"/", 10}, {"%", 10}};
+
+    SkipSpaces();
+    for (auto &[Operator, Precedence] : Operators)
+      if (Expr.substr(Pos, Operator.size()) == Operator) {
+        Op = Operator;
+        return Precedence;
+      }
+    return -1;
+  }
+
+  static int64_t Apply(std::string_view Op, int64_t L, int64_t R) {
+    if (Op == "||")
+      return L || R;
+    if (Op == "&&")
+      return L && R;
+    if (Op == "==")
+      return L == R;
+    if (Op == "!=")
+      return L != R;
+    if (Op == "<=")
+      return L <= R;
+    if (Op == ">=")
+      return L >= R;
+    if (Op == "<<")
+      return L << R;
+    if (Op == ">>")
+      return L >> R;
+    if (Op == "|")
+      return L | R;
+    if (Op == "^")
+      return L ^ R;
+    if (Op == "&")
+      return L & R;
+    if (Op == "<")
+      return L < R;
+    if (Op == ">")
+      return L > R;
+    if (Op == "+")
+      return L + R;
+    if (Op == "-")
+      return L - R;
+    if (Op == "*")
+      return L * R;
+    // division by zero is only allowed in unevaluated operands, like in
+    // "B != 0 && A / B", so the result does not matter
+    if (Op == "/")
+      return R != 0 ? L / R : 0;
+    if (Op == "%")
+      return R != 0 ? L % R : 0;
+
+    assert(!"Unhandled operator");
+    return 0;
+  }
+
+  int64_t ParseConditional() {
+    auto Condition = ParseBinary(1);
+    if (!Consume("?"))
+      return Condition;
+
+    auto TrueValue = ParseConditional();
+    [[maybe_unused]] bool HasColon = Consume(":");
+    assert(HasColon && "Expected ':' in #if expression");
+    auto FalseValue = ParseConditional();
+
+    return Condition ? TrueValue : FalseValue;
+  }
+
+  int64_t ParseBinary(int MinPrecedence) {
+    auto LHS = ParseUnary();
+
+    std::string_view Op;
+    for (int Precedence = PeekBinaryOperator(Op); Precedence >= MinPrecedence;
+         Precedence = PeekBinaryOperator(Op)) {
+      Pos += Op.size();
+      // all of the binary operators are left associative
+      auto RHS = ParseBinary(Precedence + 1);
+      LHS = Apply(Op, LHS, RHS);
+    }
+
+    return LHS;
+  }
+
+  int64_t ParseUnary() {
+    if (Consume("!"))
+      return !ParseUnary();
+    if (Consume("~"))
+      return ~ParseUnary();
+    if (Consume("-"))
+      return -ParseUnary();
+    if (Consume("+"))
+      return ParseUnary();
+    return ParsePrimary();
+  }
+
+  int64_t ParsePrimary() {
+    if (Consume("(")) {
+      auto Result = ParseConditional();
+      [[maybe_unused]] bool HasParen = Consume(")");
+      assert(HasParen && "Expected ')' in #if expression");
+      return Result;
+    }
+
+    SkipSpaces();
+    assert(Pos < Expr.size() && "Missing operand in #if expression");
+
+    // character constant
+    if (Expr[Pos] == '\'') {
+      Pos++;
+      int64_t Value = Expr[Pos++];
+      if (Value == '\\') {
+        switch (Expr[Pos++]) {
+        case 'n':
+          Value = '\n';
+          break;
+        case 't':
+          Value = '\t';
+          break;
+        case '0':
+          Value = 0;
+          break;
+        default:
+          Value = Expr[Pos - 1];
+          break;
+        }
+      }
+      [[maybe_unused]] bool HasQuote = Consume("'");
+      assert(HasQuote && "Unterminated character constant");
+      return Value;
+    }
+
+    size_t Start = Pos;
+    while (Pos < Expr.size() && (isalnum(Expr[Pos]) || Expr[Pos] == '_'))
+      Pos++;
+    assert(Pos > Start && "Unexpected token in #if expression");
+
+    // identifiers which are not macros evaluate to 0
+    if (!isdigit(Expr[Start]))
+      return 0;
+
+    // strtoull handles the hex and octal prefixes and stops at the suffixes
+    // like "ull"
+    std::string Number(Expr.substr(Start, Pos - Start));
+    return std::strtoull(Number.c_str(), nullptr, 0);
+  }
+
+  std::string_view Expr;
+  size_t Pos = 0;
+};
+
+} // namespace
+
+bool PreProcessor::EvaluateCondition(std::string_view Condition) {
+  // The "defined X" and "defined(X)" operators have to be replaced before
+  // the macro expansion.
+  std::string Replaced;
+  PPLexer lexer(Condition);
+  size_t CopiedUntil = 0;
+
+  for (auto T = lexer.Lex(); T.GetKind() != PPToken::EndOfFile;
+       T = lexer.Lex()) {
+    if (T.GetStringView() != "defined")
+      continue;
+
+    Replaced.append(
+        Condition.substr(CopiedUntil, lexer.GetOffset(T) - CopiedUntil));
+
+    const bool HasParen = lexer.Is(PPToken::LeftParen);
+    if (HasParen)
+      lexer.Lex(); // eat '('
+
+    auto MacroID = lexer.Lex();
+    assert((MacroID.GetKind() == PPToken::Identifier || MacroID.IsKeyword()) &&
+           "Expected identifier after 'defined'");
+    auto End = lexer.GetOffset(MacroID) + MacroID.GetStringView().size();
+
+    if (HasParen) {
+      auto RightParen = lexer.Lex();
+      assert(RightParen.GetKind() == PPToken::RightParen);
+      End = lexer.GetOffset(RightParen) + 1;
+    }
+
+    Replaced.append(LookUpMacro(MacroID.GetStringView()) ? "1" : "0");
+    CopiedUntil = End;
+  }
+  Replaced.append(Condition.substr(CopiedUntil));
+
+  std::string Expanded;
+  SubstituteMacros(Replaced, Expanded);
+
+  return ConditionEvaluator(Expanded).Evaluate() != 0;
+}
+
+void PreProcessor::ParseDirective(std::string_view Line) {
   PPLexer lexer(Line);
   lexer.Lex(); // eat '#'
 
   auto Directive = lexer.Lex();
+
+  // null directive
+  if (Directive.GetKind() == PPToken::EndOfFile)
+    return;
+
   assert(Directive.IsKeyword() && "Must be a keyword at this point");
 
   if (Directive.GetKind() == PPToken::Define) {
@@ -45,66 +457,63 @@ void PreProcessor::ParseDirective(std::string &Line, size_t LineIdx) {
     // one.
     // TODO: Solve this issue in a better way
     bool NoSpaceBetweenIDAndParen =
-        lexer.GetSource()[lexer.GetLineIndex()] == '(';
+        lexer.GetRemainingText().substr(0, 1) == "(";
 
     if (lexer.Is(PPToken::EndOfFile))
-      DefinedMacros[DefinedID.GetString()] = {"", 0};
+      DefineMacro(DefinedID.GetStringView(), "");
     else if (lexer.Is(PPToken::LeftParen) && NoSpaceBetweenIDAndParen) {
       lexer.Lex(); // eat '('
-      std::vector<std::string> Params;
+      std::vector<std::string_view> Params;
 
-      do {
+      while (lexer.IsNot(PPToken::RightParen)) {
         auto Param = lexer.Lex();
         assert(Param.GetKind() == PPToken::Identifier);
-        Params.push_back(Param.GetString());
+        Params.push_back(Param.GetStringView());
 
         if (lexer.IsNot(PPToken::Colon))
           break;
         lexer.Lex(); // eat ','
-      } while (true);
+      }
 
       assert(lexer.Is(PPToken::RightParen));
       lexer.Lex(); // eat ')'
 
-      auto Body = lexer.GetRemainingText();
-      for (size_t i = 0; i < Params.size(); i++) {
-        // replacing the parameters with their index e.g.: with the below macro
-        //    #define MAX(A,B) (((A) > (B)) ? (A) : (B))
-        // the Body is "(((A) > (B)) ? (A) : (B))"
-        // and it became "((($0) > ($1)) ? ($0) : ($1))"
-        // this will make the substitution easier later
-        while (Body.find(Params[i]) != std::string::npos)
-          Body.replace(Body.find(Params[i]), Params[i].length(),
-                       "$" + std::to_string(i));
-      }
-
-      DefinedMacros[DefinedID.GetString()] = {Body, Params.size()};
+      DefineMacro(DefinedID.GetStringView(),
+                  std::string(lexer.GetRemainingText()), true, Params);
     }
     // plain define (eg.: #define TRUE 1)
     else {
-      DefinedMacros[DefinedID.GetString()] = {RemainingText, 0};
+      DefineMacro(DefinedID.GetStringView(), std::string(RemainingText));
     }
   } else if (Directive.GetKind() == PPToken::Include) {
-    assert(lexer.Is(PPToken::DoubleQuote) || lexer.Is(PPToken::LessThan));
+    assert(lexer.Is(PPToken::StringLiteral) || lexer.Is(PPToken::LessThan));
     bool IsSystem = lexer.Is(PPToken::LessThan);
-    lexer.Lex(); // eat the token
+    auto FirstToken = lexer.Lex();
 
     std::string FileName;
 
-    auto NextToken = lexer.Lex();
-    while (NextToken.GetKind() == PPToken::Identifier ||
-           NextToken.GetKind() == PPToken::Dot ||
-           NextToken.GetKind() == PPToken::ForwardSlash) {
-      FileName.append(NextToken.GetString());
-      NextToken = lexer.Lex();
-    }
+    if (IsSystem) {
+      auto NextToken = lexer.Lex();
+      while (NextToken.GetKind() == PPToken::Identifier ||
+             NextToken.GetKind() == PPToken::Dot ||
+             NextToken.GetKind() == PPToken::ForwardSlash) {
+        FileName.append(NextToken.GetString());
+        NextToken = lexer.Lex();
+      }
 
-    assert((NextToken.GetKind() == PPToken::DoubleQuote && !IsSystem) ||
-           (NextToken.GetKind() == PPToken::GreaterThan && IsSystem));
+      assert(NextToken.GetKind() == PPToken::GreaterThan);
+    } else {
+      // removing the quotes
+      auto Quoted = FirstToken.GetStringView();
+      assert(Quoted.size() >= 2 && Quoted.back() == '"');
+      FileName = Quoted.substr(1, Quoted.size() - 2);
+    }
 
     // in case if system headers were used, use source_code/include/ as include
     // path
-    if (IsSystem) {
+    if (IsSystem && !SystemIncludeDir.empty()) {
+      FilePath = SystemIncludeDir;
+    } else if (IsSystem) {
       auto Path = std::filesystem::current_path();
       Path.remove_filename();
 
@@ -112,114 +521,499 @@ void PreProcessor::ParseDirective(std::string &Line, size_t LineIdx) {
       FilePath += "include/";
     }
 
-    std::vector<std::string> FileContent;
-    auto Success = getFileContent(FilePath + FileName, FileContent);
-    assert(Success && "Cannot open file");
+    IncludeFile(FilePath + FileName);
+  } else if (Directive.GetKind() == PPToken::Pragma) {
+    // the other pragmas are ignored
+    if (lexer.GetCurrentPPToken().GetStringView() == "once" && CurrentFile)
+      CurrentFile->IsIncludeOnce = true;
+  } else if (Directive.GetKind() == PPToken::Undef) {
+    auto UndefinedID = lexer.Lex();
+    assert(UndefinedID.GetKind() == PPToken::Identifier);
+    DefinedMacros.erase(UndefinedID.GetStringView());
+  } else if (Directive.GetKind() == PPToken::If ||
+             Directive.GetKind() == PPToken::IfDef ||
+             Directive.GetKind() == PPToken::IfNotDef) {
+    bool Taken;
+    if (Directive.GetKind() == PPToken::If)
+      Taken = EvaluateCondition(lexer.GetRemainingText());
+    else {
+      auto MacroID = lexer.Lex();
+      assert(MacroID.GetKind() == PPToken::Identifier);
+      Taken = (LookUpMacro(MacroID.GetStringView()) != nullptr) ==
+              (Directive.GetKind() == PPToken::IfDef);
+    }
 
-    Source.insert(Source.begin() + LineIdx + 1, FileContent.begin(),
-                  FileContent.end());
-  } else if (Directive.GetKind() == PPToken::IfNotDef) {
-    // TODO
+    Conditionals.push_back({Taken, false});
+    SkipRequested = !Taken;
+  } else if (Directive.GetKind() == PPToken::ElIf ||
+             Directive.GetKind() == PPToken::Else) {
+    assert(!Conditionals.empty() && "#elif or #else without #if");
+    assert(!Conditionals.back().SeenElse && "#elif or #else after #else");
+
+    // Reaching here means the previous branch was taken, so the rest have to
+    // be skipped. The branches which are not taken are handled by
+    // SkipConditionalBlock.
+    Conditionals.back().SeenElse = Directive.GetKind() == PPToken::Else;
+    SkipRequested = true;
   } else if (Directive.GetKind() == PPToken::EndIf) {
-    // TODO
+    assert(!Conditionals.empty() && "#endif without #if");
+    Conditionals.pop_back();
   }
 }
 
-void PreProcessor::SubstituteMacros(std::string &Line) {
-  // To save the processed line state at the beginning of the iteration.
-  std::string LineCopy;
+/// Return the directive name of @Line like "ifdef" for "#  ifdef FOO", empty
+/// string if @Line is not a directive.
+static std::string_view GetDirectiveName(std::string_view Line) {
+  size_t Pos = 0;
+  while (Pos < Line.size() && (Line[Pos] == ' ' || Line[Pos] == '\t'))
+    Pos++;
+  if (Pos >= Line.size() || Line[Pos] != '#')
+    return {};
 
-  do {
-    LineCopy = Line;
+  Pos++;
+  while (Pos < Line.size() && (Line[Pos] == ' ' || Line[Pos] == '\t'))
+    Pos++;
 
-    for (auto &[MacroID, MacroData] : DefinedMacros) {
-      auto &[MacroBody, MacroParam] = MacroData;
+  size_t NameStart = Pos;
+  while (Pos < Line.size() && isalpha(Line[Pos]))
+    Pos++;
 
-      // simple search and replace of plain macros
-      if (MacroParam == 0) {
-        int LoopCounter = 0; // make sure not stuck in an endless loop
+  return Line.substr(NameStart, Pos - NameStart);
+}
 
-        while (LoopCounter < 20 && Line.find(MacroID) != std::string::npos) {
-          Line.replace(Line.find(MacroID), MacroID.length(), MacroBody);
-          LoopCounter++;
-        }
+size_t PreProcessor::SkipConditionalBlock(std::string_view Source, size_t Pos) {
+  // The nesting level of the conditionals inside the skipped region
+  unsigned Depth = 0;
+
+  while (Pos < Source.size()) {
+    auto LineEnd = Source.find('\n', Pos);
+    if (LineEnd == std::string_view::npos)
+      LineEnd = Source.size();
 
-        assert((LoopCounter < 20) && "Was stuck in an endless loop");
+    const auto Line = Source.substr(Pos, LineEnd - Pos);
+    Pos = LineEnd + 1;
+
+    // Not even tokenizing the skipped lines, only the directive names are
+    // of interest
+    auto Name = GetDirectiveName(Line);
+    if (Name.empty())
+      continue;
+
+    if (Name == "if" || Name == "ifdef" || Name == "ifndef") {
+      Depth++;
+      continue;
+    }
+
+    if (Depth > 0) {
+      if (Name == "endif")
+        Depth--;
+      continue;
+    }
+
+    auto &Conditional = Conditionals.back();
+
+    if (Name == "endif") {
+      Conditionals.pop_back();
+      return Pos;
+    }
+
+    if (Name == "else") {
+      assert(!Conditional.SeenElse && "#else after #else");
+      Conditional.SeenElse = true;
+    }
+
+    if (Conditional.WasTaken)
+      continue;
+
+    const bool IsElse = Name == "else";
+    if (IsElse || Name == "elif") {
+      assert((IsElse || !Conditional.SeenElse) && "#elif after #else");
+      auto Condition = Line.substr(Line.find(Name) + Name.size());
+      if (IsElse || EvaluateCondition(Condition)) {
+        Conditional.WasTaken = true;
+        return Pos;
       }
-      // otherwise, it is a function macro and have to substitute the right
-      // values into its parameters
-      else {
-        auto Pos = Line.find(MacroID); // macro start pos
-
-        // If it is the end of the line or the macro is a substring of another
-        // identifier like example "MacroID == assert" and the line contain
-        // "__assert_fail", then do not need to do substitution, continue with
-        // next iteration.
-        if (Pos == std::string::npos ||
-            std::isalnum(Line[Pos + MacroID.length()]) ||
-            Line[Pos + MacroID.length()] == '_' ||
-            (Pos > 0 && (std::isalnum(Line[Pos - 1]) || Line[Pos - 1] == '_')))
-          continue;
-
-        Pos += MacroID.length();
-        assert(Line[Pos] == '(');
-        Pos++;
-
-        auto RemainingLine = Line.substr(Pos);
-        size_t StartPos = 0;
-        std::vector<std::string> ActualParams(0);
-        for (size_t i = 0; i < MacroParam; i++) {
-          size_t EndPos = i != MacroParam - 1 ? RemainingLine.find(',')
-                                              : RemainingLine.find(')');
-          ActualParams.push_back(
-              RemainingLine.substr(StartPos, EndPos - StartPos));
-          StartPos = EndPos + 1;
-        }
+    }
+  }
 
-        auto ReplacedMacroBody = MacroBody;
-        for (size_t i = 0; i < ActualParams.size(); i++) {
-          auto Param = "$" + std::to_string(i);
-          while (ReplacedMacroBody.find(Param) != std::string::npos) {
-            // If a '#' character precede the parameter, then the content of
-            // the parameter needs to be stringified.
-            if (ReplacedMacroBody.find(Param) > 0 &&
-                ReplacedMacroBody[ReplacedMacroBody.find(Param) - 1] == '#')
-              ReplacedMacroBody.replace(ReplacedMacroBody.find(Param) - 1,
-                                        Param.length() + 1,
-                                        "\"" + ActualParams[i] + "\"");
-            else // Plain string replace
-              ReplacedMacroBody.replace(ReplacedMacroBody.find(Param),
-                                        Param.length(), ActualParams[i]);
-          }
-        }
+  assert(!"Unterminated conditional directive");
+  return Pos;
+}
+
+void PreProcessor::SubstituteMacros(std::string_view Text, std::string &Out) {
+  PPLexer lexer(Text);
+  size_t CopiedUntil = 0;
+
+  for (auto T = lexer.Lex(); T.GetKind() != PPToken::EndOfFile;
+       T = lexer.Lex()) {
+    if (T.GetKind() != PPToken::Identifier && !T.IsKeyword())
+      continue;
+
+    auto M = LookUpMacro(T.GetStringView());
+    if (!M || M->IsBeingExpanded)
+      continue;
+
+    const size_t MacroStart = lexer.GetOffset(T);
+    size_t MacroEnd = MacroStart + T.GetStringView().size();
+
+    std::string Replacement;
+    std::string_view ReplacementText;
+
+    if (M->IsLineMacro) {
+      Replacement = std::to_string(OutputLineCount + 1);
+      ReplacementText = Replacement;
+    } else if (!M->IsFunctionLike)
+      ReplacementText = M->Definition;
+    // otherwise, it is a function macro and have to substitute the right
+    // values into its parameters
+    else {
+      // just the name of the macro without invoking it
+      if (lexer.IsNot(PPToken::LeftParen))
+        continue;
+      lexer.Lex(); // eat '('
+
+      // Collect the arguments, commas in nested parenthesis like in
+      // "MAX(foo(a, b), c)" are not separating arguments
+      std::vector<std::string_view> Args;
+      size_t ArgStart = lexer.GetOffset(lexer.GetCurrentPPToken());
+      unsigned Depth = 1;
+
+      while (Depth > 0) {
+        auto ArgToken = lexer.Lex();
+        const size_t Offset = lexer.GetOffset(ArgToken);
 
-        if (Line.find(MacroID) != std::string::npos)
-          Line.replace(Line.find(MacroID), MacroID.length() + StartPos + 1,
-                       ReplacedMacroBody);
+        if (ArgToken.GetKind() == PPToken::EndOfFile)
+          break;
+        if (ArgToken.GetKind() == PPToken::LeftParen)
+          Depth++;
+        else if (ArgToken.GetKind() == PPToken::RightParen)
+          Depth--;
+
+        if ((ArgToken.GetKind() == PPToken::Colon && Depth == 1) ||
+            Depth == 0) {
+          Args.push_back(Text.substr(ArgStart, Offset - ArgStart));
+          ArgStart = Offset + 1;
+          MacroEnd = Offset + 1;
+        }
       }
+
+      // TODO: Support invocations spanning over multiple lines
+      assert(Depth == 0 && "Unterminated macro invocation");
+
+      // "FOO()" has one empty argument, which is no argument for a macro
+      // without parameters
+      if (M->ParamCount == 0 && Args.size() == 1 && Trim(Args[0]).empty())
+        Args.clear();
+
+      assert(Args.size() == M->ParamCount &&
+             "Wrong number of macro arguments");
+
+      SubstituteParams(*M, Args, Replacement);
+      ReplacementText = Replacement;
     }
 
-  } while (LineCopy != Line);
+    Out.append(Text.substr(CopiedUntil, MacroStart - CopiedUntil));
+
+    // Rescan the result for further macros. The macro itself is disabled
+    // meanwhile so self-referencing macros are not expanded endlessly.
+    M->IsBeingExpanded = true;
+    SubstituteMacros(ReplacementText, Out);
+    M->IsBeingExpanded = false;
+
+    CopiedUntil = MacroEnd;
+  }
+
+  Out.append(Text.substr(CopiedUntil));
 }
 
-void PreProcessor::Run() {
-  for (size_t LineIdx = 0; LineIdx < Source.size(); LineIdx++) {
-    auto &Line = Source[LineIdx];
-    if (Line.empty())
+/// Return true if the first non whitespace character of @Line is a '#'.
+static bool IsDirective(std::string_view Line) {
+  auto FirstChar = Line.find_first_not_of(" \t");
+  return FirstChar != std::string_view::npos && Line[FirstChar] == '#';
+}
+
+/// Return true if @Line has nothing but whitespaces and comments. @InComment
+/// tells if the line starts within a block comment and updated to tell if the
+/// next line will.
+static bool IsBlankLine(std::string_view Line, bool &InComment) {
+  size_t Pos = 0;
+  while (Pos < Line.size()) {
+    if (InComment) {
+      auto CommentEnd = Line.find("*/", Pos);
+      if (CommentEnd == std::string_view::npos)
+        return true;
+      InComment = false;
+      Pos = CommentEnd + 2;
+    } else if (isspace(Line[Pos]))
+      Pos++;
+    else if (Line.substr(Pos, 2) == "//")
+      return true;
+    else if (Line.substr(Pos, 2) == "/*") {
+      InComment = true;
+      Pos += 2;
+    } else
+      return false;
+  }
+  return true;
+}
+
+/// Return the name of the include guard macro if the whole content of
+/// @Source is wrapped in "#ifndef NAME" ... "#endif", otherwise an empty
+/// string.
+static std::string DetectIncludeGuard(std::string_view Source) {
+  std::string_view Guard;
+  unsigned Depth = 0;
+  bool GuardClosed = false;
+  bool InComment = false;
+
+  size_t LineStart = 0;
+  while (LineStart < Source.size()) {
+    auto LineEnd = Source.find('\n', LineStart);
+    if (LineEnd == std::string_view::npos)
+      LineEnd = Source.size();
+
+    const auto Line = Source.substr(LineStart, LineEnd - LineStart);
+    LineStart = LineEnd + 1;
+
+    if (InComment || !IsDirective(Line)) {
+      // anything outside of the guard means there is no guard
+      if (!IsBlankLine(Line, InComment) && Depth == 0)
+        return "";
+      continue;
+    }
+
+    PPLexer lexer(Line);
+    lexer.Lex(); // eat '#'
+    auto Directive = lexer.Lex().GetStringView();
+
+    if (Depth == 0) {
+      if (GuardClosed || Directive != "ifndef")
+        return "";
+
+      auto GuardID = lexer.Lex();
+      if (GuardID.GetKind() != PPToken::Identifier)
+        return "";
+
+      Guard = GuardID.GetStringView();
+      Depth = 1;
+    } else if (Directive == "if" || Directive == "ifdef" ||
+               Directive == "ifndef")
+      Depth++;
+    else if (Directive == "endif") {
+      if (--Depth == 0)
+        GuardClosed = true;
+    }
+    // an else branch of the guard condition is not guarded
+    else if ((Directive == "else" || Directive == "elif") && Depth == 1)
+      return "";
+  }
+
+  return GuardClosed ? std::string(Guard) : "";
+}
+
+PreProcessor::FileInfo *PreProcessor::LookUpFile(const std::string &Path) {
+  if (auto It = ResolvedPaths.find(Path); It != ResolvedPaths.end())
+    return It->second;
+
+  // Resolve the path, so the same file is cached only once even if it is
+  // referred differently like "foo.h" and "../dir/foo.h"
+  std::error_code EC;
+  auto ResolvedPath = std::filesystem::weakly_canonical(Path, EC).string();
+  if (EC)
+    ResolvedPath = Path;
+
+  auto &File = Files[ResolvedPath];
+  if (!File.Buffer)
+    File.Buffer = SM.GetFileBuffer(ResolvedPath);
+
+  auto Result = File.Buffer ? &File : nullptr;
+  ResolvedPaths[Path] = Result;
+  return Result;
+}
+
+void PreProcessor::ProcessFile(FileInfo &File) {
+  auto PrevFile = CurrentFile;
+  CurrentFile = &File;
+  [[maybe_unused]] auto OpenConditionals = Conditionals.size();
+
+  ProcessBuffer(*File.Buffer);
+
+  assert(OpenConditionals == Conditionals.size() &&
+         "Unterminated conditional directive");
+  CurrentFile = PrevFile;
+
+  if (!File.WasIncluded) {
+    File.WasIncluded = true;
+    File.GuardMacro = DetectIncludeGuard(File.Buffer->GetBuffer());
+  }
+}
+
+void PreProcessor::IncludeFile(const std::string &Path) {
+  auto File = LookUpFile(Path);
+  assert(File && "Cannot open file");
+
+  // Including the file again would not produce anything if it has a
+  // "#pragma once" or if its include guard macro is already defined
+  if (File->WasIncluded &&
+      (File->IsIncludeOnce ||
+       (!File->GuardMacro.empty() && LookUpMacro(File->GuardMacro))))
+    return;
+
+  ProcessFile(*File);
+}
+
+void PreProcessor::ProcessBuffer(const SourceBuffer &Buffer) {
+  const auto Source = Buffer.GetBuffer();
+
+  size_t LineStart = 0;
+  while (LineStart < Source.size()) {
+    auto LineEnd = Source.find('\n', LineStart);
+    if (LineEnd == std::string_view::npos)
+      LineEnd = Source.size();
+
+    const auto RawLine = Source.substr(LineStart, LineEnd - LineStart);
+    LineStart = LineEnd + 1;
+
+    // directives are consumed, assuming they only use one line
+    if (IsDirective(RawLine)) {
+      ParseDirective(RawLine);
+
+      if (SkipRequested) {
+        SkipRequested = false;
+        LineStart = SkipConditionalBlock(Source, LineStart);
+      }
       continue;
+    }
+
+    // TODO: With the current handling of the includes - which is basically
+    // insertion of its content - __LINE__ will return false line numbers
+    // if any includes were used. Fix it.
+    SubstituteMacros(RawLine, Output);
+    Output.push_back('\n');
+    OutputLineCount++;
+  }
+}
+
+SourceBuffer *PreProcessor::Run() {
+  auto MainFile = LookUpFile(MainFilePath);
+  if (!MainFile)
+    return nullptr;
+
+  Output.reserve(MainFile->Buffer->GetSize());
+  ProcessFile(*MainFile);
+
+  return SM.CreateBuffer(MainFilePath, std::move(Output));
+}
 
-    if (!Line.empty() && Line[0] == '#') {
-      ParseDirective(Line, LineIdx);
-      // delete current line, assuming the directive only used one line
-      Source.erase(Source.begin() + LineIdx);
-      LineIdx--; // since the erase we have to check again the same LineIdx
-    } else if (!DefinedMacros.empty()) {
-      // Update __LINE__ here, so the correct line number can be substituted
-      // TODO: With the current handling of the includes - which is basically
-      // insertion of its content - this macro will return false line numbers
-      // if any includes were used. Fix it.
-      DefinedMacros["__LINE__"].first = std::to_string(LineIdx + 1);
-      SubstituteMacros(Line);
+/// Return the modification time of the file at @Path or 0 on error.
+static uint64_t GetModificationTime(const std::string &Path) {
+  std::error_code EC;
+  auto Time = std::filesystem::last_write_time(Path, EC);
+  return EC ? 0 : Time.time_since_epoch().count();
+}
+
+void PreProcessor::WritePCH(PCHWriter &W, const SourceBuffer &Output) const {
+  assert(Conditionals.empty() && "Unterminated conditional directive");
+
+  // The included files with their size and modification time, to detect if
+  // the precompiled header is out of date
+  std::vector<std::pair<std::string, const FileInfo *>> IncludedFiles;
+  for (auto &[Path, File] : Files)
+    if (File.WasIncluded)
+      IncludedFiles.push_back({Path, &File});
+  std::sort(IncludedFiles.begin(), IncludedFiles.end());
+
+  // The precompiled header itself is included only once, even without an
+  // include guard, its content is already at the beginning of the output
+  const FileInfo *MainFile = ResolvedPaths.at(MainFilePath);
+
+  W.WriteInt(IncludedFiles.size());
+  for (auto &[Path, File] : IncludedFiles) {
+    W.WriteString(Path);
+    W.WriteInt(File->Buffer->GetSize());
+    W.WriteInt(GetModificationTime(Path));
+    W.WriteString(File->GuardMacro);
+    W.WriteBool(File->IsIncludeOnce || File == MainFile);
+  }
+
+  // The builtin macros depend on the main file, they are defined by the
+  // constructor anyway
+  std::vector<std::string_view> MacroNamesToSave;
+  for (auto &[Name, M] : DefinedMacros)
+    if (Name != "__FILE__" && Name != "__LINE__")
+      MacroNamesToSave.push_back(Name);
+  std::sort(MacroNamesToSave.begin(), MacroNamesToSave.end());
+
+  W.WriteInt(MacroNamesToSave.size());
+  for (auto Name : MacroNamesToSave) {
+    auto &M = DefinedMacros.at(Name);
+    W.WriteString(Name);
+    W.WriteString(M.Definition);
+    W.WriteBool(M.IsFunctionLike);
+    W.WriteInt(M.ParamCount);
+
+    // The body parts are views into the definition, so they are saved as
+    // offsets into it. The parameter parts have no text at all.
+    W.WriteInt(M.Body.size());
+    for (auto &Part : M.Body) {
+      const auto Offset =
+          Part.Text.empty() ? 0 : Part.Text.data() - M.Definition.data();
+      W.WriteInt(Offset);
+      W.WriteInt(Part.Text.size());
+      W.WriteInt(Part.ParamIdx + 1);
+      W.WriteBool(Part.Stringify);
+      W.WriteBool(Part.Paste);
     }
   }
+
+  W.WriteString(Output.GetBuffer());
+  W.WriteInt(OutputLineCount);
+}
+
+bool PreProcessor::ReadPCH(PCHReader &R) {
+  for (auto NumFiles = R.ReadInt(); NumFiles > 0 && !R.HasError(); NumFiles--) {
+    const std::string Path(R.ReadString());
+    const auto Size = R.ReadInt();
+    const auto ModificationTime = R.ReadInt();
+
+    std::error_code EC;
+    if (std::filesystem::file_size(Path, EC) != Size || EC ||
+        GetModificationTime(Path) != ModificationTime)
+      return false;
+
+    // The buffer is only opened if the file is included again
+    auto &File = Files[Path];
+    File.GuardMacro = R.ReadString();
+    File.IsIncludeOnce = R.ReadBool();
+    File.WasIncluded = true;
+  }
+
+  for (auto NumMacros = R.ReadInt(); NumMacros > 0 && !R.HasError();
+       NumMacros--) {
+    const auto Name = R.ReadString();
+    auto &M = DefineMacro(Name, std::string(R.ReadString()));
+    M.IsFunctionLike = R.ReadBool();
+    M.ParamCount = R.ReadInt();
+    M.Body.clear();
+
+    std::string_view Def = M.Definition;
+    for (auto NumParts = R.ReadInt(); NumParts > 0 && !R.HasError();
+         NumParts--) {
+      const auto Offset = R.ReadInt();
+      const auto Size = R.ReadInt();
+      if (Offset > Def.size() || Size > Def.size() - Offset)
+        R.SetError();
+
+      auto &Part = M.Body.emplace_back();
+      Part.Text = R.HasError() ? "" : Def.substr(Offset, Size);
+      Part.ParamIdx = static_cast<int>(R.ReadInt()) - 1;
+      Part.Stringify = R.ReadBool();
+      Part.Paste = R.ReadBool();
+    }
+  }
+
+  Output = R.ReadString();
+  OutputLineCount = R.ReadInt();
+
+  return !R.HasError();
 }
@@ -1,31 +1,154 @@
 #ifndef PREPROCESSOR_H
 #define PREPROCESSOR_H
 
-#include <map>
+#include "../SourceManager.hpp"
+#include <deque>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+class PCHReader;
+class PCHWriter;
+
 class PreProcessor {
 public:
   PreProcessor() = delete;
-  PreProcessor(std::vector<std::string> &Src, const std::string &Path)
-      : Source(Src) {
-    FilePath = Path.substr(0, Path.rfind('/'));
-    if (FilePath.length() > 0 && FilePath[FilePath.length() - 1] != '/')
-      FilePath.push_back('/');
+  PreProcessor(SourceManager &SM, const std::string &Path);
+
+  /// Look up the system headers in @Dir instead of the include/ directory
+  /// next to the working directory.
+  void SetSystemIncludeDir(const std::string &Dir);
+
+  void ParseDirective(std::string_view Line);
+
+  /// Expand the macros in @Text and append the result to @Out.
+  void SubstituteMacros(std::string_view Text, std::string &Out);
+
+  /// Preprocess the content of @Buffer line by line and append the result to
+  /// the output. Included files are processed recursively in place.
+  void ProcessBuffer(const SourceBuffer &Buffer);
+
+  /// Evaluate the controlling expression @Condition of an #if or #elif.
+  bool EvaluateCondition(std::string_view Condition);
 
-    DefinedMacros["__FILE__"] = {"\"" + Path + "\"", 0};
-    DefinedMacros["__LINE__"] = {"1", 0};
-  }
+  /// Skip the lines of a conditional branch which was not taken starting from
+  /// @Pos of @Source. Only the directives are looked at, to find the end of
+  /// the branch. Return the position of the line after the directive ending
+  /// the skipped region.
+  size_t SkipConditionalBlock(std::string_view Source, size_t Pos);
 
-  void ParseDirective(std::string &Line, size_t LineIdx);
-  void SubstituteMacros(std::string &Line);
-  void Run();
+  /// Handle the include of the file at @Path, which is skipped if its content
+  /// was already included and would produce nothing again.
+  void IncludeFile(const std::string &Path);
+
+  /// Preprocess the main file. Return the buffer holding the whole
+  /// translation unit or nullptr if the main file cannot be opened.
+  SourceBuffer *Run();
+
+  /// Save the macros, the included files and the @Output of Run() into @W,
+  /// after preprocessing a header.
+  void WritePCH(PCHWriter &W, const SourceBuffer &Output) const;
+
+  /// Restore the state saved by WritePCH before Run(), as if the header was
+  /// included at the beginning of the main file. Return false if the data is
+  /// malformed or any of the included files changed since.
+  bool ReadPCH(PCHReader &R);
 
 private:
+  struct Macro {
+    /// A piece of the replacement list, either a verbatim text or a reference
+    /// to a parameter, which is substituted with the actual argument.
+    struct BodyPart {
+      std::string_view Text;
+      int ParamIdx = -1;
+      bool Stringify = false;
+      bool Paste = false;
+    };
+
+    /// The replacement list text, the body parts are views into it.
+    std::string Definition;
+    std::vector<BodyPart> Body;
+    unsigned ParamCount = 0;
+    bool IsFunctionLike = false;
+    /// __LINE__ has no fix replacement, it is computed at each use
+    bool IsLineMacro = false;
+    /// Set while the macro is being expanded to prevent recursive expansion
+    bool IsBeingExpanded = false;
+  };
+
+  struct FileInfo {
+    SourceBuffer *Buffer = nullptr;
+    /// The macro of the include guard wrapping the whole file, like
+    /// "#ifndef FOO_H" ... "#endif", empty if the file has no such guard
+    std::string GuardMacro;
+    /// Set if the file has a "#pragma once"
+    bool IsIncludeOnce = false;
+    /// Set after the file was processed once
+    bool WasIncluded = false;
+  };
+
+  /// Return the info of the file at @Path or nullptr if it cannot be opened.
+  /// The path resolution is done only the first time a path is seen.
+  FileInfo *LookUpFile(const std::string &Path);
+
+  /// Preprocess @File and detect its include guard on the first time.
+  void ProcessFile(FileInfo &File);
+
+  /// Register macro @Name with the given @Definition. If @Params are given,
+  /// then the macro is a function like one and the occurrences of the
+  /// parameters in the replacement list are resolved here once, so expanding
+  /// the macro later on does not need any search.
+  Macro &DefineMacro(std::string_view Name, std::string Definition,
+                     bool IsFunctionLike = false,
+                     const std::vector<std::string_view> &Params = {});
+
+  /// Returns nullptr if @Name is not a defined macro.
+  Macro *LookUpMacro(std::string_view Name);
+
+  /// Build the replacement text of @M into @Out with the given @Args.
+  void SubstituteParams(const Macro &M, const std::vector<std::string_view> &Args,
+                        std::string &Out);
+
+  SourceManager &SM;
+  std::string MainFilePath;
   std::string FilePath;
-  std::vector<std::string> &Source;
-  std::map<std::string, std::pair<std::string, unsigned>> DefinedMacros;
+  /// The directory of the system headers ending with '/', if empty then it is
+  /// the include/ next to the working directory
+  std::string SystemIncludeDir;
+
+  struct ConditionalState {
+    /// One of the branches of the conditional was already taken, so the
+    /// following ones have to be skipped
+    bool WasTaken = false;
+    /// An #else was seen already
+    bool SeenElse = false;
+  };
+
+  /// The stack of the currently open #if, #ifdef and #ifndef directives
+  std::vector<ConditionalState> Conditionals;
+
+  /// Set by the directives, if the lines following it up to the next
+  /// matching #elif, #else or #endif need to be skipped
+  bool SkipRequested = false;
+
+  /// Header cache, every file is opened and analyzed once, keyed by its
+  /// resolved path
+  std::unordered_map<std::string, FileInfo> Files;
+  /// Maps the paths as they were spelled in the includes to the files
+  std::unordered_map<std::string, FileInfo *> ResolvedPaths;
+  /// The file being processed, nullptr if none
+  FileInfo *CurrentFile = nullptr;
+
+  /// The preprocessed translation unit and its number of lines so far
+  std::string Output;
+  unsigned OutputLineCount = 0;
+
+  /// Every macro name is stored once here, the keys of DefinedMacros refer to
+  /// these, so looking up an identifier is a single hash lookup without
+  /// creating any string.
+  std::deque<std::string> MacroNames;
+  std::unordered_map<std::string_view, Macro> DefinedMacros;
 };
 
 #endif
@@ -1,5 +1,5 @@
-#ifndef _STDIO_H
-#define _STDIO_H
+#ifndef _INTTYPES_H
+#define _INTTYPES_H
 
 typedef unsigned char uint8_t;
 typedef char int8_t;
@@ -0,0 +1,66 @@
+#include "ConstantPool.hpp"
+#include <cstring>
+
+ConstantPool::~ConstantPool() {
+  for (auto &E : Table)
+    if (E.C)
+      E.C->~Constant();
+}
+
+size_t ConstantPool::Hash(uint64_t Bits, uint8_t BitWidth, bool IsFP) {
+  // finalizer of splitmix64, every input bit affects every output bit
+  uint64_t H = Bits ^ ((uint64_t)BitWidth << 1 | IsFP);
+  H = (H ^ (H >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  H = (H ^ (H >> 27)) * 0x94d049bb133111ebULL;
+  return H ^ (H >> 31);
+}
+
+ConstantPool::Entry &ConstantPool::FindSlot(uint64_t Bits, uint8_t BitWidth,
+                                            bool IsFP) {
+  const size_t Mask = Table.size() - 1;
+  for (size_t Idx = Hash(Bits, BitWidth, IsFP) & Mask;;
+       Idx = (Idx + 1) & Mask) {
+    auto &E = Table[Idx];
+    if (!E.C || (E.Bits == Bits && E.BitWidth == BitWidth && E.IsFP == IsFP))
+      return E;
+  }
+}
+
+void ConstantPool::Grow() {
+  std::vector<Entry> Old(Table.empty() ? 64 : Table.size() * 2);
+  Old.swap(Table);
+
+  for (auto &E : Old)
+    if (E.C)
+      FindSlot(E.Bits, E.BitWidth, E.IsFP) = E;
+}
+
+Constant *ConstantPool::GetInt(uint64_t Val, uint8_t BitWidth) {
+  // keep the load factor below 3/4
+  if ((NumEntries + 1) * 4 > Table.size() * 3)
+    Grow();
+
+  auto &E = FindSlot(Val, BitWidth, false);
+  if (!E.C) {
+    E = {Val, BitWidth, false,
+         new (Arena.Allocate<Constant>()) Constant(Val, BitWidth)};
+    NumEntries++;
+  }
+  return E.C;
+}
+
+Constant *ConstantPool::GetFP(double Val, uint8_t BitWidth) {
+  if ((NumEntries + 1) * 4 > Table.size() * 3)
+    Grow();
+
+  uint64_t Bits;
+  std::memcpy(&Bits, &Val, sizeof(Bits));
+
+  auto &E = FindSlot(Bits, BitWidth, true);
+  if (!E.C) {
+    E = {Bits, BitWidth, true,
+         new (Arena.Allocate<Constant>()) Constant(Val, BitWidth)};
+    NumEntries++;
+  }
+  return E.C;
+}
@@ -0,0 +1,50 @@
+#ifndef CONSTANT_POOL_HPP
+#define CONSTANT_POOL_HPP
+
+#include "../../support/BumpAllocator.hpp"
+#include "Value.hpp"
+#include <cstdint>
+#include <vector>
+
+/// Uniques the integer and floating point constants, so each distinct
+/// constant is created only once. Constants are identified by their raw bit
+/// pattern, bit width and kind, therefore 0.0 and -0.0, the different NaNs and
+/// the 32 and 64 bit versions of the same value are all different constants.
+///
+/// The lookup is done in an open addressing hash table with linear probing,
+/// the constants themselves are allocated in an arena.
+class ConstantPool {
+public:
+  ConstantPool() = default;
+  ConstantPool(const ConstantPool &) = delete;
+  ConstantPool &operator=(const ConstantPool &) = delete;
+  ~ConstantPool();
+
+  Constant *GetInt(uint64_t Val, uint8_t BitWidth);
+  Constant *GetFP(double Val, uint8_t BitWidth);
+
+  size_t size() const { return NumEntries; }
+
+private:
+  struct Entry {
+    uint64_t Bits = 0;
+    uint8_t BitWidth = 0;
+    bool IsFP = false;
+    Constant *C = nullptr;
+  };
+
+  static size_t Hash(uint64_t Bits, uint8_t BitWidth, bool IsFP);
+
+  /// Return the slot holding the key or the empty slot where it should be
+  /// inserted.
+  Entry &FindSlot(uint64_t Bits, uint8_t BitWidth, bool IsFP);
+
+  void Grow();
+
+  /// The size is always a power of 2
+  std::vector<Entry> Table;
+  size_t NumEntries = 0;
+  BumpAllocator Arena;
+};
+
+#endif
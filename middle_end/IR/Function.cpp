@@ -5,8 +5,9 @@
 #include <iostream>
 #include <utility>
 
-Function::Function(const std::string &Name, IRType RT)
-    : Name(Name), ReturnType(std::move(RT)) {
+Function::Function(Symbol Name, IRType RT)
+    : Name(Name), ReturnType(std::move(RT)),
+      InstructionArena(std::make_unique<BumpAllocator>()) {
   auto FinalName = std::string("entry_") + Name;
   auto Ptr = new BasicBlock(FinalName, this);
   std::unique_ptr<BasicBlock> BB(Ptr);
@@ -46,35 +47,35 @@ void Function::Insert(std::unique_ptr<FunctionParameter> FP) {
   Parameters.push_back(std::move(FP));
 }
 
-void Function::Print() const {
+void Function::Print(std::ostream &OS) const {
   if (DeclarationOnly)
-    std::cout << "declare ";
-  std::cout << "func " << Name << " (";
+    OS << "declare ";
+  OS << "func " << Name << " (";
 
   auto size = Parameters.size();
   if (!(size == 1 && Parameters[0]->GetType().IsVoid())) {
     for (unsigned i = 0; i < size; i++) {
-      std::cout << Parameters[i]->ValueString() << " :";
-      std::cout << Parameters[i]->GetType().AsString();
+      OS << Parameters[i]->ValueString() << " :";
+      OS << Parameters[i]->GetType().AsString();
       if (i + 1 < size)
-        std::cout << ", ";
+        OS << ", ";
     }
   }
 
-  std::cout << ")";
+  OS << ")";
   if (!ReturnType.IsVoid()) {
-    std::cout << " -> " << ReturnType.AsString();
+    OS << " -> " << ReturnType.AsString();
   }
 
   if (DeclarationOnly)
-    std::cout << ";";
+    OS << ";";
   else
-    std::cout << ":";
-  std::cout << std::endl;
+    OS << ":";
+  OS << std::endl;
 
   if (!DeclarationOnly)
     for (auto &BB : BasicBlocks)
-      BB->Print();
+      BB->Print(OS);
 
-  std::cout << std::endl << std::endl;
+  OS << std::endl << std::endl;
 }
@@ -1,9 +1,13 @@
 #ifndef FUNCTION_HPP
 #define FUNCTION_HPP
 
+#include "../../support/BumpAllocator.hpp"
+#include "../../support/Symbol.hpp"
 #include "IRType.hpp"
+#include <iostream>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 class Value;
@@ -15,7 +19,7 @@ class Function {
   using ParameterList = std::vector<std::unique_ptr<FunctionParameter>>;
 
 public:
-  Function(const std::string &Name, IRType RT);
+  Function(Symbol Name, IRType RT);
 
   /// Since unique_ptr is not copyable, therefore this class should not as well
   Function(const Function &) = delete;
@@ -24,7 +28,7 @@ public:
   BasicBlock *GetCurrentBB();
   BasicBlock *GetBB(size_t Index);
 
-  std::string &GetName() { return Name; }
+  Symbol GetName() const { return Name; }
 
   BasicBlockList &GetBasicBlocks() { return BasicBlocks; }
 
@@ -56,15 +60,26 @@ public:
 
   void CreateBasicBlock();
 
+  /// Create an instruction in the arena of the function. It has to be
+  /// inserted into one of the basic blocks of the function, which will destroy
+  /// it once it is erased.
+  template <typename T, typename... Args> T *CreateInstruction(Args &&...Arg) {
+    return new (InstructionArena->Allocate<T>()) T(std::forward<Args>(Arg)...);
+  }
+
   void Insert(std::unique_ptr<BasicBlock> BB);
   void Insert(std::unique_ptr<FunctionParameter> FP);
 
-  void Print() const;
+  void Print(std::ostream &OS = std::cout) const;
 
 private:
-  std::string Name;
+  Symbol Name;
   IRType ReturnType;
   ParameterList Parameters;
+  /// Held by pointer, so the instructions stay in place when the function is
+  /// moved. Must be declared before the basic blocks, since they destroy their
+  /// instructions.
+  std::unique_ptr<BumpAllocator> InstructionArena;
   BasicBlockList BasicBlocks;
 
   std::string IgnorableStructVarName;
@@ -3,12 +3,13 @@
 
 #include "../../backend/TargetMachine.hpp"
 #include "BasicBlock.hpp"
+#include "ConstantPool.hpp"
 #include "Function.hpp"
 #include "Instructions.hpp"
 #include "Module.hpp"
 #include "Value.hpp"
-#include <map>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 
 template <typename T>
@@ -128,25 +129,30 @@ private:
   Value *CreateBinaryInstruction(Instruction::IKind K, Value *L, Value *R) {
     // If both operand is constant, then evaluate them
     if (L->IsConstant() && R->IsConstant()) {
-      auto ConstLHS = dynamic_cast<Constant *>(L);
-      auto ConstRHS = dynamic_cast<Constant *>(R);
+      auto ConstLHS = cast<Constant>(L);
+      auto ConstRHS = cast<Constant>(R);
       assert(ConstLHS && ConstRHS);
 
       return EvaluateBinaryConstExpression(ConstLHS, ConstRHS, K);
     }
 
-    auto Inst = std::make_unique<BinaryInstruction>(K, L, R, GetCurrentBB());
+    auto Inst = Create<BinaryInstruction>(K, L, R, GetCurrentBB());
     Inst->SetID(ID++);
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   BasicBlock *GetCurrentBB() { return CurrentModule.CurrentBB(); }
 
-  Instruction *Insert(std::unique_ptr<Instruction> I) {
-    return this->GetCurrentBB()->Insert(std::move(I));
+  Instruction *Insert(Instruction *I) {
+    return this->GetCurrentBB()->Insert(I);
+  }
+
+  /// Create an instruction in the arena of the current function.
+  template <typename T, typename... Args> T *Create(Args &&...Arg) {
+    return GetCurrentFunction()->CreateInstruction<T>(
+        std::forward<Args>(Arg)...);
   }
 
 public:
@@ -218,144 +224,129 @@ public:
   }
 
   UnaryInstruction *CreateSEXT(Value *Operand, uint8_t BitWidth = 32) {
-    auto Inst = std::make_unique<UnaryInstruction>(Instruction::SEXT,
-                                                   IRType::CreateInt(BitWidth),
-                                                   Operand, GetCurrentBB());
+    auto Inst = Create<UnaryInstruction>(Instruction::SEXT,
+                                         IRType::CreateInt(BitWidth), Operand,
+                                         GetCurrentBB());
     Inst->SetID(ID++);
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   UnaryInstruction *CreateZEXT(Value *Operand, uint8_t BitWidth = 32) {
-    auto Inst = std::make_unique<UnaryInstruction>(Instruction::ZEXT,
-                                                   IRType::CreateInt(BitWidth),
-                                                   Operand, GetCurrentBB());
+    auto Inst = Create<UnaryInstruction>(Instruction::ZEXT,
+                                         IRType::CreateInt(BitWidth), Operand,
+                                         GetCurrentBB());
     Inst->SetID(ID++);
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   UnaryInstruction *CreateTRUNC(Value *Operand, uint8_t BitWidth = 32) {
-    auto Inst = std::make_unique<UnaryInstruction>(Instruction::TRUNC,
-                                                   IRType::CreateInt(BitWidth),
-                                                   Operand, GetCurrentBB());
+    auto Inst = Create<UnaryInstruction>(Instruction::TRUNC,
+                                         IRType::CreateInt(BitWidth), Operand,
+                                         GetCurrentBB());
     Inst->SetID(ID++);
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   UnaryInstruction *CreateFTOI(Value *Operand, uint8_t BitWidth = 32) {
-    auto Inst = std::make_unique<UnaryInstruction>(Instruction::FTOI,
-                                                   IRType::CreateInt(BitWidth),
-                                                   Operand, GetCurrentBB());
+    auto Inst = Create<UnaryInstruction>(Instruction::FTOI,
+                                         IRType::CreateInt(BitWidth), Operand,
+                                         GetCurrentBB());
     Inst->SetID(ID++);
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   UnaryInstruction *CreateITOF(Value *Operand, uint8_t BitWidth = 32) {
-    auto Inst = std::make_unique<UnaryInstruction>(
-        Instruction::ITOF, IRType::CreateFloat(BitWidth), Operand,
-        GetCurrentBB());
+    auto Inst = Create<UnaryInstruction>(Instruction::ITOF,
+                                         IRType::CreateFloat(BitWidth), Operand,
+                                         GetCurrentBB());
     Inst->SetID(ID++);
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   UnaryInstruction *CreateBITCAST(Value *Operand, const IRType &To) {
-    auto Inst = std::make_unique<UnaryInstruction>(Instruction::BITCAST, To,
-                                                   Operand, GetCurrentBB());
+    auto Inst = Create<UnaryInstruction>(Instruction::BITCAST, To, Operand,
+                                         GetCurrentBB());
     Inst->SetID(ID++);
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
-  CallInstruction *CreateCALL(std::string &Name, std::vector<Value *> Args,
+  CallInstruction *CreateCALL(Symbol Name, std::vector<Value *> Args,
                               const IRType &Type, int StructIdx = -1) {
-    auto Inst = std::make_unique<CallInstruction>(Name, Args, Type,
-                                                  GetCurrentBB(), StructIdx);
-    auto InstPtr = Inst.get();
+    auto Inst = Create<CallInstruction>(Name, Args, Type, GetCurrentBB(),
+                                        StructIdx);
 
     if (!Type.IsVoid())
       Inst->SetID(ID++);
 
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   ReturnInstruction *CreateRET(Value *ReturnValue) {
-    auto Inst =
-        std::make_unique<ReturnInstruction>(ReturnValue, GetCurrentBB());
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    auto Inst = Create<ReturnInstruction>(ReturnValue, GetCurrentBB());
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   StackAllocationInstruction *CreateSA(std::string Identifier,
                                        const IRType &Type) {
-    auto Inst = std::make_unique<StackAllocationInstruction>(
-        Identifier, Type, CurrentModule.GetBB(0));
-    auto InstPtr = Inst.get();
+    auto Inst = Create<StackAllocationInstruction>(Identifier, Type,
+                                                   CurrentModule.GetBB(0));
     Inst->SetID(ID++);
-    CurrentModule.GetBB(0)->InsertSA(std::move(Inst));
+    CurrentModule.GetBB(0)->InsertSA(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   GetElementPointerInstruction *CreateGEP(const IRType &ResultType,
                                           Value *Source, Value *Index) {
-    auto Inst = std::make_unique<GetElementPointerInstruction>(
-        ResultType, Source, Index, GetCurrentBB());
-    auto InstPtr = Inst.get();
+    auto Inst = Create<GetElementPointerInstruction>(ResultType, Source, Index,
+                                                     GetCurrentBB());
     Inst->SetID(ID++);
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   StoreInstruction *CreateSTR(Value *Source, Value *Destination) {
-    auto Inst =
-        std::make_unique<StoreInstruction>(Source, Destination, GetCurrentBB());
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    auto Inst = Create<StoreInstruction>(Source, Destination, GetCurrentBB());
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   LoadInstruction *CreateLD(const IRType &ResultType, Value *Source,
                             Value *Offset = nullptr) {
-    auto Inst = std::make_unique<LoadInstruction>(ResultType, Source, Offset,
-                                                  GetCurrentBB());
-    auto InstPtr = Inst.get();
+    auto Inst = Create<LoadInstruction>(ResultType, Source, Offset,
+                                        GetCurrentBB());
     Inst->SetID(ID++);
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   MemoryCopyInstruction *CreateMEMCOPY(Value *Destination, Value *Source,
                                        size_t Bytes) {
-    auto Inst = std::make_unique<MemoryCopyInstruction>(Destination, Source,
-                                                        Bytes, GetCurrentBB());
-    auto InstPtr = Inst.get();
+    auto Inst = Create<MemoryCopyInstruction>(Destination, Source, Bytes,
+                                              GetCurrentBB());
     Inst->SetID(ID++);
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   Value *CreateCMP(CompareInstruction::CompRel Relation, Value *LHS,
@@ -364,8 +355,8 @@ public:
     if (LHS->IsConstant() && RHS->IsConstant()) {
       assert(LHS->IsFPType() == RHS->IsFPType());
       assert(LHS->GetBitWidth() == RHS->GetBitWidth());
-      auto ConstLHS = dynamic_cast<Constant *>(LHS);
-      auto ConstRHS = dynamic_cast<Constant *>(RHS);
+      auto ConstLHS = cast<Constant>(LHS);
+      auto ConstRHS = cast<Constant>(RHS);
       auto TrueVal = GetConstant((uint64_t)1);
       auto FalseVal = GetConstant((uint64_t)0);
 
@@ -383,42 +374,42 @@ public:
       }
     }
 
-    auto Inst = std::make_unique<CompareInstruction>(LHS, RHS, Relation,
-                                                     GetCurrentBB());
-    auto InstPtr = Inst.get();
+    auto Inst = Create<CompareInstruction>(LHS, RHS, Relation, GetCurrentBB());
     Inst->SetID(ID++);
-    Insert(std::move(Inst));
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   JumpInstruction *CreateJUMP(BasicBlock *Destination) {
-    auto Inst = std::make_unique<JumpInstruction>(
-        JumpInstruction(Destination, GetCurrentBB()));
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    auto Inst = Create<JumpInstruction>(Destination, GetCurrentBB());
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
   BranchInstruction *CreateBR(Value *Condition, BasicBlock *True,
                               BasicBlock *False = nullptr) {
-    auto Inst = std::make_unique<BranchInstruction>(
-        BranchInstruction(Condition, True, False, GetCurrentBB()));
-    auto InstPtr = Inst.get();
-    Insert(std::move(Inst));
+    auto Inst = Create<BranchInstruction>(Condition, True, False,
+                                          GetCurrentBB());
+    Insert(Inst);
 
-    return InstPtr;
+    return Inst;
   }
 
-  GlobalVariable *CreateGlobalVar(std::string &Identifier, const IRType &Type) {
+  /// Return a new, module wide unique name for a string literal.
+  Symbol CreateStringLiteralName() {
+    return Symbol::Intern(".L.str" + std::to_string(StringLiteralCounter++));
+  }
+
+  GlobalVariable *CreateGlobalVar(Symbol Identifier, const IRType &Type) {
     auto GlobalVar = new GlobalVariable(Identifier, Type);
     GlobalVar->SetID(ID++);
 
     return GlobalVar;
   }
 
-  GlobalVariable *CreateGlobalVar(std::string &Identifier, const IRType &Type,
+  GlobalVariable *CreateGlobalVar(Symbol Identifier, const IRType &Type,
                                   std::string Value) {
     auto GlobalVar = new GlobalVariable(Identifier, Type, std::move(Value));
     GlobalVar->SetID(ID++);
@@ -426,7 +417,7 @@ public:
     return GlobalVar;
   }
 
-  GlobalVariable *CreateGlobalVar(std::string &Identifier, const IRType &Type,
+  GlobalVariable *CreateGlobalVar(Symbol Identifier, const IRType &Type,
                                   Value *Val) {
     auto GlobalVar = new GlobalVariable(Identifier, Type, Val);
     GlobalVar->SetID(ID++);
@@ -434,7 +425,7 @@ public:
     return GlobalVar;
   }
 
-  GlobalVariable *CreateGlobalVar(std::string &Identifier, const IRType &Type,
+  GlobalVariable *CreateGlobalVar(Symbol Identifier, const IRType &Type,
                                   std::vector<uint64_t> InitList) {
     auto GlobalVar = new GlobalVariable(Identifier, Type, std::move(InitList));
     GlobalVar->SetID(ID++);
@@ -442,7 +433,7 @@ public:
     return GlobalVar;
   }
 
-  void CreateNewFunction(std::string &Name, IRType ReturnType) {
+  void CreateNewFunction(Symbol Name, IRType ReturnType) {
     CurrentModule.AddFunction(Function(Name, std::move(ReturnType)));
     SymbolTable.clear();
     LabelTable.clear();
@@ -455,7 +446,7 @@ public:
     SetGlobalScope(false);
   }
 
-  Value *GetGlobalVar(const std::string &Identifier) {
+  Value *GetGlobalVar(Symbol Identifier) {
     return CurrentModule.GetGlobalVar(Identifier);
   }
 
@@ -472,9 +463,8 @@ public:
 
   void InsertBB(std::unique_ptr<BasicBlock> BB) {
     // Modify label name to guarantee its uniqueness
-    auto NewName = BB->GetName() + std::to_string(LabelTable[BB->GetName()]);
-    LabelTable[BB->GetName()]++;
-    BB->SetName(NewName);
+    auto &Count = LabelTable[Symbol::Intern(BB->GetName())];
+    BB->SetName(BB->GetName() + std::to_string(Count++));
 
     GetCurrentFunction()->Insert(std::move(BB));
   }
@@ -486,45 +476,26 @@ public:
 
   void EraseLastBB() { GetCurrentFunction()->GetBasicBlocks().pop_back(); }
 
-  void EraseInst(Instruction *I) {
-    for (auto &BB : GetCurrentFunction()->GetBasicBlocks())
-      for (size_t i = 0; i < BB->GetInstructions().size(); i++)
-        if (BB->GetInstructions()[i].get() == I) {
-          BB->GetInstructions().erase(BB->GetInstructions().begin() + i);
-          return;
-        }
-  }
+  void EraseInst(Instruction *I) { I->EraseFromParent(); }
 
   void EraseLastInst() {
     GetCurrentFunction()->GetBasicBlocks().back()->GetInstructions().pop_back();
   }
 
-  void AddToSymbolTable(std::string &Identifier, Value *Value) {
+  void AddToSymbolTable(Symbol Identifier, Value *Value) {
     SymbolTable[Identifier] = Value;
   }
 
-  Value *GetSymbolValue(const std::string &Identifier) {
-    return SymbolTable[Identifier];
+  Value *GetSymbolValue(Symbol Identifier) const {
+    auto It = SymbolTable.find(Identifier);
+    return It != SymbolTable.end() ? It->second : nullptr;
   }
 
   Constant *GetConstant(uint64_t C, uint8_t BW = 32) {
-    std::pair<uint64_t, uint8_t> RequestedConst = {C, BW};
-
-    if (auto ConstVal = IntConstantPool[RequestedConst].get();
-        ConstVal != nullptr)
-      return ConstVal;
-
-    IntConstantPool[RequestedConst] =
-        std::make_unique<Constant>(RequestedConst.first, RequestedConst.second);
-    return IntConstantPool[RequestedConst].get();
+    return Constants.GetInt(C, BW);
   }
-
   Constant *GetConstant(double C, uint8_t BitWidth = 64) {
-    if (auto ConstVal = FPConstantPool[C].get(); ConstVal != nullptr)
-      return ConstVal;
-
-    FPConstantPool[C] = std::make_unique<Constant>(C, BitWidth);
-    return FPConstantPool[C].get();
+    return Constants.GetFP(C, BitWidth);
   }
 
   std::vector<BasicBlock *> &GetLoopIncrementBBsTable() {
@@ -545,24 +516,23 @@ private:
   /// A counter essentially, which used to give Values a unique ID.
   unsigned ID;
 
+  /// Used to name the string literals uniquely within the module.
+  unsigned StringLiteralCounter = 0;
+
   /// Shows whether we are in the global scope or not.
   bool GlobalScope = false;
 
-  /// To store already created integer constants
-  std::map<std::pair<uint64_t, uint8_t>, std::unique_ptr<Constant>>
-      IntConstantPool;
-
-  /// To store already created floating point constants
-  std::map<double, std::unique_ptr<Constant>> FPConstantPool;
+  /// To store already created constants
+  ConstantPool Constants;
 
   // TODO: Consider putting these to Function class
 
   /// Hold the local symbols for the current function.
-  std::map<std::string, Value *> SymbolTable;
+  std::unordered_map<Symbol, Value *> SymbolTable;
 
   /// To keep track how many times each label were defined. This number
   /// can be used to concatenate it to the label to make it unique.
-  std::map<std::string, unsigned> LabelTable;
+  std::unordered_map<Symbol, unsigned> LabelTable;
 
   /// For context information for "continue" statements. Containing the pointer
   /// to the basic block which will be the target of the generated jump.
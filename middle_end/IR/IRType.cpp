@@ -1,80 +1,152 @@
 #include "IRType.hpp"
 #include "../../backend/Support.hpp"
 #include "../../backend/TargetMachine.hpp"
+#include "IRTypeContext.hpp"
+
+IRType::IRType()
+    : S(IRTypeContext::Get().GetStorage({IRType::INVALID, 0})) {}
+
+IRType::IRType(IRType::TKind kind)
+    : S(IRTypeContext::Get().GetStorage({kind, 32})) {}
+
+IRType::IRType(IRType::TKind kind, uint8_t BW)
+    : S(IRTypeContext::Get().GetStorage({kind, BW})) {}
+
+void IRType::Update(const Storage &Modified) {
+  S = IRTypeContext::Get().GetStorage(Modified);
+}
+
+void IRType::SetPointerLevel(uint8_t pl) {
+  assert(pl < 10 && "Unrealistic pointer level");
+  if (pl == S->PointerLevel)
+    return;
+  auto Modified = *S;
+  Modified.PointerLevel = pl;
+  Update(Modified);
+}
+
+void IRType::IncrementPointerLevel() { SetPointerLevel(S->PointerLevel + 1); }
+
+void IRType::DecrementPointerLevel() {
+  assert(S->PointerLevel > 0 && "Cannot decrement below 0");
+  SetPointerLevel(S->PointerLevel - 1);
+}
 
 void IRType::ReduceDimension() {
-  if (!Dimensions.empty())
-    Dimensions.erase(Dimensions.begin());
+  if (S->Dimensions->empty())
+    return;
+  auto Modified = *S;
+  Modified.Dimensions = IRTypeContext::Get().GetDimensions(
+      {S->Dimensions->begin() + 1, S->Dimensions->end()});
+  Update(Modified);
 }
 
-unsigned IRType::GetStructMaxAlignment(TargetMachine *TM) const {
-  unsigned alignment = 1;
+void IRType::SetDimensions(const std::vector<unsigned> &N) {
+  auto Modified = *S;
+  Modified.Dimensions = IRTypeContext::Get().GetDimensions(N);
+  Update(Modified);
+}
+
+void IRType::SetStructName(Symbol Name) {
+  auto Modified = *S;
+  Modified.StructName = Name;
+  Update(Modified);
+}
 
-  for (auto &type : MembersTypeList)
+void IRType::SetMemberTypes(std::vector<IRType> Members) {
+  auto Modified = *S;
+  Modified.Body = IRTypeContext::Get().GetStructBody(std::move(Members));
+  Update(Modified);
+}
+
+IRType::StructBody::Layout
+IRType::StructBody::ComputeLayout(const std::vector<IRType> &Members,
+                                  unsigned PointerBitSize) {
+  Layout Result;
+
+  // Get the maximum alignment based on the struct members
+  unsigned alignment = 1;
+  for (auto &type : Members)
     if (type.IsPTR()) {
-      unsigned ptrSize = TM ? TM->GetPointerSize() / 8 : 8;
+      unsigned ptrSize = PointerBitSize / 8;
       alignment = std::max(alignment, ptrSize);
     } else if (type.IsArray()) {
-      if (type.GetBaseType().IsScalar())
+      // the size of the base type is computed directly, since this is called
+      // while the context is locked, so no new types can be requested
+      if (type.IsScalar())
         alignment =
-            std::max(alignment, (unsigned)type.GetBaseType().GetByteSize(TM));
-#if 0
-      else if (type.GetBaseType().IsScalar())
-        // TODO: this will not work currently, since GetBaseType implementation
-        // does not cover structs
-        alignment = type.GetBaseType().GetStructMaxAlignment(TM);
-#endif
+            std::max(alignment, (unsigned)(type.GetBitSize() + 7) / 8);
       else
         assert(!"Unhandled array base type");
     } else if (type.IsScalar())
-      alignment = std::max(alignment, (unsigned)type.GetByteSize(TM));
-    else if (type.IsStruct())
-      alignment = std::max(alignment, (unsigned)type.GetStructMaxAlignment(TM));
+      alignment = std::max(alignment, (unsigned)type.GetByteSize());
+    else if (type.IsStruct()) {
+      auto Body = type.GetStorage()->Body;
+      auto MemberLayout = Body->GetCachedLayout(PointerBitSize);
+      alignment = std::max(
+          alignment, MemberLayout
+                         ? MemberLayout->MaxAlignment
+                         : ComputeLayout(Body->Members, PointerBitSize)
+                               .MaxAlignment);
+    }
     else
       assert(!"Unhandled type");
+  Result.MaxAlignment = alignment;
 
-  return alignment;
-}
-
-unsigned IRType::GetElemByteOffset(const unsigned StructElemIndex,
-                                   TargetMachine *TM) const {
-  assert(StructElemIndex < MembersTypeList.size() && "Out of bound access");
-
+  // The offset of each element, then the size of the whole struct. Note that
+  // the members are always sized with the default 64 bit pointers.
   unsigned ByteOffset = 0;
-  for (size_t i = 0; i < StructElemIndex; i++) {
-    const unsigned Size = MembersTypeList[i].GetByteSize();
+  for (auto &Member : Members) {
+    Result.ElemByteOffsets.push_back(
+        GetNextAlignedValue(ByteOffset, Result.MaxAlignment));
+
+    const unsigned Size = Member.GetByteSize();
     ByteOffset = GetNextAlignedValue(ByteOffset, Size);
     ByteOffset += Size;
   }
+  Result.ByteSize = GetNextAlignedValue(ByteOffset, Result.MaxAlignment);
 
-  const unsigned MaxAlignment = GetStructMaxAlignment(TM);
-  ByteOffset = GetNextAlignedValue(ByteOffset, MaxAlignment);
-  return ByteOffset;
+  return Result;
 }
 
-size_t IRType::GetByteSize(TargetMachine *TM) const {
-  unsigned NumberOfElements = 1;
+static unsigned GetPointerBitSize(TargetMachine *TM) {
+  return TM ? TM->GetPointerSize() : 64;
+}
 
-  if (!Dimensions.empty())
-    for (unsigned int Dimension : Dimensions)
-      NumberOfElements *= Dimension;
+unsigned IRType::GetStructMaxAlignment(TargetMachine *TM) const {
+  const auto PointerBitSize = GetPointerBitSize(TM);
+  if (auto Layout = S->Body->GetCachedLayout(PointerBitSize))
+    return Layout->MaxAlignment;
+  return StructBody::ComputeLayout(S->Body->Members, PointerBitSize)
+      .MaxAlignment;
+}
 
-  if (IsStruct() && !IsPTR()) {
-    unsigned Result = 0;
-    const unsigned Alignment = GetStructMaxAlignment(TM);
+unsigned IRType::GetElemByteOffset(const unsigned StructElemIndex,
+                                   TargetMachine *TM) const {
+  assert(StructElemIndex < S->Body->Members.size() && "Out of bound access");
 
-    for (auto &type : MembersTypeList) {
-      auto size = type.GetByteSize();
-      Result = GetNextAlignedValue(Result, size);
-      Result += size;
-    }
+  const auto PointerBitSize = GetPointerBitSize(TM);
+  if (auto Layout = S->Body->GetCachedLayout(PointerBitSize))
+    return Layout->ElemByteOffsets[StructElemIndex];
+  return StructBody::ComputeLayout(S->Body->Members, PointerBitSize)
+      .ElemByteOffsets[StructElemIndex];
+}
 
-    Result = GetNextAlignedValue(Result, Alignment);
-    return Result;
+size_t IRType::GetByteSize(TargetMachine *TM) const {
+  if (IsStruct() && !IsPTR()) {
+    const auto PointerBitSize = GetPointerBitSize(TM);
+    if (auto Layout = S->Body->GetCachedLayout(PointerBitSize))
+      return Layout->ByteSize;
+    return StructBody::ComputeLayout(S->Body->Members, PointerBitSize)
+        .ByteSize;
   }
 
-  if (PointerLevel == 0)
-    return (BitWidth * NumberOfElements + 7) / 8;
+  unsigned NumberOfElements = 1;
+  for (unsigned int Dimension : *S->Dimensions)
+    NumberOfElements *= Dimension;
+
+  if (S->PointerLevel == 0)
+    return (S->BitWidth * NumberOfElements + 7) / 8;
 
   // in case if it is a pointer type, then ask the target for the pointer size
   // or if it was not given then the default size is 64
@@ -88,14 +160,14 @@ size_t IRType::GetByteSize(TargetMachine *TM) const {
 size_t IRType::GetBaseTypeByteSize(TargetMachine *TM) const {
   auto TypeCopy = *this;
   TypeCopy.SetPointerLevel(0);
-  TypeCopy.GetDimensions().clear();
+  TypeCopy.SetDimensions({});
   return TypeCopy.GetByteSize(TM);
 }
 
 std::string IRType::AsString() const {
   std::string Str;
 
-  switch (Kind) {
+  switch (S->Kind) {
   case FP:
     Str += "f";
     break;
@@ -106,7 +178,7 @@ std::string IRType::AsString() const {
     Str += "i";
     break;
   case STRUCT:
-    Str += "struct." + StructName;
+    Str += "struct." + S->StructName;
     break;
   case NONE:
     return "void";
@@ -115,16 +187,17 @@ std::string IRType::AsString() const {
     break;
   }
 
-  if (Kind != STRUCT)
-    Str += std::to_string(BitWidth);
+  if (S->Kind != STRUCT)
+    Str += std::to_string(S->BitWidth);
 
+  auto &Dimensions = GetDimensions();
   if (!Dimensions.empty()) {
     for (int i = Dimensions.size() - 1; i >= 0; i--)
       Str = "[" + std::to_string(Dimensions[i]) + " x " + Str + "]";
   }
 
   std::string PtrStr;
-  for (auto i = 0; i < PointerLevel; i++)
+  for (auto i = 0; i < S->PointerLevel; i++)
     PtrStr += "*";
 
   return PtrStr + Str;
@@ -1,6 +1,7 @@
 #ifndef IRTYPE_HPP
 #define IRTYPE_HPP
 
+#include "../../support/Symbol.hpp"
 #include <cassert>
 #include <cstdint>
 #include <string>
@@ -8,26 +9,45 @@
 
 class TargetMachine;
 
+/// Type of an IR value. An IRType is only a handle of a uniqued, immutable
+/// storage owned by the IRTypeContext, so copying it is a pointer copy.
+/// Modifying a type (like incrementing its pointer level) makes the handle
+/// refer to the storage of the modified type.
 class IRType {
 public:
   enum TKind : uint8_t { INVALID, NONE, FP, UINT, SINT, PTR, STRUCT };
 
-  IRType() : Kind(INVALID), BitWidth(0) {}
+  struct StructBody;
 
-  explicit IRType(IRType::TKind kind) : Kind(kind), BitWidth(32) {}
+  /// The uniqued representation of a type. The member list and the
+  /// dimensions are uniqued as well, so two storages are identical if all of
+  /// their fields are equal.
+  struct Storage {
+    TKind Kind = INVALID;
+    uint8_t BitWidth = 0;
+    uint8_t PointerLevel = 0;
+    Symbol StructName;
+    const StructBody *Body = nullptr;
+    const std::vector<unsigned> *Dimensions = nullptr;
 
-  IRType(IRType::TKind kind, uint8_t BW) : Kind(kind), BitWidth(BW) {}
+    bool IsIdentical(const Storage &RHS) const {
+      return Kind == RHS.Kind && BitWidth == RHS.BitWidth &&
+             PointerLevel == RHS.PointerLevel &&
+             StructName == RHS.StructName && Body == RHS.Body &&
+             Dimensions == RHS.Dimensions;
+    }
+  };
 
-  uint8_t GetPointerLevel() const { return PointerLevel; }
-  void SetPointerLevel(uint8_t pl) {
-    assert(pl < 10 && "Unrealistic pointer level");
-    PointerLevel = pl;
-  }
-  void IncrementPointerLevel() { PointerLevel++; }
-  void DecrementPointerLevel() {
-    assert(PointerLevel > 0 && "Cannot decrement below 0");
-    PointerLevel--;
-  }
+  IRType();
+
+  explicit IRType(IRType::TKind kind);
+
+  IRType(IRType::TKind kind, uint8_t BW);
+
+  uint8_t GetPointerLevel() const { return S->PointerLevel; }
+  void SetPointerLevel(uint8_t pl);
+  void IncrementPointerLevel();
+  void DecrementPointerLevel();
 
   void ReduceDimension();
 
@@ -39,37 +59,42 @@ public:
 
   static IRType CreateInt(uint8_t BitWidth = 32) { return {SINT, BitWidth}; }
 
-  bool operator==(const IRType &RHS) {
-    return BitWidth == RHS.BitWidth && Kind == RHS.Kind;
+  bool operator==(const IRType &RHS) const {
+    return S->BitWidth == RHS.S->BitWidth && S->Kind == RHS.S->Kind;
   }
 
-  bool IsInvalid() const { return Kind == INVALID; }
-  bool IsFP() const { return Kind == FP; }
-  bool IsSInt() const { return Kind == SINT; }
-  bool IsUInt() const { return Kind == UINT; }
+  /// Return true if every property of the types are the same, unlike
+  /// operator== which only checks the kind and the bit width.
+  bool IsIdentical(const IRType &RHS) const { return S == RHS.S; }
+
+  bool IsInvalid() const { return S->Kind == INVALID; }
+  bool IsFP() const { return S->Kind == FP; }
+  bool IsSInt() const { return S->Kind == SINT; }
+  bool IsUInt() const { return S->Kind == UINT; }
   bool IsINT() const { return IsSInt() || IsUInt(); }
   bool IsScalar() const { return IsFP() || IsINT(); }
-  bool IsPTR() const { return PointerLevel > 0; }
-  bool IsStruct() const { return Kind == STRUCT; }
-  bool IsArray() const { return !Dimensions.empty(); }
-  bool IsVoid() const { return Kind == NONE && PointerLevel == 0; }
-
-  void SetDimensions(const std::vector<unsigned> &N) { Dimensions = N; }
-  std::vector<unsigned> &GetDimensions() { return Dimensions; }
-  unsigned CalcElemSize(unsigned dim) {
+  bool IsPTR() const { return S->PointerLevel > 0; }
+  bool IsStruct() const { return S->Kind == STRUCT; }
+  bool IsArray() const { return !S->Dimensions->empty(); }
+  bool IsVoid() const { return S->Kind == NONE && S->PointerLevel == 0; }
+
+  void SetDimensions(const std::vector<unsigned> &N);
+  const std::vector<unsigned> &GetDimensions() const { return *S->Dimensions; }
+  unsigned CalcElemSize(unsigned dim) const {
     unsigned result = 1;
+    auto &Dimensions = GetDimensions();
     assert((dim == 0 || dim < Dimensions.size()) && "Out of bound");
-    size_t i = PointerLevel > 1 ? dim : dim + 1;
+    size_t i = S->PointerLevel > 1 ? dim : dim + 1;
     for (; i < Dimensions.size(); i++)
       result *= Dimensions[i];
 
-    return result * (BitWidth / 8);
+    return result * (S->BitWidth / 8);
   }
 
   unsigned GetElemByteOffset(unsigned StructElemIndex,
                              TargetMachine *TM = nullptr) const;
 
-  size_t GetBitSize() const { return BitWidth; }
+  size_t GetBitSize() const { return S->BitWidth; }
 
   size_t GetByteSize(TargetMachine *TM = nullptr) const;
 
@@ -77,22 +102,59 @@ public:
   /// and dimensionality.
   size_t GetBaseTypeByteSize(TargetMachine *TM = nullptr) const;
 
-  IRType GetBaseType() const { return {Kind, BitWidth}; }
+  IRType GetBaseType() const { return {S->Kind, S->BitWidth}; }
+
+  void SetStructName(Symbol Name);
+  Symbol GetStructName() const { return S->StructName; }
 
-  void SetStructName(std::string &str) { StructName = str; }
-  const std::string &GetStructName() const { return StructName; }
+  inline const std::vector<IRType> &GetMemberTypes() const;
+  void SetMemberTypes(std::vector<IRType> Members);
 
-  std::vector<IRType> &GetMemberTypes() { return MembersTypeList; }
+  const Storage *GetStorage() const { return S; }
 
   std::string AsString() const;
 
 private:
-  uint8_t BitWidth;
-  uint8_t PointerLevel = 0;
-  std::string StructName;
-  std::vector<IRType> MembersTypeList;
-  std::vector<unsigned> Dimensions;
-  TKind Kind;
+  explicit IRType(const Storage *S) : S(S) {}
+
+  /// Replace the storage with the canonical one of @Modified.
+  void Update(const Storage &Modified);
+
+  const Storage *S;
+
+  friend class IRTypeContext;
 };
 
+/// Member types of a struct together with its layout. The layout only
+/// depends on the members and the pointer size of the target, therefore it is
+/// computed once, when the body is created, for 32 and 64 bit pointers.
+struct IRType::StructBody {
+  struct Layout {
+    unsigned MaxAlignment = 1;
+    size_t ByteSize = 0;
+    std::vector<unsigned> ElemByteOffsets;
+  };
+
+  std::vector<IRType> Members;
+  Layout Layout32;
+  Layout Layout64;
+
+  /// Compute the layout of the members for @PointerBitSize sized pointers.
+  static Layout ComputeLayout(const std::vector<IRType> &Members,
+                              unsigned PointerBitSize);
+
+  /// Return the precomputed layout if there is one for @PointerBitSize.
+  const Layout *GetCachedLayout(unsigned PointerBitSize) const {
+    if (PointerBitSize == 64)
+      return &Layout64;
+    if (PointerBitSize == 32)
+      return &Layout32;
+    return nullptr;
+  }
+};
+
+const std::vector<IRType> &IRType::GetMemberTypes() const {
+  return S->Body->Members;
+}
+
 #endif
@@ -0,0 +1,123 @@
+#include "IRTypeContext.hpp"
+
+static void HashCombine(size_t &Seed, size_t Value) {
+  Seed ^= Value + 0x9e3779b97f4a7c15ULL + (Seed << 6) + (Seed >> 2);
+}
+
+size_t IRTypeContext::StorageHash::operator()(const IRType::Storage *S) const {
+  size_t Hash = S->StructName.GetID();
+  HashCombine(Hash, S->Kind);
+  HashCombine(Hash, S->BitWidth);
+  HashCombine(Hash, S->PointerLevel);
+  HashCombine(Hash, reinterpret_cast<uintptr_t>(S->Body));
+  HashCombine(Hash, reinterpret_cast<uintptr_t>(S->Dimensions));
+  return Hash;
+}
+
+size_t
+IRTypeContext::BodyHash::operator()(const IRType::StructBody *B) const {
+  size_t Hash = B->Members.size();
+  for (auto &Member : B->Members)
+    HashCombine(Hash, reinterpret_cast<uintptr_t>(Member.GetStorage()));
+  return Hash;
+}
+
+bool IRTypeContext::BodyEq::operator()(const IRType::StructBody *L,
+                                       const IRType::StructBody *R) const {
+  if (L->Members.size() != R->Members.size())
+    return false;
+  for (size_t i = 0; i < L->Members.size(); i++)
+    if (!L->Members[i].IsIdentical(R->Members[i]))
+      return false;
+  return true;
+}
+
+size_t
+IRTypeContext::DimensionsHash::operator()(const std::vector<unsigned> *D) const {
+  size_t Hash = D->size();
+  for (auto Dim : *D)
+    HashCombine(Hash, Dim);
+  return Hash;
+}
+
+IRTypeContext &IRTypeContext::Get() {
+  static IRTypeContext Context;
+  return Context;
+}
+
+IRTypeContext::IRTypeContext() {
+  for (auto &KindTypes : ScalarTypes)
+    for (auto &ScalarType : KindTypes)
+      ScalarType.store(nullptr, std::memory_order_relaxed);
+
+  EmptyBody = GetStructBody({});
+  EmptyDimensions = GetDimensions({});
+}
+
+const IRType::Storage *IRTypeContext::GetStorage(const IRType::Storage &Key) {
+  const bool IsScalar = !Key.PointerLevel && Key.StructName.IsEmpty() &&
+                        (!Key.Body || Key.Body == EmptyBody) &&
+                        (!Key.Dimensions || Key.Dimensions == EmptyDimensions);
+  if (!IsScalar) {
+    std::lock_guard<std::mutex> Guard(Lock);
+    return GetStorageImpl(Key);
+  }
+
+  auto &Slot = ScalarTypes[Key.Kind][Key.BitWidth];
+  if (auto Result = Slot.load(std::memory_order_acquire))
+    return Result;
+
+  std::lock_guard<std::mutex> Guard(Lock);
+  auto Result = GetStorageImpl(Key);
+  Slot.store(Result, std::memory_order_release);
+  return Result;
+}
+
+const IRType::Storage *
+IRTypeContext::GetStorageImpl(const IRType::Storage &Key) {
+  IRType::Storage Canonical = Key;
+  if (!Canonical.Body)
+    Canonical.Body = EmptyBody;
+  if (!Canonical.Dimensions)
+    Canonical.Dimensions = EmptyDimensions;
+
+  if (auto It = UniqueStorages.find(&Canonical); It != UniqueStorages.end())
+    return *It;
+
+  auto &New = Storages.emplace_back(Canonical);
+  UniqueStorages.insert(&New);
+  return &New;
+}
+
+const IRType::StructBody *
+IRTypeContext::GetStructBody(std::vector<IRType> Members) {
+  std::lock_guard<std::mutex> Guard(Lock);
+
+  IRType::StructBody Key;
+  Key.Members = std::move(Members);
+  if (auto It = UniqueBodies.find(&Key); It != UniqueBodies.end())
+    return *It;
+
+  auto &New = Bodies.emplace_back(std::move(Key));
+  New.Layout32 = IRType::StructBody::ComputeLayout(New.Members, 32);
+  New.Layout64 = IRType::StructBody::ComputeLayout(New.Members, 64);
+  UniqueBodies.insert(&New);
+  return &New;
+}
+
+const std::vector<unsigned> *
+IRTypeContext::GetDimensions(std::vector<unsigned> Dims) {
+  std::lock_guard<std::mutex> Guard(Lock);
+
+  if (auto It = UniqueDimensions.find(&Dims); It != UniqueDimensions.end())
+    return *It;
+
+  auto &New = DimensionLists.emplace_back(std::move(Dims));
+  UniqueDimensions.insert(&New);
+  return &New;
+}
+
+size_t IRTypeContext::GetNumTypes() {
+  std::lock_guard<std::mutex> Guard(Lock);
+  return Storages.size();
+}
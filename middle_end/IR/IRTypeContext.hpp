@@ -0,0 +1,85 @@
+#ifndef IRTYPE_CONTEXT_HPP
+#define IRTYPE_CONTEXT_HPP
+
+#include "IRType.hpp"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/// Uniquely owns every distinct IRType, so a type is stored only once and
+/// an IRType is just a pointer to it. The member lists of structs (with their
+/// layouts) and the array dimensions are uniqued as well.
+///
+/// IR types are created all over the middle end and the backend (instruction
+/// constructors, constants), mostly without access to the module, therefore
+/// the context is process wide and lives until the end of the program. It is
+/// safe to use from multiple threads. Once created, the scalar types, like
+/// IRType(IRType::SINT, 32), are available without locking.
+class IRTypeContext {
+public:
+  static IRTypeContext &Get();
+
+  /// Return the canonical storage which is identical to @Key.
+  const IRType::Storage *GetStorage(const IRType::Storage &Key);
+
+  const IRType::StructBody *GetStructBody(std::vector<IRType> Members);
+  const std::vector<unsigned> *GetDimensions(std::vector<unsigned> Dims);
+
+  /// Number of distinct types created so far.
+  size_t GetNumTypes();
+
+private:
+  IRTypeContext();
+
+  const IRType::Storage *GetStorageImpl(const IRType::Storage &Key);
+
+  struct StorageHash {
+    size_t operator()(const IRType::Storage *S) const;
+  };
+  struct StorageEq {
+    bool operator()(const IRType::Storage *L, const IRType::Storage *R) const {
+      return L->IsIdentical(*R);
+    }
+  };
+  struct BodyHash {
+    size_t operator()(const IRType::StructBody *B) const;
+  };
+  struct BodyEq {
+    bool operator()(const IRType::StructBody *L,
+                    const IRType::StructBody *R) const;
+  };
+  struct DimensionsHash {
+    size_t operator()(const std::vector<unsigned> *D) const;
+  };
+  struct DimensionsEq {
+    bool operator()(const std::vector<unsigned> *L,
+                    const std::vector<unsigned> *R) const {
+      return *L == *R;
+    }
+  };
+
+  std::mutex Lock;
+
+  // Deques, since they never move their elements
+  std::deque<IRType::Storage> Storages;
+  std::deque<IRType::StructBody> Bodies;
+  std::deque<std::vector<unsigned>> DimensionLists;
+
+  std::unordered_set<const IRType::Storage *, StorageHash, StorageEq>
+      UniqueStorages;
+  std::unordered_set<const IRType::StructBody *, BodyHash, BodyEq>
+      UniqueBodies;
+  std::unordered_set<const std::vector<unsigned> *, DimensionsHash,
+                     DimensionsEq>
+      UniqueDimensions;
+
+  const IRType::StructBody *EmptyBody;
+  const std::vector<unsigned> *EmptyDimensions;
+
+  /// Scalar types indexed by kind and bit width, filled in on first use.
+  std::atomic<const IRType::Storage *> ScalarTypes[IRType::STRUCT + 1][256];
+};
+
+#endif
@@ -75,23 +75,39 @@ std::string Instruction::AsString(IKind IK) {
   }
 }
 
-void BinaryInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
-  std::cout << ValueString() << ", ";
-  if (LHS)
-    std::cout << LHS->ValueString() << ", ";
+void Instruction::MoveBefore(Instruction *I) {
+  auto &To = I->Parent->GetInstructions();
+  To.splice(BasicBlock::InstructionList::iterator(I),
+            Parent->GetInstructions(), this);
+  Parent = I->Parent;
+}
+
+void Instruction::MoveAfter(Instruction *I) {
+  auto &To = I->Parent->GetInstructions();
+  To.splice(std::next(BasicBlock::InstructionList::iterator(I)),
+            Parent->GetInstructions(), this);
+  Parent = I->Parent;
+}
+
+void Instruction::EraseFromParent() { Parent->GetInstructions().erase(this); }
+
+void BinaryInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
+  OS << ValueString() << ", ";
+  if (GetLHS())
+    OS << GetLHS()->ValueString() << ", ";
   else
-    std::cout << "NULL, ";
-  if (RHS)
-    std::cout << RHS->ValueString() << std::endl;
+    OS << "NULL, ";
+  if (GetRHS())
+    OS << GetRHS()->ValueString() << std::endl;
   else
-    std::cout << "NULL" << std::endl;
+    OS << "NULL" << std::endl;
 }
 
-void UnaryInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
-  std::cout << ValueString() << ", ";
-  std::cout << Op->ValueString() << std::endl;
+void UnaryInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
+  OS << ValueString() << ", ";
+  OS << Op->ValueString() << std::endl;
 }
 
 const char *CompareInstruction::GetRelString() const {
@@ -138,34 +154,34 @@ void CompareInstruction::InvertRelation() {
   }
 }
 
-void CompareInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "." << GetRelString() << "\t";
-  std::cout << ValueString() << ", ";
-  std::cout << LHS->ValueString() << ", ";
-  std::cout << RHS->ValueString() << std::endl;
+void CompareInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "." << GetRelString() << "\t";
+  OS << ValueString() << ", ";
+  OS << GetLHS()->ValueString() << ", ";
+  OS << GetRHS()->ValueString() << std::endl;
 }
 
-void CallInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
+void CallInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
   if (!ValueType.IsVoid())
-    std::cout << ValueString() << ", ";
-  std::cout << Name << "(";
+    OS << ValueString() << ", ";
+  OS << Name << "(";
 
   int i = 0;
-  for (auto Arg : Arguments) {
+  for (auto &Arg : Arguments) {
     if (i > 0)
-      std::cout << ", ";
-    std::cout << Arg->ValueString();
+      OS << ", ";
+    OS << Arg->ValueString();
     i++;
   }
-  std::cout << ")" << std::endl;
+  OS << ")" << std::endl;
 }
 
 std::string &JumpInstruction::GetTargetLabelName() { return Target->GetName(); }
 
-void JumpInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
-  std::cout << "<" << Target->GetName() << ">" << std::endl;
+void JumpInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
+  OS << "<" << Target->GetName() << ">" << std::endl;
 }
 
 std::string &BranchInstruction::GetTrueLabelName() {
@@ -175,60 +191,60 @@ std::string &BranchInstruction::GetFalseLabelName() {
   return FalseTarget->GetName();
 }
 
-void BranchInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
+void BranchInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
   if (Condition)
-    std::cout << Condition->ValueString() << ", ";
+    OS << Condition->ValueString() << ", ";
   else
-    std::cout << "NULL, ";
-  std::cout << "<" << TrueTarget->GetName() << ">";
+    OS << "NULL, ";
+  OS << "<" << TrueTarget->GetName() << ">";
   if (FalseTarget)
-    std::cout << ", <" << FalseTarget->GetName() << ">";
-  std::cout << std::endl;
+    OS << ", <" << FalseTarget->GetName() << ">";
+  OS << std::endl;
 }
 
-void ReturnInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
+void ReturnInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
   if (RetVal)
-    std::cout << RetVal->ValueString();
-  std::cout << std::endl;
+    OS << RetVal->ValueString();
+  OS << std::endl;
 }
 
-void StackAllocationInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
-  std::cout << ValueString() << std::endl;
+void StackAllocationInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
+  OS << ValueString() << std::endl;
 }
 
-void GetElementPointerInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
-  std::cout << ValueString() << ", ";
-  std::cout << Source->ValueString();
+void GetElementPointerInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
+  OS << ValueString() << ", ";
+  OS << GetSource()->ValueString();
   std::string str = ", ";
-  str += Index->ValueString();
-  std::cout << str << std::endl;
+  str += GetIndex()->ValueString();
+  OS << str << std::endl;
 }
 
-void StoreInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
-  if (Destination)
-    std::cout << "[" << Destination->ValueString() << "], ";
+void StoreInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
+  if (GetMemoryLocation())
+    OS << "[" << GetMemoryLocation()->ValueString() << "], ";
   else
-    std::cout << "[NULL], ";
-  std::cout << Source->ValueString() << std::endl;
+    OS << "[NULL], ";
+  OS << GetSavedValue()->ValueString() << std::endl;
 }
 
-void LoadInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
-  std::cout << ValueString() << ", ";
-  std::cout << "[" << Source->ValueString();
-  if (Offset)
-    std::cout << " + " << Offset->ValueString();
-  std::cout << "]" << std::endl;
+void LoadInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
+  OS << ValueString() << ", ";
+  OS << "[" << GetMemoryLocation()->ValueString();
+  if (GetOffset())
+    OS << " + " << GetOffset()->ValueString();
+  OS << "]" << std::endl;
 }
 
-void MemoryCopyInstruction::Print() const {
-  std::cout << "\t" << AsString(InstKind) << "\t";
-  std::cout << Dest->ValueString() << ", ";
-  std::cout << Src->ValueString() << ", ";
-  std::cout << N << std::endl;
+void MemoryCopyInstruction::Print(std::ostream &OS) const {
+  OS << "\t" << AsString(InstKind) << "\t";
+  OS << GetDestination()->ValueString() << ", ";
+  OS << GetSource()->ValueString() << ", ";
+  OS << N << std::endl;
 }
@@ -1,6 +1,9 @@
 #ifndef INSTRUCTIONS_HPP
 #define INSTRUCTIONS_HPP
 
+#include "../../support/Casting.hpp"
+#include "../../support/IntrusiveList.hpp"
+#include "../../support/IteratorRange.hpp"
 #include "Value.hpp"
 #include <cassert>
 #include <iostream>
@@ -10,7 +13,7 @@
 
 class BasicBlock;
 
-class Instruction : public Value {
+class Instruction : public Value, public IntrusiveListNode<Instruction> {
 public:
   enum IKind {
     // Integer Arithmetic and Logical
@@ -57,7 +60,7 @@ public:
     GET_ELEM_PTR,
   };
 
-  IKind GetInstructionKind() { return InstKind; }
+  IKind GetInstructionKind() const { return InstKind; }
 
   static std::string AsString(IKind IK);
 
@@ -66,6 +69,10 @@ public:
     BasicBlockTerminator = (InstKind == RET || InstKind == JUMP);
   }
 
+  /// Every instruction result is a virtual register, and only instructions
+  /// define registers.
+  static bool classof(const Value *V) { return V->GetKind() == REGISTER; }
+
   bool IsStackAllocation() const { return InstKind == STACK_ALLOC; }
 
   bool IsTerminator() const { return BasicBlockTerminator; }
@@ -76,62 +83,114 @@ public:
   bool IsJump() const { return InstKind == JUMP; }
   bool IsGEP() const { return InstKind == GET_ELEM_PTR; }
 
+  BasicBlock *GetParent() const { return Parent; }
+  void SetParent(BasicBlock *BB) { Parent = BB; }
+
+  /// Unlink this instruction from its basic block and insert it before @I,
+  /// which might be in another basic block.
+  void MoveBefore(Instruction *I);
+
+  /// Unlink this instruction from its basic block and insert it after @I.
+  void MoveAfter(Instruction *I);
+
+  /// Unlink this instruction from its basic block and destroy it.
+  void EraseFromParent();
+
   /// Is this instruction define a value? For example JUMP is not.
   virtual bool IsDef() const { return true; }
 
-  virtual Value *Get1stUse() { return nullptr; }
-  virtual Value *Get2ndUse() { return nullptr; }
+  using OperandRange = IteratorRange<Use *>;
+  using ConstOperandRange = IteratorRange<const Use *>;
 
-  virtual void Set1stUse(Value *v) {}
-  virtual void Set2ndUse(Value *v) {}
+  /// The values read by the instruction, including call arguments and GEP
+  /// indices. Branch targets are not operands.
+  OperandRange operands() { return {OperandList, OperandList + NumOperands}; }
+  ConstOperandRange operands() const {
+    return {OperandList, OperandList + NumOperands};
+  }
+
+  unsigned GetNumOperands() const { return NumOperands; }
 
-  virtual void Print() const { assert(!"Cannot print base class"); }
+  Value *GetOperand(unsigned Idx) const {
+    assert(Idx < NumOperands && "Operand index out of range");
+    return OperandList[Idx];
+  }
+
+  void SetOperand(unsigned Idx, Value *V) {
+    assert(Idx < NumOperands && "Operand index out of range");
+    OperandList[Idx] = V;
+  }
+
+  virtual void Print(std::ostream &OS) const {
+    assert(!"Cannot print base class");
+  }
 
 protected:
+  /// Set the storage of the operands, which is owned by the subclass.
+  void SetOperandList(Use *Ops, unsigned Num) {
+    OperandList = Ops;
+    NumOperands = Num;
+  }
+
   IKind InstKind;
   BasicBlock *Parent = nullptr;
   bool BasicBlockTerminator = false;
+
+private:
+  Use *OperandList = nullptr;
+  unsigned NumOperands = 0;
 };
 
 class BinaryInstruction : public Instruction {
 public:
   BinaryInstruction(IKind BO, Value *L, Value *R, BasicBlock *P)
-      : Instruction(BO, P, L->GetType()), LHS(L), RHS(R) {}
-
-  Value *GetLHS() { return LHS; }
-  Value *GetRHS() { return RHS; }
+      : Instruction(BO, P, L->GetType()), Ops{{L, this}, {R, this}} {
+    SetOperandList(Ops, 2);
+  }
 
-  Value *Get1stUse() override { return LHS; }
-  Value *Get2ndUse() override { return RHS; }
+  static bool classof(const Instruction *I) {
+    auto K = I->GetInstructionKind();
+    return K <= MODU || (K >= ADDF && K <= DIVF);
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
 
-  void Set1stUse(Value *v) override { LHS = v; }
-  void Set2ndUse(Value *v) override { RHS = v; }
+  Value *GetLHS() const { return Ops[0]; }
+  Value *GetRHS() const { return Ops[1]; }
 
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
-  Value *LHS;
-  Value *RHS;
+  Use Ops[2];
 };
 
 class UnaryInstruction : public Instruction {
 public:
   UnaryInstruction(IKind UO, Value *Operand, BasicBlock *P)
-      : Instruction(UO, P, Operand->GetType()), Op(Operand) {}
+      : Instruction(UO, P, Operand->GetType()), Op(Operand, this) {
+    SetOperandList(&Op, 1);
+  }
 
   UnaryInstruction(IKind UO, IRType ResultType, Value *Operand, BasicBlock *P)
-      : Instruction(UO, P, std::move(ResultType)), Op(Operand) {}
-
-  Value *GetOperand() { return Op; }
+      : Instruction(UO, P, std::move(ResultType)), Op(Operand, this) {
+    SetOperandList(&Op, 1);
+  }
 
-  Value *Get1stUse() override { return Op; }
+  static bool classof(const Instruction *I) {
+    auto K = I->GetInstructionKind();
+    return K >= SEXT && K <= BITCAST;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
 
-  void Set1stUse(Value *v) override { Op = v; }
+  Value *GetOperand() const { return Op; }
 
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
-  Value *Op;
+  Use Op;
 };
 
 class CompareInstruction : public Instruction {
@@ -142,51 +201,68 @@ public:
       : Instruction(L->IsFPType() && R->IsFPType() ? Instruction::CMPF
                                                    : Instruction::CMP,
                     P, IRType(IRType::SINT, 1)),
-        LHS(L), RHS(R), Relation(REL) {}
+        Relation(REL), Ops{{L, this}, {R, this}} {
+    SetOperandList(Ops, 2);
+  }
+
+  static bool classof(const Instruction *I) {
+    auto K = I->GetInstructionKind();
+    return K == CMP || K == CMPF;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
 
   const char *GetRelString() const;
 
-  Value *GetLHS() { return LHS; }
-  Value *GetRHS() { return RHS; }
+  Value *GetLHS() const { return Ops[0]; }
+  Value *GetRHS() const { return Ops[1]; }
   unsigned GetRelation() { return (unsigned)Relation; }
 
   void InvertRelation();
 
-  Value *Get1stUse() override { return LHS; }
-  Value *Get2ndUse() override { return RHS; }
-
-  void Set1stUse(Value *v) override { LHS = v; }
-  void Set2ndUse(Value *v) override { RHS = v; }
-
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
   CompRel Relation = INVALID;
-  Value *LHS;
-  Value *RHS;
+  Use Ops[2];
 };
 
 class CallInstruction : public Instruction {
 public:
-  CallInstruction(std::string N, std::vector<Value *> &A, IRType T,
-                  BasicBlock *P, int StructIdx)
-      : Instruction(Instruction::CALL, P, std::move(T)), Name(std::move(N)),
-        Arguments(A), ImplicitStructArgIndex(StructIdx) {}
+  CallInstruction(Symbol N, std::vector<Value *> &A, IRType T, BasicBlock *P,
+                  int StructIdx)
+      : Instruction(Instruction::CALL, P, std::move(T)), Name(N),
+        ImplicitStructArgIndex(StructIdx) {
+    Arguments.reserve(A.size());
+    for (auto Arg : A)
+      Arguments.emplace_back(Arg, this);
+    SetOperandList(Arguments.data(), Arguments.size());
+  }
 
-  CallInstruction(std::string N, IRType T, BasicBlock *P)
-      : Instruction(Instruction::CALL, P, std::move(T)), Name(std::move(N)) {}
+  CallInstruction(Symbol N, IRType T, BasicBlock *P)
+      : Instruction(Instruction::CALL, P, std::move(T)), Name(N) {}
 
-  std::string &GetName() { return Name; }
-  std::vector<Value *> &GetArgs() { return Arguments; }
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == CALL;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
+
+  Symbol GetName() const { return Name; }
+  /// The arguments are the operands of the call.
+  OperandRange GetArgs() { return operands(); }
   int GetImplicitStructArgIndex() const { return ImplicitStructArgIndex; }
 
   bool IsDef() const override { return !GetType().IsVoid(); }
 
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
-  std::string Name;
-  std::vector<Value *> Arguments;
+  Symbol Name;
+  /// Not modified after the construction, since the operand list refers to it
+  std::vector<Use> Arguments;
   int ImplicitStructArgIndex = -1;
 };
 
@@ -195,6 +271,13 @@ public:
   JumpInstruction(BasicBlock *D, BasicBlock *P)
       : Instruction(Instruction::JUMP, P, IRType(IRType::NONE)), Target(D) {}
 
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == JUMP;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
+
   BasicBlock *GetTargetBB() { return Target; }
   void SetTargetBB(BasicBlock *t) { Target = t; }
 
@@ -202,7 +285,7 @@ public:
 
   bool IsDef() const override { return false; }
 
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
   BasicBlock *Target;
@@ -212,24 +295,29 @@ class BranchInstruction : public Instruction {
 public:
   BranchInstruction(Value *C, BasicBlock *True, BasicBlock *False,
                     BasicBlock *P)
-      : Instruction(Instruction::BRANCH, P, IRType(IRType::NONE)), Condition(C),
-        TrueTarget(True), FalseTarget(False) {}
+      : Instruction(Instruction::BRANCH, P, IRType(IRType::NONE)),
+        Condition(C, this), TrueTarget(True), FalseTarget(False) {
+    SetOperandList(&Condition, 1);
+  }
+
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == BRANCH;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
 
-  Value *GetCondition() { return Condition; }
+  Value *GetCondition() const { return Condition; }
   std::string &GetTrueLabelName();
   std::string &GetFalseLabelName();
 
   bool HasFalseLabel() { return FalseTarget != nullptr; }
   bool IsDef() const override { return false; }
 
-  Value *Get1stUse() override { return Condition; }
-
-  void Set1stUse(Value *v) override { Condition = v; }
-
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
-  Value *Condition;
+  Use Condition;
   BasicBlock *TrueTarget;
   BasicBlock *FalseTarget;
 };
@@ -239,21 +327,25 @@ public:
   ReturnInstruction(Value *RV, BasicBlock *P)
       : Instruction(Instruction::RET, P,
                     RV ? RV->GetType() : IRType(IRType::NONE)),
-        RetVal(RV) {
+        RetVal(RV, this) {
     BasicBlockTerminator = true;
+    SetOperandList(&RetVal, RV ? 1 : 0);
+  }
+
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == RET;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
   }
 
   Value *GetRetVal() const { return RetVal; }
   bool IsDef() const override { return false; }
 
-  Value *Get1stUse() override { return RetVal; }
-
-  void Set1stUse(Value *v) override { RetVal = v; }
-
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
-  Value *RetVal;
+  Use RetVal;
 };
 
 class StackAllocationInstruction : public Instruction {
@@ -265,7 +357,14 @@ public:
                                        1);
   }
 
-  void Print() const override;
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == STACK_ALLOC;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
+
+  void Print(std::ostream &OS) const override;
 
 private:
   std::string VariableName;
@@ -276,53 +375,60 @@ public:
   GetElementPointerInstruction(IRType T, Value *CompositeObject,
                                Value *AccessIndex, BasicBlock *P)
       : Instruction(Instruction::GET_ELEM_PTR, P, std::move(T)),
-        Source(CompositeObject), Index(AccessIndex) {}
-
-  Value *GetSource() const { return Source; }
-  Value *GetIndex() { return Index; }
+        Ops{{CompositeObject, this}, {AccessIndex, this}} {
+    SetOperandList(Ops, 2);
+  }
 
-  Value *Get1stUse() override { return Source; }
-  Value *Get2ndUse() override { return Index; }
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == GET_ELEM_PTR;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
 
-  void Set1stUse(Value *v) override { Source = v; }
-  void Set2ndUse(Value *v) override { Index = v; }
+  Value *GetSource() const { return Ops[0]; }
+  Value *GetIndex() const { return Ops[1]; }
 
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
-  Value *Source;
-  Value *Index;
+  Use Ops[2];
 };
 
 class StoreInstruction : public Instruction {
 public:
   StoreInstruction(Value *S, Value *D, BasicBlock *P)
-      : Instruction(Instruction::STORE, P, IRType(IRType::NONE)), Source(S),
-        Destination(D) {
-    assert(Source && Destination);
+      : Instruction(Instruction::STORE, P, IRType(IRType::NONE)),
+        Ops{{S, this}, {D, this}} {
+    assert(S && D);
+    SetOperandList(Ops, 2);
   }
 
-  void Print() const override;
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == STORE;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
 
-  Value *GetMemoryLocation() { return Destination; }
-  Value *GetSavedValue() { return Source; }
+  void Print(std::ostream &OS) const override;
 
-  bool IsDef() const override { return false; }
+  Value *GetMemoryLocation() const { return Ops[1]; }
+  Value *GetSavedValue() const { return Ops[0]; }
 
-  Value *Get1stUse() override { return Source; }
-  Value *Get2ndUse() override { return Destination; }
-  void Set1stUse(Value *v) override { Source = v; }
-  void Set2ndUse(Value *v) override { Destination = v; }
+  bool IsDef() const override { return false; }
 
 private:
-  Value *Source;
-  Value *Destination;
+  /// The saved value and the memory location
+  Use Ops[2];
 };
 
 class LoadInstruction : public Instruction {
 public:
   LoadInstruction(IRType T, Value *S, Value *O, BasicBlock *P)
-      : Instruction(Instruction::LOAD, P, std::move(T)), Source(S), Offset(O) {
+      : Instruction(Instruction::LOAD, P, std::move(T)),
+        Ops{{S, this}, {O, this}} {
+    SetOperandList(Ops, O ? 2 : 1);
     auto PtrLVL = this->GetTypeRef().GetPointerLevel();
     // Globals are handled differently, it is implicitly assumed that they
     // have 1 pointer level more, even though their IRType does not reflect this
@@ -332,52 +438,51 @@ public:
   }
 
   LoadInstruction(IRType T, Value *S, BasicBlock *P)
-      : Instruction(Instruction::LOAD, P, std::move(T)), Source(S),
-        Offset(nullptr) {
-    auto PtrLVL = this->GetTypeRef().GetPointerLevel();
-    if (PtrLVL != 0 && !S->IsGlobalVar())
-      PtrLVL--;
-    this->GetTypeRef().SetPointerLevel(PtrLVL);
-  }
+      : LoadInstruction(std::move(T), S, nullptr, P) {}
 
-  void Print() const override;
-
-  Value *GetMemoryLocation() { return Source; }
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == LOAD;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
 
-  Value *Get1stUse() override { return Source; }
-  Value *Get2ndUse() override { return Offset; }
+  void Print(std::ostream &OS) const override;
 
-  void Set1stUse(Value *v) override { Source = v; }
-  void Set2ndUse(Value *v) override { Offset = v; }
+  Value *GetMemoryLocation() const { return Ops[0]; }
+  /// Return the offset added to the memory location or nullptr if none.
+  Value *GetOffset() const { return Ops[1]; }
 
 private:
-  Value *Source;
-  Value *Offset;
+  /// The memory location and the optional offset
+  Use Ops[2];
 };
 
 class MemoryCopyInstruction : public Instruction {
 public:
   MemoryCopyInstruction(Value *Destination, Value *Source, size_t Bytes,
                         BasicBlock *P)
-      : Instruction(Instruction::MEM_COPY, P, IRType()), Dest(Destination),
-        Src(Source), N(Bytes) {}
+      : Instruction(Instruction::MEM_COPY, P, IRType()),
+        Ops{{Destination, this}, {Source, this}}, N(Bytes) {
+    SetOperandList(Ops, 2);
+  }
 
-  Value *GetDestination() { return Dest; }
-  Value *GetSource() { return Src; }
+  static bool classof(const Instruction *I) {
+    return I->GetInstructionKind() == MEM_COPY;
+  }
+  static bool classof(const Value *V) {
+    return isa<Instruction>(V) && classof(cast<Instruction>(V));
+  }
+
+  Value *GetDestination() const { return Ops[0]; }
+  Value *GetSource() const { return Ops[1]; }
   size_t GetSize() const { return N; }
   bool IsDef() const override { return false; }
 
-  Value *Get1stUse() override { return Dest; }
-  Value *Get2ndUse() override { return Src; }
-
-  void Set1stUse(Value *v) override { Dest = v; }
-  void Set2ndUse(Value *v) override { Src = v; }
-
-  void Print() const override;
+  void Print(std::ostream &OS) const override;
 
 private:
-  Value *Dest;
-  Value *Src;
+  Use Ops[2];
   size_t N;
 };
 
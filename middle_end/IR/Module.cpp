@@ -24,6 +24,11 @@ void Module::AddFunction(Function F) { Functions.push_back(std::move(F)); }
 
 void Module::AddGlobalVar(std::unique_ptr<Value> GV) {
   assert(GV && "Cannot be a nullptr");
+
+  // like the previous look up by a linear search, the first one wins
+  if (auto GlobalVar = dyn_cast<GlobalVariable>(GV.get()))
+    GlobalVarsByName.emplace(GlobalVar->GetName(), GlobalVar);
+
   GlobalVars.push_back(std::move(GV));
 }
 
@@ -35,12 +40,9 @@ bool Module::IsGlobalValue(Value *V) const {
   return false;
 }
 
-Value *Module::GetGlobalVar(const std::string &Name) const {
-  for (auto &GV : GlobalVars)
-    if (((GlobalVariable *)GV.get())->GetName() == Name)
-      return GV.get();
-
-  return nullptr;
+Value *Module::GetGlobalVar(Symbol Name) const {
+  auto It = GlobalVarsByName.find(Name);
+  return It != GlobalVarsByName.end() ? It->second : nullptr;
 }
 
 BasicBlock *Module::CreateBasicBlock() {
@@ -49,9 +51,9 @@ BasicBlock *Module::CreateBasicBlock() {
   return CurrentBB();
 }
 
-void Module::Print() const {
+void Module::Print(std::ostream &OS) const {
   for (auto &GlobalVar : GlobalVars)
-    dynamic_cast<GlobalVariable *>(GlobalVar.get())->Print();
+    cast<GlobalVariable>(GlobalVar.get())->Print(OS);
   for (auto &Function : Functions)
-    Function.Print();
+    Function.Print(OS);
 }
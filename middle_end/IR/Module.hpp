@@ -1,9 +1,12 @@
 #ifndef MODULE_HPP
 #define MODULE_HPP
 
+#include "../../support/Symbol.hpp"
 #include "IRType.hpp"
 #include <cassert>
+#include <iostream>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 class BasicBlock;
@@ -29,15 +32,17 @@ public:
 
   bool IsGlobalValue(Value *V) const;
 
-  Value *GetGlobalVar(const std::string &Name) const;
+  Value *GetGlobalVar(Symbol Name) const;
 
   BasicBlock *CreateBasicBlock();
 
-  void Print() const;
+  void Print(std::ostream &OS = std::cout) const;
 
 private:
   std::vector<IRType> StructTypes;
   std::vector<std::unique_ptr<Value>> GlobalVars;
+  /// The named global variables for quick look up
+  std::unordered_map<Symbol, Value *> GlobalVarsByName;
   std::vector<Function> Functions;
 };
 
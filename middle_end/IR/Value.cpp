@@ -1,5 +1,26 @@
 #include "Value.hpp"
 
+unsigned Value::GetNumUses() const {
+  unsigned Num = 0;
+  for (auto U = UseList; U; U = U->GetNext())
+    Num++;
+  return Num;
+}
+
+void Value::ReplaceAllUsesWith(Value *V) {
+  assert(V != this && "Cannot replace a value with itself");
+  while (UseList)
+    UseList->Set(V);
+}
+
+void Value::DropAllUses() {
+  while (UseList) {
+    auto U = UseList;
+    U->RemoveFromList();
+    U->Val = nullptr;
+  }
+}
+
 uint64_t Constant::GetIntValue() const {
   assert(ValueType.IsINT());
   int64_t result;
@@ -40,24 +61,24 @@ std::string Constant::ValueString() const {
   return str;
 }
 
-void GlobalVariable::Print() const {
-  std::cout << "global var (" << GetType().AsString() << "):" << std::endl
-            << "\t" << Name;
+void GlobalVariable::Print(std::ostream &OS) const {
+  OS << "global var (" << GetType().AsString() << "):" << std::endl
+     << "\t" << Name;
 
   if (!InitList.empty()) {
-    std::cout << " = {";
+    OS << " = {";
     for (size_t i = 0; i < InitList.size(); i++) {
-      std::cout << " " << std::to_string(InitList[i]);
+      OS << " " << std::to_string(InitList[i]);
       if (i + 1 < InitList.size())
-        std::cout << ",";
+        OS << ",";
     }
-    std::cout << " }";
+    OS << " }";
   } else if (!InitString.empty()) {
-    std::cout << " = \"" << InitString << "\"";
-  } else if (auto GV = dynamic_cast<GlobalVariable *>(InitValue);
+    OS << " = \"" << InitString << "\"";
+  } else if (auto GV = dyn_cast_or_null<GlobalVariable>(InitValue);
              GV != nullptr) {
-    std::cout << " = " << GV->GetName();
+    OS << " = " << GV->GetName();
   }
 
-  std::cout << std::endl << std::endl;
+  OS << std::endl << std::endl;
 }
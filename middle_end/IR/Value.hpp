@@ -1,12 +1,63 @@
 #ifndef VALUE_HPP
 #define VALUE_HPP
 
+#include "../../support/Casting.hpp"
+#include "../../support/Symbol.hpp"
 #include "IRType.hpp"
 #include <iostream>
 #include <string>
 #include <utility>
 #include <variant>
 
+class Instruction;
+class Value;
+
+/// A use of the value @Val by the @User instruction, in other words an operand
+/// of @User. Uses are linked into the use list of the used value, therefore
+/// the users of a value can be found without scanning the whole function.
+class Use {
+public:
+  Use(Value *V, Instruction *U) : User(U) { Set(V); }
+
+  /// Only used when a vector of uses is reallocated, the user stays the same.
+  Use(Use &&Other) noexcept : User(Other.User) {
+    Set(Other.Val);
+    Other.Set(nullptr);
+  }
+
+  Use(const Use &) = delete;
+  Use &operator=(const Use &) = delete;
+
+  ~Use() { RemoveFromList(); }
+
+  Value *Get() const { return Val; }
+  /// Make this use refer to @V, moving it from the use list of the old value
+  /// to the use list of @V.
+  void Set(Value *V);
+
+  Instruction *GetUser() const { return User; }
+  Use *GetNext() const { return Next; }
+
+  Use &operator=(Value *V) {
+    Set(V);
+    return *this;
+  }
+  operator Value *() const { return Val; }
+  Value *operator->() const { return Val; }
+
+private:
+  void AddToList(Use **List);
+  void RemoveFromList();
+
+  Value *Val = nullptr;
+  Instruction *User;
+  Use *Next = nullptr;
+  /// Points to the Next field of the previous use or to the head of the list
+  Use **Prev = nullptr;
+
+  friend class Value;
+};
+
 class Value {
 public:
   enum VKind { INVALID = 1, NONE, REGISTER, LABEL, CONST, PARAM, GLOBALVAR };
@@ -16,11 +67,18 @@ public:
   explicit Value(IRType T) : ValueType(std::move(T)), Kind(REGISTER) {}
   Value(VKind VK, IRType T) : Kind(VK), ValueType(std::move(T)) {}
 
-  virtual ~Value() = default;
+  /// The uses are not copied, the copy is not used by anything.
+  Value(const Value &V)
+      : UniqueID(V.UniqueID), Kind(V.Kind), ValueType(V.ValueType) {}
+
+  /// The remaining users will refer to nullptr.
+  virtual ~Value() { DropAllUses(); }
 
   IRType &GetTypeRef() { return ValueType; }
   IRType GetType() const { return ValueType; }
 
+  VKind GetKind() const { return Kind; }
+
   unsigned GetID() const { return UniqueID; }
   void SetID(const unsigned i) { UniqueID = i; }
 
@@ -34,6 +92,20 @@ public:
   bool IsIntType() const { return ValueType.IsINT(); }
   bool IsFPType() const { return ValueType.IsFP(); }
 
+  /// Uses are only tracked for function local values. Constants and global
+  /// variables are shared between the functions, so their use lists are not
+  /// maintained and they always appear to be unused.
+  bool IsUseTracked() const { return Kind != CONST && Kind != GLOBALVAR; }
+
+  bool HasUses() const { return UseList != nullptr; }
+  unsigned GetNumUses() const;
+
+  /// Head of the use list, the rest is reachable through Use::GetNext.
+  Use *GetFirstUse() const { return UseList; }
+
+  /// Make every user of this value use @V instead.
+  void ReplaceAllUsesWith(Value *V);
+
   virtual std::string ValueString() const {
     return "$" + std::to_string(UniqueID) + "<" + ValueType.AsString() + ">";
   }
@@ -42,8 +114,40 @@ protected:
   unsigned UniqueID = ~0;
   VKind Kind = REGISTER;
   IRType ValueType;
+
+private:
+  void DropAllUses();
+
+  Use *UseList = nullptr;
+
+  friend class Use;
 };
 
+inline void Use::AddToList(Use **List) {
+  Next = *List;
+  if (Next)
+    Next->Prev = &Next;
+  Prev = List;
+  *List = this;
+}
+
+inline void Use::RemoveFromList() {
+  if (!Prev)
+    return;
+  *Prev = Next;
+  if (Next)
+    Next->Prev = Prev;
+  Next = nullptr;
+  Prev = nullptr;
+}
+
+inline void Use::Set(Value *V) {
+  RemoveFromList();
+  Val = V;
+  if (V && V->IsUseTracked())
+    AddToList(&V->UseList);
+}
+
 class Constant : public Value {
 public:
   Constant() = delete;
@@ -52,6 +156,8 @@ public:
   explicit Constant(double V, uint8_t BW = 32)
       : Value(Value::CONST, IRType(IRType::FP, BW)), Val(V) {}
 
+  static bool classof(const Value *V) { return V->GetKind() == CONST; }
+
   bool IsFPConst() const { return ValueType.IsFP(); }
 
   uint64_t GetIntValue() const;
@@ -69,6 +175,8 @@ public:
   FunctionParameter(std::string &Name, IRType Type, bool Struct = false)
       : Value(PARAM, std::move(Type)), Name(Name), ImplicitStructPtr(Struct) {}
 
+  static bool classof(const Value *V) { return V->GetKind() == PARAM; }
+
   std::string &GetName() { return Name; }
   bool IsImplicitStructPtr() const { return ImplicitStructPtr; }
   std::string ValueString() const override { return "$" + Name; }
@@ -81,21 +189,23 @@ private:
 class GlobalVariable : public Value {
 public:
   GlobalVariable() = delete;
-  GlobalVariable(std::string &Name, IRType Type)
+  GlobalVariable(Symbol Name, IRType Type)
       : Value(GLOBALVAR, std::move(Type)), Name(Name) {}
 
-  GlobalVariable(std::string &Name, IRType Type, std::string InitStr)
+  GlobalVariable(Symbol Name, IRType Type, std::string InitStr)
       : Value(GLOBALVAR, std::move(Type)), Name(Name),
         InitString(std::move(InitStr)) {}
 
-  GlobalVariable(std::string &Name, IRType Type, Value *InitValue)
+  GlobalVariable(Symbol Name, IRType Type, Value *InitValue)
       : Value(GLOBALVAR, std::move(Type)), Name(Name), InitValue(InitValue) {}
 
-  GlobalVariable(std::string &Name, IRType Type, std::vector<uint64_t> InitList)
+  GlobalVariable(Symbol Name, IRType Type, std::vector<uint64_t> InitList)
       : Value(GLOBALVAR, std::move(Type)), Name(Name),
         InitList(std::move(InitList)) {}
 
-  std::string &GetName() { return Name; }
+  static bool classof(const Value *V) { return V->GetKind() == GLOBALVAR; }
+
+  Symbol GetName() const { return Name; }
   std::vector<uint64_t> &GetInitList() { return InitList; }
   std::string &GetInitString() { return InitString; }
   Value *GetInitValue() { return InitValue; }
@@ -104,10 +214,10 @@ public:
     return "@" + Name + "<" + ValueType.AsString() + ">";
   }
 
-  void Print() const;
+  void Print(std::ostream &OS = std::cout) const;
 
 private:
-  std::string Name;
+  Symbol Name;
   std::vector<uint64_t> InitList;
   std::string InitString;
   Value *InitValue = nullptr;
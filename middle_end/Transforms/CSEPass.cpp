@@ -1,8 +1,22 @@
 #include "CSEPass.hpp"
 #include "../IR/BasicBlock.hpp"
 #include "../IR/Function.hpp"
-#include "Util.hpp"
-#include <map>
+#include "../../support/Statistic.hpp"
+#include <algorithm>
+#include <vector>
+
+STATISTIC(NumReusedExpressions, "CSEPass",
+          "Number of expressions replaced by an earlier one");
+
+static bool HasSameOperands(const Instruction *I1, const Instruction *I2) {
+  auto Ops1 = I1->operands();
+  auto Ops2 = I2->operands();
+  return Ops1.size() == Ops2.size() &&
+         std::equal(Ops1.begin(), Ops1.end(), Ops2.begin(),
+                    [](const Use &U1, const Use &U2) {
+                      return U1.Get() == U2.Get();
+                    });
+}
 
 struct AliveDefinitions {
   std::vector<Instruction *> Instructions;
@@ -18,8 +32,7 @@ struct AliveDefinitions {
       // If there is already an instruction with the same type, which used the
       // same operands
       if (I->GetInstructionKind() == Instr->GetInstructionKind() &&
-          I->Get1stUse() == Instr->Get1stUse() &&
-          I->Get2ndUse() == Instr->Get2ndUse()) {
+          HasSameOperands(I, Instr)) {
         // then the value computed by I is already computed, return it's
         // defining instruction
         return Instr;
@@ -32,16 +45,17 @@ struct AliveDefinitions {
 
 static void ProcessBB(std::unique_ptr<BasicBlock> &BB) {
   auto &InstList = BB->GetInstructions();
-  std::map<Value *, Value *> Renamables;
   AliveDefinitions AliveDefs;
 
   for (auto &Instr : InstList) {
-    auto InstrPtr = Instr.get();
+    auto InstrPtr = &Instr;
 
     // Nothing to do with stack allocations or jumps. Also it is assumed, that
     // copy propagation was already done before this pass, therefore loads can
-    // also be ignored.
-    if (InstrPtr->IsStackAllocation() || InstrPtr->IsJump())
+    // also be ignored. They must be, since two loads with the same operands
+    // can read different values if there is a store between them.
+    if (InstrPtr->IsStackAllocation() || InstrPtr->IsJump() ||
+        InstrPtr->IsLoad())
       continue;
 
     // call -s might clobber registers at the target level, so anything defined
@@ -54,17 +68,17 @@ static void ProcessBB(std::unique_ptr<BasicBlock> &BB) {
     }
 
     // If the current instruction computation is already done by previous
-    // ones then register it as renamable
+    // ones then use that value instead
     if (auto ACE = AliveDefs.GetAlreadyComputedExpression(InstrPtr)) {
-      Renamables[InstrPtr] = ACE;
+      // An instruction without uses is dead already, nothing is reused then
+      if (InstrPtr->HasUses())
+        ++NumReusedExpressions;
+      InstrPtr->ReplaceAllUsesWith(ACE);
     } else {
       // Otherwise it is a newly defined expression/value, so register it
       AliveDefs.InsertDef(InstrPtr);
     }
   }
-
-  if (!Renamables.empty())
-    RenameRegisters(Renamables, InstList);
 }
 
 bool CSEPass::RunOnFunction(Function &F) {
@@ -1,16 +1,24 @@
 #include "CopyPropagationPass.hpp"
 #include "../IR/BasicBlock.hpp"
 #include "../IR/Function.hpp"
-#include "Util.hpp"
+#include "../../support/Statistic.hpp"
 #include <map>
 
+STATISTIC(NumForwardedLoads, "CopyPropagationPass",
+          "Number of loads replaced by a known value");
+
+// Only checking global vars, stack allocations and GEPs
+static bool IsTrackedMemoryLocation(Value *V) {
+  return isa<GlobalVariable>(V) || isa<StackAllocationInstruction>(V) ||
+         isa<GetElementPointerInstruction>(V);
+}
+
 static void ProcessBB(std::unique_ptr<BasicBlock> &BB) {
   auto &InstList = BB->GetInstructions();
-  std::map<Value *, Value *> Renamables;
   std::map<Value *, Instruction *> KnownMemoryValues;
 
   for (auto &Instr : InstList) {
-    auto InstrPtr = Instr.get();
+    auto InstrPtr = &Instr;
 
     // call -s will clobber registers at the target level, so anything defined
     // before a call will be invalid. Although this is IR level and should not
@@ -24,52 +32,45 @@ static void ProcessBB(std::unique_ptr<BasicBlock> &BB) {
     // If it is a load from a stack allocation or global variable, then register
     // the source as a know value, since it's value is now held in the
     // destination of the load.
-    if (InstrPtr->IsLoad()) {
-      auto Source = InstrPtr->Get1stUse();
+    if (auto Load = dyn_cast<LoadInstruction>(InstrPtr)) {
+      auto Source = Load->GetMemoryLocation();
 
       // If the source is null or the load use an offset then skip it
-      if (!Source || InstrPtr->Get2ndUse())
+      if (!Source || Load->GetOffset())
         continue;
 
-      // Only checking global vars, stack allocations and GEPs
-      if (!Source->IsGlobalVar() &&
-          !dynamic_cast<StackAllocationInstruction *>(Source) &&
-          !dynamic_cast<GetElementPointerInstruction *>(Source))
+      if (!IsTrackedMemoryLocation(Source))
         continue;
 
       // If the value is not known yet, then it is now
       if (KnownMemoryValues.count(Source) == 0)
-        KnownMemoryValues[Source] = InstrPtr;
+        KnownMemoryValues[Source] = Load;
       // Otherwise there is already a load or store which defined this
       // stack allocation or global variable, therefore it is known and this
-      // load is superflous. Register it's definition as renamable.
-      else
-        Renamables[InstrPtr] = KnownMemoryValues[Source];
+      // load is superflous. Replace its uses with the known value.
+      else if (Load->HasUses()) {
+        Load->ReplaceAllUsesWith(KnownMemoryValues[Source]);
+        ++NumForwardedLoads;
+      }
     }
 
     // Similarly as load, if a value is stored to a stack allocation or global
     // var, then that value is known, therefore does not require load in
     // subsequent uses.
-    else if (InstrPtr->IsStore()) {
-      auto Source = InstrPtr->Get2ndUse();
+    else if (auto Store = dyn_cast<StoreInstruction>(InstrPtr)) {
+      auto Source = Store->GetMemoryLocation();
 
-      // If source is null or the stored value is not a register, then skip it
-      if (!Source || !InstrPtr->Get1stUse()->IsRegister())
+      // If the stored value is not a register, then skip it
+      auto SavedInstr = dyn_cast<Instruction>(Store->GetSavedValue());
+      if (!SavedInstr)
         continue;
 
-      // Only checking global vars, stack allocations and GEPs
-      if (!Source->IsGlobalVar() &&
-          !dynamic_cast<StackAllocationInstruction *>(Source) &&
-          !dynamic_cast<GetElementPointerInstruction *>(Source))
+      if (!IsTrackedMemoryLocation(Source))
         continue;
 
-      KnownMemoryValues[Source] =
-          dynamic_cast<Instruction *>(InstrPtr->Get1stUse());
+      KnownMemoryValues[Source] = SavedInstr;
     }
   }
-
-  if (!Renamables.empty())
-    RenameRegisters(Renamables, InstList);
 }
 
 bool CopyPropagationPass::RunOnFunction(Function &F) {
@@ -2,78 +2,60 @@
 #include "../IR/BasicBlock.hpp"
 #include "../IR/Function.hpp"
 #include "../IR/Instructions.hpp"
-#include <set>
+#include "../../support/Statistic.hpp"
+#include <iterator>
 
-void FindDeadInstructions(const std::unique_ptr<BasicBlock> &BB,
-                          std::vector<size_t> &DeadInstrIndexes) {
-  auto &Instructions = BB->GetInstructions();
-  std::set<Value *> UsedValues;
+STATISTIC(NumDeadInstructions, "DeadCodeEliminationPass",
+          "Number of instructions removed");
 
-  for (int i = Instructions.size() - 1; i >= 0; i--) {
-    if (auto Use1 = Instructions[i]->Get1stUse(); Use1 && Use1->IsRegister())
-      UsedValues.insert(Use1);
+static bool IsDead(const Instruction &Instr) {
+  // if an instruction does not define a value then it considered alive
+  // also stack allocation and calls too
+  if (!Instr.IsDef() || Instr.IsStackAllocation() || Instr.IsCall())
+    return false;
 
-    if (auto Use2 = Instructions[i]->Get2ndUse(); Use2 && Use2->IsRegister())
-      UsedValues.insert(Use2);
-
-    // If it is a call then added all of it's parameters to the use set
-    if (Instructions[i]->IsCall())
-      for (auto Param :
-           dynamic_cast<CallInstruction *>(Instructions[i].get())->GetArgs())
-        UsedValues.insert(Param);
-
-    // if an instruction does not define a value then it considered alive
-    // also stack allocation and calls too
-    if (!Instructions[i]->IsDef() || Instructions[i]->IsStackAllocation() ||
-        Instructions[i]->IsCall())
-      continue;
-
-    // If the instruction result has no uses after it (note: iteration is bottom
-    // up) then it's defined value is dead, mark it for termination.
-    if (UsedValues.count(Instructions[i].get()) == 0)
-      DeadInstrIndexes.push_back(i);
-  }
+  return !Instr.HasUses();
 }
 
-// Deleting the instructions at the indexes defined by @DeadInstrIndexes.
-// It is assumed that @DeadInstrIndexes is sorted in descending order, which
-// should be true given that FindDeadInstructions doing a bottom up scan of
-// the instructions.
-void DeleteInstructions(const std::unique_ptr<BasicBlock> &BB,
-                        std::vector<size_t> &DeadInstrIndexes) {
-  auto &Instructions = BB->GetInstructions();
-
-  for (auto Index : DeadInstrIndexes)
-    Instructions.erase(Instructions.begin() + Index);
+// Deleting the instructions whose defined value is not used anywhere. The
+// iteration is bottom up, so when an instruction is deleted, the definitions
+// of its operands are visited afterwards, and they are deleted as well if
+// that was their last use.
+static void DeleteDeadInstructions(BasicBlock::InstructionList &Instructions) {
+  for (auto It = Instructions.end(); It != Instructions.begin();) {
+    --It;
+    if (IsDead(*It)) {
+      It = Instructions.erase(It);
+      ++NumDeadInstructions;
+    }
+  }
 }
 
 bool DeadCodeEliminationPass::RunOnFunction(Function &F) {
-  std::vector<size_t> DeadInstrIndexes;
   for (auto &BB : F.GetBasicBlocks()) {
-    DeadInstrIndexes.clear();
     auto &Instructions = BB->GetInstructions();
 
-    FindDeadInstructions(BB, DeadInstrIndexes);
-    if (!DeadInstrIndexes.empty())
-      DeleteInstructions(BB, DeadInstrIndexes);
+    DeleteDeadInstructions(Instructions);
 
-    for (size_t i = 0; i < Instructions.size(); i++) {
+    for (auto It = Instructions.begin(); It != Instructions.end(); It++) {
       // If a basic block terminator instruction has been found AND it is a JUMP
       // AND after it there is no ret instruction, then delete the remaining
       // instruction from this BB, since they are dead code.
-      if (Instructions[i]->IsTerminator() && i + 1 < Instructions.size()) {
+      auto Next = std::next(It);
+      if (It->IsTerminator() && Next != Instructions.end()) {
         bool CanDeleteTheRest = true;
 
-        if (Instructions[i]->IsJump())
-          for (auto It = Instructions.begin() + i + 1; It != Instructions.end();
-               It++)
-            if (It->get()->IsReturn()) {
+        if (It->IsJump())
+          for (auto Rest = Next; Rest != Instructions.end(); Rest++)
+            if (Rest->IsReturn()) {
               CanDeleteTheRest = false;
               break;
             }
 
-        if (CanDeleteTheRest)
-          Instructions.erase(Instructions.begin() + i + 1, Instructions.end());
+        if (CanDeleteTheRest) {
+          NumDeadInstructions += std::distance(Next, Instructions.end());
+          Instructions.erase(Next, Instructions.end());
+        }
         break;
       }
     }
@@ -1,41 +1,55 @@
 #include "PassManager.hpp"
 #include "../IR/Function.hpp"
 #include "../IR/Module.hpp"
+#include "../../support/TimeProfiler.hpp"
 
 bool PassManager::RunAll() {
+  for (auto &F : IRModule->GetFunctions())
+    RunOnFunction(F);
+
+  return true;
+}
+
+bool PassManager::RunOnFunction(Function &F) {
+  TimeScope Scope("codegen", "IROptimizer", F.GetName().Str());
+
   auto CSE = std::make_unique<CSEPass>();
   auto CopyProp = std::make_unique<CopyPropagationPass>();
   auto ValNum = std::make_unique<ValueNumberingPass>();
   auto LoopHoist = std::make_unique<LoopHoistingPass>();
   auto DCE = std::make_unique<DeadCodeEliminationPass>();
 
-  for (auto &F : IRModule->GetFunctions()) {
-    if (Optimizations.count(Optimization::CopyPropagation) != 0 &&
-        Optimizations.count(Optimization::CSE) == 0) {
-      CopyProp->RunOnFunction(F);
-      DCE->RunOnFunction(F);
-    }
-
-    if (Optimizations.count(Optimization::CopyPropagation) != 0 &&
-        Optimizations.count(Optimization::CSE) != 0) {
-      size_t InstNumAtStart;
-
-      // It is an iterative process, since after CopyProp, CSE and DCE
-      // new opportunities for CopyProp and CSE could arise, so running it until
-      // there is no change in the instructions size between the
-      // start and end of iteration.
-      do {
-        InstNumAtStart = F.GetNumberOfInstructions();
-        CopyProp->RunOnFunction(F);
-        CSE->RunOnFunction(F);
-        DCE->RunOnFunction(F);
-      } while (InstNumAtStart != F.GetNumberOfInstructions());
-    }
-
-    ValNum->RunOnFunction(F);
-    LoopHoist->RunOnFunction(F);
-    DCE->RunOnFunction(F);
+  // Every run of a pass is measured on its own
+  auto Run = [&F](FunctionPass &Pass, const char *Name) {
+    TimeScope PassScope("pass", Name, F.GetName().Str());
+    Pass.RunOnFunction(F);
+  };
+
+  if (Optimizations.count(Optimization::CopyPropagation) != 0 &&
+      Optimizations.count(Optimization::CSE) == 0) {
+    Run(*CopyProp, "CopyPropagationPass");
+    Run(*DCE, "DeadCodeEliminationPass");
   }
 
+  if (Optimizations.count(Optimization::CopyPropagation) != 0 &&
+      Optimizations.count(Optimization::CSE) != 0) {
+    size_t InstNumAtStart;
+
+    // It is an iterative process, since after CopyProp, CSE and DCE
+    // new opportunities for CopyProp and CSE could arise, so running it until
+    // there is no change in the instructions size between the
+    // start and end of iteration.
+    do {
+      InstNumAtStart = F.GetNumberOfInstructions();
+      Run(*CopyProp, "CopyPropagationPass");
+      Run(*CSE, "CSEPass");
+      Run(*DCE, "DeadCodeEliminationPass");
+    } while (InstNumAtStart != F.GetNumberOfInstructions());
+  }
+
+  Run(*ValNum, "ValueNumberingPass");
+  Run(*LoopHoist, "LoopHoistingPass");
+  Run(*DCE, "DeadCodeEliminationPass");
+
   return true;
 }
@@ -8,6 +8,7 @@
 #include "ValueNumberingPass.hpp"
 #include <set>
 
+class Function;
 class Module;
 
 enum Optimization {
@@ -18,14 +19,18 @@ enum Optimization {
 
 class PassManager {
 public:
-  explicit PassManager(Module *m, std::set<Optimization> &opts)
+  explicit PassManager(Module *m, const std::set<Optimization> &opts)
       : IRModule(m), Optimizations(opts) {}
 
   bool RunAll();
 
+  /// Run the pipeline on @F only. The passes only modify @F, so different
+  /// functions can be optimized concurrently.
+  bool RunOnFunction(Function &F);
+
 private:
   Module *IRModule;
-  std::set<Optimization> &Optimizations;
+  const std::set<Optimization> &Optimizations;
 };
 
 #endif // PASS_MANAGER_HPP
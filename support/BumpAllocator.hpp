@@ -0,0 +1,96 @@
+#ifndef BUMP_ALLOCATOR_HPP
+#define BUMP_ALLOCATOR_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+/// Arena allocator, where an allocation is just a pointer bump in the current
+/// slab. Memory is never given back one by one, every slab is released at once
+/// when the allocator is destroyed or reset. Objects placed into the arena do
+/// not get their destructors called, that is the job of the owner.
+class BumpAllocator {
+public:
+  BumpAllocator() = default;
+  explicit BumpAllocator(size_t SlabSize) : SlabSize(SlabSize) {}
+
+  BumpAllocator(const BumpAllocator &) = delete;
+  BumpAllocator &operator=(const BumpAllocator &) = delete;
+
+  BumpAllocator(BumpAllocator &&Other) noexcept
+      : SlabSize(Other.SlabSize), CurPtr(Other.CurPtr), End(Other.End),
+        Slabs(std::move(Other.Slabs)), BytesAllocated(Other.BytesAllocated) {
+    Other.CurPtr = Other.End = nullptr;
+    Other.Slabs.clear();
+    Other.BytesAllocated = 0;
+  }
+
+  ~BumpAllocator() { Reset(); }
+
+  /// Return @Size bytes aligned to @Align, which must be a power of 2.
+  void *Allocate(size_t Size, size_t Align) {
+    assert(Align && !(Align & (Align - 1)) && "Alignment must be power of 2");
+    BytesAllocated += Size;
+
+    auto Aligned = AlignUp(CurPtr, Align);
+    if (CurPtr && Aligned + Size <= End) {
+      CurPtr = Aligned + Size;
+      return Aligned;
+    }
+
+    // Oversized requests get their own slab, so the current one can still be
+    // used for the upcoming small allocations.
+    const size_t PaddedSize = Size + Align - 1;
+    if (PaddedSize > SlabSize / 2)
+      return AlignUp(NewSlab(PaddedSize), Align);
+
+    CurPtr = NewSlab(SlabSize);
+    End = CurPtr + SlabSize;
+    Aligned = AlignUp(CurPtr, Align);
+    CurPtr = Aligned + Size;
+    return Aligned;
+  }
+
+  template <typename T> T *Allocate(size_t Num = 1) {
+    return static_cast<T *>(Allocate(Num * sizeof(T), alignof(T)));
+  }
+
+  /// Free every slab. Pointers handed out so far become dangling.
+  void Reset() {
+    for (auto Slab : Slabs)
+      std::free(Slab);
+    Slabs.clear();
+    CurPtr = End = nullptr;
+    BytesAllocated = 0;
+  }
+
+  /// Sum of the requested sizes, without the alignment and slab slack.
+  size_t GetBytesAllocated() const { return BytesAllocated; }
+  size_t GetNumSlabs() const { return Slabs.size(); }
+
+private:
+  static char *AlignUp(char *Ptr, size_t Align) {
+    return reinterpret_cast<char *>(
+        (reinterpret_cast<uintptr_t>(Ptr) + Align - 1) & ~(Align - 1));
+  }
+
+  char *NewSlab(size_t Size) {
+    auto Slab = static_cast<char *>(std::malloc(Size));
+    if (!Slab)
+      throw std::bad_alloc();
+    Slabs.push_back(Slab);
+    return Slab;
+  }
+
+  size_t SlabSize = 64 * 1024;
+  char *CurPtr = nullptr;
+  char *End = nullptr;
+  std::vector<char *> Slabs;
+  size_t BytesAllocated = 0;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef CASTING_HPP
+#define CASTING_HPP
+
+#include <cassert>
+
+/// RTTI free type checks and casts for class hierarchies, where each class
+/// provides a static classof predicate deciding whether the object passed to
+/// it is an instance of the class, usually based on a kind tag stored in the
+/// object. Unlike dynamic_cast these do not walk the type info of the object.
+
+/// Return true if @V is an instance of To. @V must not be null.
+template <typename To, typename From> bool isa(const From *V) {
+  assert(V && "isa<> used on a null pointer");
+  return To::classof(V);
+}
+
+/// Cast @V to To, which must be its actual type.
+template <typename To, typename From> To *cast(From *V) {
+  assert(isa<To>(V) && "cast<> to incompatible type");
+  return static_cast<To *>(V);
+}
+
+template <typename To, typename From> const To *cast(const From *V) {
+  assert(isa<To>(V) && "cast<> to incompatible type");
+  return static_cast<const To *>(V);
+}
+
+/// Return @V casted to To if it is an instance of it, nullptr otherwise.
+template <typename To, typename From> To *dyn_cast(From *V) {
+  return isa<To>(V) ? static_cast<To *>(V) : nullptr;
+}
+
+template <typename To, typename From> const To *dyn_cast(const From *V) {
+  return isa<To>(V) ? static_cast<const To *>(V) : nullptr;
+}
+
+/// Same as dyn_cast, but accepts nullptr as well.
+template <typename To, typename From> To *dyn_cast_or_null(From *V) {
+  return V ? dyn_cast<To>(V) : nullptr;
+}
+
+#endif
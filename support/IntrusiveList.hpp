@@ -0,0 +1,212 @@
+#ifndef INTRUSIVE_LIST_HPP
+#define INTRUSIVE_LIST_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+
+template <typename T> class IntrusiveList;
+
+/// Base class of the elements of an IntrusiveList, it holds the links to the
+/// neighbouring elements. Copying a node does not copy its links, the copy is
+/// not part of any list.
+template <typename T> class IntrusiveListNode {
+public:
+  IntrusiveListNode() = default;
+  IntrusiveListNode(const IntrusiveListNode &) {}
+  IntrusiveListNode &operator=(const IntrusiveListNode &) { return *this; }
+
+  bool IsLinked() const { return Next != nullptr; }
+
+private:
+  IntrusiveListNode *Prev = nullptr;
+  IntrusiveListNode *Next = nullptr;
+
+  friend class IntrusiveList<T>;
+};
+
+/// Doubly linked list, where the links are stored in the elements themselves,
+/// so inserting, erasing and moving elements between lists are O(1) and do
+/// not invalidate the iterators of the other elements.
+///
+/// The list does not allocate the elements, they are expected to live in an
+/// arena. Erasing an element or destroying the list only runs the destructors
+/// of the elements, the memory is given back by the arena.
+template <typename T> class IntrusiveList {
+  using Node = IntrusiveListNode<T>;
+
+public:
+  template <typename ValueT> class Iterator {
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ValueT *;
+    using reference = ValueT &;
+
+    Iterator() = default;
+    explicit Iterator(Node *N) : N(N) {}
+    explicit Iterator(ValueT *V) : N(const_cast<T *>(V)) {}
+
+    /// Allow conversion from iterator to const_iterator
+    template <typename OtherT>
+    Iterator(const Iterator<OtherT> &Other) : N(Other.GetNode()) {}
+
+    reference operator*() const { return *static_cast<ValueT *>(N); }
+    pointer operator->() const { return static_cast<ValueT *>(N); }
+
+    Iterator &operator++() {
+      N = N->Next;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto Old = *this;
+      N = N->Next;
+      return Old;
+    }
+    Iterator &operator--() {
+      N = N->Prev;
+      return *this;
+    }
+    Iterator operator--(int) {
+      auto Old = *this;
+      N = N->Prev;
+      return Old;
+    }
+
+    bool operator==(const Iterator &RHS) const { return N == RHS.N; }
+    bool operator!=(const Iterator &RHS) const { return N != RHS.N; }
+
+    Node *GetNode() const { return N; }
+
+  private:
+    Node *N = nullptr;
+  };
+
+  using iterator = Iterator<T>;
+  using const_iterator = Iterator<const T>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  IntrusiveList() { Sentinel.Prev = Sentinel.Next = &Sentinel; }
+
+  IntrusiveList(const IntrusiveList &) = delete;
+  IntrusiveList &operator=(const IntrusiveList &) = delete;
+
+  IntrusiveList(IntrusiveList &&Other) noexcept : IntrusiveList() {
+    TakeElements(Other);
+  }
+
+  IntrusiveList &operator=(IntrusiveList &&Other) noexcept {
+    if (this != &Other) {
+      clear();
+      TakeElements(Other);
+    }
+    return *this;
+  }
+
+  ~IntrusiveList() { clear(); }
+
+  iterator begin() { return iterator(Sentinel.Next); }
+  iterator end() { return iterator(&Sentinel); }
+  const_iterator begin() const { return const_iterator(Sentinel.Next); }
+  const_iterator end() const {
+    return const_iterator(const_cast<Node *>(&Sentinel));
+  }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  size_t size() const { return NumElements; }
+  bool empty() const { return NumElements == 0; }
+
+  T &front() {
+    assert(!empty() && "List is empty");
+    return *begin();
+  }
+  T &back() {
+    assert(!empty() && "List is empty");
+    return *std::prev(end());
+  }
+
+  /// Link @Elem before @Pos and return an iterator to it.
+  iterator insert(iterator Pos, T *Elem) {
+    Node *N = Elem;
+    assert(!N->IsLinked() && "Element is already in a list");
+    Node *Next = Pos.GetNode();
+    N->Prev = Next->Prev;
+    N->Next = Next;
+    Next->Prev->Next = N;
+    Next->Prev = N;
+    NumElements++;
+    return iterator(N);
+  }
+
+  void push_back(T *Elem) { insert(end(), Elem); }
+  void push_front(T *Elem) { insert(begin(), Elem); }
+
+  /// Unlink @Elem from the list without destroying it.
+  T *remove(T *Elem) {
+    Node *N = Elem;
+    assert(N->IsLinked() && "Element is not in a list");
+    N->Prev->Next = N->Next;
+    N->Next->Prev = N->Prev;
+    N->Prev = N->Next = nullptr;
+    NumElements--;
+    return Elem;
+  }
+
+  /// Unlink and destroy the element at @Pos. Return the iterator to the next
+  /// element.
+  iterator erase(iterator Pos) {
+    assert(Pos != end() && "Cannot erase the end iterator");
+    auto Next = std::next(Pos);
+    remove(&*Pos)->~T();
+    return Next;
+  }
+
+  iterator erase(T *Elem) { return erase(iterator(Elem)); }
+
+  /// Unlink and destroy the elements in the [First, Last) range.
+  iterator erase(iterator First, iterator Last) {
+    while (First != Last)
+      First = erase(First);
+    return Last;
+  }
+
+  void pop_back() { erase(std::prev(end())); }
+
+  void clear() { erase(begin(), end()); }
+
+  /// Move @Elem from @From before @Pos. @From can be this list as well.
+  void splice(iterator Pos, IntrusiveList &From, T *Elem) {
+    if (Pos.GetNode() == static_cast<Node *>(Elem))
+      return;
+    insert(Pos, From.remove(Elem));
+  }
+
+private:
+  void TakeElements(IntrusiveList &Other) {
+    if (Other.empty())
+      return;
+
+    Sentinel.Next = Other.Sentinel.Next;
+    Sentinel.Prev = Other.Sentinel.Prev;
+    Sentinel.Next->Prev = Sentinel.Prev->Next = &Sentinel;
+    NumElements = Other.NumElements;
+
+    Other.Sentinel.Prev = Other.Sentinel.Next = &Other.Sentinel;
+    Other.NumElements = 0;
+  }
+
+  Node Sentinel;
+  size_t NumElements = 0;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef ITERATOR_RANGE_HPP
+#define ITERATOR_RANGE_HPP
+
+#include <cstddef>
+#include <iterator>
+
+/// A pair of iterators usable in range based for loops.
+template <typename IteratorT> class IteratorRange {
+public:
+  IteratorRange(IteratorT Begin, IteratorT End) : Begin(Begin), End(End) {}
+
+  IteratorT begin() const { return Begin; }
+  IteratorT end() const { return End; }
+
+  size_t size() const { return std::distance(Begin, End); }
+  bool empty() const { return Begin == End; }
+
+private:
+  IteratorT Begin;
+  IteratorT End;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#include "Statistic.hpp"
+#include <iomanip>
+#include <map>
+#include <string>
+
+Statistic::Statistic(const char *Group, const char *Name,
+                     const char *Description)
+    : Group(Group), Name(Name), Description(Description) {
+  StatisticRegistry::Get().Register(this);
+}
+
+StatisticRegistry &StatisticRegistry::Get() {
+  static StatisticRegistry Registry;
+  return Registry;
+}
+
+void StatisticRegistry::Register(Statistic *S) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Statistics.push_back(S);
+}
+
+void StatisticRegistry::ResetAll() {
+  std::lock_guard<std::mutex> Guard(Lock);
+  for (auto S : Statistics)
+    S->Reset();
+}
+
+/// The summed value and the description of the counters with the same group
+/// and name.
+struct MergedStatistic {
+  const char *Group;
+  const char *Name;
+  const char *Description;
+  uint64_t Value = 0;
+};
+
+/// Merge the counters of @Statistics by their group and name, sorted by those.
+static std::vector<MergedStatistic>
+Merge(const std::vector<Statistic *> &Statistics) {
+  std::map<std::pair<std::string, std::string>, MergedStatistic> Merged;
+  for (auto S : Statistics) {
+    auto [It, Inserted] = Merged.try_emplace(
+        {S->GetGroup(), S->GetName()},
+        MergedStatistic{S->GetGroup(), S->GetName(), S->GetDescription()});
+    It->second.Value += S->GetValue();
+  }
+
+  std::vector<MergedStatistic> Result;
+  for (auto &[Key, S] : Merged)
+    Result.push_back(S);
+  return Result;
+}
+
+void StatisticRegistry::PrintText(std::ostream &OS) const {
+  std::lock_guard<std::mutex> Guard(Lock);
+
+  OS << "===" << std::string(70, '-') << "===" << std::endl;
+  OS << "  Statistics collected" << std::endl;
+  OS << "===" << std::string(70, '-') << "===" << std::endl;
+
+  for (auto &S : Merge(Statistics))
+    if (S.Value != 0)
+      OS << std::setw(10) << S.Value << " " << S.Group << " - "
+         << S.Description << std::endl;
+
+  OS << std::endl;
+}
+
+void StatisticRegistry::PrintJSON(std::ostream &OS) const {
+  std::lock_guard<std::mutex> Guard(Lock);
+
+  // The groups and names are identifiers, they need no escaping
+  OS << "{";
+  bool First = true;
+  for (auto &S : Merge(Statistics)) {
+    OS << (First ? "" : ",") << std::endl
+       << "  \"" << S.Group << "." << S.Name << "\": " << S.Value;
+    First = false;
+  }
+  OS << std::endl << "}" << std::endl;
+}
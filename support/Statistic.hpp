@@ -0,0 +1,77 @@
+#ifndef STATISTIC_HPP
+#define STATISTIC_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+/// A named counter of what the compiler did, like the number of instructions
+/// removed by a pass. They are printed by -stats, so the effectiveness of the
+/// optimizations can be tracked across versions of the compiler.
+///
+/// The counters are meant to be static objects defined by the STATISTIC
+/// macro, they register themselves on construction. Counting is thread safe
+/// and always enabled, it is a relaxed atomic increment.
+class Statistic {
+public:
+  Statistic(const char *Group, const char *Name, const char *Description);
+
+  Statistic(const Statistic &) = delete;
+  Statistic &operator=(const Statistic &) = delete;
+
+  Statistic &operator++() {
+    Value.fetch_add(1, std::memory_order_relaxed);
+    return *this;
+  }
+
+  Statistic &operator+=(uint64_t N) {
+    Value.fetch_add(N, std::memory_order_relaxed);
+    return *this;
+  }
+
+  uint64_t GetValue() const { return Value.load(std::memory_order_relaxed); }
+  void Reset() { Value.store(0, std::memory_order_relaxed); }
+
+  const char *GetGroup() const { return Group; }
+  const char *GetName() const { return Name; }
+  const char *GetDescription() const { return Description; }
+
+private:
+  const char *Group;
+  const char *Name;
+  const char *Description;
+  std::atomic<uint64_t> Value = 0;
+};
+
+/// Define the counter @Var of @Group, which is usually the name of the pass.
+#define STATISTIC(Var, Group, Description)                                     \
+  static Statistic Var(Group, #Var, Description)
+
+/// The list of every counter of the compiler.
+class StatisticRegistry {
+public:
+  static StatisticRegistry &Get();
+
+  void Register(Statistic *S);
+
+  /// Set every counter to zero, to start the counting of a new compilation.
+  void ResetAll();
+
+  /// Print the non zero counters, one per line with their description.
+  void PrintText(std::ostream &OS = std::cerr) const;
+
+  /// Print every counter, including the zero ones, as a JSON object keyed by
+  /// "<group>.<name>". The counters defined with the same group and name in
+  /// multiple files are summed in both formats.
+  void PrintJSON(std::ostream &OS = std::cerr) const;
+
+private:
+  StatisticRegistry() = default;
+
+  mutable std::mutex Lock;
+  std::vector<Statistic *> Statistics;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "Symbol.hpp"
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/// The pool behind the symbols. The strings are copied into big chunks of
+/// memory, and the ID to string table is also chunked, so nothing is ever
+/// moved and the readers do not need to lock.
+class StringPool {
+public:
+  StringPool() { Intern(""); }
+
+  static StringPool &Get() {
+    static StringPool Pool;
+    return Pool;
+  }
+
+  uint32_t Intern(std::string_view Str) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+
+    if (auto It = IDs.find(Str); It != IDs.end())
+      return It->second;
+
+    auto Stored = Store(Str);
+    uint32_t ID = NumStrings;
+    assert(ID < MaxTableChunks * TableChunkSize && "Too many symbols");
+
+    auto &Chunk = Table[ID / TableChunkSize];
+    if (!Chunk)
+      Chunk = std::make_unique<std::string_view[]>(TableChunkSize);
+    Chunk[ID % TableChunkSize] = Stored;
+
+    IDs.emplace(Stored, ID);
+    NumStrings = ID + 1;
+    return ID;
+  }
+
+  std::string_view GetString(uint32_t ID) const {
+    // The IDs are only handed out after their entry is written, so an
+    // existing symbol always refers to a valid entry
+    return Table[ID / TableChunkSize][ID % TableChunkSize];
+  }
+
+private:
+  /// Copy @Str with a terminating null character into the storage.
+  std::string_view Store(std::string_view Str) {
+    const size_t Size = Str.size() + 1;
+    char *Dest;
+
+    // Strings larger than a chunk get their own, the current chunk is kept
+    if (Size > StorageChunkSize) {
+      Storage.push_back(std::make_unique<char[]>(Size));
+      Dest = Storage.back().get();
+    } else {
+      if (!CurrentChunk || Size > StorageChunkSize - StorageUsed) {
+        Storage.push_back(std::make_unique<char[]>(StorageChunkSize));
+        CurrentChunk = Storage.back().get();
+        StorageUsed = 0;
+      }
+      Dest = CurrentChunk + StorageUsed;
+      StorageUsed += Size;
+    }
+
+    Str.copy(Dest, Str.size());
+    Dest[Str.size()] = '\0';
+    return {Dest, Str.size()};
+  }
+
+  static constexpr size_t StorageChunkSize = 64 * 1024;
+  static constexpr size_t TableChunkSize = 4096;
+  static constexpr size_t MaxTableChunks = 16 * 1024;
+
+  std::mutex Mutex;
+  std::unordered_map<std::string_view, uint32_t> IDs;
+  std::vector<std::unique_ptr<char[]>> Storage;
+  char *CurrentChunk = nullptr;
+  size_t StorageUsed = 0;
+  std::unique_ptr<std::unique_ptr<std::string_view[]>[]> Table =
+      std::make_unique<std::unique_ptr<std::string_view[]>[]>(MaxTableChunks);
+  uint32_t NumStrings = 0;
+};
+
+} // namespace
+
+Symbol Symbol::Intern(std::string_view Str) {
+  return Symbol(StringPool::Get().Intern(Str));
+}
+
+std::string_view Symbol::Str() const { return StringPool::Get().GetString(ID); }
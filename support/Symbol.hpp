@@ -0,0 +1,62 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/// Handle of an interned string. Every distinct string is stored only once in
+/// a process wide pool and gets a stable 32 bit ID, so comparing and hashing
+/// symbols are integer operations. Identifiers are interned once, when they
+/// are lexed, and every later table uses the symbol as key.
+///
+/// Interning is thread safe, and the text of a symbol can be read from any
+/// thread without locking.
+class Symbol {
+public:
+  /// The empty symbol, which is the interned empty string.
+  Symbol() = default;
+
+  /// Return the symbol of @Str, adding it to the pool on first use.
+  static Symbol Intern(std::string_view Str);
+
+  std::string_view Str() const;
+
+  /// The text is stored null terminated, so it is usable as a C string.
+  const char *CStr() const { return Str().data(); }
+  std::string ToString() const { return std::string(Str()); }
+
+  uint32_t GetID() const { return ID; }
+  bool IsEmpty() const { return ID == 0; }
+
+  bool operator==(Symbol RHS) const { return ID == RHS.ID; }
+  bool operator!=(Symbol RHS) const { return ID != RHS.ID; }
+
+  /// Orders by the ID, which is the order of interning, not alphabetical.
+  bool operator<(Symbol RHS) const { return ID < RHS.ID; }
+
+private:
+  explicit Symbol(uint32_t ID) : ID(ID) {}
+
+  uint32_t ID = 0;
+};
+
+inline std::ostream &operator<<(std::ostream &OS, Symbol S) {
+  return OS << S.Str();
+}
+
+inline std::string operator+(const std::string &LHS, Symbol RHS) {
+  return LHS + std::string(RHS.Str());
+}
+
+inline std::string operator+(Symbol LHS, const std::string &RHS) {
+  return std::string(LHS.Str()) + RHS;
+}
+
+template <> struct std::hash<Symbol> {
+  size_t operator()(Symbol S) const { return std::hash<uint32_t>()(S.GetID()); }
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include "ThreadPool.hpp"
+#include <cassert>
+
+ThreadPool::ThreadPool(unsigned NumThreads) {
+  assert(NumThreads > 0 && "The pool needs at least one thread");
+
+  for (unsigned i = 0; i < NumThreads; i++)
+    Queues.push_back(std::make_unique<WorkQueue>());
+
+  for (unsigned i = 0; i < NumThreads; i++)
+    Workers.emplace_back([this, i] { WorkerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+  Wait();
+
+  {
+    std::lock_guard<std::mutex> Guard(Lock);
+    Stopping = true;
+  }
+  WorkAvailable.notify_all();
+
+  for (auto &Worker : Workers)
+    Worker.join();
+}
+
+void ThreadPool::Async(Task T) {
+  {
+    std::lock_guard<std::mutex> Guard(Lock);
+    auto &Queue = *Queues[NextQueue];
+    NextQueue = (NextQueue + 1) % Queues.size();
+
+    // The task has to be in the queue before it is counted, otherwise a
+    // worker could claim it before it could be found
+    std::lock_guard<std::mutex> QueueGuard(Queue.Lock);
+    Queue.Tasks.push_back(std::move(T));
+    NumQueued++;
+    NumPending++;
+  }
+  WorkAvailable.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> Guard(Lock);
+  AllDone.wait(Guard, [this] { return NumPending == 0; });
+}
+
+bool ThreadPool::PopTask(unsigned Index, Task &T) {
+  {
+    auto &Own = *Queues[Index];
+    std::lock_guard<std::mutex> Guard(Own.Lock);
+    if (!Own.Tasks.empty()) {
+      T = std::move(Own.Tasks.back());
+      Own.Tasks.pop_back();
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i < Queues.size(); i++) {
+    auto &Victim = *Queues[(Index + i) % Queues.size()];
+    std::lock_guard<std::mutex> Guard(Victim.Lock);
+    if (!Victim.Tasks.empty()) {
+      T = std::move(Victim.Tasks.front());
+      Victim.Tasks.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::WorkerLoop(unsigned Index) {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> Guard(Lock);
+      WorkAvailable.wait(Guard, [this] { return Stopping || NumQueued > 0; });
+      if (NumQueued == 0)
+        return;
+
+      // Claim one of the queued tasks, so it is guaranteed that there is
+      // one for this worker in the queues
+      NumQueued--;
+    }
+
+    Task T;
+    while (!PopTask(Index, T))
+      std::this_thread::yield();
+
+    T();
+
+    std::lock_guard<std::mutex> Guard(Lock);
+    if (--NumPending == 0)
+      AllDone.notify_all();
+  }
+}
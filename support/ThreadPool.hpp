@@ -0,0 +1,68 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed size pool of worker threads with work stealing. Every worker has its
+/// own task queue, the submitted tasks are spread over them in a round robin
+/// fashion. A worker takes the most recently queued task from its own queue
+/// and when that is empty, then it steals the oldest task of another worker,
+/// so uneven tasks (like a huge function among small ones) do not leave the
+/// other workers idle.
+///
+/// The tasks are not ordered in any way, the callers are responsible to
+/// collect the results deterministically.
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  explicit ThreadPool(unsigned NumThreads);
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// Wait for the queued tasks, then stop the workers.
+  ~ThreadPool();
+
+  /// Queue @T to be run by one of the workers.
+  void Async(Task T);
+
+  /// Block until every task submitted so far is finished.
+  void Wait();
+
+  unsigned GetNumThreads() const { return Workers.size(); }
+
+private:
+  struct WorkQueue {
+    std::mutex Lock;
+    std::deque<Task> Tasks;
+  };
+
+  void WorkerLoop(unsigned Index);
+
+  /// Take a task from the back of the @Index -th queue, or steal one from the
+  /// front of the other queues. Return false if all of them are empty.
+  bool PopTask(unsigned Index, Task &T);
+
+  std::vector<std::unique_ptr<WorkQueue>> Queues;
+  std::vector<std::thread> Workers;
+  unsigned NextQueue = 0;
+
+  /// Guards the counters below.
+  std::mutex Lock;
+  std::condition_variable WorkAvailable;
+  std::condition_variable AllDone;
+  /// Tasks which are in a queue and not yet claimed by a worker.
+  size_t NumQueued = 0;
+  /// Tasks which are queued or running.
+  size_t NumPending = 0;
+  bool Stopping = false;
+};
+
+#endif
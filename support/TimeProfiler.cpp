@@ -0,0 +1,234 @@
+#include "TimeProfiler.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <unistd.h>
+
+TimeProfiler &TimeProfiler::Get() {
+  static TimeProfiler Profiler;
+  return Profiler;
+}
+
+void TimeProfiler::Start() {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Events.clear();
+  ThreadIndices.clear();
+  StartTime = EndTime = Clock::now();
+  Enabled = true;
+}
+
+void TimeProfiler::Stop() {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Enabled = false;
+  EndTime = Clock::now();
+}
+
+void TimeProfiler::AddEvent(const char *Category, std::string_view Name,
+                            std::string_view Detail, Clock::time_point Begin,
+                            Clock::time_point End) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  auto ThreadIndex =
+      ThreadIndices.emplace(std::this_thread::get_id(), ThreadIndices.size())
+          .first->second;
+  Events.push_back({Category, std::string(Name), std::string(Detail), Begin,
+                    End, ThreadIndex});
+}
+
+static double ToMilliseconds(TimeProfiler::Clock::duration D) {
+  return std::chrono::duration<double, std::milli>(D).count();
+}
+
+/// A line of the report: the summed time of the events with the same name.
+struct ReportRow {
+  std::string Name;
+  TimeProfiler::Clock::duration Time{};
+  unsigned Count = 0;
+};
+
+/// Sum the time of the events which are accepted by @Filter, grouped by the
+/// key returned by @GetKey. The rows are sorted by decreasing time.
+template <typename FilterT, typename KeyT>
+static std::vector<ReportRow>
+Aggregate(const std::vector<TimeProfiler::Event> &Events, FilterT Filter,
+          KeyT GetKey) {
+  std::map<std::string, ReportRow> Rows;
+  for (auto &E : Events) {
+    if (!Filter(E))
+      continue;
+
+    auto &Key = GetKey(E);
+    auto &Row = Rows[Key];
+    Row.Name = Key;
+    Row.Time += E.End - E.Begin;
+    Row.Count++;
+  }
+
+  std::vector<ReportRow> Result;
+  for (auto &[Key, Row] : Rows)
+    Result.push_back(Row);
+
+  std::stable_sort(Result.begin(), Result.end(),
+                   [](const ReportRow &LHS, const ReportRow &RHS) {
+                     return LHS.Time > RHS.Time;
+                   });
+  return Result;
+}
+
+/// Print the first @MaxRows of @Rows. The count is only meaningful when the
+/// rows are the individual phases or passes, so it is optional.
+static void PrintTable(std::ostream &OS, const std::string &Title,
+                       const std::vector<ReportRow> &Rows, bool PrintCount,
+                       size_t MaxRows = SIZE_MAX) {
+  if (Rows.empty())
+    return;
+
+  TimeProfiler::Clock::duration Total{};
+  for (auto &Row : Rows)
+    Total += Row.Time;
+
+  OS << std::endl << "  " << Title << std::endl;
+  OS << "  " << std::setw(12) << "Time (ms)" << std::setw(8) << "%"
+     << std::setw(9) << (PrintCount ? "Count" : "") << "  Name" << std::endl;
+
+  for (size_t i = 0; i < Rows.size() && i < MaxRows; i++) {
+    auto &Row = Rows[i];
+    const double Percent =
+        Total.count() > 0 ? 100.0 * Row.Time.count() / Total.count() : 0.0;
+    OS << "  " << std::setw(12) << std::setprecision(3)
+       << ToMilliseconds(Row.Time) << std::setw(7) << std::setprecision(1)
+       << Percent << "%" << std::setw(9);
+    if (PrintCount)
+      OS << Row.Count;
+    else
+      OS << "";
+    OS << "  " << Row.Name << std::endl;
+  }
+
+  OS << "  " << std::setw(12) << std::setprecision(3) << ToMilliseconds(Total)
+     << std::setw(7) << std::setprecision(1) << 100.0 << "%" << std::setw(9)
+     << "" << "  Total" << std::endl;
+}
+
+void TimeProfiler::PrintReport(std::ostream &OS) const {
+  std::lock_guard<std::mutex> Guard(Lock);
+
+  const auto Flags = OS.flags();
+  const auto Precision = OS.precision();
+  OS << std::fixed << std::setprecision(3);
+
+  OS << "===" << std::string(70, '-') << "===" << std::endl;
+  OS << "  Time report, wall clock time: "
+     << ToMilliseconds(EndTime - StartTime) << " ms" << std::endl;
+  if (ThreadIndices.size() > 1)
+    OS << "  Measured on " << ThreadIndices.size()
+       << " threads, the sums can exceed the wall clock time" << std::endl;
+  OS << "===" << std::string(70, '-') << "===" << std::endl;
+
+  auto GetName = [](const Event &E) -> const std::string & { return E.Name; };
+  auto GetDetail = [](const Event &E) -> const std::string & {
+    return E.Detail;
+  };
+  auto IsPhase = [](const Event &E) {
+    return std::string_view(E.Category) == "frontend" ||
+           std::string_view(E.Category) == "codegen";
+  };
+  auto IsPass = [](const Event &E) {
+    return std::string_view(E.Category) == "pass";
+  };
+  auto IsFunctionPhase = [](const Event &E) {
+    return std::string_view(E.Category) == "codegen" && !E.Detail.empty();
+  };
+
+  PrintTable(OS, "Phases:", Aggregate(Events, IsPhase, GetName), true);
+  PrintTable(OS, "IR passes:", Aggregate(Events, IsPass, GetName), true);
+
+  // The functions are measured by their phases, so both the serial and the
+  // parallel pipeline are covered
+  const unsigned MaxFunctions = 10;
+  auto Functions = Aggregate(Events, IsFunctionPhase, GetDetail);
+  PrintTable(OS,
+             Functions.size() > MaxFunctions
+                 ? "Slowest " + std::to_string(MaxFunctions) + " of " +
+                       std::to_string(Functions.size()) + " functions:"
+                 : "Functions:",
+             Functions, false, MaxFunctions);
+
+  OS << std::endl;
+  OS.flags(Flags);
+  OS.precision(Precision);
+}
+
+static void PrintJSONString(std::ostream &OS, std::string_view Str) {
+  OS << '"';
+  for (unsigned char C : Str) {
+    if (C == '"' || C == '\\')
+      OS << '\\' << C;
+    else if (C < 0x20) {
+      char Escaped[8];
+      std::snprintf(Escaped, sizeof(Escaped), "\\u%04x", C);
+      OS << Escaped;
+    } else
+      OS << C;
+  }
+  OS << '"';
+}
+
+bool TimeProfiler::WriteTrace(const std::string &Path) const {
+  std::lock_guard<std::mutex> Guard(Lock);
+
+  std::ofstream OS(Path);
+  if (!OS)
+    return false;
+
+  auto ToMicroseconds = [](Clock::duration D) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(D).count();
+  };
+
+  const auto PID = getpid();
+  OS << "{\"traceEvents\":[" << std::endl;
+
+  // The outer events have to come first among the ones starting at the same
+  // time, otherwise the viewers do not nest them properly
+  std::vector<const Event *> Sorted;
+  for (auto &E : Events)
+    Sorted.push_back(&E);
+  std::stable_sort(Sorted.begin(), Sorted.end(),
+                   [](const Event *LHS, const Event *RHS) {
+                     if (LHS->Begin != RHS->Begin)
+                       return LHS->Begin < RHS->Begin;
+                     return LHS->End > RHS->End;
+                   });
+
+  bool First = true;
+  for (auto E : Sorted) {
+    OS << (First ? "" : ",\n") << "{\"cat\":\"" << E->Category
+       << "\",\"name\":";
+    PrintJSONString(OS, E->Name);
+    OS << ",\"ph\":\"X\",\"pid\":" << PID << ",\"tid\":" << E->ThreadIndex
+       << ",\"ts\":" << ToMicroseconds(E->Begin - StartTime)
+       << ",\"dur\":" << ToMicroseconds(E->End - E->Begin);
+    if (!E->Detail.empty()) {
+      OS << ",\"args\":{\"detail\":";
+      PrintJSONString(OS, E->Detail);
+      OS << "}";
+    }
+    OS << "}";
+    First = false;
+  }
+
+  // Name the threads, they are numbered in the order of their first event
+  for (auto &[ID, Index] : ThreadIndices) {
+    OS << (First ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\","
+       << "\"pid\":" << PID << ",\"tid\":" << Index
+       << ",\"args\":{\"name\":\"thread " << Index << "\"}}";
+    First = false;
+  }
+
+  OS << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+  OS.close();
+  return static_cast<bool>(OS);
+}
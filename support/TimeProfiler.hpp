@@ -0,0 +1,106 @@
+#ifndef TIME_PROFILER_HPP
+#define TIME_PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/// Process wide recorder of the time spent in the phases of the compilation,
+/// used by -ftime-report and -ftime-trace. The intervals are measured by
+/// TimeScope objects placed around the phases, the passes and the functions.
+/// Recording is thread safe, so the concurrently compiled functions and files
+/// are measured as well, each on the thread it was compiled on.
+///
+/// While the profiler is not started, a TimeScope costs an atomic load only.
+class TimeProfiler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// A measured interval. The category groups the events of the report:
+  ///  - "file": the compilation of a whole file, the detail is its path
+  ///  - "frontend": a phase working on a whole file, the detail is its path
+  ///  - "codegen": a phase working on a function, the detail is its name
+  ///  - "pass": an IR pass, the detail is the name of the function
+  ///  - "function": the whole pipeline of a function, the name is the
+  ///    function, only used by the parallel compilation
+  struct Event {
+    const char *Category;
+    std::string Name;
+    std::string Detail;
+    Clock::time_point Begin;
+    Clock::time_point End;
+    unsigned ThreadIndex;
+  };
+
+  static TimeProfiler &Get();
+
+  /// Drop the previous events and start recording.
+  void Start();
+  /// Stop recording, the events are kept for the report and the trace.
+  void Stop();
+
+  bool IsEnabled() const { return Enabled.load(std::memory_order_relaxed); }
+
+  void AddEvent(const char *Category, std::string_view Name,
+                std::string_view Detail, Clock::time_point Begin,
+                Clock::time_point End);
+
+  /// Print the time spent in each phase, each pass and the slowest functions
+  /// as a table.
+  void PrintReport(std::ostream &OS = std::cerr) const;
+
+  /// Write the events as Chrome trace events into @Path, which can be opened
+  /// by chrome://tracing or Perfetto. Return false if it cannot be written.
+  bool WriteTrace(const std::string &Path) const;
+
+private:
+  TimeProfiler() = default;
+
+  std::atomic<bool> Enabled = false;
+  Clock::time_point StartTime;
+  Clock::time_point EndTime;
+
+  mutable std::mutex Lock;
+  std::vector<Event> Events;
+  /// Small indices of the threads in the order they recorded their first
+  /// event, the trace is more readable with those than the native IDs.
+  std::unordered_map<std::thread::id, unsigned> ThreadIndices;
+};
+
+/// Measure the lifetime of the object as an event of the TimeProfiler, if it
+/// is enabled at the construction.
+class TimeScope {
+public:
+  TimeScope(const char *Category, std::string_view Name,
+            std::string_view Detail = {})
+      : Category(Category), Name(Name), Detail(Detail),
+        Enabled(TimeProfiler::Get().IsEnabled()) {
+    if (Enabled)
+      Begin = TimeProfiler::Clock::now();
+  }
+
+  ~TimeScope() {
+    if (Enabled)
+      TimeProfiler::Get().AddEvent(Category, Name, Detail, Begin,
+                                   TimeProfiler::Clock::now());
+  }
+
+  TimeScope(const TimeScope &) = delete;
+  TimeScope &operator=(const TimeScope &) = delete;
+
+private:
+  const char *Category;
+  /// Both have to outlive the scope.
+  std::string_view Name;
+  std::string_view Detail;
+  bool Enabled;
+  TimeProfiler::Clock::time_point Begin;
+};
+
+#endif
@@ -3,10 +3,12 @@ import re
 import subprocess
 from os import path
 import sys
+import tempfile
 from dataclasses import dataclass
 from dataclasses import field
 
 save_temps = False
+compiler = "../build/miniCC"
 
 @dataclass
 class Context:
@@ -20,6 +22,7 @@ class Context:
     compile_test: bool = False
     negative_test: bool = False
     extra_compile_flags: str = ""
+    command: str = ""
 
 def clean_up():
   if path.exists("test_main.c"):
@@ -72,6 +75,10 @@ def check_file(file_name):
             if m:
                 context.extra_compile_flags = m.group(1)
 
+            m = re.search(r'(?:/{2}|#) *COMMAND: (.*)', line)
+            if m:
+                context.command = m.group(1)
+
     return context
 
 
@@ -87,13 +94,25 @@ def execute_tests(file_name, context):
       return False
 
     # create the full command to call the compiler
-    command = ["../build/miniCC", "-arch=" + context.arch, file_name]
+    command = [compiler, "-arch=" + context.arch, file_name]
     if context.extra_compile_flags != "":
       command.extend(context.extra_compile_flags.split())
 
+    # a COMMAND replaces the compiler call with a shell command, where %miniCC
+    # is the compiler, %s is the test file, %S is its directory and %t is a
+    # temporary path unique to the test
+    if context.command != "":
+      temp_path = path.join(tempfile.gettempdir(),
+                            "miniCC-test-" + path.basename(file_name))
+      command = context.command.replace("%miniCC", compiler)
+      command = command.replace("%s", file_name)
+      command = command.replace("%S", path.dirname(file_name))
+      command = command.replace("%t", temp_path)
+
     # call the compiler
     try:
-      result = subprocess.run(command, capture_output=True, timeout=3)
+      result = subprocess.run(command, capture_output=True, timeout=3,
+                              shell=context.command != "")
     except subprocess.TimeoutExpired:
       print(f'Timeout for {command} (3s) expired')
       if not save_temps:
@@ -0,0 +1,38 @@
+// RUN: AArch64
+// EXTRA-FLAGS: -O -j 4
+
+// FUNC-DECL: int test(int)
+// TEST-CASE: test(0) -> 0
+// TEST-CASE: test(5) -> 80
+// TEST-CASE: test(10) -> 395
+
+// The functions are compiled on different threads, the labels and the
+// callee saved register spills of each must stay intact.
+
+int Counter = 0;
+
+int square(int a) { return a * a; }
+
+int sum_squares(int n) {
+  int sum = 0;
+  for (int i = 0; i < n; i++)
+    sum = sum + square(i);
+  return sum;
+}
+
+int count(int n) {
+  while (n > 0) {
+    Counter = Counter + 1;
+    n = n - 1;
+  }
+  return Counter;
+}
+
+int test(int n) {
+  Counter = 0;
+  int res = sum_squares(n);
+  res = res + count(n) * 10;
+  if (res > 100)
+    return res + n;
+  return res;
+}
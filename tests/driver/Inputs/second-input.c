@@ -0,0 +1 @@
+int second(int a) { return a + 2; }
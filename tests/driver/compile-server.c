@@ -0,0 +1,16 @@
+// COMPILE-TEST
+// COMMAND: echo "keep this file" > %t.file; %miniCC --server %t.file 2>&1; cat %t.file; rm -f %t.file %t.sock; %miniCC --server %t.sock & for i in $(seq 50); do [ -S %t.sock ] && break; sleep 0.05; done; %miniCC --server %t.sock 2>&1; %miniCC --connect %t.sock -arch=aarch64 %s && %miniCC --connect %t.sock -arch=aarch64 %s -dump-ir; %miniCC --connect %t.sock --shutdown; wait; [ -e %t.sock ] || echo "socket removed"
+
+// The server refuses to start on a path which is not a socket and on the
+// socket of a running server, leaving both intact. The request is compiled
+// by the server in the working directory of the client, and the server keeps
+// serving requests until it is shut down, then removes its socket.
+
+// CHECK: exists and is not a socket
+// CHECK: keep this file
+// CHECK: is in use
+// CHECK: square:
+// CHECK: mul
+// CHECK: func square
+// CHECK: socket removed
+int square(int a) { return a * a; }
@@ -0,0 +1,11 @@
+// COMPILE-TEST
+// COMMAND: rm -rf %t && %miniCC -arch=aarch64 -j 2 -o %t %s %S/Inputs/second-input.c && cat %t/multiple-inputs.s %t/second-input.s
+
+// Multiple inputs are compiled concurrently, each into "<name>.s" in the
+// output directory, which is created if it does not exist yet.
+
+// CHECK: first:
+// CHECK: ret
+// CHECK: second:
+// CHECK: ret
+int first(int a) { return a + 1; }
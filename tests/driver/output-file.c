@@ -0,0 +1,10 @@
+// COMPILE-TEST
+// COMMAND: rm -f %t.s && %miniCC -arch=aarch64 -o %t.s %s && cat %t.s && %miniCC -arch=aarch64 -o %t.s %S/Inputs/semantic-error.c; [ -e %t.s ] || echo "output removed"
+
+// A single input is written to the file given by -o, and the output file is
+// removed if the compilation fails, so no partial assembly is left behind.
+
+// CHECK: only:
+// CHECK: ret
+// CHECK: output removed
+int only(int a) { return a * 3; }
@@ -0,0 +1,10 @@
+// RUN: AArch64
+// FUNC-DECL: int test()
+// TEST-CASE: test() -> 7
+
+int test() {
+  unsigned /* comment */ long a = 3;
+  unsigned // comment
+      int b = 4;
+  return (int /* cast */)a + b;
+}
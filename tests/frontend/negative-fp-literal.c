@@ -0,0 +1,12 @@
+// COMPILE-TEST
+
+// The negative floating point literals are folded into a constant of the
+// type of the literal, like the integer ones.
+
+// CHECK: dbl:
+// CHECK: fmov	d0, #-1.500000
+// CHECK: flt:
+// CHECK: fmov	s0, #-1.500000
+double dbl() { return -1.5; }
+
+float flt() { return -1.5; }
@@ -0,0 +1,12 @@
+// RUN: AArch64
+// FUNC-DECL: int test()
+// TEST-CASE: test() -> 23
+
+#include "../includes/guarded.h"
+#include "../includes/pragma-once.h"
+#include "../includes/guarded.h"
+#include "../frontend/../includes/pragma-once.h"
+
+int test() {
+  return guarded_value() + pragma_once_value();
+}
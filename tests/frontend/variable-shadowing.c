@@ -0,0 +1,19 @@
+// RUN: AArch64
+// FUNC-DECL: int test()
+// TEST-CASE: test() -> 321
+
+int x = 1;
+
+int test() {
+  int result = x;
+  int x = 2;
+  result = result + x * 10;
+
+  for (int i = 0; i < 1; i++) {
+    int x = 3;
+    result = result + x * 100;
+  }
+
+  result = result + x - 2;
+  return result;
+}
@@ -0,0 +1,7 @@
+// include guard detection test header
+#ifndef GUARDED_H
+#define GUARDED_H
+
+int guarded_value() { return 20; }
+
+#endif /* GUARDED_H */
@@ -0,0 +1,3 @@
+#pragma once
+
+int pragma_once_value() { return 3; }
@@ -0,0 +1,20 @@
+// COMPILE-TEST
+// EXTRA-FLAGS: -dump-ir
+
+// The constants are uniqued by their bit pattern and width, so 0.0 and -0.0
+// must stay different constants, and so must the 32 and 64 bit versions of
+// the same literal.
+
+// CHECK: str	[$0<*f64>], 0.000000<f64>
+// CHECK: str	[$1<*f64>], -0.000000<f64>
+double zeros() {
+  double p = 0.0;
+  double n = -0.0;
+  return p + n;
+}
+
+// CHECK: ret	1.500000<f32>
+float single() { return 1.5; }
+
+// CHECK: ret	1.500000<f64>
+double twice() { return 1.5; }
@@ -0,0 +1,52 @@
+// RUN: AArch64
+
+// FUNC-DECL: int test()
+// TEST-CASE: test() -> 31
+
+#define FOO
+#define VERSION 3
+#define TWICE(x) ((x) * 2)
+
+#ifdef FOO
+#define A 1
+#else
+#define A 100
+#endif
+
+#ifndef FOO
+#define B 100
+#elif VERSION > 2 && defined(FOO)
+#define B 2
+#else
+#define B 200
+#endif
+
+#if TWICE(VERSION) == 5
+#define C 100
+#elif !defined BAR && (VERSION << 1) % 4 == 2
+  #if 0
+    #if UNDEFINED_MACRO
+      #error never seen
+    #endif
+    #define C 300
+  #else
+    #define C 4
+  #endif
+#else
+#define C 200
+#endif
+
+#undef FOO
+#if defined(FOO) || 0x10 != 16
+#define D 100
+#elif 'a' == 97 ? 1 : 0
+#define D 8
+#endif
+
+# if VERSION >= 3
+#  define E 16
+# endif
+
+int test() {
+  return A + B + C + D + E;
+}